@@ -34,19 +34,26 @@ ChartsEndWorkoutForm {
         timer.stopTimer(sendMail)
     }
 
+    // about one point per pixel, whatever the length of the workout
+    function updateSeries()
+    {
+        rootItem.update_chart_series(powerSeries, "watt", powerChart.width);
+        rootItem.update_chart_series(heartSeries, "heart", heartChart.width);
+        rootItem.update_chart_series(cadenceSeries, "cadence", cadenceChart.width);
+        // the resistance series are drawn in the cadence chart, so they take its width
+        rootItem.update_chart_series(resistanceSeries, "resistance", cadenceChart.width);
+        rootItem.update_chart_series(pelotonResistanceSeries, "peloton_resistance", cadenceChart.width);
+    }
+
     Component.onCompleted: {
         headerToolbar.visible = true;
 
         //console.log("ChartsEndWorkoutForm completed " + rootItem.workout_sample_points)
-        for(var i=0;i<rootItem.workout_sample_points;i+=10)
-        {
-            //console.log("ChartsEndWorkoutForm completed " + i + " " + rootItem.workout_watt_points[i])
-            powerSeries.append(i * 1000, rootItem.workout_watt_points[i]);
-            heartSeries.append(i * 1000, rootItem.workout_heart_points[i]);
-            cadenceSeries.append(i * 1000, rootItem.workout_cadence_points[i]);
-            resistanceSeries.append(i * 1000, rootItem.workout_resistance_points[i]);
-            pelotonResistanceSeries.append(i * 1000, rootItem.workout_peloton_resistance_points[i]);
-        }
+        // the charts may not be laid out yet, the series follow their width
+        updateSeries();
+        powerChart.widthChanged.connect(updateSeries);
+        heartChart.widthChanged.connect(updateSeries);
+        cadenceChart.widthChanged.connect(updateSeries);
         rootItem.update_chart_power(powerChart);
         //rootItem.update_axes(valueAxisX, valueAxisY);
         rootItem.update_chart_heart(heartChart);
@@ -253,11 +253,11 @@ HomeForm{
         id: loc
         enabled: window.lockTiles
         anchors.fill: parent
-        onPressAndHold: { console.log("onPressAndHold " + index); if(index !== -1) currentId = appModel[newIndex = index].gridId; else currentId = -1; }
+        onPressAndHold: { console.log("onPressAndHold " + index); if(index !== -1) currentId = appModel.get(newIndex = index).gridId; else currentId = -1; }
         onReleased: {
             console.log("onReleased " + currentId + " " + index );
             if (currentId !== -1 && index !== -1 && index !== newIndex) {
-                rootItem.moveTile(appModel[currentId].name, index, newIndex);
+                rootItem.moveTile(appModel.get(currentId).name, index, newIndex);
             } currentId = -1
         }
 
@@ -1,4 +1,5 @@
 #include "activiotreadmill.h"
+#include "packettrace.h"
 
 #include "activiotreadmill.h"
 #include "ios/lockscreen.h"
@@ -58,8 +59,7 @@ void activiotreadmill::writeCharacteristic(const QLowEnergyCharacteristic charac
     gattCommunicationChannelService->writeCharacteristic(characteristc, QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -119,13 +119,13 @@ void activiotreadmill::update() {
             if (virtual_device_enabled) {
                 if (!virtual_device_force_bike) {
                     debug("creating virtual treadmill interface...");
-                    virtualTreadMill = new virtualtreadmill(this, noHeartService);
+                    virtualTreadMill = virtualtreadmill::create(this, noHeartService);
                     connect(virtualTreadMill, &virtualtreadmill::debug, this, &activiotreadmill::debug);
                     connect(virtualTreadMill, &virtualtreadmill::changeInclination, this,
                             &activiotreadmill::changeInclinationRequested);
                 } else {
                     debug("creating virtual bike interface...");
-                    virtualBike = new virtualbike(this);
+                    virtualBike = virtualbike::create(this);
                     connect(virtualBike, &virtualbike::changeInclination, this,
                             &activiotreadmill::changeInclinationRequested);
                 }
@@ -230,7 +230,7 @@ void activiotreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    emit debug(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
+    packettrace::rx(this, value);
     emit packetReceived();
 
     if (newValue.length() < 12)
@@ -523,7 +523,7 @@ void activiotreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor,
 void activiotreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                              const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void activiotreadmill::serviceScanDone(void) {
@@ -0,0 +1,19 @@
+#ifndef APPDIR_H
+#define APPDIR_H
+
+#include <QString>
+
+// Directory where the app writes its files (logs, workouts, settings, templates...): the external files dir on
+// Android, Downloads on macOS, Documents on iOS and the working directory elsewhere.
+// Kept apart from homeform so the classes that only need the path don't depend on the UI.
+class appdir {
+
+  public:
+    // empty or ending with a '/'
+    static QString writable();
+#if defined(Q_OS_ANDROID)
+    static QString androidData();
+#endif
+};
+
+#endif // APPDIR_H
@@ -1,7 +1,7 @@
 
 #include "bike.h"
 #include "qdebugfixup.h"
-#include <QSettings>
+#include "settingssnapshot.h"
 
 bike::bike() { elapsed.setType(metric::METRIC_ELAPSED); }
 
@@ -41,11 +41,11 @@ void bike::changePower(int32_t power) {
 
     RequestedPower = power;
     requestPower = power; // used by some bikes that have ERG mode builtin
-    QSettings settings;
-    bool force_resistance = settings.value(QStringLiteral("virtualbike_forceresistance"), true).toBool();
-    // bool erg_mode = settings.value(QStringLiteral("zwift_erg"), false).toBool(); //Not used anywhere in code
-    double erg_filter_upper = settings.value(QStringLiteral("zwift_erg_filter"), 0.0).toDouble();
-    double erg_filter_lower = settings.value(QStringLiteral("zwift_erg_filter_down"), 0.0).toDouble();
+    const auto settings = settingssnapshot::current();
+    bool force_resistance = settings->virtualbike_forceresistance;
+    // bool erg_mode = settings->zwift_erg; //Not used anywhere in code
+    double erg_filter_upper = settings->zwift_erg_filter;
+    double erg_filter_lower = settings->zwift_erg_filter_down;
 
     double deltaDown = wattsMetric().value() - ((double)power);
     double deltaUp = ((double)power) - wattsMetric().value();
@@ -152,9 +152,7 @@ void bike::setLap() {
 
 uint8_t bike::metrics_override_heartrate() {
 
-    QSettings settings;
-    QString setting =
-        settings.value(QStringLiteral("peloton_heartrate_metric"), QStringLiteral("Heart Rate")).toString();
+    const QString setting = settingssnapshot::current()->peloton_heartrate_metric;
     if (!setting.compare(QStringLiteral("Heart Rate"))) {
         return qRound(currentHeart().value());
     } else if (!setting.compare(QStringLiteral("Speed"))) {
@@ -0,0 +1,179 @@
+#include "blewritequeue.h"
+#include "packettrace.h"
+#include "qdebugfixup.h"
+
+using namespace std::chrono_literals;
+
+blewritequeue::blewritequeue(QObject *parent) : QObject(parent) {
+    timeoutTimer.setSingleShot(true);
+    pacingTimer.setSingleShot(true);
+    connect(&timeoutTimer, &QTimer::timeout, this, &blewritequeue::timeout);
+    connect(&pacingTimer, &QTimer::timeout, this, &blewritequeue::next);
+    setPacing(0ms, 300ms);
+}
+
+void blewritequeue::setPacing(std::chrono::milliseconds interval, std::chrono::milliseconds timeout) {
+    pacingTimer.setInterval(interval);
+    timeoutTimer.setInterval(timeout);
+}
+
+blewritequeue::command blewritequeue::writeCommand(QLowEnergyService *service,
+                                                   const QLowEnergyCharacteristic &characteristic,
+                                                   const QByteArray &data, const QString &info, bool disableLog,
+                                                   bool waitForResponse, int coalesce) {
+    command c;
+    c.service = service;
+    c.characteristic = characteristic;
+    c.data = data;
+    c.info = info;
+    c.disableLog = disableLog;
+    c.waitForResponse = waitForResponse;
+    c.coalesce = coalesce;
+    return c;
+}
+
+void blewritequeue::write(QLowEnergyService *service, const QLowEnergyCharacteristic &characteristic,
+                          const QByteArray &data, const QString &info, bool disableLog, bool waitForResponse,
+                          int coalesce, const completion &done) {
+    command c = writeCommand(service, characteristic, data, info, disableLog, waitForResponse, coalesce);
+    c.done = done;
+    enqueue(c);
+}
+
+void blewritequeue::waitForResponse(const QString &info, const completion &done) {
+    command c;
+    c.info = info;
+    c.waitForResponse = true;
+    c.done = done;
+    enqueue(c);
+}
+
+void blewritequeue::enqueue(const command &c) { enqueue(QList<command>() << c); }
+
+void blewritequeue::enqueue(const QList<command> &frame) {
+    // the queued frames sharing a coalescing key with this one, unless their first write is already sent
+    QList<int> stale;
+    for (const command &c : frame) {
+        if (c.coalesce == NO_COALESCE) {
+            continue;
+        }
+        for (const command &q : qAsConst(queue)) {
+            if (q.coalesce == c.coalesce && q.frame != sentFrame && !stale.contains(q.frame)) {
+                stale.append(q.frame);
+            }
+        }
+    }
+
+    QList<completion> superseded;
+    for (int i = queue.count() - 1; i >= 0; i--) {
+        if (stale.contains(queue.at(i).frame)) {
+            qDebug() << QStringLiteral("blewritequeue: superseded") << queue.at(i).info;
+            if (queue.at(i).done) {
+                superseded.append(queue.at(i).done);
+            }
+            queue.removeAt(i);
+        }
+    }
+
+    const int id = ++frames;
+    for (command c : frame) {
+        c.frame = id;
+        queue.append(c);
+    }
+
+    for (const completion &done : qAsConst(superseded)) {
+        done(false);
+    }
+
+    if (!busy && !pacingTimer.isActive()) {
+        next();
+    }
+}
+
+void blewritequeue::clear() {
+    queue.clear();
+    if (busy) {
+        complete(false);
+    }
+}
+
+void blewritequeue::next() {
+    while (!busy && !queue.isEmpty()) {
+        current = queue.takeFirst();
+        sentFrame = current.frame;
+
+        if (current.data.isEmpty()) {
+            // only waiting for a response
+            busy = true;
+            timeoutTimer.start();
+            return;
+        }
+
+        if (!current.service || current.service->state() != QLowEnergyService::ServiceDiscovered) {
+            qDebug() << QStringLiteral("blewritequeue: writeCharacteristic error because the connection is closed")
+                     << current.info;
+            if (current.done) {
+                current.done(false);
+            }
+            continue;
+        }
+
+        busy = true;
+        if (!current.waitForResponse) {
+            writtenConnection = connect(current.service, &QLowEnergyService::characteristicWritten, this,
+                                        &blewritequeue::characteristicWritten);
+        }
+        timeoutTimer.start();
+
+        current.service->writeCharacteristic(current.characteristic, current.data, current.mode);
+
+        if (!current.disableLog) {
+            packettrace::tx(parent(), current.data, current.info);
+        }
+
+        // no acknowledge will come for a write without response
+        if (!current.waitForResponse && current.mode == QLowEnergyService::WriteWithoutResponse) {
+            complete(true);
+        }
+        return;
+    }
+}
+
+void blewritequeue::complete(bool ok) {
+    timeoutTimer.stop();
+    if (writtenConnection) {
+        disconnect(writtenConnection);
+    }
+    busy = false;
+
+    completion done = current.done;
+    current = command();
+
+    // starting the next write from the pacing timer keeps this non recursive even with an interval of 0
+    pacingTimer.start();
+
+    if (done) {
+        done(ok);
+    }
+}
+
+void blewritequeue::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
+                                          const QByteArray &newValue) {
+    Q_UNUSED(newValue);
+    if (busy && !current.waitForResponse && characteristic.uuid() == current.characteristic.uuid()) {
+        complete(true);
+    }
+}
+
+void blewritequeue::responseReceived() {
+    if (busy && current.waitForResponse) {
+        complete(true);
+    }
+}
+
+void blewritequeue::timeout() {
+    if (busy) {
+        qDebug() << QStringLiteral(" exit for timeout") << current.info;
+        complete(false);
+    }
+}
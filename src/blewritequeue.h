@@ -0,0 +1,106 @@
+#ifndef BLEWRITEQUEUE_H
+#define BLEWRITEQUEUE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <QtBluetooth/qlowenergycharacteristic.h>
+#include <QtBluetooth/qlowenergyservice.h>
+
+#include <chrono>
+#include <functional>
+
+// Per-device queue of BLE characteristic writes.
+// Writes are sent one at a time from the event loop: the next one starts when the previous one has been
+// acknowledged (characteristicWritten), answered (responseReceived() for the commands that wait for a
+// response) or timed out. Nothing blocks or re-enters the event loop, so the other timers keep running.
+// A command with a coalescing key replaces the pending frames with the same key, so for example a newer
+// resistance request supersedes one that didn't reach the device yet. A frame whose first write has already
+// been sent is never replaced: the device would get half of it.
+// ftmsbike, domyostreadmill and horizontreadmill write through it; the other devices still use their own
+// writeCharacteristic() waiting in a local event loop.
+class blewritequeue : public QObject {
+
+    Q_OBJECT
+  public:
+    enum COALESCE_KEY {
+        NO_COALESCE = -1,
+        COALESCE_RESISTANCE = 0,
+        COALESCE_POWER,
+        COALESCE_SPEED,
+        COALESCE_INCLINATION,
+        COALESCE_SPEED_INCLINATION,
+        COALESCE_FAN,
+        COALESCE_DISPLAY,
+        COALESCE_NOOP,
+    };
+
+    // called with true when the write has been acknowledged or answered, false if it timed out, was
+    // superseded by a newer command with the same coalescing key or the service wasn't available
+    typedef std::function<void(bool)> completion;
+
+    struct command {
+        QLowEnergyService *service = nullptr;
+        QLowEnergyCharacteristic characteristic;
+        QByteArray data; // empty: nothing is written, the command only waits for a response
+        QString info;
+        bool disableLog = false;
+        bool waitForResponse = false;
+        int coalesce = NO_COALESCE;
+        QLowEnergyService::WriteMode mode = QLowEnergyService::WriteWithResponse;
+        completion done;
+        int frame = 0; // set by enqueue(), the same for the commands of a frame
+    };
+
+    explicit blewritequeue(QObject *parent = nullptr);
+
+    // interval: minimum gap between the completion of a write and the start of the next one
+    // timeout: how long a write waits for its acknowledge or response
+    void setPacing(std::chrono::milliseconds interval, std::chrono::milliseconds timeout);
+
+    static command writeCommand(QLowEnergyService *service, const QLowEnergyCharacteristic &characteristic,
+                                const QByteArray &data, const QString &info, bool disableLog = false,
+                                bool waitForResponse = false, int coalesce = NO_COALESCE);
+
+    void write(QLowEnergyService *service, const QLowEnergyCharacteristic &characteristic, const QByteArray &data,
+               const QString &info, bool disableLog = false, bool waitForResponse = false,
+               int coalesce = NO_COALESCE, const completion &done = completion());
+
+    // waits for the next response without writing anything, to keep the writes following it on hold
+    void waitForResponse(const QString &info = QString(), const completion &done = completion());
+
+    void enqueue(const command &c);
+
+    // the commands of a frame are queued together: a frame split in several writes is coalesced as a whole
+    void enqueue(const QList<command> &frame);
+
+    void clear();
+    int pending() const { return queue.count() + (busy ? 1 : 0); }
+
+  public slots:
+    // devices connect here the signal telling that a complete answer has been received
+    void responseReceived();
+
+  private slots:
+    void characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
+    void timeout();
+    void next();
+
+  private:
+    void complete(bool ok);
+
+    QList<command> queue;
+    command current;
+    bool busy = false;
+    int frames = 0;
+    int sentFrame = 0; // frame of the last command taken from the queue
+    QMetaObject::Connection writtenConnection;
+
+    QTimer timeoutTimer;
+    QTimer pacingTimer;
+};
+
+#endif // BLEWRITEQUEUE_H
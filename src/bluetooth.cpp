@@ -172,137 +172,65 @@ void bluetooth::debug(const QString &text) {
 }
 
 bool bluetooth::cscSensorAvaiable() {
-
-    QSettings settings;
-    bool csc_as_bike = settings.value(QStringLiteral("cadence_sensor_as_bike"), false).toBool();
-    QString cscName = settings.value(QStringLiteral("cadence_sensor_name"), QStringLiteral("Disabled")).toString();
-
-    if (csc_as_bike) {
-        return false;
-    }
-
-    for (const QBluetoothDeviceInfo &b : qAsConst(devices)) {
-        if (!cscName.compare(b.name())) {
-
-            return true;
-        }
-    }
-    return false;
+    loadDiscoverySettings();
+    return !discoverySettings.cadence_sensor_as_bike && devicesNames.contains(discoverySettings.cadence_sensor_name);
 }
 
 bool bluetooth::ftmsAccessoryAvaiable() {
-
-    QSettings settings;
-    QString ftmsAccessoryName =
-        settings.value(QStringLiteral("ftms_accessory_name"), QStringLiteral("Disabled")).toString();
-
-    Q_FOREACH (QBluetoothDeviceInfo b, devices) {
-        if (!ftmsAccessoryName.compare(b.name())) {
-
-            return true;
-        }
-    }
-    return false;
+    loadDiscoverySettings();
+    return devicesNames.contains(discoverySettings.ftms_accessory_name);
 }
 
 bool bluetooth::powerSensorAvaiable() {
-
-    QSettings settings;
-    bool power_as_bike = settings.value(QStringLiteral("power_sensor_as_bike"), false).toBool();
-    bool power_as_treadmill = settings.value(QStringLiteral("power_sensor_as_treadmill"), false).toBool();
-    QString powerSensorName =
-        settings.value(QStringLiteral("power_sensor_name"), QStringLiteral("Disabled")).toString();
-
-    if (power_as_bike || power_as_treadmill) {
-        return false;
-    }
-
-    Q_FOREACH (QBluetoothDeviceInfo b, devices) {
-        if (!powerSensorName.compare(b.name())) {
-
-            return true;
-        }
-    }
-    return false;
+    loadDiscoverySettings();
+    return !discoverySettings.power_sensor_as_bike && !discoverySettings.power_sensor_as_treadmill &&
+           devicesNames.contains(discoverySettings.power_sensor_name);
 }
 
 bool bluetooth::eliteRizerAvaiable() {
-
-    QSettings settings;
-    QString eliteRizerName = settings.value(QStringLiteral("elite_rizer_name"), QStringLiteral("Disabled")).toString();
-
-    Q_FOREACH (QBluetoothDeviceInfo b, devices) {
-        if (!eliteRizerName.compare(b.name())) {
-
-            return true;
-        }
-    }
-    return false;
+    loadDiscoverySettings();
+    return devicesNames.contains(discoverySettings.elite_rizer_name);
 }
 
 bool bluetooth::eliteSterzoSmartAvaiable() {
-
-    QSettings settings;
-    QString eliteSterzoSmartName =
-        settings.value(QStringLiteral("elite_sterzo_smart_name"), QStringLiteral("Disabled")).toString();
-
-    Q_FOREACH (QBluetoothDeviceInfo b, devices) {
-        if (!eliteSterzoSmartName.compare(b.name())) {
-
-            return true;
-        }
-    }
-    return false;
+    loadDiscoverySettings();
+    return devicesNames.contains(discoverySettings.elite_sterzo_smart_name);
 }
 
 bool bluetooth::heartRateBeltAvaiable() {
+    loadDiscoverySettings();
+    return devicesNames.contains(discoverySettings.heart_rate_belt_name);
+}
 
-    QSettings settings;
-    QString heartRateBeltName =
-        settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
-
-    Q_FOREACH (QBluetoothDeviceInfo b, devices) {
-        if (!heartRateBeltName.compare(b.name())) {
+static QString deviceKey(const QBluetoothDeviceInfo &device) {
+#if defined(Q_OS_IOS)
+    return device.deviceUuid().toString();
+#else
+    return device.address().toString();
+#endif
+}
 
-            return true;
-        }
+void bluetooth::loadDiscoverySettings() {
+    // read again only when the settings have been changed
+    auto snapshot = settingssnapshot::current();
+    if (snapshot != discoverySettingsSnapshot) {
+        discoverySettingsSnapshot = snapshot;
+        discoverySettings.load();
+        devicesMatched = false;
     }
-    return false;
 }
 
 void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
 
-    QSettings settings;
-    QString heartRateBeltName =
-        settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
-    QString ftmsAccessoryName =
-        settings.value(QStringLiteral("ftms_accessory_name"), QStringLiteral("Disabled")).toString();
-    bool heartRateBeltFound = heartRateBeltName.startsWith(QStringLiteral("Disabled"));
-    bool ftmsAccessoryFound = ftmsAccessoryName.startsWith(QStringLiteral("Disabled"));
-    bool toorx_bike = settings.value(QStringLiteral("toorx_bike"), false).toBool() ||
-                      settings.value(QStringLiteral("jll_IC400_bike"), false).toBool() ||
-                      settings.value(QStringLiteral("fytter_ri08_bike"), false).toBool() ||
-                      settings.value(QStringLiteral("asviva_bike"), false).toBool() ||
-                      settings.value(QStringLiteral("hertz_xr_770"), false).toBool();
-    bool snode_bike = settings.value(QStringLiteral("snode_bike"), false).toBool();
-    bool fitplus_bike = settings.value(QStringLiteral("fitplus_bike"), false).toBool();
-    bool csc_as_bike = settings.value(QStringLiteral("cadence_sensor_as_bike"), false).toBool();
-    bool power_as_bike = settings.value(QStringLiteral("power_sensor_as_bike"), false).toBool();
-    bool power_as_treadmill = settings.value(QStringLiteral("power_sensor_as_treadmill"), false).toBool();
-    QString cscName = settings.value(QStringLiteral("cadence_sensor_name"), QStringLiteral("Disabled")).toString();
-    bool cscFound = cscName.startsWith(QStringLiteral("Disabled")) || csc_as_bike;
-    bool hammerRacerS = settings.value(QStringLiteral("hammer_racer_s"), false).toBool();
-    bool flywheel_life_fitness_ic8 = settings.value(QStringLiteral("flywheel_life_fitness_ic8"), false).toBool();
-    QString powerSensorName =
-        settings.value(QStringLiteral("power_sensor_name"), QStringLiteral("Disabled")).toString();
-    QString eliteRizerName = settings.value(QStringLiteral("elite_rizer_name"), QStringLiteral("Disabled")).toString();
-    QString eliteSterzoSmartName =
-        settings.value(QStringLiteral("elite_sterzo_smart_name"), QStringLiteral("Disabled")).toString();
-    bool powerSensorFound =
-        powerSensorName.startsWith(QStringLiteral("Disabled")) || power_as_bike || power_as_treadmill;
-    bool eliteRizerFound = eliteRizerName.startsWith(QStringLiteral("Disabled"));
-    bool eliteSterzoSmartFound = eliteSterzoSmartName.startsWith(QStringLiteral("Disabled"));
-    bool fake_bike = settings.value(QStringLiteral("applewatch_fakedevice"), false).toBool();
+    loadDiscoverySettings();
+    const discoverysettings &s = discoverySettings;
+    bool heartRateBeltFound = s.heart_rate_belt_name.startsWith(QStringLiteral("Disabled"));
+    bool ftmsAccessoryFound = s.ftms_accessory_name.startsWith(QStringLiteral("Disabled"));
+    bool cscFound = s.cadence_sensor_name.startsWith(QStringLiteral("Disabled")) || s.cadence_sensor_as_bike;
+    bool powerSensorFound = s.power_sensor_name.startsWith(QStringLiteral("Disabled")) || s.power_sensor_as_bike ||
+                            s.power_sensor_as_treadmill;
+    bool eliteRizerFound = s.elite_rizer_name.startsWith(QStringLiteral("Disabled"));
+    bool eliteSterzoSmartFound = s.elite_sterzo_smart_name.startsWith(QStringLiteral("Disabled"));
 
     if (!heartRateBeltFound) {
 
@@ -329,19 +257,19 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
         eliteSterzoSmartFound = eliteSterzoSmartAvaiable();
     }
 
-    bool found = false;
-    QMutableListIterator<QBluetoothDeviceInfo> i(devices);
-    while (i.hasNext()) {
-        QBluetoothDeviceInfo b = i.next();
-        if (SAME_BLUETOOTH_DEVICE(b, device) && !b.name().isEmpty()) {
-
-            found = true;
-            break;
-        }
-    }
-    if (!found) {
+    // the same device is advertised again and again while scanning: only a new one needs to be matched
+    const QString key = deviceKey(device);
+    bool newDevice = true;
+    auto known = devicesIndex.constFind(key);
+    if (known == devicesIndex.constEnd()) {
+        devicesIndex.insert(key, devices.count());
         devices.append(device);
+    } else if (devices.at(known.value()).name().isEmpty()) {
+        devices[known.value()] = device;
+    } else {
+        newDevice = false;
     }
+    devicesNames.insert(device.name());
 
     emit deviceFound(device.name());
     debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") + device.address().toString() +
@@ -356,886 +284,948 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
     if ((heartRateBeltFound && ftmsAccessoryFound && cscFound && powerSensorFound && eliteRizerFound &&
          eliteSterzoSmartFound) ||
         forceHeartBeltOffForTimeout) {
-        for (const QBluetoothDeviceInfo &b : qAsConst(devices)) {
+        if (!devicesMatched) {
+            // first time, or the settings changed: all the devices found so far
+            devicesMatched = true;
+            for (const QBluetoothDeviceInfo &b : qAsConst(devices)) {
+                matchDevice(b);
+            }
+        } else if (newDevice) {
+            // the others have already been matched with the same settings
+            matchDevice(devices.at(devicesIndex.value(key)));
+        }
+    }
+}
+
+void bluetooth::matchDevice(const QBluetoothDeviceInfo &b) {
+    const discoverysettings &s = discoverySettings;
+    bool filter = true;
+    if (!filterDevice.isEmpty() && !filterDevice.startsWith(QStringLiteral("Disabled"))) {
 
-            bool filter = true;
-            if (!filterDevice.isEmpty() && !filterDevice.startsWith(QStringLiteral("Disabled"))) {
+        filter = (b.name().compare(filterDevice, Qt::CaseInsensitive) == 0);
+    }
+    if (b.name().startsWith(QStringLiteral("M3")) && !m3iBike && filter) {
 
-                filter = (b.name().compare(filterDevice, Qt::CaseInsensitive) == 0);
+        if (m3ibike::isCorrectUnit(b)) {
+            discoveryAgent->stop();
+            m3iBike = new m3ibike(noWriteResistance, noHeartService);
+            emit deviceConnected(b);
+            connect(m3iBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+            // connect(domyosBike, SIGNAL(disconnected()), this, SLOT(restart()));
+            connect(m3iBike, &m3ibike::debug, this, &bluetooth::debug);
+            m3iBike->deviceDiscovered(b);
+            connect(this, &bluetooth::searchingStop, m3iBike, &m3ibike::searchingStop);
+            if (!discoveryAgent->isActive())
+                emit searchingStop();
+            userTemplateManager->start(m3iBike);
+            innerTemplateManager->start(m3iBike);
+        }
+    } else if (s.applewatch_fakedevice && !fakeBike) {
+        discoveryAgent->stop();
+        fakeBike = new fakebike(noWriteResistance, noHeartService, false);
+        emit deviceConnected(b);
+        connect(fakeBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        connect(fakeBike, &fakebike::inclinationChanged, this, &bluetooth::inclinationChanged);
+        // connect(cscBike, SIGNAL(disconnected()), this, SLOT(restart()));
+        // connect(this, SIGNAL(searchingStop()), fakeBike, SLOT(searchingStop())); //NOTE: Commented due to
+        // #358
+        if (!discoveryAgent->isActive()) {
+            emit searchingStop();
+        }
+        userTemplateManager->start(fakeBike);
+        innerTemplateManager->start(fakeBike);
+    } else if (s.cadence_sensor_as_bike && b.name().startsWith(s.cadence_sensor_name) && !cscBike && filter) {
+
+        discoveryAgent->stop();
+        cscBike = new cscbike(noWriteResistance, noHeartService, false);
+        emit deviceConnected(b);
+        connect(cscBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(cscBike, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(cscBike, &cscbike::debug, this, &bluetooth::debug);
+        cscBike->deviceDiscovered(b);
+        // connect(this, SIGNAL(searchingStop()), cscBike, SLOT(searchingStop())); //NOTE: Commented due to #358
+        if (!discoveryAgent->isActive()) {
+            emit searchingStop();
+        }
+        userTemplateManager->start(cscBike);
+        innerTemplateManager->start(cscBike);
+    } else if (s.power_sensor_as_bike && b.name().startsWith(s.power_sensor_name) && !powerBike && filter) {
+
+        discoveryAgent->stop();
+        powerBike = new stagesbike(noWriteResistance, noHeartService, false);
+        emit deviceConnected(b);
+        connect(powerBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(cscBike, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(powerBike, &stagesbike::debug, this, &bluetooth::debug);
+        powerBike->deviceDiscovered(b);
+        // connect(this, SIGNAL(searchingStop()), cscBike, SLOT(searchingStop())); //NOTE: Commented due to #358
+        if (!discoveryAgent->isActive()) {
+            emit searchingStop();
+        }
+        userTemplateManager->start(powerBike);
+        innerTemplateManager->start(powerBike);
+    } else if (s.power_sensor_as_treadmill && b.name().startsWith(s.power_sensor_name) && !powerTreadmill && filter) {
+
+        discoveryAgent->stop();
+        powerTreadmill = new strydrunpowersensor(noWriteResistance, noHeartService, false);
+        emit deviceConnected(b);
+        connect(powerTreadmill, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(cscBike, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(powerTreadmill, &strydrunpowersensor::debug, this, &bluetooth::debug);
+        powerTreadmill->deviceDiscovered(b);
+        // connect(this, SIGNAL(searchingStop()), cscBike, SLOT(searchingStop())); //NOTE: Commented due to #358
+        if (!discoveryAgent->isActive()) {
+            emit searchingStop();
+        }
+        userTemplateManager->start(powerTreadmill);
+        innerTemplateManager->start(powerTreadmill);
+    } else if (filter) {
+        // the first class handling this name that isn't connected yet
+        for (deviceregistry::DEVICE d : deviceregistry::instance().match(b.name(), s)) {
+            if (connectDevice(d, b)) {
+                break;
             }
-            if (b.name().startsWith(QStringLiteral("M3")) && !m3iBike && filter) {
-
-                if (m3ibike::isCorrectUnit(b)) {
-                    discoveryAgent->stop();
-                    m3iBike = new m3ibike(noWriteResistance, noHeartService);
-                    emit deviceConnected(b);
-                    connect(m3iBike, &bluetoothdevice::connectedAndDiscovered, this,
-                            &bluetooth::connectedAndDiscovered);
-                    // connect(domyosBike, SIGNAL(disconnected()), this, SLOT(restart()));
-                    connect(m3iBike, &m3ibike::debug, this, &bluetooth::debug);
-                    m3iBike->deviceDiscovered(b);
-                    connect(this, &bluetooth::searchingStop, m3iBike, &m3ibike::searchingStop);
-                    if (!discoveryAgent->isActive())
-                        emit searchingStop();
-                    userTemplateManager->start(m3iBike);
-                    innerTemplateManager->start(m3iBike);
-                }
-            } else if (fake_bike && !fakeBike) {
-                discoveryAgent->stop();
-                fakeBike = new fakebike(noWriteResistance, noHeartService, false);
-                emit deviceConnected(b);
-                connect(fakeBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
-                connect(fakeBike, &fakebike::inclinationChanged, this, &bluetooth::inclinationChanged);
-                // connect(cscBike, SIGNAL(disconnected()), this, SLOT(restart()));
-                // connect(this, SIGNAL(searchingStop()), fakeBike, SLOT(searchingStop())); //NOTE: Commented due to
-                // #358
-                if (!discoveryAgent->isActive()) {
-                    emit searchingStop();
-                }
-                userTemplateManager->start(fakeBike);
-                innerTemplateManager->start(fakeBike);
-            } else if (csc_as_bike && b.name().startsWith(cscName) && !cscBike && filter) {
-
-                discoveryAgent->stop();
-                cscBike = new cscbike(noWriteResistance, noHeartService, false);
-                emit deviceConnected(b);
-                connect(cscBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
-                // connect(cscBike, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(cscBike, &cscbike::debug, this, &bluetooth::debug);
-                cscBike->deviceDiscovered(b);
-                // connect(this, SIGNAL(searchingStop()), cscBike, SLOT(searchingStop())); //NOTE: Commented due to #358
-                if (!discoveryAgent->isActive()) {
-                    emit searchingStop();
-                }
-                userTemplateManager->start(cscBike);
-                innerTemplateManager->start(cscBike);
-            } else if (power_as_bike && b.name().startsWith(powerSensorName) && !powerBike && filter) {
-
-                discoveryAgent->stop();
-                powerBike = new stagesbike(noWriteResistance, noHeartService, false);
-                emit deviceConnected(b);
-                connect(powerBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
-                // connect(cscBike, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(powerBike, &stagesbike::debug, this, &bluetooth::debug);
-                powerBike->deviceDiscovered(b);
-                // connect(this, SIGNAL(searchingStop()), cscBike, SLOT(searchingStop())); //NOTE: Commented due to #358
-                if (!discoveryAgent->isActive()) {
-                    emit searchingStop();
-                }
-                userTemplateManager->start(powerBike);
-                innerTemplateManager->start(powerBike);
-            } else if (power_as_treadmill && b.name().startsWith(powerSensorName) && !powerTreadmill && filter) {
-
-                discoveryAgent->stop();
-                powerTreadmill = new strydrunpowersensor(noWriteResistance, noHeartService, false);
-                emit deviceConnected(b);
-                connect(powerTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(cscBike, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(powerTreadmill, &strydrunpowersensor::debug, this, &bluetooth::debug);
-                powerTreadmill->deviceDiscovered(b);
-                // connect(this, SIGNAL(searchingStop()), cscBike, SLOT(searchingStop())); //NOTE: Commented due to #358
-                if (!discoveryAgent->isActive()) {
-                    emit searchingStop();
-                }
-                userTemplateManager->start(powerTreadmill);
-                innerTemplateManager->start(powerTreadmill);
-            } else if (b.name().startsWith(QStringLiteral("Domyos-Bike")) &&
-                       !b.name().startsWith(QStringLiteral("DomyosBridge")) && !domyosBike && filter) {
-                discoveryAgent->stop();
-                domyosBike = new domyosbike(noWriteResistance, noHeartService, testResistance, bikeResistanceOffset,
-                                            bikeResistanceGain);
-                emit deviceConnected(b);
-                connect(domyosBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
-                // connect(domyosBike, SIGNAL(disconnected()), this, SLOT(restart()));
-                // connect(domyosBike, SIGNAL(debug(QString)), this, SLOT(debug(QString)));//NOTE: Commented due to #358
-                domyosBike->deviceDiscovered(b);
-                connect(this, &bluetooth::searchingStop, domyosBike, &domyosbike::searchingStop);
-                if (!discoveryAgent->isActive()) {
-                    emit searchingStop();
-                }
-                userTemplateManager->start(domyosBike);
-                innerTemplateManager->start(domyosBike);
-            } else if (b.name().startsWith(QStringLiteral("Domyos-EL")) &&
-                       !b.name().startsWith(QStringLiteral("DomyosBridge")) && !domyosElliptical && filter) {
-                discoveryAgent->stop();
-                domyosElliptical = new domyoselliptical(noWriteResistance, noHeartService, testResistance,
-                                                        bikeResistanceOffset, bikeResistanceGain);
-                emit deviceConnected(b);
-                connect(domyosElliptical, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(domyosElliptical, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(domyosElliptical, &domyoselliptical::debug, this, &bluetooth::debug);
-                domyosElliptical->deviceDiscovered(b);
-                connect(this, &bluetooth::searchingStop, domyosElliptical, &domyoselliptical::searchingStop);
-                if (!discoveryAgent->isActive()) {
-                    emit searchingStop();
-                }
-                userTemplateManager->start(domyosElliptical);
-                innerTemplateManager->start(domyosElliptical);
-            } else if ((b.name().toUpper().startsWith(QStringLiteral("E95S")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("E25")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("E35")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("E55")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("E95")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("E98")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("E98S"))) &&
-                       !soleElliptical && filter) {
-                discoveryAgent->stop();
-                soleElliptical = new soleelliptical(noWriteResistance, noHeartService, testResistance,
-                                                    bikeResistanceOffset, bikeResistanceGain);
-                emit deviceConnected(b);
-                connect(soleElliptical, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(soleElliptical, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(soleElliptical, &soleelliptical::debug, this, &bluetooth::debug);
-                soleElliptical->deviceDiscovered(b);
-                connect(this, &bluetooth::searchingStop, soleElliptical, &soleelliptical::searchingStop);
-                if (!discoveryAgent->isActive())
-                    emit searchingStop();
-                userTemplateManager->start(soleElliptical);
-                innerTemplateManager->start(soleElliptical);
-            } else if (b.name().startsWith(QStringLiteral("Domyos")) &&
-                       !b.name().startsWith(QStringLiteral("DomyosBr")) && !domyos && !domyosElliptical &&
-                       !domyosBike && filter) {
-                settings.setValue(QStringLiteral("bluetooth_lastdevice_name"), b.name());
+        }
+    }
+}
+
+bool bluetooth::connectDevice(deviceregistry::DEVICE device, const QBluetoothDeviceInfo &b) {
+    QSettings settings;
+    switch (device) {
+    case deviceregistry::DOMYOS_BIKE:
+        if (domyosBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        domyosBike = new domyosbike(noWriteResistance, noHeartService, testResistance, bikeResistanceOffset,
+                                    bikeResistanceGain);
+        emit deviceConnected(b);
+        connect(domyosBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(domyosBike, SIGNAL(disconnected()), this, SLOT(restart()));
+        // connect(domyosBike, SIGNAL(debug(QString)), this, SLOT(debug(QString)));//NOTE: Commented due to #358
+        domyosBike->deviceDiscovered(b);
+        connect(this, &bluetooth::searchingStop, domyosBike, &domyosbike::searchingStop);
+        if (!discoveryAgent->isActive()) {
+            emit searchingStop();
+        }
+        userTemplateManager->start(domyosBike);
+        innerTemplateManager->start(domyosBike);
+        break;
+    case deviceregistry::DOMYOS_ELLIPTICAL:
+        if (domyosElliptical) {
+            return false;
+        }
+        discoveryAgent->stop();
+        domyosElliptical = new domyoselliptical(noWriteResistance, noHeartService, testResistance,
+                                                bikeResistanceOffset, bikeResistanceGain);
+        emit deviceConnected(b);
+        connect(domyosElliptical, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(domyosElliptical, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(domyosElliptical, &domyoselliptical::debug, this, &bluetooth::debug);
+        domyosElliptical->deviceDiscovered(b);
+        connect(this, &bluetooth::searchingStop, domyosElliptical, &domyoselliptical::searchingStop);
+        if (!discoveryAgent->isActive()) {
+            emit searchingStop();
+        }
+        userTemplateManager->start(domyosElliptical);
+        innerTemplateManager->start(domyosElliptical);
+        break;
+    case deviceregistry::SOLE_ELLIPTICAL:
+        if (soleElliptical) {
+            return false;
+        }
+        discoveryAgent->stop();
+        soleElliptical = new soleelliptical(noWriteResistance, noHeartService, testResistance,
+                                            bikeResistanceOffset, bikeResistanceGain);
+        emit deviceConnected(b);
+        connect(soleElliptical, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(soleElliptical, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(soleElliptical, &soleelliptical::debug, this, &bluetooth::debug);
+        soleElliptical->deviceDiscovered(b);
+        connect(this, &bluetooth::searchingStop, soleElliptical, &soleelliptical::searchingStop);
+        if (!discoveryAgent->isActive())
+            emit searchingStop();
+        userTemplateManager->start(soleElliptical);
+        innerTemplateManager->start(soleElliptical);
+        break;
+    case deviceregistry::DOMYOS_TREADMILL:
+        if (domyos || domyosElliptical || domyosBike) {
+            return false;
+        }
+        settings.setValue(QStringLiteral("bluetooth_lastdevice_name"), b.name());
 #ifndef Q_OS_IOS
-                settings.setValue(QStringLiteral("bluetooth_lastdevice_address"), b.address().toString());
+        settings.setValue(QStringLiteral("bluetooth_lastdevice_address"), b.address().toString());
 #else
-                settings.setValue("bluetooth_lastdevice_address", b.deviceUuid().toString());
+        settings.setValue("bluetooth_lastdevice_address", b.deviceUuid().toString());
 #endif
 
-                discoveryAgent->stop();
-                domyos = new domyostreadmill(this->pollDeviceTime, noConsole, noHeartService);
+        discoveryAgent->stop();
+        domyos = new domyostreadmill(this->pollDeviceTime, noConsole, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
-                stateFileRead();
+        stateFileRead();
 #endif
-                emit deviceConnected(b);
-                connect(domyos, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
-                // connect(domyos, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(domyos, &domyostreadmill::debug, this, &bluetooth::debug);
-                connect(domyos, &domyostreadmill::speedChanged, this, &bluetooth::speedChanged);
-                connect(domyos, &domyostreadmill::inclinationChanged, this, &bluetooth::inclinationChanged);
-                domyos->deviceDiscovered(b);
-                connect(this, &bluetooth::searchingStop, domyos, &domyostreadmill::searchingStop);
-                if (!discoveryAgent->isActive())
-                    emit searchingStop();
-                userTemplateManager->start(domyos);
-                innerTemplateManager->start(domyos);
-            } else if ((b.name().toUpper().startsWith(QStringLiteral("KS-R1AC")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("KS-HC-R1AA")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("KS-HC-R1AC"))) &&
-                       !kingsmithR2Treadmill && filter) {
-                settings.setValue(QStringLiteral("bluetooth_lastdevice_name"), b.name());
+        emit deviceConnected(b);
+        connect(domyos, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(domyos, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(domyos, &domyostreadmill::debug, this, &bluetooth::debug);
+        connect(domyos, &domyostreadmill::speedChanged, this, &bluetooth::speedChanged);
+        connect(domyos, &domyostreadmill::inclinationChanged, this, &bluetooth::inclinationChanged);
+        domyos->deviceDiscovered(b);
+        connect(this, &bluetooth::searchingStop, domyos, &domyostreadmill::searchingStop);
+        if (!discoveryAgent->isActive())
+            emit searchingStop();
+        userTemplateManager->start(domyos);
+        innerTemplateManager->start(domyos);
+        break;
+    case deviceregistry::KINGSMITH_R2_TREADMILL:
+        if (kingsmithR2Treadmill) {
+            return false;
+        }
+        settings.setValue(QStringLiteral("bluetooth_lastdevice_name"), b.name());
 #ifndef Q_OS_IOS
-                settings.setValue(QStringLiteral("bluetooth_lastdevice_address"), b.address().toString());
+        settings.setValue(QStringLiteral("bluetooth_lastdevice_address"), b.address().toString());
 #else
-                settings.setValue("bluetooth_lastdevice_address", b.deviceUuid().toString());
+        settings.setValue("bluetooth_lastdevice_address", b.deviceUuid().toString());
 #endif
 
-                discoveryAgent->stop();
-                kingsmithR2Treadmill = new kingsmithr2treadmill(this->pollDeviceTime, noConsole, noHeartService);
+        discoveryAgent->stop();
+        kingsmithR2Treadmill = new kingsmithr2treadmill(this->pollDeviceTime, noConsole, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
-                stateFileRead();
+        stateFileRead();
 #endif
-                emit deviceConnected(b);
-                connect(kingsmithR2Treadmill, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(kingsmithR2Treadmill, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(kingsmithR2Treadmill, &kingsmithr2treadmill::debug, this, &bluetooth::debug);
-                connect(kingsmithR2Treadmill, &kingsmithr2treadmill::speedChanged, this, &bluetooth::speedChanged);
-                connect(kingsmithR2Treadmill, &kingsmithr2treadmill::inclinationChanged, this,
-                        &bluetooth::inclinationChanged);
-                kingsmithR2Treadmill->deviceDiscovered(b);
-                connect(this, &bluetooth::searchingStop, kingsmithR2Treadmill, &kingsmithr2treadmill::searchingStop);
-                if (!discoveryAgent->isActive())
-                    emit searchingStop();
-                userTemplateManager->start(kingsmithR2Treadmill);
-                innerTemplateManager->start(kingsmithR2Treadmill);
-            } else if ((b.name().toUpper().startsWith(QStringLiteral("R1 PRO")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("KINGSMITH")) ||
-                        !b.name().toUpper().compare(QStringLiteral("RE")) || // just "RE"
-                        b.name().toUpper().startsWith(
-                            QStringLiteral("KS-"))) && // Treadmill KingSmith WalkingPad R2 Pro KS-HCR1AA
-                       !kingsmithR1ProTreadmill &&
-                       filter) {
-                settings.setValue(QStringLiteral("bluetooth_lastdevice_name"), b.name());
+        emit deviceConnected(b);
+        connect(kingsmithR2Treadmill, &bluetoothdevice::connectedAndDiscovered, this,
+                &bluetooth::connectedAndDiscovered);
+        // connect(kingsmithR2Treadmill, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(kingsmithR2Treadmill, &kingsmithr2treadmill::debug, this, &bluetooth::debug);
+        connect(kingsmithR2Treadmill, &kingsmithr2treadmill::speedChanged, this, &bluetooth::speedChanged);
+        connect(kingsmithR2Treadmill, &kingsmithr2treadmill::inclinationChanged, this, &bluetooth::inclinationChanged);
+        kingsmithR2Treadmill->deviceDiscovered(b);
+        connect(this, &bluetooth::searchingStop, kingsmithR2Treadmill, &kingsmithr2treadmill::searchingStop);
+        if (!discoveryAgent->isActive())
+            emit searchingStop();
+        userTemplateManager->start(kingsmithR2Treadmill);
+        innerTemplateManager->start(kingsmithR2Treadmill);
+        break;
+    case deviceregistry::KINGSMITH_R1_PRO_TREADMILL:
+        if (kingsmithR1ProTreadmill) {
+            return false;
+        }
+        settings.setValue(QStringLiteral("bluetooth_lastdevice_name"), b.name());
 #ifndef Q_OS_IOS
-                settings.setValue(QStringLiteral("bluetooth_lastdevice_address"), b.address().toString());
+        settings.setValue(QStringLiteral("bluetooth_lastdevice_address"), b.address().toString());
 #else
-                settings.setValue("bluetooth_lastdevice_address", b.deviceUuid().toString());
+        settings.setValue("bluetooth_lastdevice_address", b.deviceUuid().toString());
 #endif
 
-                discoveryAgent->stop();
-                kingsmithR1ProTreadmill = new kingsmithr1protreadmill(this->pollDeviceTime, noConsole, noHeartService);
+        discoveryAgent->stop();
+        kingsmithR1ProTreadmill = new kingsmithr1protreadmill(this->pollDeviceTime, noConsole, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
-                stateFileRead();
+        stateFileRead();
 #endif
-                emit deviceConnected(b);
-                connect(kingsmithR1ProTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(kingsmithR1ProTreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(kingsmithR1ProTreadmill, &kingsmithr1protreadmill::debug, this, &bluetooth::debug);
-                connect(kingsmithR1ProTreadmill, &kingsmithr1protreadmill::speedChanged, this,
-                        &bluetooth::speedChanged);
-                connect(kingsmithR1ProTreadmill, &kingsmithr1protreadmill::inclinationChanged, this,
-                        &bluetooth::inclinationChanged);
-                kingsmithR1ProTreadmill->deviceDiscovered(b);
-                connect(this, &bluetooth::searchingStop, kingsmithR1ProTreadmill,
-                        &kingsmithr1protreadmill::searchingStop);
-                if (!discoveryAgent->isActive())
-                    emit searchingStop();
-                userTemplateManager->start(kingsmithR1ProTreadmill);
-                innerTemplateManager->start(kingsmithR1ProTreadmill);
-            } else if ((b.name().toUpper().startsWith(QStringLiteral("ZW-"))) && !shuaA5Treadmill && filter) {
-                settings.setValue(QStringLiteral("bluetooth_lastdevice_name"), b.name());
+        emit deviceConnected(b);
+        connect(kingsmithR1ProTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
+                &bluetooth::connectedAndDiscovered);
+        // connect(kingsmithR1ProTreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(kingsmithR1ProTreadmill, &kingsmithr1protreadmill::debug, this, &bluetooth::debug);
+        connect(kingsmithR1ProTreadmill, &kingsmithr1protreadmill::speedChanged, this, &bluetooth::speedChanged);
+        connect(kingsmithR1ProTreadmill, &kingsmithr1protreadmill::inclinationChanged, this,
+                &bluetooth::inclinationChanged);
+        kingsmithR1ProTreadmill->deviceDiscovered(b);
+        connect(this, &bluetooth::searchingStop, kingsmithR1ProTreadmill, &kingsmithr1protreadmill::searchingStop);
+        if (!discoveryAgent->isActive())
+            emit searchingStop();
+        userTemplateManager->start(kingsmithR1ProTreadmill);
+        innerTemplateManager->start(kingsmithR1ProTreadmill);
+        break;
+    case deviceregistry::SHUA_A5_TREADMILL:
+        if (shuaA5Treadmill) {
+            return false;
+        }
+        settings.setValue(QStringLiteral("bluetooth_lastdevice_name"), b.name());
 #ifndef Q_OS_IOS
-                settings.setValue(QStringLiteral("bluetooth_lastdevice_address"), b.address().toString());
+        settings.setValue(QStringLiteral("bluetooth_lastdevice_address"), b.address().toString());
 #else
-                settings.setValue("bluetooth_lastdevice_address", b.deviceUuid().toString());
+        settings.setValue("bluetooth_lastdevice_address", b.deviceUuid().toString());
 #endif
 
-                discoveryAgent->stop();
-                shuaA5Treadmill = new shuaa5treadmill(noWriteResistance, noHeartService);
+        discoveryAgent->stop();
+        shuaA5Treadmill = new shuaa5treadmill(noWriteResistance, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
-                stateFileRead();
+        stateFileRead();
 #endif
-                emit deviceConnected(b);
-                connect(shuaA5Treadmill, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(shuaA5Treadmill, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(shuaA5Treadmill, &shuaa5treadmill::debug, this, &bluetooth::debug);
-                connect(shuaA5Treadmill, &shuaa5treadmill::speedChanged, this, &bluetooth::speedChanged);
-                connect(shuaA5Treadmill, &shuaa5treadmill::inclinationChanged, this, &bluetooth::inclinationChanged);
-                shuaA5Treadmill->deviceDiscovered(b);
-                if (!discoveryAgent->isActive())
-                    emit searchingStop();
-                userTemplateManager->start(shuaA5Treadmill);
-                innerTemplateManager->start(shuaA5Treadmill);
-            } else if ((b.name().toUpper().startsWith(QStringLiteral("F80")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("F65")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("F63")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("F85"))) &&
-                       !soleF80 && filter) {
-                discoveryAgent->stop();
-                soleF80 = new solef80treadmill(noWriteResistance, noHeartService);
+        emit deviceConnected(b);
+        connect(shuaA5Treadmill, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(shuaA5Treadmill, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(shuaA5Treadmill, &shuaa5treadmill::debug, this, &bluetooth::debug);
+        connect(shuaA5Treadmill, &shuaa5treadmill::speedChanged, this, &bluetooth::speedChanged);
+        connect(shuaA5Treadmill, &shuaa5treadmill::inclinationChanged, this, &bluetooth::inclinationChanged);
+        shuaA5Treadmill->deviceDiscovered(b);
+        if (!discoveryAgent->isActive())
+            emit searchingStop();
+        userTemplateManager->start(shuaA5Treadmill);
+        innerTemplateManager->start(shuaA5Treadmill);
+        break;
+    case deviceregistry::SOLE_F80_TREADMILL:
+        if (soleF80) {
+            return false;
+        }
+        discoveryAgent->stop();
+        soleF80 = new solef80treadmill(noWriteResistance, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
-                stateFileRead();
+        stateFileRead();
 #endif
-                emit deviceConnected(b);
-                connect(soleF80, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
-                // connect(soleF80, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(soleF80, &solef80treadmill::debug, this, &bluetooth::debug);
-                // NOTE: Commented due to #358
-                // connect(soleF80, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // NOTE: Commented due to #358
-                // connect(soleF80, SIGNAL(inclinationChanged(double)), this,
-                // SLOT(inclinationChanged(double)));
-                soleF80->deviceDiscovered(b);
-                // NOTE: Commented due to #358
-                // connect(this, SIGNAL(searchingStop()), horizonTreadmill, SLOT(searchingStop()));
-                if (!discoveryAgent->isActive()) {
-                    emit searchingStop();
-                }
-                userTemplateManager->start(soleF80);
-                innerTemplateManager->start(soleF80);
-            } else if ((b.name().toUpper().startsWith(QStringLiteral("HORIZON")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("AFG SPORT")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("WLT2541")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("S77")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("T318_")) || // FTMS
-                        b.name().toUpper().startsWith(QStringLiteral("ESANGLINKER"))) &&
-                       !horizonTreadmill && filter) {
-                discoveryAgent->stop();
-                horizonTreadmill = new horizontreadmill(noWriteResistance, noHeartService);
+        emit deviceConnected(b);
+        connect(soleF80, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(soleF80, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(soleF80, &solef80treadmill::debug, this, &bluetooth::debug);
+        // NOTE: Commented due to #358
+        // connect(soleF80, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // NOTE: Commented due to #358
+        // connect(soleF80, SIGNAL(inclinationChanged(double)), this,
+        // SLOT(inclinationChanged(double)));
+        soleF80->deviceDiscovered(b);
+        // NOTE: Commented due to #358
+        // connect(this, SIGNAL(searchingStop()), horizonTreadmill, SLOT(searchingStop()));
+        if (!discoveryAgent->isActive()) {
+            emit searchingStop();
+        }
+        userTemplateManager->start(soleF80);
+        innerTemplateManager->start(soleF80);
+        break;
+    case deviceregistry::HORIZON_TREADMILL:
+        if (horizonTreadmill) {
+            return false;
+        }
+        discoveryAgent->stop();
+        horizonTreadmill = new horizontreadmill(noWriteResistance, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
-                stateFileRead();
+        stateFileRead();
 #endif
-                emit deviceConnected(b);
-                connect(horizonTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(horizonTreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(horizonTreadmill, &horizontreadmill::debug, this, &bluetooth::debug);
-                // NOTE: Commented due to #358
-                // connect(horizonTreadmill, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // NOTE: Commented due to #358
-                // connect(horizonTreadmill, SIGNAL(inclinationChanged(double)), this,
-                // SLOT(inclinationChanged(double)));
-                horizonTreadmill->deviceDiscovered(b);
-                // NOTE: Commented due to #358
-                // connect(this, SIGNAL(searchingStop()), horizonTreadmill, SLOT(searchingStop()));
-                if (!discoveryAgent->isActive()) {
-                    emit searchingStop();
-                }
-                userTemplateManager->start(horizonTreadmill);
-                innerTemplateManager->start(horizonTreadmill);
-            } else if (b.name().toUpper().startsWith(QStringLiteral("MYRUN ")) && !technogymmyrunTreadmill && filter) {
-                discoveryAgent->stop();
-                technogymmyrunTreadmill = new technogymmyruntreadmill(noWriteResistance, noHeartService);
+        emit deviceConnected(b);
+        connect(horizonTreadmill, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(horizonTreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(horizonTreadmill, &horizontreadmill::debug, this, &bluetooth::debug);
+        // NOTE: Commented due to #358
+        // connect(horizonTreadmill, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // NOTE: Commented due to #358
+        // connect(horizonTreadmill, SIGNAL(inclinationChanged(double)), this,
+        // SLOT(inclinationChanged(double)));
+        horizonTreadmill->deviceDiscovered(b);
+        // NOTE: Commented due to #358
+        // connect(this, SIGNAL(searchingStop()), horizonTreadmill, SLOT(searchingStop()));
+        if (!discoveryAgent->isActive()) {
+            emit searchingStop();
+        }
+        userTemplateManager->start(horizonTreadmill);
+        innerTemplateManager->start(horizonTreadmill);
+        break;
+    case deviceregistry::TECHNOGYM_MYRUN_TREADMILL:
+        if (technogymmyrunTreadmill) {
+            return false;
+        }
+        discoveryAgent->stop();
+        technogymmyrunTreadmill = new technogymmyruntreadmill(noWriteResistance, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
-                stateFileRead();
+        stateFileRead();
 #endif
-                emit deviceConnected(b);
-                connect(technogymmyrunTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(technogymmyrunTreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(technogymmyrunTreadmill, &technogymmyruntreadmill::debug, this, &bluetooth::debug);
-                // NOTE: Commented due to #358
-                // connect(horizonTreadmill, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // NOTE: Commented due to #358
-                // connect(horizonTreadmill, SIGNAL(inclinationChanged(double)), this,
-                // SLOT(inclinationChanged(double)));
-                technogymmyrunTreadmill->deviceDiscovered(b);
-                // NOTE: Commented due to #358
-                // connect(this, SIGNAL(searchingStop()), horizonTreadmill, SLOT(searchingStop()));
-                if (!discoveryAgent->isActive()) {
-                    emit searchingStop();
-                }
-                userTemplateManager->start(technogymmyrunTreadmill);
-                innerTemplateManager->start(technogymmyrunTreadmill);
-            } else if ((b.name().toUpper().startsWith("TACX NEO 2") ||
-                        (b.name().toUpper().startsWith("TACX SMART BIKE"))) &&
-                       !tacxneo2Bike && filter) {
-                discoveryAgent->stop();
-                tacxneo2Bike = new tacxneo2(noWriteResistance, noHeartService);
-                // stateFileRead();
-                emit(deviceConnected(b));
-                connect(tacxneo2Bike, SIGNAL(connectedAndDiscovered()), this, SLOT(connectedAndDiscovered()));
-                // connect(tacxneo2Bike, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(tacxneo2Bike, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
-                // connect(tacxneo2Bike, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(tacxneo2Bike, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
-                tacxneo2Bike->deviceDiscovered(b);
-                userTemplateManager->start(tacxneo2Bike);
-                innerTemplateManager->start(tacxneo2Bike);
-            } else if ((b.name().toUpper().startsWith(QStringLiteral(">CABLE")) ||
-                        (b.name().toUpper().startsWith(QStringLiteral("MD")) && b.name().length() == 7) ||
-                        // BIKE 1, BIKE 2, BIKE 3...
-                        (b.name().toUpper().startsWith(QStringLiteral("BIKE")) && flywheel_life_fitness_ic8 == false &&
-                         b.name().length() == 6)) &&
-                       !npeCableBike && filter) {
-                discoveryAgent->stop();
-                npeCableBike = new npecablebike(noWriteResistance, noHeartService);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(npeCableBike, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(echelonConnectSport, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(npeCableBike, &npecablebike::debug, this, &bluetooth::debug);
-                // connect(echelonConnectSport, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(echelonConnectSport, SIGNAL(inclinationChanged(double)), this,
-                // SLOT(inclinationChanged(double)));
-                npeCableBike->deviceDiscovered(b);
-                userTemplateManager->start(npeCableBike);
-                innerTemplateManager->start(npeCableBike);
-            } else if (((b.name().startsWith("FS-") && hammerRacerS) ||
-                        (b.name().toUpper().startsWith("WAHOO KICKR")) || (b.name().toUpper().startsWith("B94")) ||
-                        (b.name().toUpper().startsWith("STAGES BIKE")) || (b.name().toUpper().startsWith("SUITO")) ||
-                        (b.name().toUpper().startsWith("DIRETO XR")) || (b.name().toUpper().startsWith("SMB1"))) &&
-                       !ftmsBike && !snodeBike && !fitPlusBike && !stagesBike && filter) {
-                discoveryAgent->stop();
-                ftmsBike = new ftmsbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
-                emit deviceConnected(b);
-                connect(ftmsBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
-                // connect(trxappgateusb, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(ftmsBike, &ftmsbike::debug, this, &bluetooth::debug);
-                ftmsBike->deviceDiscovered(b);
-                userTemplateManager->start(ftmsBike);
-                innerTemplateManager->start(ftmsBike);
-            } else if (((b.name().toUpper().startsWith("JFIC")) // HORIZON GR7
-                        ) &&
-                       !horizonGr7Bike && filter) {
-                discoveryAgent->stop();
-                horizonGr7Bike =
-                    new horizongr7bike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
-                emit deviceConnected(b);
-                connect(horizonGr7Bike, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(trxappgateusb, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(horizonGr7Bike, &horizongr7bike::debug, this, &bluetooth::debug);
-                horizonGr7Bike->deviceDiscovered(b);
-                userTemplateManager->start(horizonGr7Bike);
-                innerTemplateManager->start(horizonGr7Bike);
-            } else if ((b.name().toUpper().startsWith(QStringLiteral("STAGES ")) ||
-                        (b.name().toUpper().startsWith(QStringLiteral("ASSIOMA")) &&
-                         powerSensorName.startsWith(QStringLiteral("Disabled")))) &&
-                       !stagesBike && !ftmsBike && filter) {
-
-                discoveryAgent->stop();
-                stagesBike = new stagesbike(noWriteResistance, noHeartService, false);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(stagesBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
-                // connect(stagesBike, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(stagesBike, &stagesbike::debug, this, &bluetooth::debug);
-                // connect(stagesBike, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(stagesBike, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
-                stagesBike->deviceDiscovered(b);
-                userTemplateManager->start(stagesBike);
-                innerTemplateManager->start(stagesBike);
-            } else if (b.name().startsWith(QStringLiteral("SMARTROW")) && !smartrowRower && filter) {
-
-                discoveryAgent->stop();
-                smartrowRower =
-                    new smartrowrower(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(smartrowRower, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(smartrowRower, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(smartrowRower, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
-                // connect(v, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(smartrowRower, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
-                smartrowRower->deviceDiscovered(b);
-                userTemplateManager->start(smartrowRower);
-                innerTemplateManager->start(smartrowRower);
-            } else if ((b.name().toUpper().startsWith(QStringLiteral("CR 00")) ||
-                        (b.name().toUpper().startsWith(QStringLiteral("PM5")) &&
-                         b.name().toUpper().contains(QStringLiteral("ROW")))) &&
-                       !ftmsRower && filter) {
-                discoveryAgent->stop();
-                ftmsRower = new ftmsrower(noWriteResistance, noHeartService);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(ftmsRower, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
-                // connect(ftmsRower, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(ftmsRower, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
-                // connect(v, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(ftmsRower, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
-                ftmsRower->deviceDiscovered(b);
-                userTemplateManager->start(ftmsRower);
-                innerTemplateManager->start(ftmsRower);
-            } else if ((b.name().toUpper().startsWith(QLatin1String("ECH-STRIDE")) ||
-                        b.name().toUpper().startsWith(QLatin1String("ECH-SD-SPT"))) &&
-                       !echelonStride && filter) {
-
-                discoveryAgent->stop();
-                echelonStride = new echelonstride(this->pollDeviceTime, noConsole, noHeartService);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(echelonStride, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(echelonRower, SIGNAL(disconnected()), this, SLOT(restart())); connect(echelonStride,
-                connect(echelonStride, &echelonstride::debug, this, &bluetooth::debug);
-                connect(echelonStride, &echelonstride::speedChanged, this, &bluetooth::speedChanged);
-                connect(echelonStride, &echelonstride::inclinationChanged, this, &bluetooth::inclinationChanged);
-                echelonStride->deviceDiscovered(b);
-                userTemplateManager->start(echelonStride);
-                innerTemplateManager->start(echelonStride);
-            } else if (b.name().startsWith(QStringLiteral("ECH-ROW")) && !echelonRower && filter) {
-
-                discoveryAgent->stop();
-                echelonRower =
-                    new echelonrower(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(echelonRower, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(echelonRower, SIGNAL(disconnected()), this, SLOT(restart()));
-                // connect(echelonRower, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
-                // connect(echelonRower, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(echelonRower, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
-                echelonRower->deviceDiscovered(b);
-                userTemplateManager->start(echelonRower);
-                innerTemplateManager->start(echelonRower);
-            } else if (b.name().startsWith(QStringLiteral("ECH")) && !echelonRower && !echelonStride &&
-                       !echelonConnectSport && filter) {
-
-                discoveryAgent->stop();
-                echelonConnectSport = new echelonconnectsport(noWriteResistance, noHeartService, bikeResistanceOffset,
-                                                              bikeResistanceGain);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(echelonConnectSport, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(echelonConnectSport, SIGNAL(disconnected()), this, SLOT(restart()));
-                // connect(echelonConnectSport, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
-                // connect(echelonConnectSport, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(echelonConnectSport, SIGNAL(inclinationChanged(double)), this,
-                // SLOT(inclinationChanged(double)));
-                echelonConnectSport->deviceDiscovered(b);
-                userTemplateManager->start(echelonConnectSport);
-                innerTemplateManager->start(echelonConnectSport);
-            } else if ((b.name().toUpper().startsWith(QStringLiteral("IC BIKE")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("C7-")) ||
-                        b.name().toUpper().startsWith(QStringLiteral("C9/C10"))) &&
-                       !schwinnIC4Bike && filter) {
-                settings.setValue(QStringLiteral("bluetooth_lastdevice_name"), b.name());
+        emit deviceConnected(b);
+        connect(technogymmyrunTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
+                &bluetooth::connectedAndDiscovered);
+        // connect(technogymmyrunTreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(technogymmyrunTreadmill, &technogymmyruntreadmill::debug, this, &bluetooth::debug);
+        // NOTE: Commented due to #358
+        // connect(horizonTreadmill, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // NOTE: Commented due to #358
+        // connect(horizonTreadmill, SIGNAL(inclinationChanged(double)), this,
+        // SLOT(inclinationChanged(double)));
+        technogymmyrunTreadmill->deviceDiscovered(b);
+        // NOTE: Commented due to #358
+        // connect(this, SIGNAL(searchingStop()), horizonTreadmill, SLOT(searchingStop()));
+        if (!discoveryAgent->isActive()) {
+            emit searchingStop();
+        }
+        userTemplateManager->start(technogymmyrunTreadmill);
+        innerTemplateManager->start(technogymmyrunTreadmill);
+        break;
+    case deviceregistry::TACX_NEO_2:
+        if (tacxneo2Bike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        tacxneo2Bike = new tacxneo2(noWriteResistance, noHeartService);
+        // stateFileRead();
+        emit(deviceConnected(b));
+        connect(tacxneo2Bike, SIGNAL(connectedAndDiscovered()), this, SLOT(connectedAndDiscovered()));
+        // connect(tacxneo2Bike, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(tacxneo2Bike, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
+        // connect(tacxneo2Bike, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(tacxneo2Bike, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
+        tacxneo2Bike->deviceDiscovered(b);
+        userTemplateManager->start(tacxneo2Bike);
+        innerTemplateManager->start(tacxneo2Bike);
+        break;
+    case deviceregistry::NPE_CABLE_BIKE:
+        if (npeCableBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        npeCableBike = new npecablebike(noWriteResistance, noHeartService);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(npeCableBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(echelonConnectSport, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(npeCableBike, &npecablebike::debug, this, &bluetooth::debug);
+        // connect(echelonConnectSport, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(echelonConnectSport, SIGNAL(inclinationChanged(double)), this,
+        // SLOT(inclinationChanged(double)));
+        npeCableBike->deviceDiscovered(b);
+        userTemplateManager->start(npeCableBike);
+        innerTemplateManager->start(npeCableBike);
+        break;
+    case deviceregistry::FTMS_BIKE:
+        if (ftmsBike || snodeBike || fitPlusBike || stagesBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        ftmsBike = new ftmsbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+        emit deviceConnected(b);
+        connect(ftmsBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(trxappgateusb, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(ftmsBike, &ftmsbike::debug, this, &bluetooth::debug);
+        ftmsBike->deviceDiscovered(b);
+        userTemplateManager->start(ftmsBike);
+        innerTemplateManager->start(ftmsBike);
+        break;
+    case deviceregistry::HORIZON_GR7_BIKE:
+        if (horizonGr7Bike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        horizonGr7Bike =
+            new horizongr7bike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+        emit deviceConnected(b);
+        connect(horizonGr7Bike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(trxappgateusb, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(horizonGr7Bike, &horizongr7bike::debug, this, &bluetooth::debug);
+        horizonGr7Bike->deviceDiscovered(b);
+        userTemplateManager->start(horizonGr7Bike);
+        innerTemplateManager->start(horizonGr7Bike);
+        break;
+    case deviceregistry::STAGES_BIKE:
+        if (stagesBike || ftmsBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        stagesBike = new stagesbike(noWriteResistance, noHeartService, false);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(stagesBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(stagesBike, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(stagesBike, &stagesbike::debug, this, &bluetooth::debug);
+        // connect(stagesBike, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(stagesBike, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
+        stagesBike->deviceDiscovered(b);
+        userTemplateManager->start(stagesBike);
+        innerTemplateManager->start(stagesBike);
+        break;
+    case deviceregistry::SMARTROW_ROWER:
+        if (smartrowRower) {
+            return false;
+        }
+        discoveryAgent->stop();
+        smartrowRower = new smartrowrower(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(smartrowRower, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(smartrowRower, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(smartrowRower, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
+        // connect(v, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(smartrowRower, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
+        smartrowRower->deviceDiscovered(b);
+        userTemplateManager->start(smartrowRower);
+        innerTemplateManager->start(smartrowRower);
+        break;
+    case deviceregistry::FTMS_ROWER:
+        if (ftmsRower) {
+            return false;
+        }
+        discoveryAgent->stop();
+        ftmsRower = new ftmsrower(noWriteResistance, noHeartService);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(ftmsRower, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(ftmsRower, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(ftmsRower, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
+        // connect(v, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(ftmsRower, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
+        ftmsRower->deviceDiscovered(b);
+        userTemplateManager->start(ftmsRower);
+        innerTemplateManager->start(ftmsRower);
+        break;
+    case deviceregistry::ECHELON_STRIDE:
+        if (echelonStride) {
+            return false;
+        }
+        discoveryAgent->stop();
+        echelonStride = new echelonstride(this->pollDeviceTime, noConsole, noHeartService);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(echelonStride, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(echelonRower, SIGNAL(disconnected()), this, SLOT(restart())); connect(echelonStride,
+        connect(echelonStride, &echelonstride::debug, this, &bluetooth::debug);
+        connect(echelonStride, &echelonstride::speedChanged, this, &bluetooth::speedChanged);
+        connect(echelonStride, &echelonstride::inclinationChanged, this, &bluetooth::inclinationChanged);
+        echelonStride->deviceDiscovered(b);
+        userTemplateManager->start(echelonStride);
+        innerTemplateManager->start(echelonStride);
+        break;
+    case deviceregistry::ECHELON_ROWER:
+        if (echelonRower) {
+            return false;
+        }
+        discoveryAgent->stop();
+        echelonRower = new echelonrower(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(echelonRower, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(echelonRower, SIGNAL(disconnected()), this, SLOT(restart()));
+        // connect(echelonRower, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
+        // connect(echelonRower, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(echelonRower, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
+        echelonRower->deviceDiscovered(b);
+        userTemplateManager->start(echelonRower);
+        innerTemplateManager->start(echelonRower);
+        break;
+    case deviceregistry::ECHELON_CONNECT_SPORT:
+        if (echelonRower || echelonStride || echelonConnectSport) {
+            return false;
+        }
+        discoveryAgent->stop();
+        echelonConnectSport = new echelonconnectsport(noWriteResistance, noHeartService, bikeResistanceOffset,
+                                                      bikeResistanceGain);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(echelonConnectSport, &bluetoothdevice::connectedAndDiscovered, this,
+                &bluetooth::connectedAndDiscovered);
+        // connect(echelonConnectSport, SIGNAL(disconnected()), this, SLOT(restart()));
+        // connect(echelonConnectSport, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
+        // connect(echelonConnectSport, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(echelonConnectSport, SIGNAL(inclinationChanged(double)), this,
+        // SLOT(inclinationChanged(double)));
+        echelonConnectSport->deviceDiscovered(b);
+        userTemplateManager->start(echelonConnectSport);
+        innerTemplateManager->start(echelonConnectSport);
+        break;
+    case deviceregistry::SCHWINN_IC4_BIKE:
+        if (schwinnIC4Bike) {
+            return false;
+        }
+        settings.setValue(QStringLiteral("bluetooth_lastdevice_name"), b.name());
 #ifndef Q_OS_IOS
-                settings.setValue(QStringLiteral("bluetooth_lastdevice_address"), b.address().toString());
+        settings.setValue(QStringLiteral("bluetooth_lastdevice_address"), b.address().toString());
 #else
-                settings.setValue("bluetooth_lastdevice_address", b.deviceUuid().toString());
+        settings.setValue("bluetooth_lastdevice_address", b.deviceUuid().toString());
 #endif
-                discoveryAgent->stop();
-                schwinnIC4Bike = new schwinnic4bike(noWriteResistance, noHeartService);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(schwinnIC4Bike, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(echelonConnectSport, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(schwinnIC4Bike, &schwinnic4bike::debug, this, &bluetooth::debug);
-                // connect(echelonConnectSport, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(echelonConnectSport, SIGNAL(inclinationChanged(double)), this,
-                // SLOT(inclinationChanged(double)));
-                schwinnIC4Bike->deviceDiscovered(b);
-                userTemplateManager->start(schwinnIC4Bike);
-                innerTemplateManager->start(schwinnIC4Bike);
-            } else if (b.name().toUpper().startsWith(QStringLiteral("EW-BK")) && !sportsTechBike && filter) {
-
-                discoveryAgent->stop();
-                sportsTechBike = new sportstechbike(noWriteResistance, noHeartService);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(sportsTechBike, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(echelonConnectSport, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(sportsTechBike, &sportstechbike::debug, this, &bluetooth::debug);
-                // connect(echelonConnectSport, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(echelonConnectSport, SIGNAL(inclinationChanged(double)), this,
-                // SLOT(inclinationChanged(double)));
-                sportsTechBike->deviceDiscovered(b);
-                userTemplateManager->start(sportsTechBike);
-                innerTemplateManager->start(sportsTechBike);
-            } else if (b.name().toUpper().startsWith(QStringLiteral("CARDIOFIT")) && !sportsPlusBike && filter) {
-
-                discoveryAgent->stop();
-                sportsPlusBike = new sportsplusbike(noWriteResistance, noHeartService);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(sportsPlusBike, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(sportsPlusBike, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(sportsPlusBike, &sportsplusbike::debug, this, &bluetooth::debug);
-                // connect(sportsPlusBike, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(sportsPlusBike, SIGNAL(inclinationChanged(double)), this,
-                // SLOT(inclinationChanged(double)));
-                sportsPlusBike->deviceDiscovered(b);
-                userTemplateManager->start(sportsPlusBike);
-                innerTemplateManager->start(sportsPlusBike);
-            } else if (b.name().startsWith(QStringLiteral("YESOUL")) && !yesoulBike && filter) {
-
-                discoveryAgent->stop();
-                yesoulBike = new yesoulbike(noWriteResistance, noHeartService);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(yesoulBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
-                // connect(yesoulBike, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(yesoulBike, &yesoulbike::debug, this, &bluetooth::debug);
-                // connect(echelonConnectSport, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(echelonConnectSport, SIGNAL(inclinationChanged(double)), this,
-                // SLOT(inclinationChanged(double)));
-                yesoulBike->deviceDiscovered(b);
-                userTemplateManager->start(yesoulBike);
-                innerTemplateManager->start(yesoulBike);
-            } else if ((b.name().startsWith(QStringLiteral("I_EB")) || b.name().startsWith(QStringLiteral("I_SB"))) &&
-                       !proformBike && filter) {
-
-                discoveryAgent->stop();
-                proformBike =
-                    new proformbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(proformBike, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(proformBike, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(proformBike, &proformbike::debug, this, &bluetooth::debug);
-                // connect(proformBike, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(proformBike, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
-                proformBike->deviceDiscovered(b);
-                userTemplateManager->start(proformBike);
-                innerTemplateManager->start(proformBike);
-            } else if (b.name().startsWith(QStringLiteral("I_TL")) && !proformTreadmill && filter) {
-
-                discoveryAgent->stop();
-                proformTreadmill = new proformtreadmill(noWriteResistance, noHeartService);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(proformTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(proformtreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(proformTreadmill, &proformtreadmill::debug, this, &bluetooth::debug);
-                // connect(proformtreadmill, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(proformtreadmill, SIGNAL(inclinationChanged(double)), this,
-                // SLOT(inclinationChanged(double)));
-                proformTreadmill->deviceDiscovered(b);
-                userTemplateManager->start(proformTreadmill);
-                innerTemplateManager->start(proformTreadmill);
-            } else if (b.name().toUpper().startsWith(QStringLiteral("ESLINKER")) && !eslinkerTreadmill && filter) {
-
-                discoveryAgent->stop();
-                eslinkerTreadmill = new eslinkertreadmill(this->pollDeviceTime, noConsole, noHeartService);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(eslinkerTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(proformtreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(eslinkerTreadmill, &eslinkertreadmill::debug, this, &bluetooth::debug);
-                // connect(proformtreadmill, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(proformtreadmill, SIGNAL(inclinationChanged(double)), this,
-                // SLOT(inclinationChanged(double)));
-                eslinkerTreadmill->deviceDiscovered(b);
-                userTemplateManager->start(eslinkerTreadmill);
-                innerTemplateManager->start(eslinkerTreadmill);
-            } else if (b.name().toUpper().startsWith(QStringLiteral("BOWFLEX T216")) && !bowflexTreadmill && filter) {
-
-                discoveryAgent->stop();
-                bowflexTreadmill = new bowflextreadmill(this->pollDeviceTime, noConsole, noHeartService);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(bowflexTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(bowflexTreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(bowflexTreadmill, &bowflextreadmill::debug, this, &bluetooth::debug);
-                // connect(bowflexTreadmill, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(bowflexTreadmill, SIGNAL(inclinationChanged(double)), this,
-                // SLOT(inclinationChanged(double)));
-                bowflexTreadmill->deviceDiscovered(b);
-                userTemplateManager->start(bowflexTreadmill);
-                innerTemplateManager->start(bowflexTreadmill);
-            } else if ((b.name().startsWith(QStringLiteral("Flywheel")) ||
-                        // BIKE 1, BIKE 2, BIKE 3...
-                        (b.name().toUpper().startsWith(QStringLiteral("BIKE")) && flywheel_life_fitness_ic8 == true &&
-                         b.name().length() == 6)) &&
-                       !flywheelBike && filter) {
-
-                discoveryAgent->stop();
-                flywheelBike = new flywheelbike(noWriteResistance, noHeartService);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(flywheelBike, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(flywheelBike, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(flywheelBike, &flywheelbike::debug, this, &bluetooth::debug);
-                // connect(echelonConnectSport, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(echelonConnectSport, SIGNAL(inclinationChanged(double)), this,
-                // SLOT(inclinationChanged(double)));
-                flywheelBike->deviceDiscovered(b);
-                userTemplateManager->start(flywheelBike);
-                innerTemplateManager->start(flywheelBike);
-            } else if ((b.name().toUpper().startsWith(QStringLiteral("MCF-"))) && !mcfBike && filter) {
-
-                discoveryAgent->stop();
-                mcfBike = new mcfbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
-                // stateFileRead();
-                emit deviceConnected(b);
-                connect(mcfBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
-                // connect(mcfBike, SIGNAL(disconnected()), this, SLOT(restart()));
-                // connect(mcfBike, &mcfbike::debug, this, &bluetooth::debug);
-                // connect(mcfBike, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // connect(mcfBike, SIGNAL(inclinationChanged(double)), this,
-                // SLOT(inclinationChanged(double)));
-                mcfBike->deviceDiscovered(b);
-                userTemplateManager->start(mcfBike);
-                innerTemplateManager->start(mcfBike);
-            } else if ((b.name().startsWith(QStringLiteral("TRX ROUTE KEY"))) && !toorx && filter) {
-
-                discoveryAgent->stop();
-                toorx = new toorxtreadmill();
-                emit deviceConnected(b);
-                connect(toorx, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
-                // connect(toorx, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(toorx, &toorxtreadmill::debug, this, &bluetooth::debug);
-                toorx->deviceDiscovered(b);
-                userTemplateManager->start(toorx);
-                innerTemplateManager->start(toorx);
-            } else if ((b.name().toUpper().startsWith(QStringLiteral("BH DUALKIT"))) && !iConceptBike && filter) {
-
-                discoveryAgent->stop();
-                iConceptBike = new iconceptbike();
-                emit deviceConnected(b);
-                connect(iConceptBike, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(toorx, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(iConceptBike, &iconceptbike::debug, this, &bluetooth::debug);
-                iConceptBike->deviceDiscovered(b);
-                userTemplateManager->start(iConceptBike);
-                innerTemplateManager->start(iConceptBike);
-            } else if (b.name().toUpper().startsWith(QStringLiteral("XT485")) && !spiritTreadmill && filter) {
-
-                discoveryAgent->stop();
-                spiritTreadmill = new spirittreadmill();
-                emit deviceConnected(b);
-                connect(spiritTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(spiritTreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(spiritTreadmill, &spirittreadmill::debug, this, &bluetooth::debug);
-                spiritTreadmill->deviceDiscovered(b);
-                userTemplateManager->start(spiritTreadmill);
-                innerTemplateManager->start(spiritTreadmill);
-            } else if (b.name().toUpper().startsWith(QStringLiteral("RUNNERT")) && !activioTreadmill && filter) {
-
-                discoveryAgent->stop();
-                activioTreadmill = new activiotreadmill();
-                emit deviceConnected(b);
-                connect(activioTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(activioTreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(activioTreadmill, &activiotreadmill::debug, this, &bluetooth::debug);
-                activioTreadmill->deviceDiscovered(b);
-                userTemplateManager->start(activioTreadmill);
-                innerTemplateManager->start(activioTreadmill);
-            } else if (((b.name().startsWith(QStringLiteral("TOORX"))) ||
-                        (b.name().startsWith(QStringLiteral("V-RUN"))) ||
-                        (b.name().toUpper().startsWith(QStringLiteral("I-CONSOLE+"))) ||
-                        (b.name().toUpper().startsWith(QStringLiteral("ICONSOLE+"))) ||
-                        (b.name().toUpper().startsWith(QStringLiteral("I-RUNNING"))) ||
-                        (b.name().toUpper().startsWith(QStringLiteral("DKN RUN"))) ||
-                        (b.name().toUpper().startsWith(QStringLiteral("REEBOK")))) &&
-                       !trxappgateusb && !trxappgateusbBike && !toorx_bike && filter) {
-                discoveryAgent->stop();
-                trxappgateusb = new trxappgateusbtreadmill();
-                emit deviceConnected(b);
-                connect(trxappgateusb, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(trxappgateusb, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(trxappgateusb, &trxappgateusbtreadmill::debug, this, &bluetooth::debug);
-                trxappgateusb->deviceDiscovered(b);
-                userTemplateManager->start(trxappgateusb);
-                innerTemplateManager->start(trxappgateusb);
-            } else if ((((b.name().startsWith(QStringLiteral("TOORX")) ||
-                          b.name().toUpper().startsWith(QStringLiteral("I-CONSOLE+")) ||
-                          b.name().toUpper().startsWith(QStringLiteral("IBIKING+")) ||
-                          b.name().toUpper().startsWith(QStringLiteral("ICONSOLE+")) ||
-                          b.name().toUpper().startsWith(QStringLiteral("DKN MOTION"))) &&
-                         (toorx_bike))) &&
-                       !trxappgateusb && !trxappgateusbBike && filter) {
-                discoveryAgent->stop();
-                trxappgateusbBike = new trxappgateusbbike(noWriteResistance, noHeartService);
-                emit deviceConnected(b);
-                connect(trxappgateusbBike, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(trxappgateusb, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(trxappgateusbBike, &trxappgateusbbike::debug, this, &bluetooth::debug);
-                trxappgateusbBike->deviceDiscovered(b);
-                userTemplateManager->start(trxappgateusbBike);
-                innerTemplateManager->start(trxappgateusbBike);
-            } else if (b.name().toUpper().startsWith(QStringLiteral("BFCP")) && !skandikaWiriBike && filter) {
-
-                discoveryAgent->stop();
-                skandikaWiriBike =
-                    new skandikawiribike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
-                emit deviceConnected(b);
-                connect(skandikaWiriBike, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(skandikaWiriBike, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(skandikaWiriBike, &skandikawiribike::debug, this, &bluetooth::debug);
-                skandikaWiriBike->deviceDiscovered(b);
-                userTemplateManager->start(skandikaWiriBike);
-                innerTemplateManager->start(skandikaWiriBike);
-            } else if ((b.name().toUpper().startsWith("RQ") && b.name().length() == 5) && !renphoBike && !snodeBike &&
-                       !fitPlusBike && filter) {
-
-                discoveryAgent->stop();
-                renphoBike = new renphobike(noWriteResistance, noHeartService);
-                emit(deviceConnected(b));
-                connect(renphoBike, SIGNAL(connectedAndDiscovered()), this, SLOT(connectedAndDiscovered()));
-                // connect(trxappgateusb, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(renphoBike, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
-                renphoBike->deviceDiscovered(b);
-                userTemplateManager->start(renphoBike);
-                innerTemplateManager->start(renphoBike);
-            } else if ((b.name().toUpper().startsWith("PAFERS_")) && !pafersBike && filter) {
-
-                discoveryAgent->stop();
-                pafersBike =
-                    new pafersbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
-                emit(deviceConnected(b));
-                connect(pafersBike, SIGNAL(connectedAndDiscovered()), this, SLOT(connectedAndDiscovered()));
-                // connect(pafersBike, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(pafersBike, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
-                pafersBike->deviceDiscovered(b);
-                userTemplateManager->start(pafersBike);
-                innerTemplateManager->start(pafersBike);
-            } else if (((b.name().startsWith(QStringLiteral("FS-")) && snode_bike) ||
-                        b.name().startsWith(QStringLiteral("TF-"))) && // TF-769DF2
-                       !snodeBike &&
-                       !ftmsBike && !fitPlusBike && filter) {
-
-                discoveryAgent->stop();
-                snodeBike = new snodebike(noWriteResistance, noHeartService);
-                emit deviceConnected(b);
-                connect(snodeBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
-                // connect(trxappgateusb, SIGNAL(disconnected()), this, SLOT(restart()));
-                connect(snodeBike, &snodebike::debug, this, &bluetooth::debug);
-                snodeBike->deviceDiscovered(b);
-                userTemplateManager->start(snodeBike);
-                innerTemplateManager->start(snodeBike);
-            } else if ((b.name().startsWith(QStringLiteral("FS-")) && fitplus_bike) && !fitPlusBike && !ftmsBike &&
-                       !snodeBike && filter) {
-
-                discoveryAgent->stop();
-                fitPlusBike =
-                    new fitplusbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
-                emit deviceConnected(b);
-                connect(fitPlusBike, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                // connect(fitPlusBike, SIGNAL(disconnected()), this, SLOT(restart()));
-                // NOTE: Commented due to #358
-                // connect(fitPlusBike, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
-                fitPlusBike->deviceDiscovered(b);
-                userTemplateManager->start(fitPlusBike);
-                innerTemplateManager->start(fitPlusBike);
-            } else if (((b.name().startsWith(QStringLiteral("FS-")) && !snode_bike && !fitplus_bike && !ftmsBike) ||
-                        (b.name().startsWith(QStringLiteral("SW")) && b.name().length() == 14)) &&
-                       !fitshowTreadmill && filter) {
-                discoveryAgent->stop();
-                fitshowTreadmill = new fitshowtreadmill(this->pollDeviceTime, noConsole, noHeartService);
-                emit deviceConnected(b);
-                connect(fitshowTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                connect(fitshowTreadmill, &fitshowtreadmill::debug, this, &bluetooth::debug);
-                fitshowTreadmill->deviceDiscovered(b);
-                connect(this, &bluetooth::searchingStop, fitshowTreadmill, &fitshowtreadmill::searchingStop);
-                if (!discoveryAgent->isActive())
-                    emit searchingStop();
-                userTemplateManager->start(fitshowTreadmill);
-                innerTemplateManager->start(fitshowTreadmill);
-            } else if (b.name().toUpper().startsWith(QStringLiteral("IC")) && b.name().length() == 8 && !inspireBike &&
-                       filter) {
-
-                discoveryAgent->stop();
-                inspireBike = new inspirebike(noWriteResistance, noHeartService);
+        discoveryAgent->stop();
+        schwinnIC4Bike = new schwinnic4bike(noWriteResistance, noHeartService);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(schwinnIC4Bike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(echelonConnectSport, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(schwinnIC4Bike, &schwinnic4bike::debug, this, &bluetooth::debug);
+        // connect(echelonConnectSport, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(echelonConnectSport, SIGNAL(inclinationChanged(double)), this,
+        // SLOT(inclinationChanged(double)));
+        schwinnIC4Bike->deviceDiscovered(b);
+        userTemplateManager->start(schwinnIC4Bike);
+        innerTemplateManager->start(schwinnIC4Bike);
+        break;
+    case deviceregistry::SPORTSTECH_BIKE:
+        if (sportsTechBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        sportsTechBike = new sportstechbike(noWriteResistance, noHeartService);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(sportsTechBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(echelonConnectSport, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(sportsTechBike, &sportstechbike::debug, this, &bluetooth::debug);
+        // connect(echelonConnectSport, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(echelonConnectSport, SIGNAL(inclinationChanged(double)), this,
+        // SLOT(inclinationChanged(double)));
+        sportsTechBike->deviceDiscovered(b);
+        userTemplateManager->start(sportsTechBike);
+        innerTemplateManager->start(sportsTechBike);
+        break;
+    case deviceregistry::SPORTSPLUS_BIKE:
+        if (sportsPlusBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        sportsPlusBike = new sportsplusbike(noWriteResistance, noHeartService);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(sportsPlusBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(sportsPlusBike, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(sportsPlusBike, &sportsplusbike::debug, this, &bluetooth::debug);
+        // connect(sportsPlusBike, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(sportsPlusBike, SIGNAL(inclinationChanged(double)), this,
+        // SLOT(inclinationChanged(double)));
+        sportsPlusBike->deviceDiscovered(b);
+        userTemplateManager->start(sportsPlusBike);
+        innerTemplateManager->start(sportsPlusBike);
+        break;
+    case deviceregistry::YESOUL_BIKE:
+        if (yesoulBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        yesoulBike = new yesoulbike(noWriteResistance, noHeartService);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(yesoulBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(yesoulBike, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(yesoulBike, &yesoulbike::debug, this, &bluetooth::debug);
+        // connect(echelonConnectSport, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(echelonConnectSport, SIGNAL(inclinationChanged(double)), this,
+        // SLOT(inclinationChanged(double)));
+        yesoulBike->deviceDiscovered(b);
+        userTemplateManager->start(yesoulBike);
+        innerTemplateManager->start(yesoulBike);
+        break;
+    case deviceregistry::PROFORM_BIKE:
+        if (proformBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        proformBike = new proformbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(proformBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(proformBike, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(proformBike, &proformbike::debug, this, &bluetooth::debug);
+        // connect(proformBike, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(proformBike, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
+        proformBike->deviceDiscovered(b);
+        userTemplateManager->start(proformBike);
+        innerTemplateManager->start(proformBike);
+        break;
+    case deviceregistry::PROFORM_TREADMILL:
+        if (proformTreadmill) {
+            return false;
+        }
+        discoveryAgent->stop();
+        proformTreadmill = new proformtreadmill(noWriteResistance, noHeartService);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(proformTreadmill, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(proformtreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(proformTreadmill, &proformtreadmill::debug, this, &bluetooth::debug);
+        // connect(proformtreadmill, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(proformtreadmill, SIGNAL(inclinationChanged(double)), this,
+        // SLOT(inclinationChanged(double)));
+        proformTreadmill->deviceDiscovered(b);
+        userTemplateManager->start(proformTreadmill);
+        innerTemplateManager->start(proformTreadmill);
+        break;
+    case deviceregistry::ESLINKER_TREADMILL:
+        if (eslinkerTreadmill) {
+            return false;
+        }
+        discoveryAgent->stop();
+        eslinkerTreadmill = new eslinkertreadmill(this->pollDeviceTime, noConsole, noHeartService);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(eslinkerTreadmill, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(proformtreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(eslinkerTreadmill, &eslinkertreadmill::debug, this, &bluetooth::debug);
+        // connect(proformtreadmill, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(proformtreadmill, SIGNAL(inclinationChanged(double)), this,
+        // SLOT(inclinationChanged(double)));
+        eslinkerTreadmill->deviceDiscovered(b);
+        userTemplateManager->start(eslinkerTreadmill);
+        innerTemplateManager->start(eslinkerTreadmill);
+        break;
+    case deviceregistry::BOWFLEX_TREADMILL:
+        if (bowflexTreadmill) {
+            return false;
+        }
+        discoveryAgent->stop();
+        bowflexTreadmill = new bowflextreadmill(this->pollDeviceTime, noConsole, noHeartService);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(bowflexTreadmill, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(bowflexTreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(bowflexTreadmill, &bowflextreadmill::debug, this, &bluetooth::debug);
+        // connect(bowflexTreadmill, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(bowflexTreadmill, SIGNAL(inclinationChanged(double)), this,
+        // SLOT(inclinationChanged(double)));
+        bowflexTreadmill->deviceDiscovered(b);
+        userTemplateManager->start(bowflexTreadmill);
+        innerTemplateManager->start(bowflexTreadmill);
+        break;
+    case deviceregistry::FLYWHEEL_BIKE:
+        if (flywheelBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        flywheelBike = new flywheelbike(noWriteResistance, noHeartService);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(flywheelBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(flywheelBike, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(flywheelBike, &flywheelbike::debug, this, &bluetooth::debug);
+        // connect(echelonConnectSport, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(echelonConnectSport, SIGNAL(inclinationChanged(double)), this,
+        // SLOT(inclinationChanged(double)));
+        flywheelBike->deviceDiscovered(b);
+        userTemplateManager->start(flywheelBike);
+        innerTemplateManager->start(flywheelBike);
+        break;
+    case deviceregistry::MCF_BIKE:
+        if (mcfBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        mcfBike = new mcfbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+        // stateFileRead();
+        emit deviceConnected(b);
+        connect(mcfBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(mcfBike, SIGNAL(disconnected()), this, SLOT(restart()));
+        // connect(mcfBike, &mcfbike::debug, this, &bluetooth::debug);
+        // connect(mcfBike, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // connect(mcfBike, SIGNAL(inclinationChanged(double)), this,
+        // SLOT(inclinationChanged(double)));
+        mcfBike->deviceDiscovered(b);
+        userTemplateManager->start(mcfBike);
+        innerTemplateManager->start(mcfBike);
+        break;
+    case deviceregistry::TOORX_TREADMILL:
+        if (toorx) {
+            return false;
+        }
+        discoveryAgent->stop();
+        toorx = new toorxtreadmill();
+        emit deviceConnected(b);
+        connect(toorx, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(toorx, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(toorx, &toorxtreadmill::debug, this, &bluetooth::debug);
+        toorx->deviceDiscovered(b);
+        userTemplateManager->start(toorx);
+        innerTemplateManager->start(toorx);
+        break;
+    case deviceregistry::ICONCEPT_BIKE:
+        if (iConceptBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        iConceptBike = new iconceptbike();
+        emit deviceConnected(b);
+        connect(iConceptBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(toorx, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(iConceptBike, &iconceptbike::debug, this, &bluetooth::debug);
+        iConceptBike->deviceDiscovered(b);
+        userTemplateManager->start(iConceptBike);
+        innerTemplateManager->start(iConceptBike);
+        break;
+    case deviceregistry::SPIRIT_TREADMILL:
+        if (spiritTreadmill) {
+            return false;
+        }
+        discoveryAgent->stop();
+        spiritTreadmill = new spirittreadmill();
+        emit deviceConnected(b);
+        connect(spiritTreadmill, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(spiritTreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(spiritTreadmill, &spirittreadmill::debug, this, &bluetooth::debug);
+        spiritTreadmill->deviceDiscovered(b);
+        userTemplateManager->start(spiritTreadmill);
+        innerTemplateManager->start(spiritTreadmill);
+        break;
+    case deviceregistry::ACTIVIO_TREADMILL:
+        if (activioTreadmill) {
+            return false;
+        }
+        discoveryAgent->stop();
+        activioTreadmill = new activiotreadmill();
+        emit deviceConnected(b);
+        connect(activioTreadmill, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(activioTreadmill, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(activioTreadmill, &activiotreadmill::debug, this, &bluetooth::debug);
+        activioTreadmill->deviceDiscovered(b);
+        userTemplateManager->start(activioTreadmill);
+        innerTemplateManager->start(activioTreadmill);
+        break;
+    case deviceregistry::TRXAPPGATEUSB_TREADMILL:
+        if (trxappgateusb || trxappgateusbBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        trxappgateusb = new trxappgateusbtreadmill();
+        emit deviceConnected(b);
+        connect(trxappgateusb, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(trxappgateusb, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(trxappgateusb, &trxappgateusbtreadmill::debug, this, &bluetooth::debug);
+        trxappgateusb->deviceDiscovered(b);
+        userTemplateManager->start(trxappgateusb);
+        innerTemplateManager->start(trxappgateusb);
+        break;
+    case deviceregistry::TRXAPPGATEUSB_BIKE:
+        if (trxappgateusb || trxappgateusbBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        trxappgateusbBike = new trxappgateusbbike(noWriteResistance, noHeartService);
+        emit deviceConnected(b);
+        connect(trxappgateusbBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(trxappgateusb, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(trxappgateusbBike, &trxappgateusbbike::debug, this, &bluetooth::debug);
+        trxappgateusbBike->deviceDiscovered(b);
+        userTemplateManager->start(trxappgateusbBike);
+        innerTemplateManager->start(trxappgateusbBike);
+        break;
+    case deviceregistry::SKANDIKA_WIRI_BIKE:
+        if (skandikaWiriBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        skandikaWiriBike =
+            new skandikawiribike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+        emit deviceConnected(b);
+        connect(skandikaWiriBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(skandikaWiriBike, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(skandikaWiriBike, &skandikawiribike::debug, this, &bluetooth::debug);
+        skandikaWiriBike->deviceDiscovered(b);
+        userTemplateManager->start(skandikaWiriBike);
+        innerTemplateManager->start(skandikaWiriBike);
+        break;
+    case deviceregistry::RENPHO_BIKE:
+        if (renphoBike || snodeBike || fitPlusBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        renphoBike = new renphobike(noWriteResistance, noHeartService);
+        emit(deviceConnected(b));
+        connect(renphoBike, SIGNAL(connectedAndDiscovered()), this, SLOT(connectedAndDiscovered()));
+        // connect(trxappgateusb, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(renphoBike, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
+        renphoBike->deviceDiscovered(b);
+        userTemplateManager->start(renphoBike);
+        innerTemplateManager->start(renphoBike);
+        break;
+    case deviceregistry::PAFERS_BIKE:
+        if (pafersBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        pafersBike = new pafersbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+        emit(deviceConnected(b));
+        connect(pafersBike, SIGNAL(connectedAndDiscovered()), this, SLOT(connectedAndDiscovered()));
+        // connect(pafersBike, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(pafersBike, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
+        pafersBike->deviceDiscovered(b);
+        userTemplateManager->start(pafersBike);
+        innerTemplateManager->start(pafersBike);
+        break;
+    case deviceregistry::SNODE_BIKE:
+        if (snodeBike || ftmsBike || fitPlusBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        snodeBike = new snodebike(noWriteResistance, noHeartService);
+        emit deviceConnected(b);
+        connect(snodeBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(trxappgateusb, SIGNAL(disconnected()), this, SLOT(restart()));
+        connect(snodeBike, &snodebike::debug, this, &bluetooth::debug);
+        snodeBike->deviceDiscovered(b);
+        userTemplateManager->start(snodeBike);
+        innerTemplateManager->start(snodeBike);
+        break;
+    case deviceregistry::FITPLUS_BIKE:
+        if (fitPlusBike || ftmsBike || snodeBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        fitPlusBike = new fitplusbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+        emit deviceConnected(b);
+        connect(fitPlusBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        // connect(fitPlusBike, SIGNAL(disconnected()), this, SLOT(restart()));
+        // NOTE: Commented due to #358
+        // connect(fitPlusBike, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
+        fitPlusBike->deviceDiscovered(b);
+        userTemplateManager->start(fitPlusBike);
+        innerTemplateManager->start(fitPlusBike);
+        break;
+    case deviceregistry::FITSHOW_TREADMILL:
+        if (fitshowTreadmill || (ftmsBike && b.name().startsWith(QStringLiteral("FS-")))) {
+            return false;
+        }
+        discoveryAgent->stop();
+        fitshowTreadmill = new fitshowtreadmill(this->pollDeviceTime, noConsole, noHeartService);
+        emit deviceConnected(b);
+        connect(fitshowTreadmill, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        connect(fitshowTreadmill, &fitshowtreadmill::debug, this, &bluetooth::debug);
+        fitshowTreadmill->deviceDiscovered(b);
+        connect(this, &bluetooth::searchingStop, fitshowTreadmill, &fitshowtreadmill::searchingStop);
+        if (!discoveryAgent->isActive())
+            emit searchingStop();
+        userTemplateManager->start(fitshowTreadmill);
+        innerTemplateManager->start(fitshowTreadmill);
+        break;
+    case deviceregistry::INSPIRE_BIKE:
+        if (inspireBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        inspireBike = new inspirebike(noWriteResistance, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
-                stateFileRead();
+        stateFileRead();
 #endif
-                emit deviceConnected(b);
-                connect(inspireBike, &bluetoothdevice::connectedAndDiscovered, this,
-                        &bluetooth::connectedAndDiscovered);
-                connect(inspireBike, &inspirebike::debug, this, &bluetooth::debug);
-                // NOTE: Commented due to #358
-                // connect(inspireBike, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // NOTE: Commented due to #358
-                // connect(inspireBike, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
-                inspireBike->deviceDiscovered(b);
-                // NOTE: Commented due to #358
-                // connect(this, SIGNAL(searchingStop()), inspireBike, SLOT(searchingStop()));
-                if (!discoveryAgent->isActive()) {
-                    emit searchingStop();
-                }
-                userTemplateManager->start(inspireBike);
-                innerTemplateManager->start(inspireBike);
-            } else if (b.name().toUpper().startsWith(QStringLiteral("CHRONO ")) && !chronoBike && filter) {
-                discoveryAgent->stop();
-                chronoBike = new chronobike(noWriteResistance, noHeartService);
+        emit deviceConnected(b);
+        connect(inspireBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        connect(inspireBike, &inspirebike::debug, this, &bluetooth::debug);
+        // NOTE: Commented due to #358
+        // connect(inspireBike, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // NOTE: Commented due to #358
+        // connect(inspireBike, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
+        inspireBike->deviceDiscovered(b);
+        // NOTE: Commented due to #358
+        // connect(this, SIGNAL(searchingStop()), inspireBike, SLOT(searchingStop()));
+        if (!discoveryAgent->isActive()) {
+            emit searchingStop();
+        }
+        userTemplateManager->start(inspireBike);
+        innerTemplateManager->start(inspireBike);
+        break;
+    case deviceregistry::CHRONO_BIKE:
+        if (chronoBike) {
+            return false;
+        }
+        discoveryAgent->stop();
+        chronoBike = new chronobike(noWriteResistance, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
-                stateFileRead();
+        stateFileRead();
 #endif
-                emit deviceConnected(b);
-                connect(chronoBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
-                connect(chronoBike, &chronobike::debug, this, &bluetooth::debug);
-                // NOTE: Commented due to #358
-                // connect(chronoBike, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
-                // NOTE: Commented due to #358
-                // connect(chronoBike, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
-                chronoBike->deviceDiscovered(b);
-                // NOTE: Commented due to #358
-                // connect(this, SIGNAL(searchingStop()), chronoBike, SLOT(searchingStop()));
-                if (!discoveryAgent->isActive()) {
-                    emit searchingStop();
-                }
-            }
+        emit deviceConnected(b);
+        connect(chronoBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+        connect(chronoBike, &chronobike::debug, this, &bluetooth::debug);
+        // NOTE: Commented due to #358
+        // connect(chronoBike, SIGNAL(speedChanged(double)), this, SLOT(speedChanged(double)));
+        // NOTE: Commented due to #358
+        // connect(chronoBike, SIGNAL(inclinationChanged(double)), this, SLOT(inclinationChanged(double)));
+        chronoBike->deviceDiscovered(b);
+        // NOTE: Commented due to #358
+        // connect(this, SIGNAL(searchingStop()), chronoBike, SLOT(searchingStop()));
+        if (!discoveryAgent->isActive()) {
+            emit searchingStop();
         }
+        break;
+    default:
+        return false;
     }
+    return true;
 }
 
 void bluetooth::connectedAndDiscovered() {
@@ -1504,6 +1494,9 @@ void bluetooth::restart() {
     }
 
     devices.clear();
+    devicesIndex.clear();
+    devicesNames.clear();
+    devicesMatched = false;
     userTemplateManager->stop();
     innerTemplateManager->stop();
 
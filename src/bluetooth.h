@@ -4,6 +4,7 @@
 #include <QBluetoothDeviceDiscoveryAgent>
 #include <QFile>
 #include <QObject>
+#include <QSet>
 #include <QtBluetooth/qlowenergyadvertisingdata.h>
 #include <QtBluetooth/qlowenergyadvertisingparameters.h>
 #include <QtBluetooth/qlowenergycharacteristic.h>
@@ -22,6 +23,7 @@
 #include "bluetoothdevice.h"
 #include "chronobike.h"
 #include "cscbike.h"
+#include "deviceregistry.h"
 #include "domyosbike.h"
 #include "domyoselliptical.h"
 #include "domyostreadmill.h"
@@ -53,6 +55,7 @@
 #include "proformbike.h"
 #include "proformtreadmill.h"
 #include "schwinnic4bike.h"
+#include "settingssnapshot.h"
 #include "signalhandler.h"
 #include "skandikawiribike.h"
 #include "smartrowrower.h"
@@ -180,6 +183,16 @@ class bluetooth : public QObject, public SignalHandler {
     bool powerSensorAvaiable();
     bool eliteRizerAvaiable();
     bool eliteSterzoSmartAvaiable();
+    void loadDiscoverySettings();
+    void matchDevice(const QBluetoothDeviceInfo &b);
+    bool connectDevice(deviceregistry::DEVICE device, const QBluetoothDeviceInfo &b);
+
+    discoverysettings discoverySettings;
+    std::shared_ptr<const settingssnapshot> discoverySettingsSnapshot;
+    QHash<QString, int> devicesIndex; // position in devices by address
+    QSet<QString> devicesNames;
+    bool devicesMatched = false; // devices matched with the current settings
+
     bool fitmetria_fanfit_isconnected(QString name);
 
   signals:
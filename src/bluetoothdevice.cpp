@@ -1,4 +1,5 @@
 #include "bluetoothdevice.h"
+#include "settingssnapshot.h"
 
 #include <QSettings>
 #include <QTime>
@@ -36,8 +37,7 @@ void bluetoothdevice::changeInclination(double grade, double percentage) {}
 void bluetoothdevice::offsetElapsedTime(int offset) { elapsed += offset; }
 
 QTime bluetoothdevice::currentPace() {
-    QSettings settings;
-    bool miles = settings.value(QStringLiteral("miles_unit"), false).toBool();
+    bool miles = settingssnapshot::current()->miles_unit;
     double unit_conversion = 1.0;
     if (miles) {
         unit_conversion = 0.621371;
@@ -53,8 +53,7 @@ QTime bluetoothdevice::currentPace() {
 
 QTime bluetoothdevice::averagePace() {
 
-    QSettings settings;
-    bool miles = settings.value(QStringLiteral("miles_unit"), false).toBool();
+    bool miles = settingssnapshot::current()->miles_unit;
     double unit_conversion = 1.0;
     if (miles) {
         unit_conversion = 0.621371;
@@ -70,8 +69,7 @@ QTime bluetoothdevice::averagePace() {
 
 QTime bluetoothdevice::maxPace() {
 
-    QSettings settings;
-    bool miles = settings.value(QStringLiteral("miles_unit"), false).toBool();
+    bool miles = settingssnapshot::current()->miles_unit;
     double unit_conversion = 1.0;
     if (miles) {
         unit_conversion = 0.621371;
@@ -111,7 +109,16 @@ bool bluetoothdevice::changeFanSpeed(uint8_t speed) {
 bool bluetoothdevice::connected() { return false; }
 metric bluetoothdevice::elevationGain() { return elevationAcc; }
 void bluetoothdevice::heartRate(uint8_t heart) { Heart.setValue(heart); }
+blewritequeue *bluetoothdevice::writeQueue() {
+    if (!m_writeQueue) {
+        m_writeQueue = new blewritequeue(this);
+    }
+    return m_writeQueue;
+}
 void bluetoothdevice::disconnectBluetooth() {
+    if (m_writeQueue) {
+        m_writeQueue->clear();
+    }
     if (m_control) {
         m_control->disconnectFromDevice();
     }
@@ -130,18 +137,13 @@ void bluetoothdevice::update_metrics(bool watt_calc, const double watts) {
 
     QDateTime current = QDateTime::currentDateTime();
     double deltaTime = (((double)_lastTimeUpdate.msecsTo(current)) / ((double)1000.0));
-    QSettings settings;
-    bool power_as_bike = settings.value(QStringLiteral("power_sensor_as_bike"), false).toBool();
-    bool power_as_treadmill = settings.value(QStringLiteral("power_sensor_as_treadmill"), false).toBool();
-
-    if (settings.value(QStringLiteral("power_sensor_name"), QStringLiteral("Disabled"))
-                .toString()
-                .startsWith(QStringLiteral("Disabled")) == false &&
-        !power_as_bike && !power_as_treadmill)
+    const auto settings = settingssnapshot::current();
+
+    if (!settings->power_sensor_disabled && !settings->power_sensor_as_bike && !settings->power_sensor_as_treadmill)
         watt_calc = false;
 
     if (!_firstUpdate && !paused) {
-        if (currentSpeed().value() > 0.0 || settings.value(QStringLiteral("continuous_moving"), true).toBool()) {
+        if (currentSpeed().value() > 0.0 || settings->continuous_moving) {
 
             elapsed += deltaTime;
         }
@@ -153,18 +155,18 @@ void bluetoothdevice::update_metrics(bool watt_calc, const double watts) {
             if (watt_calc) {
                 m_watt = watts;
             }
-            WattKg = m_watt.value() / settings.value(QStringLiteral("weight"), 75.0).toFloat();
+            WattKg = m_watt.value() / settings->weight;
         } else if (m_watt.value() > 0) {
 
             m_watt = 0;
             WattKg = 0;
         }
-    } else if (paused && settings.value(QStringLiteral("instant_power_on_pause"), false).toBool()) {
+    } else if (paused && settings->instant_power_on_pause) {
         // useful for FTP test
         if (watt_calc) {
             m_watt = watts;
         }
-        WattKg = m_watt.value() / settings.value(QStringLiteral("weight"), 75.0).toFloat();
+        WattKg = m_watt.value() / settings->weight;
     } else if (m_watt.value() > 0) {
 
         m_watt = 0;
@@ -174,6 +176,62 @@ void bluetoothdevice::update_metrics(bool watt_calc, const double watts) {
 
     _lastTimeUpdate = current;
     _firstUpdate = false;
+
+    publishSnapshot();
+    emit metricsUpdated();
+}
+
+void bluetoothdevice::publishSnapshot() {
+    devicesnapshot s;
+    metric m = currentSpeed();
+    s.speed = m.value();
+    s.speedAvg = m.average();
+    s.speedMax = m.max();
+    m = currentInclination();
+    s.inclination = m.value();
+    s.inclinationAvg = m.average();
+    s.inclinationMax = m.max();
+    m = currentCadence();
+    s.cadence = m.value();
+    s.cadenceAvg = m.average();
+    s.cadenceMax = m.max();
+    m = currentResistance();
+    s.resistance = m.value();
+    s.resistanceAvg = m.average();
+    s.resistanceMax = m.max();
+    s.watt = m_watt.value();
+    s.wattAvg = m_watt.average();
+    s.wattMax = m_watt.max();
+    s.watt5s = m_watt.average5s();
+    m = currentHeart();
+    s.heart = m.value();
+    s.heartAvg = m.average();
+    s.heartMax = m.max();
+    m = calories();
+    s.calories = m.value();
+    s.caloriesRate = m.rate1s();
+    s.odometer = odometer();
+    m = elevationGain();
+    s.elevationGain = m.value();
+    s.elevationRate = m.rate1s();
+    s.jouls = m_jouls.value();
+    s.joulsRate = m_jouls.rate1s();
+    s.wattKg = WattKg.value();
+    s.wattKgAvg = WattKg.average();
+    s.wattKgMax = WattKg.max();
+    s.mets = METS.value();
+    s.metsAvg = METS.average();
+    s.metsMax = METS.max();
+    s.crankRevolutions = currentCrankRevolutions();
+    s.elapsed = elapsed.value();
+    s.lapElapsed = elapsed.lapValue();
+    s.moving = moving.value();
+    s.lastCrankEventTime = lastCrankEventTime();
+    s.fanSpeed = fanSpeed();
+    s.heartOverride = metrics_override_heartrate();
+    s.paused = paused;
+    s.timestamp = QDateTime::currentMSecsSinceEpoch();
+    m_snapshot.store(s);
 }
 
 void bluetoothdevice::clearStats() {
@@ -256,9 +314,7 @@ uint8_t bluetoothdevice::maxResistance() { return 100; }
 
 uint8_t bluetoothdevice::metrics_override_heartrate() {
 
-    QSettings settings;
-    QString setting =
-        settings.value(QStringLiteral("peloton_heartrate_metric"), QStringLiteral("Heart Rate")).toString();
+    const QString setting = settingssnapshot::current()->peloton_heartrate_metric;
     if (!setting.compare(QStringLiteral("Heart Rate"))) {
         return currentHeart().value();
     } else if (!setting.compare(QStringLiteral("Speed"))) {
@@ -1,7 +1,10 @@
 #ifndef BLUETOOTHDEVICE_H
 #define BLUETOOTHDEVICE_H
 
+#include "blewritequeue.h"
+#include "devicesnapshot.h"
 #include "metric.h"
+#include "seqlock.h"
 #include <QBluetoothDeviceDiscoveryAgent>
 #include <QBluetoothDeviceInfo>
 #include <QDateTime>
@@ -69,6 +72,9 @@ class bluetoothdevice : public QObject {
     metric wattKg() { return WattKg; }
     metric currentMETS() { return METS; }
 
+    // values published after the last parsed packet, safe to read from any thread
+    devicesnapshot snapshot() const { return m_snapshot.load(); }
+
     enum BLUETOOTH_TYPE { UNKNOWN = 0, TREADMILL, BIKE, ROWING, ELLIPTICAL };
     enum WORKOUT_EVENT_STATE { STARTED = 0, PAUSED = 1, RESUMED = 2, STOPPED = 3 };
 
@@ -97,10 +103,17 @@ class bluetoothdevice : public QObject {
     void powerChanged(uint16_t power);
     void inclinationChanged(double grade, double percentage);
     void fanSpeedChanged(uint8_t speed);
+    // emitted by update_metrics, every time the device has refreshed its values
+    void metricsUpdated();
 
   protected:
+    // packetreplay gives the devices it creates a controller that is never connected
+    friend class packetreplay;
     QLowEnergyController *m_control = nullptr;
 
+    // asynchronous, paced queue of the writes to the device; created on first use
+    blewritequeue *writeQueue();
+
     metric elapsed;
     metric moving; // moving time
     metric Speed;
@@ -131,7 +144,11 @@ class bluetoothdevice : public QObject {
 
     QDateTime _lastTimeUpdate;
     bool _firstUpdate = true;
+    blewritequeue *m_writeQueue = nullptr;
+    seqlock<devicesnapshot> m_snapshot;
     void update_metrics(bool watt_calc, const double watts);
+    // called by update_metrics; a device that doesn't use it calls this when its values change
+    void publishSnapshot();
     double calculateMETS();
 };
 
@@ -0,0 +1,87 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+
+// Bounded lock-free multi producer / multi consumer queue (Dmitry Vyukov's array queue).
+// Every cell carries a sequence number telling whether it's free for the producer at a given position or
+// holds a value for the consumer at that position, so push and pop only need a CAS on their own index.
+// push() fails instead of blocking when the queue is full.
+template <typename T> class boundedqueue {
+
+  public:
+    // capacity is rounded up to a power of 2
+    explicit boundedqueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_cells.reset(new cell[size]);
+        for (size_t i = 0; i < size; i++) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(T &&value) {
+        cell *c;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            c = &m_cells[pos & m_mask];
+            size_t seq = c->sequence.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+            if (dif == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false; // full
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        c->value = std::move(value);
+        c->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &value) {
+        cell *c;
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            c = &m_cells[pos & m_mask];
+            size_t seq = c->sequence.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (dif == 0) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false; // empty
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(c->value);
+        c->value = T();
+        c->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+  private:
+    struct cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<cell[]> m_cells;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<size_t> m_dequeuePos{0};
+};
+
+#endif // BOUNDEDQUEUE_H
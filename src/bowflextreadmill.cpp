@@ -1,5 +1,6 @@
 #include "bowflextreadmill.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualtreadmill.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -46,8 +47,7 @@ void bowflextreadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, cons
         gattWriteCharacteristic, QByteArray((const char *)data, data_len), QLowEnergyService::WriteWithoutResponse);
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     // packets sent from the characChanged event, i don't want to block everything
@@ -92,7 +92,7 @@ void bowflextreadmill::update() {
             bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
             if (virtual_device_enabled) {
                 emit debug(QStringLiteral("creating virtual treadmill interface..."));
-                virtualTreadMill = new virtualtreadmill(this, noHeartService);
+                virtualTreadMill = virtualtreadmill::create(this, noHeartService);
                 connect(virtualTreadMill, &virtualtreadmill::debug, this, &bowflextreadmill::debug);
                 firstInit = 1;
             }
@@ -162,7 +162,7 @@ void bowflextreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    emit debug(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
+    packettrace::rx(this, value);
 
     emit packetReceived();
 
@@ -325,7 +325,7 @@ void bowflextreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor,
 void bowflextreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                               const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void bowflextreadmill::serviceScanDone(void) {
@@ -0,0 +1,64 @@
+#include "chartlod.h"
+
+void chartlod::append(double value) {
+    const uint32_t i = m_count++;
+    const float v = static_cast<float>(value);
+
+    // a new level starts with the bucket of the level below that covers every sample before this one
+    if (m_levels.isEmpty()) {
+        m_levels.append(QVector<bucket>());
+    } else if (i == (1u << m_levels.count())) {
+        m_levels.append(QVector<bucket>{m_levels.last().first()});
+    }
+
+    for (int k = 1; k <= m_levels.count(); k++) {
+        QVector<bucket> &level = m_levels[k - 1];
+        if ((i & ((1u << k) - 1)) == 0) {
+            level.append({v, v, i, i});
+            continue;
+        }
+        bucket &b = level.last();
+        // the first sample wins a tie, so the points of a flat stretch stay at its start
+        if (v < b.min) {
+            b.min = v;
+            b.minIndex = i;
+        }
+        if (v > b.max) {
+            b.max = v;
+            b.maxIndex = i;
+        }
+    }
+}
+
+void chartlod::clear() {
+    m_levels.clear();
+    m_count = 0;
+}
+
+QVector<QPointF> chartlod::points(int pixels) const {
+    QVector<QPointF> list;
+    if (m_levels.isEmpty()) {
+        return list;
+    }
+
+    // two points per bucket
+    int k = 1;
+    while (k < m_levels.count() && m_levels.at(k - 1).count() * 2 > pixels) {
+        k++;
+    }
+
+    const QVector<bucket> &level = m_levels.at(k - 1);
+    list.reserve(level.count() * 2);
+    for (const bucket &b : level) {
+        if (b.minIndex == b.maxIndex) {
+            list.append(QPointF(b.minIndex, b.min));
+        } else if (b.minIndex < b.maxIndex) {
+            list.append(QPointF(b.minIndex, b.min));
+            list.append(QPointF(b.maxIndex, b.max));
+        } else {
+            list.append(QPointF(b.maxIndex, b.max));
+            list.append(QPointF(b.minIndex, b.min));
+        }
+    }
+    return list;
+}
@@ -0,0 +1,37 @@
+#ifndef CHARTLOD_H
+#define CHARTLOD_H
+
+#include <QPointF>
+#include <QVector>
+#include <cstdint>
+
+// Level of detail of a chart channel, so a chart draws about as many points as it has pixels whatever the length of
+// the session. Level k is a min/max pyramid of buckets of 2^k samples; append() updates the last bucket of every
+// level, O(log n) per sample, and adds a level when the top one has two buckets. points() picks the finest level that
+// fits the pixels and returns the minimum and the maximum of every bucket, in the order they happened: the peaks of
+// the session are all drawn, which a plain stride would skip. Level 1 returns every sample but the repeated ones,
+// so the samples themselves aren't kept.
+class chartlod {
+
+  public:
+    void append(double value);
+    void clear();
+
+    int count() const { return m_count; }
+
+    // at most pixels points, x is the index of the sample
+    QVector<QPointF> points(int pixels) const;
+
+  private:
+    struct bucket {
+        float min;
+        float max;
+        uint32_t minIndex;
+        uint32_t maxIndex;
+    };
+
+    QVector<QVector<bucket>> m_levels; // m_levels[k - 1] is level k
+    int m_count = 0;
+};
+
+#endif // CHARTLOD_H
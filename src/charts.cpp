@@ -69,35 +69,33 @@ void charts::update() {
             chart->removeSeries(chart_series_resistance);
         }
     }
-    chart_series_inclination->clear();
-    chart_series_speed->clear();
-    chart_series_pace->clear();
-    chart_series_heart->clear();
-    chart_series_watt->clear();
-    chart_series_resistance->clear();
     const int maxQueue = 100;
 
-    for (int g = 0; g < (parent->Session.count() > maxQueue ? maxQueue : parent->Session.count()); g++) {
-        int index = g + (parent->Session.count() > maxQueue ? parent->Session.count() % maxQueue : 0);
-        if (ui->inclination->isChecked()) {
-            chart_series_inclination->append(g, static_cast<double>(parent->Session[index].inclination));
-        }
-        if (ui->speed->isChecked()) {
-            chart_series_speed->append(g, static_cast<qreal>(parent->Session[index].speed));
-        }
-        if (ui->pace->isChecked()) {
-            chart_series_pace->append(g, static_cast<qreal>(parent->Session[index].pace));
-        }
-        if (ui->heart->isChecked()) {
-            chart_series_heart->append(g, static_cast<qreal>(parent->Session[index].heart));
-        }
-        if (ui->watt->isChecked()) {
-            chart_series_watt->append(g, static_cast<qreal>(parent->Session[index].watt));
-        }
-        if (ui->resistance->isChecked()) {
-            chart_series_resistance->append(g, static_cast<qreal>(parent->Session[index].resistance));
-        }
+    // the last maxQueue lines, every series is replaced at once instead of a change signal per point
+    const int count = (parent->Session.count() > maxQueue ? maxQueue : parent->Session.count());
+    const int first = parent->Session.count() - count;
+    QVector<QPointF> inclination, speed, pace, heart, watt, resistance;
+    inclination.reserve(count);
+    speed.reserve(count);
+    pace.reserve(count);
+    heart.reserve(count);
+    watt.reserve(count);
+    resistance.reserve(count);
+    for (int g = 0; g < count; g++) {
+        const SessionLine &s = parent->Session.at(first + g);
+        inclination.append(QPointF(g, static_cast<double>(s.inclination)));
+        speed.append(QPointF(g, static_cast<qreal>(s.speed)));
+        pace.append(QPointF(g, static_cast<qreal>(s.pace)));
+        heart.append(QPointF(g, static_cast<qreal>(s.heart)));
+        watt.append(QPointF(g, static_cast<qreal>(s.watt)));
+        resistance.append(QPointF(g, static_cast<qreal>(s.resistance)));
     }
+    chart_series_inclination->replace(ui->inclination->isChecked() ? inclination : QVector<QPointF>());
+    chart_series_speed->replace(ui->speed->isChecked() ? speed : QVector<QPointF>());
+    chart_series_pace->replace(ui->pace->isChecked() ? pace : QVector<QPointF>());
+    chart_series_heart->replace(ui->heart->isChecked() ? heart : QVector<QPointF>());
+    chart_series_watt->replace(ui->watt->isChecked() ? watt : QVector<QPointF>());
+    chart_series_resistance->replace(ui->resistance->isChecked() ? resistance : QVector<QPointF>());
 
     if (ui->inclination->isChecked()) {
         chart->addSeries(chart_series_inclination);
@@ -1,5 +1,6 @@
 #include "cscbike.h"
 #include "ios/lockscreen.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -50,7 +51,7 @@ wait_for_response)
 data_len));
 
     if(!disable_log)
-        debug(" >> " + QByteArray((const char*)data, data_len).toHex(' ') + " // " + info);
+        packettrace::tx(this, QByteArray((const char*)data, data_len), info);
 
     loop.exec();
 }*/
@@ -160,7 +161,7 @@ void cscbike::characteristicChanged(const QLowEnergyCharacteristic &characterist
     // QString heartRateBeltName = //unused QString
     // settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     if (characteristic.uuid() != QBluetoothUuid((quint16)0x2A5B)) {
         return;
@@ -374,7 +375,7 @@ void cscbike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
             if (virtual_device_enabled) {
             emit debug(QStringLiteral("creating virtual bike interface..."));
-            virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
+            virtualBike = virtualbike::create(this, noWriteResistance, noHeartService);
             connect(virtualBike, &virtualbike::changeInclination, this, &cscbike::changeInclination);
             // connect(virtualBike,&virtualbike::debug ,this,&cscbike::debug);
         }
@@ -396,7 +397,7 @@ void cscbike::descriptorRead(const QLowEnergyDescriptor &descriptor, const QByte
 
 void cscbike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void cscbike::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
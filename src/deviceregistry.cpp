@@ -0,0 +1,200 @@
+#include "deviceregistry.h"
+
+#include <QSettings>
+#include <algorithm>
+
+void discoverysettings::load() {
+    QSettings settings;
+    heart_rate_belt_name =
+        settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
+    ftms_accessory_name = settings.value(QStringLiteral("ftms_accessory_name"), QStringLiteral("Disabled")).toString();
+    cadence_sensor_name = settings.value(QStringLiteral("cadence_sensor_name"), QStringLiteral("Disabled")).toString();
+    power_sensor_name = settings.value(QStringLiteral("power_sensor_name"), QStringLiteral("Disabled")).toString();
+    elite_rizer_name = settings.value(QStringLiteral("elite_rizer_name"), QStringLiteral("Disabled")).toString();
+    elite_sterzo_smart_name =
+        settings.value(QStringLiteral("elite_sterzo_smart_name"), QStringLiteral("Disabled")).toString();
+    cadence_sensor_as_bike = settings.value(QStringLiteral("cadence_sensor_as_bike"), false).toBool();
+    power_sensor_as_bike = settings.value(QStringLiteral("power_sensor_as_bike"), false).toBool();
+    power_sensor_as_treadmill = settings.value(QStringLiteral("power_sensor_as_treadmill"), false).toBool();
+    toorx_bike = settings.value(QStringLiteral("toorx_bike"), false).toBool() ||
+                 settings.value(QStringLiteral("jll_IC400_bike"), false).toBool() ||
+                 settings.value(QStringLiteral("fytter_ri08_bike"), false).toBool() ||
+                 settings.value(QStringLiteral("asviva_bike"), false).toBool() ||
+                 settings.value(QStringLiteral("hertz_xr_770"), false).toBool();
+    snode_bike = settings.value(QStringLiteral("snode_bike"), false).toBool();
+    fitplus_bike = settings.value(QStringLiteral("fitplus_bike"), false).toBool();
+    hammer_racer_s = settings.value(QStringLiteral("hammer_racer_s"), false).toBool();
+    flywheel_life_fitness_ic8 = settings.value(QStringLiteral("flywheel_life_fitness_ic8"), false).toBool();
+    applewatch_fakedevice = settings.value(QStringLiteral("applewatch_fakedevice"), false).toBool();
+}
+
+const deviceregistry &deviceregistry::instance() {
+    static const deviceregistry registry;
+    return registry;
+}
+
+deviceregistry::deviceregistry() {
+    m_sensitive.append(node());
+    m_insensitive.append(node());
+
+    add(DOMYOS_BIKE, Qt::CaseSensitive, {QStringLiteral("Domyos-Bike")});
+    add(DOMYOS_ELLIPTICAL, Qt::CaseSensitive, {QStringLiteral("Domyos-EL")});
+    add(SOLE_ELLIPTICAL, Qt::CaseInsensitive,
+        {QStringLiteral("E95S"), QStringLiteral("E25"), QStringLiteral("E35"), QStringLiteral("E55"),
+         QStringLiteral("E95"), QStringLiteral("E98"), QStringLiteral("E98S")});
+    add(DOMYOS_TREADMILL, Qt::CaseSensitive, {QStringLiteral("Domyos")}).excluding(QStringLiteral("DomyosBr"));
+    add(KINGSMITH_R2_TREADMILL, Qt::CaseInsensitive,
+        {QStringLiteral("KS-R1AC"), QStringLiteral("KS-HC-R1AA"), QStringLiteral("KS-HC-R1AC")});
+    add(KINGSMITH_R1_PRO_TREADMILL, Qt::CaseInsensitive,
+        {QStringLiteral("R1 PRO"), QStringLiteral("KINGSMITH"),
+         QStringLiteral("KS-")}); // Treadmill KingSmith WalkingPad R2 Pro KS-HCR1AA
+    add(KINGSMITH_R1_PRO_TREADMILL, Qt::CaseInsensitive, {QStringLiteral("RE")}).withLength(2); // just "RE"
+    add(SHUA_A5_TREADMILL, Qt::CaseInsensitive, {QStringLiteral("ZW-")});
+    add(SOLE_F80_TREADMILL, Qt::CaseInsensitive,
+        {QStringLiteral("F80"), QStringLiteral("F65"), QStringLiteral("F63"), QStringLiteral("F85")});
+    add(HORIZON_TREADMILL, Qt::CaseInsensitive,
+        {QStringLiteral("HORIZON"), QStringLiteral("AFG SPORT"), QStringLiteral("WLT2541"), QStringLiteral("S77"),
+         QStringLiteral("T318_"), // FTMS
+         QStringLiteral("ESANGLINKER")});
+    add(TECHNOGYM_MYRUN_TREADMILL, Qt::CaseInsensitive, {QStringLiteral("MYRUN ")});
+    add(TACX_NEO_2, Qt::CaseInsensitive, {QStringLiteral("TACX NEO 2"), QStringLiteral("TACX SMART BIKE")});
+    add(NPE_CABLE_BIKE, Qt::CaseInsensitive, {QStringLiteral(">CABLE")});
+    add(NPE_CABLE_BIKE, Qt::CaseInsensitive, {QStringLiteral("MD")}).withLength(7);
+    // BIKE 1, BIKE 2, BIKE 3...
+    add(NPE_CABLE_BIKE, Qt::CaseInsensitive, {QStringLiteral("BIKE")})
+        .withLength(6)
+        .onlyIf([](const discoverysettings &s) { return !s.flywheel_life_fitness_ic8; });
+    add(FTMS_BIKE, Qt::CaseSensitive, {QStringLiteral("FS-")}).onlyIf([](const discoverysettings &s) {
+        return s.hammer_racer_s;
+    });
+    add(FTMS_BIKE, Qt::CaseInsensitive,
+        {QStringLiteral("WAHOO KICKR"), QStringLiteral("B94"), QStringLiteral("STAGES BIKE"), QStringLiteral("SUITO"),
+         QStringLiteral("DIRETO XR"), QStringLiteral("SMB1")});
+    add(HORIZON_GR7_BIKE, Qt::CaseInsensitive, {QStringLiteral("JFIC")}); // HORIZON GR7
+    add(STAGES_BIKE, Qt::CaseInsensitive, {QStringLiteral("STAGES ")});
+    add(STAGES_BIKE, Qt::CaseInsensitive, {QStringLiteral("ASSIOMA")}).onlyIf([](const discoverysettings &s) {
+        return s.power_sensor_name.startsWith(QStringLiteral("Disabled"));
+    });
+    add(SMARTROW_ROWER, Qt::CaseSensitive, {QStringLiteral("SMARTROW")});
+    add(FTMS_ROWER, Qt::CaseInsensitive, {QStringLiteral("CR 00")});
+    add(FTMS_ROWER, Qt::CaseInsensitive, {QStringLiteral("PM5")}).containing(QStringLiteral("ROW"));
+    add(ECHELON_STRIDE, Qt::CaseInsensitive, {QStringLiteral("ECH-STRIDE"), QStringLiteral("ECH-SD-SPT")});
+    add(ECHELON_ROWER, Qt::CaseSensitive, {QStringLiteral("ECH-ROW")});
+    add(ECHELON_CONNECT_SPORT, Qt::CaseSensitive, {QStringLiteral("ECH")});
+    add(SCHWINN_IC4_BIKE, Qt::CaseInsensitive,
+        {QStringLiteral("IC BIKE"), QStringLiteral("C7-"), QStringLiteral("C9/C10")});
+    add(SPORTSTECH_BIKE, Qt::CaseInsensitive, {QStringLiteral("EW-BK")});
+    add(SPORTSPLUS_BIKE, Qt::CaseInsensitive, {QStringLiteral("CARDIOFIT")});
+    add(YESOUL_BIKE, Qt::CaseSensitive, {QStringLiteral("YESOUL")});
+    add(PROFORM_BIKE, Qt::CaseSensitive, {QStringLiteral("I_EB"), QStringLiteral("I_SB")});
+    add(PROFORM_TREADMILL, Qt::CaseSensitive, {QStringLiteral("I_TL")});
+    add(ESLINKER_TREADMILL, Qt::CaseInsensitive, {QStringLiteral("ESLINKER")});
+    add(BOWFLEX_TREADMILL, Qt::CaseInsensitive, {QStringLiteral("BOWFLEX T216")});
+    add(FLYWHEEL_BIKE, Qt::CaseSensitive, {QStringLiteral("Flywheel")});
+    // BIKE 1, BIKE 2, BIKE 3...
+    add(FLYWHEEL_BIKE, Qt::CaseInsensitive, {QStringLiteral("BIKE")})
+        .withLength(6)
+        .onlyIf([](const discoverysettings &s) { return s.flywheel_life_fitness_ic8; });
+    add(MCF_BIKE, Qt::CaseInsensitive, {QStringLiteral("MCF-")});
+    add(TOORX_TREADMILL, Qt::CaseSensitive, {QStringLiteral("TRX ROUTE KEY")});
+    add(ICONCEPT_BIKE, Qt::CaseInsensitive, {QStringLiteral("BH DUALKIT")});
+    add(SPIRIT_TREADMILL, Qt::CaseInsensitive, {QStringLiteral("XT485")});
+    add(ACTIVIO_TREADMILL, Qt::CaseInsensitive, {QStringLiteral("RUNNERT")});
+    add(TRXAPPGATEUSB_TREADMILL, Qt::CaseSensitive, {QStringLiteral("TOORX"), QStringLiteral("V-RUN")})
+        .onlyIf([](const discoverysettings &s) { return !s.toorx_bike; });
+    add(TRXAPPGATEUSB_TREADMILL, Qt::CaseInsensitive,
+        {QStringLiteral("I-CONSOLE+"), QStringLiteral("ICONSOLE+"), QStringLiteral("I-RUNNING"),
+         QStringLiteral("DKN RUN"), QStringLiteral("REEBOK")})
+        .onlyIf([](const discoverysettings &s) { return !s.toorx_bike; });
+    add(TRXAPPGATEUSB_BIKE, Qt::CaseSensitive, {QStringLiteral("TOORX")}).onlyIf([](const discoverysettings &s) {
+        return s.toorx_bike;
+    });
+    add(TRXAPPGATEUSB_BIKE, Qt::CaseInsensitive,
+        {QStringLiteral("I-CONSOLE+"), QStringLiteral("IBIKING+"), QStringLiteral("ICONSOLE+"),
+         QStringLiteral("DKN MOTION")})
+        .onlyIf([](const discoverysettings &s) { return s.toorx_bike; });
+    add(SKANDIKA_WIRI_BIKE, Qt::CaseInsensitive, {QStringLiteral("BFCP")});
+    add(RENPHO_BIKE, Qt::CaseInsensitive, {QStringLiteral("RQ")}).withLength(5);
+    add(PAFERS_BIKE, Qt::CaseInsensitive, {QStringLiteral("PAFERS_")});
+    add(SNODE_BIKE, Qt::CaseSensitive, {QStringLiteral("FS-")}).onlyIf([](const discoverysettings &s) {
+        return s.snode_bike;
+    });
+    add(SNODE_BIKE, Qt::CaseSensitive, {QStringLiteral("TF-")}); // TF-769DF2
+    add(FITPLUS_BIKE, Qt::CaseSensitive, {QStringLiteral("FS-")}).onlyIf([](const discoverysettings &s) {
+        return s.fitplus_bike;
+    });
+    add(FITSHOW_TREADMILL, Qt::CaseSensitive, {QStringLiteral("FS-")}).onlyIf([](const discoverysettings &s) {
+        return !s.snode_bike && !s.fitplus_bike;
+    });
+    add(FITSHOW_TREADMILL, Qt::CaseSensitive, {QStringLiteral("SW")}).withLength(14);
+    add(INSPIRE_BIKE, Qt::CaseInsensitive, {QStringLiteral("IC")}).withLength(8);
+    add(CHRONO_BIKE, Qt::CaseInsensitive, {QStringLiteral("CHRONO ")});
+}
+
+deviceregistry::rule &deviceregistry::add(DEVICE device, Qt::CaseSensitivity cs, const QStringList &prefixes) {
+    rule r;
+    r.device = device;
+    r.cs = cs;
+    m_rules.append(r);
+    int index = m_rules.count() - 1;
+
+    QVector<node> &trie = cs == Qt::CaseSensitive ? m_sensitive : m_insensitive;
+    for (const QString &prefix : prefixes) {
+        int n = 0;
+        for (const QChar c : prefix) {
+            auto i = trie[n].next.constFind(c);
+            if (i == trie[n].next.constEnd()) {
+                trie.append(node());
+                trie[n].next.insert(c, trie.count() - 1);
+                n = trie.count() - 1;
+            } else {
+                n = i.value();
+            }
+        }
+        trie[n].rules.append(index);
+    }
+    return m_rules[index];
+}
+
+void deviceregistry::walk(const QVector<node> &trie, const QString &name, QVector<int> &rules) const {
+    int n = 0;
+    for (const QChar c : name) {
+        auto i = trie.at(n).next.constFind(c);
+        if (i == trie.at(n).next.constEnd()) {
+            return;
+        }
+        n = i.value();
+        rules += trie.at(n).rules;
+    }
+}
+
+bool deviceregistry::accepts(const rule &r, const QString &name, const QString &upperName,
+                             const discoverysettings &settings) const {
+    if (r.length && name.length() != r.length) {
+        return false;
+    }
+    if (!r.contains.isEmpty() && !upperName.contains(r.contains)) {
+        return false;
+    }
+    if (!r.excluded.isEmpty() && (r.cs == Qt::CaseSensitive ? name : upperName).startsWith(r.excluded)) {
+        return false;
+    }
+    return !r.when || r.when(settings);
+}
+
+QVector<deviceregistry::DEVICE> deviceregistry::match(const QString &name, const discoverysettings &settings) const {
+    const QString upperName = name.toUpper();
+    QVector<int> rules;
+    walk(m_sensitive, name, rules);
+    walk(m_insensitive, upperName, rules);
+
+    QVector<DEVICE> devices;
+    for (int i : qAsConst(rules)) {
+        const rule &r = m_rules.at(i);
+        if (!devices.contains(r.device) && accepts(r, name, upperName, settings)) {
+            devices.append(r.device);
+        }
+    }
+    std::sort(devices.begin(), devices.end());
+    return devices;
+}
@@ -0,0 +1,141 @@
+#ifndef DEVICEREGISTRY_H
+#define DEVICEREGISTRY_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Settings used while discovering the devices.
+// They are read once when the discovery starts and again only when the settings change, instead of at every
+// advertisement.
+struct discoverysettings {
+    QString heart_rate_belt_name;
+    QString ftms_accessory_name;
+    QString cadence_sensor_name;
+    QString power_sensor_name;
+    QString elite_rizer_name;
+    QString elite_sterzo_smart_name;
+    bool cadence_sensor_as_bike = false;
+    bool power_sensor_as_bike = false;
+    bool power_sensor_as_treadmill = false;
+    bool toorx_bike = false; // also jll_IC400_bike, fytter_ri08_bike, asviva_bike and hertz_xr_770
+    bool snode_bike = false;
+    bool fitplus_bike = false;
+    bool hammer_racer_s = false;
+    bool flywheel_life_fitness_ic8 = false;
+    bool applewatch_fakedevice = false;
+
+    void load();
+};
+
+// Which device class handles an advertised name.
+// Every class registers its name prefixes once, with the optional conditions on the name length, on a substring
+// or on the settings. The prefixes are stored in two tries (case sensitive and upper case), so matching a name
+// costs one walk of its characters instead of a test for every known model. A name can match more than one class:
+// match() returns them in the order of DEVICE, the first one that isn't connected yet wins.
+// A new model of a supported class only needs its prefix in deviceregistry.cpp.
+class deviceregistry {
+
+  public:
+    // in order of precedence
+    enum DEVICE {
+        DOMYOS_BIKE = 0,
+        DOMYOS_ELLIPTICAL,
+        SOLE_ELLIPTICAL,
+        DOMYOS_TREADMILL,
+        KINGSMITH_R2_TREADMILL,
+        KINGSMITH_R1_PRO_TREADMILL,
+        SHUA_A5_TREADMILL,
+        SOLE_F80_TREADMILL,
+        HORIZON_TREADMILL,
+        TECHNOGYM_MYRUN_TREADMILL,
+        TACX_NEO_2,
+        NPE_CABLE_BIKE,
+        FTMS_BIKE,
+        HORIZON_GR7_BIKE,
+        STAGES_BIKE,
+        SMARTROW_ROWER,
+        FTMS_ROWER,
+        ECHELON_STRIDE,
+        ECHELON_ROWER,
+        ECHELON_CONNECT_SPORT,
+        SCHWINN_IC4_BIKE,
+        SPORTSTECH_BIKE,
+        SPORTSPLUS_BIKE,
+        YESOUL_BIKE,
+        PROFORM_BIKE,
+        PROFORM_TREADMILL,
+        ESLINKER_TREADMILL,
+        BOWFLEX_TREADMILL,
+        FLYWHEEL_BIKE,
+        MCF_BIKE,
+        TOORX_TREADMILL,
+        ICONCEPT_BIKE,
+        SPIRIT_TREADMILL,
+        ACTIVIO_TREADMILL,
+        TRXAPPGATEUSB_TREADMILL,
+        TRXAPPGATEUSB_BIKE,
+        SKANDIKA_WIRI_BIKE,
+        RENPHO_BIKE,
+        PAFERS_BIKE,
+        SNODE_BIKE,
+        FITPLUS_BIKE,
+        FITSHOW_TREADMILL,
+        INSPIRE_BIKE,
+        CHRONO_BIKE,
+        DEVICE_COUNT
+    };
+
+    typedef bool (*condition)(const discoverysettings &settings);
+
+    static const deviceregistry &instance();
+
+    // classes whose rules match the name, in order of precedence
+    QVector<DEVICE> match(const QString &name, const discoverysettings &settings) const;
+
+  private:
+    struct rule {
+        DEVICE device;
+        Qt::CaseSensitivity cs;
+        int length = 0;   // required name length, 0 for any
+        QString contains; // upper case
+        QString excluded; // prefix that doesn't match, same case sensitivity
+        condition when = nullptr;
+
+        rule &withLength(int l) {
+            length = l;
+            return *this;
+        }
+        rule &containing(const QString &s) {
+            contains = s;
+            return *this;
+        }
+        rule &excluding(const QString &s) {
+            excluded = s;
+            return *this;
+        }
+        rule &onlyIf(condition c) {
+            when = c;
+            return *this;
+        }
+    };
+
+    struct node {
+        QHash<QChar, int> next;
+        QVector<int> rules; // rules whose prefix ends here
+    };
+
+    deviceregistry();
+    // prefixes of case insensitive rules are upper case
+    rule &add(DEVICE device, Qt::CaseSensitivity cs, const QStringList &prefixes);
+    void walk(const QVector<node> &trie, const QString &name, QVector<int> &rules) const;
+    bool accepts(const rule &r, const QString &name, const QString &upperName,
+                 const discoverysettings &settings) const;
+
+    QVector<rule> m_rules;
+    QVector<node> m_sensitive;
+    QVector<node> m_insensitive;
+};
+
+#endif // DEVICEREGISTRY_H
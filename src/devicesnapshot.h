@@ -0,0 +1,54 @@
+#ifndef DEVICESNAPSHOT_H
+#define DEVICESNAPSHOT_H
+
+#include <QtGlobal>
+#include <stdint.h>
+
+// Current values of a device, published by bluetoothdevice every time it has parsed new data.
+// Plain values only: readers get a consistent copy without going through the virtual getters, which build a
+// metric for every call, and can read it from any thread. Averages and maxima are over the whole session.
+struct devicesnapshot {
+    double speed = 0; // km/h
+    double speedAvg = 0;
+    double speedMax = 0;
+    double inclination = 0; // %
+    double inclinationAvg = 0;
+    double inclinationMax = 0;
+    double cadence = 0;
+    double cadenceAvg = 0;
+    double cadenceMax = 0;
+    double resistance = 0;
+    double resistanceAvg = 0;
+    double resistanceMax = 0;
+    double watt = 0;
+    double wattAvg = 0;
+    double wattMax = 0;
+    double watt5s = 0; // average of the last 5 samples
+    double heart = 0;
+    double heartAvg = 0;
+    double heartMax = 0;
+    double calories = 0;
+    double caloriesRate = 0; // per second
+    double odometer = 0;     // km
+    double elevationGain = 0;
+    double elevationRate = 0; // per second
+    double jouls = 0;
+    double joulsRate = 0; // per second
+    double wattKg = 0;
+    double wattKgAvg = 0;
+    double wattKgMax = 0;
+    double mets = 0;
+    double metsAvg = 0;
+    double metsMax = 0;
+    double crankRevolutions = 0;
+    double elapsed = 0;    // seconds
+    double lapElapsed = 0; // seconds since the start of the lap
+    double moving = 0;     // seconds
+    uint16_t lastCrankEventTime = 0;
+    uint8_t fanSpeed = 0;
+    uint8_t heartOverride = 0; // metrics_override_heartrate()
+    bool paused = false;
+    qint64 timestamp = 0; // ms since epoch when published
+};
+
+#endif // DEVICESNAPSHOT_H
@@ -1,7 +1,9 @@
 #include "domyosbike.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualbike.h"
+#include "workerthread.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
 #include <QFile>
@@ -32,7 +34,7 @@ domyosbike::domyosbike(bool noWriteResistance, bool noHeartService, bool testRes
 domyosbike::~domyosbike() {
     qDebug() << QStringLiteral("~domyosbike()") << virtualBike;
     if (virtualBike) {
-        delete virtualBike;
+        workerthread::destroy(virtualBike);
     }
 }
 
@@ -59,8 +61,7 @@ void domyosbike::writeCharacteristic(uint8_t *data, uint8_t data_len, const QStr
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        qDebug() << QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                        QStringLiteral(" // ") + info;
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -204,8 +205,8 @@ void domyosbike::update() {
 #endif
                 if (virtual_device_enabled) {
                 qDebug() << QStringLiteral("creating virtual bike interface...");
-                virtualBike =
-                    new virtualbike(this, noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                virtualBike = virtualbike::create(this, noWriteResistance, noHeartService, bikeResistanceOffset,
+                                                  bikeResistanceGain);
                 // connect(virtualBike,&virtualbike::debug ,this,&schwinnic4bike::debug);
                 connect(virtualBike, &virtualbike::changeInclination, this, &domyosbike::changeInclination);
             }
@@ -281,7 +282,7 @@ void domyosbike::characteristicChanged(const QLowEnergyCharacteristic &character
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
     QByteArray value = newValue;
 
-    qDebug() << QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' ');
+    packettrace::rx(this, value);
 
     // for the init packets, the lenght is always less than 20
     // for the display and status packets, the lenght is always grater then 20 and there are 2 cases:
@@ -560,7 +561,7 @@ void domyosbike::descriptorWritten(const QLowEnergyDescriptor &descriptor, const
 
 void domyosbike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    qDebug() << QStringLiteral("characteristicWritten ") + newValue.toHex(' ');
+    packettrace::written(this, newValue);
 }
 
 void domyosbike::serviceScanDone(void) {
@@ -1,7 +1,9 @@
 #include "domyoselliptical.h"
+#include "packettrace.h"
 
 #include "keepawakehelper.h"
 #include "virtualtreadmill.h"
+#include "workerthread.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
 #include <QFile>
@@ -33,7 +35,7 @@ domyoselliptical::~domyoselliptical() {
     qDebug() << QStringLiteral("~domyoselliptical()") << virtualTreadmill;
 
     if (virtualTreadmill)
-        delete virtualTreadmill;
+        workerthread::destroy(virtualTreadmill);
 }
 
 void domyoselliptical::writeCharacteristic(uint8_t *data, uint8_t data_len, const QString &info, bool disable_log,
@@ -53,8 +55,7 @@ void domyoselliptical::writeCharacteristic(uint8_t *data, uint8_t data_len, cons
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -176,13 +177,13 @@ void domyoselliptical::update() {
             if (virtual_device_enabled) {
                 if (!virtual_device_force_bike) {
                     debug("creating virtual treadmill interface...");
-                    virtualTreadmill = new virtualtreadmill(this, noHeartService);
+                    virtualTreadmill = virtualtreadmill::create(this, noHeartService);
                     connect(virtualTreadmill, &virtualtreadmill::debug, this, &domyoselliptical::debug);
                     connect(virtualTreadmill, &virtualtreadmill::changeInclination, this,
                             &domyoselliptical::changeInclinationRequested);
                 } else {
                     debug("creating virtual bike interface...");
-                    virtualBike = new virtualbike(this);
+                    virtualBike = virtualbike::create(this);
                     connect(virtualBike, &virtualbike::changeInclination, this,
                             &domyoselliptical::changeInclinationRequested);
                     connect(virtualBike, &virtualbike::changeInclination, this, &domyoselliptical::changeInclination);
@@ -266,7 +267,7 @@ void domyoselliptical::characteristicChanged(const QLowEnergyCharacteristic &cha
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     lastPacket = newValue;
     if (newValue.length() != 26) {
@@ -484,7 +485,7 @@ void domyoselliptical::descriptorWritten(const QLowEnergyDescriptor &descriptor,
 void domyoselliptical::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                              const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void domyoselliptical::serviceScanDone(void) {
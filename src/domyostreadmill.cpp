@@ -1,6 +1,7 @@
 #include "domyostreadmill.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualtreadmill.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -65,42 +66,28 @@ domyostreadmill::domyostreadmill(uint32_t pollDeviceTime, bool noConsole, bool n
     refresh = new QTimer(this);
     initDone = false;
     connect(refresh, &QTimer::timeout, this, &domyostreadmill::update);
+    connect(this, &domyostreadmill::packetReceived, writeQueue(), &blewritequeue::responseReceived);
     refresh->start(pollDeviceTime);
 }
 
-void domyostreadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, const QString &info, bool disable_log,
-                                          bool wait_for_response) {
-    QEventLoop loop;
-    QTimer timeout;
-
-    if (wait_for_response) {
-        connect(this, &domyostreadmill::packetReceived, &loop, &QEventLoop::quit);
-        timeout.singleShot(300ms, &loop, &QEventLoop::quit);
-    } else {
-        connect(gattCommunicationChannelService, &QLowEnergyService::characteristicWritten, &loop, &QEventLoop::quit);
-        timeout.singleShot(300ms, &loop, &QEventLoop::quit);
-    }
+blewritequeue::command domyostreadmill::writeCommand(uint8_t *data, uint8_t data_len, const QString &info,
+                                                     bool disable_log, bool wait_for_response, int coalesce) {
+    return blewritequeue::writeCommand(gattCommunicationChannelService, gattWriteCharacteristic,
+                                       QByteArray((const char *)data, data_len), info, disable_log, wait_for_response,
+                                       coalesce);
+}
 
-    if (gattCommunicationChannelService->state() != QLowEnergyService::ServiceState::ServiceDiscovered ||
-        m_control->state() == QLowEnergyController::UnconnectedState) {
+void domyostreadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, const QString &info, bool disable_log,
+                                          bool wait_for_response, int coalesce, const blewritequeue::completion &done) {
+    if (m_control->state() == QLowEnergyController::UnconnectedState) {
         emit debug(QStringLiteral("writeCharacteristic error because the connection is closed"));
 
         return;
     }
 
-    gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic,
-                                                         QByteArray((const char *)data, data_len));
-
-    if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
-    }
-
-    loop.exec();
-
-    if (timeout.isActive() == false) {
-        emit debug(QStringLiteral(" exit for timeout"));
-    }
+    blewritequeue::command c = writeCommand(data, data_len, info, disable_log, wait_for_response, coalesce);
+    c.done = done;
+    writeQueue()->enqueue(c);
 }
 
 void domyostreadmill::updateDisplay(uint16_t elapsed) {
@@ -170,12 +157,15 @@ void domyostreadmill::updateDisplay(uint16_t elapsed) {
         display[26] += display[i]; // the last byte is a sort of a checksum
     }
 
-    writeCharacteristic(display, 20, QStringLiteral("updateDisplay elapsed=") + QString::number(elapsed), false, false);
-    writeCharacteristic(&display[20], sizeof(display) - 20,
-                        QStringLiteral("updateDisplay elapsed=") + QString::number(elapsed), false, true);
+    QString info = QStringLiteral("updateDisplay elapsed=") + QString::number(elapsed);
+    writeQueue()->enqueue(
+        QList<blewritequeue::command>()
+        << writeCommand(display, 20, info, false, false, blewritequeue::COALESCE_DISPLAY)
+        << writeCommand(&display[20], sizeof(display) - 20, info, false, true, blewritequeue::COALESCE_DISPLAY));
 }
 
-void domyostreadmill::forceSpeedOrIncline(double requestSpeed, double requestIncline) {
+void domyostreadmill::forceSpeedOrIncline(double requestSpeed, double requestIncline, int coalesce,
+                                          const blewritequeue::completion &done) {
     uint8_t writeIncline[] = {0xf0, 0xad, 0xff, 0xff, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
                               0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
 
@@ -193,14 +183,13 @@ void domyostreadmill::forceSpeedOrIncline(double requestSpeed, double requestInc
 
     // qDebug() << "writeIncline crc" << QString::number(writeIncline[26], 16);
 
-    writeCharacteristic(writeIncline, 20,
-                        QStringLiteral("forceSpeedOrIncline speed=") + QString::number(requestSpeed) +
-                            " incline=" + QString::number(requestIncline),
-                        false, false);
-    writeCharacteristic(&writeIncline[20], sizeof(writeIncline) - 20,
-                        QStringLiteral("forceSpeedOrIncline speed=") + QString::number(requestSpeed) +
-                            QStringLiteral(" incline=") + QString::number(requestIncline),
-                        false, true);
+    QString info = QStringLiteral("forceSpeedOrIncline speed=") + QString::number(requestSpeed) +
+                   QStringLiteral(" incline=") + QString::number(requestIncline);
+    blewritequeue::command tail =
+        writeCommand(&writeIncline[20], sizeof(writeIncline) - 20, info, false, true, coalesce);
+    tail.done = done;
+    writeQueue()->enqueue(QList<blewritequeue::command>()
+                          << writeCommand(writeIncline, 20, info, false, false, coalesce) << tail);
 }
 
 bool domyostreadmill::sendChangeFanSpeed(uint8_t speed) {
@@ -218,7 +207,8 @@ bool domyostreadmill::sendChangeFanSpeed(uint8_t speed) {
         fanSpeed[3] += fanSpeed[i]; // the last byte is a sort of a checksum
     }
 
-    writeCharacteristic(fanSpeed, 4, QStringLiteral("changeFanSpeed speed=") + QString::number(speed), false, true);
+    writeCharacteristic(fanSpeed, 4, QStringLiteral("changeFanSpeed speed=") + QString::number(speed), false, true,
+                        blewritequeue::COALESCE_FAN);
 
     return true;
 }
@@ -258,13 +248,13 @@ void domyostreadmill::update() {
             if (virtual_device_enabled) {
                 if (!virtual_device_force_bike) {
                     debug("creating virtual treadmill interface...");
-                    virtualTreadMill = new virtualtreadmill(this, noHeartService);
+                    virtualTreadMill = virtualtreadmill::create(this, noHeartService);
                     connect(virtualTreadMill, &virtualtreadmill::debug, this, &domyostreadmill::debug);
                     connect(virtualTreadMill, &virtualtreadmill::changeInclination, this,
                             &domyostreadmill::changeInclinationRequested);
                 } else {
                     debug("creating virtual bike interface...");
-                    virtualBike = new virtualbike(this);
+                    virtualBike = virtualbike::create(this);
                     connect(virtualBike, &virtualbike::changeInclination, this,
                             &domyostreadmill::changeInclinationRequested);
                 }
@@ -286,7 +276,8 @@ void domyostreadmill::update() {
             }
         } else {
             if (incompletePackets == false) {
-                writeCharacteristic(noOpData, sizeof(noOpData), QStringLiteral("noOp"), false, true);
+                writeCharacteristic(noOpData, sizeof(noOpData), QStringLiteral("noOp"), false, true,
+                                    blewritequeue::COALESCE_NOOP);
             }
         }
 
@@ -377,7 +368,7 @@ void domyostreadmill::characteristicChanged(const QLowEnergyCharacteristic &char
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    emit debug(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
+    packettrace::rx(this, value);
 
     // for the init packets, the lenght is always less than 20
     // for the display and status packets, the lenght is always grater then 20 and there are 2 cases:
@@ -634,6 +625,13 @@ double domyostreadmill::GetInclinationFromPacket(const QByteArray &packet) {
 }
 
 void domyostreadmill::btinit(bool startTape) {
+    // the treadmill is driven only once the last init write has been answered, the writes are still queued here
+    initDone = false;
+    const blewritequeue::completion done = [this](bool ok) {
+        Q_UNUSED(ok)
+        initDone = m_control && m_control->state() != QLowEnergyController::UnconnectedState;
+    };
+
     writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, true);
     writeCharacteristic(initData2, sizeof(initData2), QStringLiteral("init"), false, true);
     writeCharacteristic(initDataStart, sizeof(initDataStart), QStringLiteral("init"), false, true);
@@ -644,20 +642,19 @@ void domyostreadmill::btinit(bool startTape) {
 
     // writeCharacteristic(initDataStart6, sizeof(initDataStart6), "init", false, false);
     // writeCharacteristic(initDataStart7, sizeof(initDataStart7), "init", false, true);
-    forceSpeedOrIncline(lastSpeed, lastInclination);
+    forceSpeedOrIncline(lastSpeed, lastInclination, blewritequeue::NO_COALESCE);
 
     writeCharacteristic(initDataStart8, sizeof(initDataStart8), QStringLiteral("init"), false, false);
-    writeCharacteristic(initDataStart9, sizeof(initDataStart9), QStringLiteral("init"), false, true);
+    writeCharacteristic(initDataStart9, sizeof(initDataStart9), QStringLiteral("init"), false, true,
+                        blewritequeue::NO_COALESCE, startTape ? blewritequeue::completion() : done);
     if (startTape) {
         writeCharacteristic(initDataStart10, sizeof(initDataStart10), QStringLiteral("init"), false, false);
         writeCharacteristic(initDataStart11, sizeof(initDataStart11), QStringLiteral("init"), false, true);
         writeCharacteristic(initDataStart12, sizeof(initDataStart12), QStringLiteral("init"), false, false);
         writeCharacteristic(initDataStart13, sizeof(initDataStart13), QStringLiteral("init"), false, true);
 
-        forceSpeedOrIncline(lastSpeed, lastInclination);
+        forceSpeedOrIncline(lastSpeed, lastInclination, blewritequeue::NO_COALESCE, done);
     }
-
-    initDone = true;
 }
 
 void domyostreadmill::stateChanged(QLowEnergyService::ServiceState state) {
@@ -702,7 +699,7 @@ void domyostreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor,
 void domyostreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                             const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void domyostreadmill::serviceScanDone(void) {
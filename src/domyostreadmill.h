@@ -53,11 +53,16 @@ class domyostreadmill : public treadmill {
     double GetInclinationFromPacket(const QByteArray &packet);
     double GetKcalFromPacket(const QByteArray &packet);
     double GetDistanceFromPacket(const QByteArray &packet);
-    void forceSpeedOrIncline(double requestSpeed, double requestIncline);
+    void forceSpeedOrIncline(double requestSpeed, double requestIncline,
+                             int coalesce = blewritequeue::COALESCE_SPEED_INCLINATION,
+                             const blewritequeue::completion &done = blewritequeue::completion());
     void updateDisplay(uint16_t elapsed);
     void btinit(bool startTape);
     void writeCharacteristic(uint8_t *data, uint8_t data_len, const QString &info, bool disable_log = false,
-                             bool wait_for_response = false);
+                             bool wait_for_response = false, int coalesce = blewritequeue::NO_COALESCE,
+                             const blewritequeue::completion &done = blewritequeue::completion());
+    blewritequeue::command writeCommand(uint8_t *data, uint8_t data_len, const QString &info, bool disable_log,
+                                        bool wait_for_response, int coalesce);
     void startDiscover();
     volatile bool incompletePackets = false;
     bool noConsole = false;
@@ -1,6 +1,7 @@
 #include "echelonconnectsport.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -63,8 +64,7 @@ void echelonconnectsport::writeCharacteristic(uint8_t *data, uint8_t data_len, c
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        qDebug() << QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                        QStringLiteral(" // ") + info;
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -196,7 +196,7 @@ void echelonconnectsport::characteristicChanged(const QLowEnergyCharacteristic &
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    qDebug() << " << " + newValue.toHex(' ');
+    packettrace::rx(this, newValue);
 
     lastPacket = newValue;
 
@@ -390,8 +390,8 @@ void echelonconnectsport::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
                 if (virtual_device_enabled) {
                 qDebug() << QStringLiteral("creating virtual bike interface...");
-                virtualBike =
-                    new virtualbike(this, noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                virtualBike = virtualbike::create(this, noWriteResistance, noHeartService, bikeResistanceOffset,
+                                                  bikeResistanceGain);
                 // connect(virtualBike,&virtualbike::debug ,this,&echelonconnectsport::debug);
                 connect(virtualBike, &virtualbike::changeInclination, this, &echelonconnectsport::changeInclination);
             }
@@ -419,7 +419,7 @@ void echelonconnectsport::descriptorWritten(const QLowEnergyDescriptor &descript
 void echelonconnectsport::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                                 const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    qDebug() << QStringLiteral("characteristicWritten ") + newValue.toHex(' ');
+    packettrace::written(this, newValue);
 }
 
 void echelonconnectsport::serviceScanDone(void) {
@@ -1,6 +1,7 @@
 #include "echelonrower.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -63,8 +64,7 @@ void echelonrower::writeCharacteristic(uint8_t *data, uint8_t data_len, const QS
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        qDebug() << QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                        QStringLiteral(" // ") + info;
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -190,7 +190,7 @@ void echelonrower::characteristicChanged(const QLowEnergyCharacteristic &charact
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    qDebug() << QStringLiteral(" << ") + newValue.toHex(' ');
+    packettrace::rx(this, newValue);
 
     lastPacket = newValue;
 
@@ -381,7 +381,7 @@ void echelonrower::stateChanged(QLowEnergyService::ServiceState state) {
                 if (virtual_device_enabled) {
                 if (!virtual_device_rower) {
                     qDebug() << QStringLiteral("creating virtual bike interface...");
-                    virtualBike = new virtualbike(this, noWriteResistance, noHeartService, bikeResistanceOffset,
+                    virtualBike = virtualbike::create(this, noWriteResistance, noHeartService, bikeResistanceOffset,
                                                   bikeResistanceGain);
                     // connect(virtualBike,&virtualbike::debug ,this,&echelonrower::debug);
                 } else {
@@ -413,7 +413,7 @@ void echelonrower::descriptorWritten(const QLowEnergyDescriptor &descriptor, con
 
 void echelonrower::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    qDebug() << QStringLiteral("characteristicWritten ") + newValue.toHex(' ');
+    packettrace::written(this, newValue);
 }
 
 void echelonrower::serviceScanDone(void) {
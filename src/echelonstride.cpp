@@ -1,6 +1,7 @@
 #include "echelonstride.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualtreadmill.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -55,8 +56,7 @@ void echelonstride::writeCharacteristic(uint8_t *data, uint8_t data_len, const Q
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -137,13 +137,13 @@ void echelonstride::update() {
             if (virtual_device_enabled) {
                 if (!virtual_device_force_bike) {
                     debug("creating virtual treadmill interface...");
-                    virtualTreadMill = new virtualtreadmill(this, noHeartService);
+                    virtualTreadMill = virtualtreadmill::create(this, noHeartService);
                     connect(virtualTreadMill, &virtualtreadmill::debug, this, &echelonstride::debug);
                     connect(virtualTreadMill, &virtualtreadmill::changeInclination, this,
                             &echelonstride::changeInclinationRequested);
                 } else {
                     debug("creating virtual bike interface...");
-                    virtualBike = new virtualbike(this);
+                    virtualBike = virtualbike::create(this);
                     connect(virtualBike, &virtualbike::changeInclination, this,
                             &echelonstride::changeInclinationRequested);
                 }
@@ -224,7 +224,7 @@ void echelonstride::characteristicChanged(const QLowEnergyCharacteristic &charac
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    qDebug() << QStringLiteral(" << ") + newValue.toHex(' ');
+    packettrace::rx(this, newValue);
 
     lastPacket = newValue;
 
@@ -381,7 +381,7 @@ void echelonstride::descriptorWritten(const QLowEnergyDescriptor &descriptor, co
 
 void echelonstride::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void echelonstride::serviceScanDone(void) {
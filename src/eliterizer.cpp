@@ -1,5 +1,6 @@
 #include "eliterizer.h"
 #include "ios/lockscreen.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -57,8 +58,7 @@ void eliterizer::writeCharacteristic(uint8_t *data, uint8_t data_len, const QStr
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -96,7 +96,7 @@ void eliterizer::serviceDiscovered(const QBluetoothUuid &gatt) {
 
 void eliterizer::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
 
-    emit debug(QStringLiteral(" << ") + characteristic.uuid().toString() +  QStringLiteral(" ") +newValue.toHex(' '));
+    packettrace::rx(this, newValue, characteristic.uuid());
 
     lastPacket = newValue;
 
@@ -200,7 +200,7 @@ void eliterizer::descriptorRead(const QLowEnergyDescriptor &descriptor, const QB
 void eliterizer::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
 
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void eliterizer::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
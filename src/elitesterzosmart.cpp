@@ -1,5 +1,6 @@
 #include "elitesterzosmart.h"
 #include "ios/lockscreen.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -46,8 +47,7 @@ void elitesterzosmart::writeCharacteristic(uint8_t *data, uint8_t data_len, cons
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -88,7 +88,7 @@ void elitesterzosmart::characteristicChanged(const QLowEnergyCharacteristic &cha
 
     Q_UNUSED(characteristic);
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     lastPacket = newValue;
 
@@ -161,7 +161,7 @@ void elitesterzosmart::characteristicWritten(const QLowEnergyCharacteristic &cha
                                              const QByteArray &newValue) {
 
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void elitesterzosmart::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
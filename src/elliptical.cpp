@@ -1,6 +1,6 @@
 
 #include "elliptical.h"
-#include <QSettings>
+#include "settingssnapshot.h"
 
 elliptical::elliptical() {}
 
@@ -8,9 +8,9 @@ void elliptical::update_metrics(bool watt_calc, const double watts) {
 
     QDateTime current = QDateTime::currentDateTime();
     double deltaTime = (((double)_lastTimeUpdate.msecsTo(current)) / ((double)1000.0));
-    QSettings settings;
+    const auto settings = settingssnapshot::current();
     if (!_firstUpdate && !paused) {
-        if (currentSpeed().value() > 0.0 || settings.value(QStringLiteral("continuous_moving"), true).toBool()) {
+        if (currentSpeed().value() > 0.0 || settings->continuous_moving) {
             elapsed += deltaTime;
         }
         if (currentSpeed().value() > 0.0) {
@@ -20,7 +20,7 @@ void elliptical::update_metrics(bool watt_calc, const double watts) {
             }
             m_jouls += (m_watt.value() * deltaTime);
             WeightLoss = metric::calculateWeightLoss(KCal.value());
-            WattKg = m_watt.value() / settings.value(QStringLiteral("weight"), 75.0).toFloat();
+            WattKg = m_watt.value() / settings->weight;
         } else if (m_watt.value() > 0) {
             m_watt = 0;
             WattKg = 0;
@@ -35,6 +35,9 @@ void elliptical::update_metrics(bool watt_calc, const double watts) {
 
     _lastTimeUpdate = current;
     _firstUpdate = false;
+
+    publishSnapshot();
+    emit metricsUpdated();
 }
 
 uint16_t elliptical::watts() { return 0; }
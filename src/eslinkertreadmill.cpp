@@ -1,5 +1,6 @@
 #include "eslinkertreadmill.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualtreadmill.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -46,8 +47,7 @@ void eslinkertreadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, con
         gattWriteCharacteristic, QByteArray((const char *)data, data_len), QLowEnergyService::WriteWithoutResponse);
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     // packets sent from the characChanged event, i don't want to block everything
@@ -114,7 +114,7 @@ void eslinkertreadmill::update() {
             bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
             if (virtual_device_enabled) {
                 emit debug(QStringLiteral("creating virtual treadmill interface..."));
-                virtualTreadMill = new virtualtreadmill(this, noHeartService);
+                virtualTreadMill = virtualtreadmill::create(this, noHeartService);
                 connect(virtualTreadMill, &virtualtreadmill::debug, this, &eslinkertreadmill::debug);
                 firstInit = 1;
             }
@@ -228,7 +228,7 @@ void eslinkertreadmill::characteristicChanged(const QLowEnergyCharacteristic &ch
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    emit debug(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
+    packettrace::rx(this, value);
 
     emit packetReceived();
 
@@ -483,7 +483,7 @@ void eslinkertreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor
 void eslinkertreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                               const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void eslinkertreadmill::serviceScanDone(void) {
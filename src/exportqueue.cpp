@@ -0,0 +1,239 @@
+#include "exportqueue.h"
+#include "gpx.h"
+#include "qdebugfixup.h"
+#include "workerthread.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSettings>
+#include <QThread>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+exportqueue::exportqueue(QObject *parent) : QObject(parent) {
+    m_thread = workerthread::get(QStringLiteral("export"));
+
+    m_retryTimer.setSingleShot(true);
+    connect(&m_retryTimer, &QTimer::timeout, this, &exportqueue::nextUpload);
+
+    loadUploads();
+    if (!m_uploads.isEmpty()) {
+        qDebug() << QStringLiteral("export:") << m_uploads.count() << QStringLiteral("uploads pending");
+        // the network and the token may not be ready at the start
+        m_retryTimer.start(30s);
+    }
+}
+
+exportqueue::~exportqueue() {
+    // the jobs still queued report back to this object
+    m_thread->drain();
+}
+
+void exportqueue::exportSession(const sessionstore &session, const job &j) {
+    if (session.isEmpty()) {
+        return;
+    }
+    m_pendingJobs++;
+    emit progress(j.fitFile.isEmpty() ? j.gpxFile : j.fitFile, 0);
+    if (!m_thread->isRunning()) {
+        // quitting: the session is still there until the job is done
+        run(std::shared_ptr<const sessionstore>(&session, [](const sessionstore *) {}), j);
+        return;
+    }
+    auto copy = std::make_shared<sessionstore>();
+    copy->copyFrom(session);
+    m_thread->post([this, copy, j]() { run(copy, j); });
+}
+
+void exportqueue::run(std::shared_ptr<const sessionstore> session, const job &j) {
+    QSettings settings;
+    const bool gzipFit = j.strava && settings.value(QStringLiteral("strava_upload_gzip"), false).toBool();
+    const QString file = j.fitFile.isEmpty() ? j.gpxFile : j.fitFile;
+    const int steps = (j.gpxFile.isEmpty() ? 0 : 1) + (j.fitFile.isEmpty() ? 0 : 1) + (gzipFit ? 1 : 0);
+    int step = 0;
+    // without the worker thread there's no event loop left to deliver a queued call: report directly
+    const bool synchronous = QThread::currentThread() == thread();
+    auto stepDone = [this, &step, steps, file, synchronous]() {
+        int percent = ++step * 100 / steps;
+        if (percent >= 100) {
+            return;
+        }
+        if (synchronous) {
+            emit progress(file, percent);
+        } else {
+            QMetaObject::invokeMethod(
+                this, [this, file, percent]() { emit progress(file, percent); }, Qt::QueuedConnection);
+        }
+    };
+
+    job done = j;
+    if (!j.gpxFile.isEmpty()) {
+        gpx::save(j.gpxFile, *session, j.type);
+        stepDone();
+    }
+    if (!j.fitFile.isEmpty()) {
+        qfit::save(j.fitFile, *session, j.type, j.processFlag, j.sport);
+        stepDone();
+        done.stravaUpload.file = j.fitFile;
+    }
+    if (gzipFit) {
+        QFile f(j.fitFile);
+        QFile gz(j.fitFile + QStringLiteral(".gz"));
+        if (f.open(QIODevice::ReadOnly) && gz.open(QIODevice::WriteOnly) && gz.write(gzip(f.readAll())) > 0) {
+            done.stravaUpload.file = gz.fileName();
+        } else {
+            qDebug() << QStringLiteral("export: gzip error") << gz.errorString();
+        }
+        stepDone();
+    }
+
+    if (synchronous) {
+        finish(done);
+    } else {
+        QMetaObject::invokeMethod(
+            this, [this, done]() { finish(done); }, Qt::QueuedConnection);
+    }
+}
+
+void exportqueue::finish(const job &j) {
+    m_pendingJobs--;
+    const QString file = j.fitFile.isEmpty() ? j.gpxFile : j.fitFile;
+    qDebug() << QStringLiteral("export: saved") << file;
+    emit progress(file, 100);
+
+    if (j.strava && !j.stravaUpload.file.isEmpty()) {
+        m_uploads.append(j.stravaUpload);
+        saveUploads();
+        nextUpload();
+    }
+    emit finished(j);
+}
+
+void exportqueue::nextUpload() {
+    if (m_uploading || m_uploads.isEmpty()) {
+        return;
+    }
+    m_retryTimer.stop();
+
+    QSettings settings;
+    if (settings.value(QStringLiteral("strava_accesstoken"), QLatin1String("")).toString().isEmpty()) {
+        qDebug() << QStringLiteral("export: strava not connected, the uploads stay in the queue");
+        return;
+    }
+
+    QFile f(m_uploads.first().file);
+    if (!f.open(QIODevice::ReadOnly)) {
+        qDebug() << QStringLiteral("export: can't read") << f.fileName() << QStringLiteral("removed from the queue");
+        m_uploads.removeFirst();
+        saveUploads();
+        nextUpload();
+        return;
+    }
+    m_uploading = true;
+    qDebug() << QStringLiteral("export: uploading") << f.fileName() << QStringLiteral("attempt")
+             << m_uploads.first().attempts + 1;
+    emit uploadRequested(m_uploads.first(), f.readAll());
+}
+
+void exportqueue::uploadFinished(bool ok, bool retry) {
+    if (!m_uploading || m_uploads.isEmpty()) {
+        return;
+    }
+    m_uploading = false;
+
+    if (ok || !retry) {
+        if (!ok) {
+            qDebug() << QStringLiteral("export: upload refused, removed from the queue") << m_uploads.first().file;
+        }
+        m_uploads.removeFirst();
+        saveUploads();
+        nextUpload();
+        return;
+    }
+
+    // 5, 10, 15... minutes, at most one hour
+    upload &u = m_uploads.first();
+    u.attempts++;
+    saveUploads();
+    const int minutes = qMin(u.attempts, 12) * 5;
+    qDebug() << QStringLiteral("export: upload failed, next attempt in") << minutes << QStringLiteral("minutes");
+    m_retryTimer.start(minutes * 60 * 1000);
+}
+
+void exportqueue::loadUploads() {
+    QSettings settings;
+    const QJsonArray queue =
+        QJsonDocument::fromJson(settings.value(QStringLiteral("strava_upload_queue"), QString()).toString().toUtf8())
+            .array();
+    m_uploads.clear();
+    for (const QJsonValue &v : queue) {
+        const QJsonObject o = v.toObject();
+        upload u;
+        u.file = o.value(QStringLiteral("file")).toString();
+        u.activityType = o.value(QStringLiteral("activity_type")).toString();
+        u.name = o.value(QStringLiteral("name")).toString();
+        u.description = o.value(QStringLiteral("description")).toString();
+        u.attempts = o.value(QStringLiteral("attempts")).toInt();
+        if (!u.file.isEmpty()) {
+            m_uploads.append(u);
+        }
+    }
+}
+
+void exportqueue::saveUploads() {
+    QJsonArray queue;
+    for (const upload &u : qAsConst(m_uploads)) {
+        QJsonObject o;
+        o.insert(QStringLiteral("file"), u.file);
+        o.insert(QStringLiteral("activity_type"), u.activityType);
+        o.insert(QStringLiteral("name"), u.name);
+        o.insert(QStringLiteral("description"), u.description);
+        o.insert(QStringLiteral("attempts"), u.attempts);
+        queue.append(o);
+    }
+    QSettings settings;
+    settings.setValue(QStringLiteral("strava_upload_queue"),
+                      QString::fromUtf8(QJsonDocument(queue).toJson(QJsonDocument::Compact)));
+}
+
+QByteArray exportqueue::gzip(const QByteArray &data) {
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        tableReady = true;
+    }
+    uint32_t crc = 0xFFFFFFFF;
+    for (char b : data) {
+        crc = table[(crc ^ (uint8_t)b) & 0xFF] ^ (crc >> 8);
+    }
+    crc ^= 0xFFFFFFFF;
+
+    // qCompress: 4 bytes of size, then a zlib stream (2 bytes of header, deflate data, 4 bytes of adler32)
+    const QByteArray z = qCompress(data, 9);
+    if (z.size() < 10) {
+        return QByteArray();
+    }
+
+    QByteArray out;
+    out.reserve(z.size() + 12);
+    out.append("\x1f\x8b\x08\x00\x00\x00\x00\x00\x02\x03", 10); // deflate, no name, max compression, unix
+    out.append(z.constData() + 6, z.size() - 10);
+    const uint32_t size = (uint32_t)data.size();
+    for (int i = 0; i < 4; i++) {
+        out.append((char)((crc >> (8 * i)) & 0xFF));
+    }
+    for (int i = 0; i < 4; i++) {
+        out.append((char)((size >> (8 * i)) & 0xFF));
+    }
+    return out;
+}
@@ -0,0 +1,81 @@
+#ifndef EXPORTQUEUE_H
+#define EXPORTQUEUE_H
+
+#include "bluetoothdevice.h"
+#include "qfit.h"
+#include "sessionstore.h"
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <memory>
+
+class workerthread;
+
+// Workout files written in the background and Strava uploads that survive a failure.
+// exportSession() copies the session and returns: the GPX and FIT encoding, and the gzip of the FIT file when
+// strava_upload_gzip is enabled, run one job after the other in the "export" worker thread, and progress() is
+// emitted in the GUI thread after every step, then finished() once the files are written. Once the application is
+// quitting the jobs run synchronously, and finished() is emitted before exportSession() returns.
+// The files to upload are kept in the strava_upload_queue setting until Strava accepts them: a failed upload (no
+// network, expired token...) is tried again later, also after a restart, without encoding the session again.
+// The HTTP request itself is made by the owner of the Strava token, through uploadRequested() and
+// uploadFinished().
+class exportqueue : public QObject {
+
+    Q_OBJECT
+  public:
+    struct upload {
+        QString file;         // .fit or .fit.gz
+        QString activityType; // run, rowing or ride
+        QString name;
+        QString description;
+        int attempts = 0;
+    };
+
+    struct job {
+        bluetoothdevice::BLUETOOTH_TYPE type = bluetoothdevice::UNKNOWN;
+        QString gpxFile; // empty to skip it
+        QString fitFile; // empty to skip it
+        uint32_t processFlag = QFIT_PROCESS_NONE;
+        FIT_SPORT sport = FIT_SPORT_INVALID;
+        bool strava = false; // queue the FIT file for the upload
+        upload stravaUpload; // file is set by the job
+    };
+
+    explicit exportqueue(QObject *parent = nullptr);
+    ~exportqueue();
+
+    void exportSession(const sessionstore &session, const job &j);
+    int pendingJobs() const { return m_pendingJobs; }
+
+    // result of the upload requested by uploadRequested(): retry keeps the file in the queue
+    void uploadFinished(bool ok, bool retry);
+
+  signals:
+    // percent of the steps of the job writing file
+    void progress(const QString &file, int percent);
+    // the files of the job are written, pendingJobs() already counts it as done
+    void finished(const exportqueue::job &j);
+    void uploadRequested(const exportqueue::upload &u, const QByteArray &data);
+
+  public slots:
+    // sends the first file of the queue, unless an upload is already running
+    void nextUpload();
+
+  private:
+    static QByteArray gzip(const QByteArray &data);
+    void run(std::shared_ptr<const sessionstore> session, const job &j);
+    void finish(const job &j);
+    void loadUploads();
+    void saveUploads();
+
+    workerthread *m_thread;
+    int m_pendingJobs = 0;
+    QList<upload> m_uploads;
+    bool m_uploading = false;
+    QTimer m_retryTimer;
+};
+
+#endif // EXPORTQUEUE_H
@@ -57,7 +57,7 @@ void fakebike::update() {
 #endif
         if (virtual_device_enabled) {
             emit debug(QStringLiteral("creating virtual bike interface..."));
-            virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
+            virtualBike = virtualbike::create(this, noWriteResistance, noHeartService);
             connect(virtualBike, &virtualbike::changeInclination, this,
                     &fakebike::changeInclinationRequested);
         }
@@ -97,6 +97,9 @@ void fakebike::update() {
     #endif
     #endif
     }
+
+    publishSnapshot();
+    emit metricsUpdated();
 }
 
 void fakebike::changeInclinationRequested(double grade, double percentage) {
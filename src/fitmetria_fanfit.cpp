@@ -1,4 +1,5 @@
 #include "fitmetria_fanfit.h"
+#include "packettrace.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
 #include <QEventLoop>
@@ -31,7 +32,7 @@ void fitmetria_fanfit::characteristicChanged(const QLowEnergyCharacteristic &cha
     Q_UNUSED(characteristic);
     emit packetReceived();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 }
 
 void fitmetria_fanfit::fanSpeedRequest(uint8_t speed) {
@@ -83,8 +84,7 @@ void fitmetria_fanfit::writeCharacteristic(uint8_t *data, uint8_t data_len, cons
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        qDebug() << QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                        QStringLiteral(" // ") + info;
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -137,7 +137,7 @@ void fitmetria_fanfit::descriptorWritten(const QLowEnergyDescriptor &descriptor,
 void fitmetria_fanfit::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                              const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void fitmetria_fanfit::serviceScanDone(void) {
@@ -1,6 +1,7 @@
 #include "fitplusbike.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -63,8 +64,7 @@ void fitplusbike::writeCharacteristic(uint8_t *data, uint8_t data_len, const QSt
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log)
-        qDebug() << QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                        QStringLiteral(" // ") + info;
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
 
     loop.exec();
 }
@@ -178,7 +178,7 @@ void fitplusbike::characteristicChanged(const QLowEnergyCharacteristic &characte
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    qDebug() << QStringLiteral(" << ") + newValue.toHex(' ');
+    packettrace::rx(this, newValue);
 
     lastPacket = newValue;
 
@@ -332,8 +332,8 @@ void fitplusbike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
                 if (virtual_device_enabled) {
                 qDebug() << QStringLiteral("creating virtual bike interface...");
-                virtualBike =
-                    new virtualbike(this, noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                virtualBike = virtualbike::create(this, noWriteResistance, noHeartService, bikeResistanceOffset,
+                                                  bikeResistanceGain);
                 // connect(virtualBike,&virtualbike::debug ,this,&fitplusbike::debug);
                 connect(virtualBike, &virtualbike::changeInclination, this, &fitplusbike::changeInclination);
             }
@@ -358,7 +358,7 @@ void fitplusbike::descriptorWritten(const QLowEnergyDescriptor &descriptor, cons
 
 void fitplusbike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    qDebug() << QStringLiteral("characteristicWritten ") + newValue.toHex(' ');
+    packettrace::written(this, newValue);
 }
 
 void fitplusbike::serviceScanDone(void) {
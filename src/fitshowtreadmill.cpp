@@ -1,7 +1,9 @@
 #include "fitshowtreadmill.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualtreadmill.h"
+#include "workerthread.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
 #include <QFile>
@@ -41,7 +43,7 @@ fitshowtreadmill::~fitshowtreadmill() {
         delete refresh;
     }
     if (virtualTreadMill) {
-        delete virtualTreadMill;
+        workerthread::destroy(virtualTreadMill);
     }
 #if defined(Q_OS_IOS) && !defined(IO_UNDER_QT)
     if (h)
@@ -149,7 +151,7 @@ void fitshowtreadmill::update() {
             bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
             if (virtual_device_enabled) {
                 emit debug(QStringLiteral("creating virtual treadmill interface..."));
-                virtualTreadMill = new virtualtreadmill(this, noHeartService);
+                virtualTreadMill = virtualtreadmill::create(this, noHeartService);
                 connect(virtualTreadMill, &virtualtreadmill::debug, this, &fitshowtreadmill::debug);
 
                 firstInit = 1;
@@ -276,7 +278,7 @@ void fitshowtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    emit debug(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
+    packettrace::rx(this, value);
 
     emit debug(QStringLiteral("packetReceived!"));
     emit packetReceived();
@@ -647,7 +649,7 @@ void fitshowtreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor,
 void fitshowtreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                              const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void fitshowtreadmill::serviceScanDone(void) {
@@ -1,6 +1,7 @@
 #include "flywheelbike.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -39,8 +40,7 @@ void flywheelbike::writeCharacteristic(uint8_t *data, uint8_t data_len, const QS
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -248,7 +248,7 @@ void flywheelbike::characteristicChanged(const QLowEnergyCharacteristic &charact
     //    QString heartRateBeltName = settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled"))
     //                                    .toString(); // NOTE: clazy-unused-non-trivial-variable
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     lastPacket = newValue;
 
@@ -380,7 +380,7 @@ void flywheelbike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
                 if (virtual_device_enabled) {
                 emit debug(QStringLiteral("creating virtual bike interface..."));
-                virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
+                virtualBike = virtualbike::create(this, noWriteResistance, noHeartService);
                 // connect(virtualBike,&virtualbike::debug ,this,&flywheelbike::debug);
                 connect(virtualBike, &virtualbike::changeInclination, this, &flywheelbike::changeInclination);
             }
@@ -405,7 +405,7 @@ void flywheelbike::descriptorWritten(const QLowEnergyDescriptor &descriptor, con
 
 void flywheelbike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void flywheelbike::serviceScanDone(void) {
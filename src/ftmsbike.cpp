@@ -1,5 +1,7 @@
 #include "ftmsbike.h"
+#include "ftmscodec.h"
 #include "ios/lockscreen.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -12,6 +14,7 @@
 #include <QLowEnergyConnectionParameters>
 #endif
 #include "keepawakehelper.h"
+#include "settingssnapshot.h"
 #include <chrono>
 
 using namespace std::chrono_literals;
@@ -31,25 +34,9 @@ ftmsbike::ftmsbike(bool noWriteResistance, bool noHeartService, uint8_t bikeResi
 }
 
 void ftmsbike::writeCharacteristic(uint8_t *data, uint8_t data_len, const QString &info, bool disable_log,
-                                   bool wait_for_response) {
-    QEventLoop loop;
-    QTimer timeout;
-    if (wait_for_response) {
-        connect(gattFTMSService, &QLowEnergyService::characteristicChanged, &loop, &QEventLoop::quit);
-        timeout.singleShot(300ms, &loop, &QEventLoop::quit);
-    } else {
-        connect(gattFTMSService, &QLowEnergyService::characteristicWritten, &loop, &QEventLoop::quit);
-        timeout.singleShot(300ms, &loop, &QEventLoop::quit);
-    }
-
-    gattFTMSService->writeCharacteristic(gattWriteCharControlPointId, QByteArray((const char *)data, data_len));
-
-    if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
-    }
-
-    loop.exec();
+                                   bool wait_for_response, int coalesce) {
+    writeQueue()->write(gattFTMSService, gattWriteCharControlPointId, QByteArray((const char *)data, data_len), info,
+                        disable_log, wait_for_response, coalesce);
 }
 
 void ftmsbike::forceResistance(int8_t requestResistance) {
@@ -63,7 +50,8 @@ void ftmsbike::forceResistance(int8_t requestResistance) {
     write[3] = ((uint16_t)requestResistance * 100) & 0xFF;
     write[4] = ((uint16_t)requestResistance * 100) >> 8;
 
-    writeCharacteristic(write, sizeof(write), QStringLiteral("forceResistance ") + QString::number(requestResistance));
+    writeCharacteristic(write, sizeof(write), QStringLiteral("forceResistance ") + QString::number(requestResistance),
+                        false, false, blewritequeue::COALESCE_RESISTANCE);
 }
 
 void ftmsbike::update() {
@@ -125,93 +113,51 @@ void ftmsbike::serviceDiscovered(const QBluetoothUuid &gatt) {
 void ftmsbike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
     Q_UNUSED(characteristic);
-    QSettings settings;
-    QString heartRateBeltName =
-        settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
-    bool disable_hr_frommachinery = settings.value(QStringLiteral("heart_ignore_builtin"), false).toBool();
+    const auto settings = settingssnapshot::current();
+    bool disable_hr_frommachinery = settings->heart_ignore_builtin;
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
-    if (characteristic.uuid() != QBluetoothUuid((quint16)0x2AD2)) {
+    if (characteristic.uuid() != QBluetoothUuid(ftms::indoorbike::uuid)) {
         return;
     }
 
     lastPacket = newValue;
 
-    union flags {
-        struct {
-            uint16_t moreData : 1;
-            uint16_t avgSpeed : 1;
-            uint16_t instantCadence : 1;
-            uint16_t avgCadence : 1;
-            uint16_t totDistance : 1;
-            uint16_t resistanceLvl : 1;
-            uint16_t instantPower : 1;
-            uint16_t avgPower : 1;
-            uint16_t expEnergy : 1;
-            uint16_t heartRate : 1;
-            uint16_t metabolic : 1;
-            uint16_t elapsedTime : 1;
-            uint16_t remainingTime : 1;
-            uint16_t spare : 3;
-        };
-
-        uint16_t word_flags;
-    };
-
-    flags Flags;
-    int index = 0;
-    Flags.word_flags = (newValue.at(1) << 8) | newValue.at(0);
-    index += 2;
-
-    if (!Flags.moreData) {
-        if (!settings.value(QStringLiteral("speed_power_based"), false).toBool()) {
-            Speed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                              (uint16_t)((uint8_t)newValue.at(index)))) /
-                    100.0;
+    ftms::frame<ftms::indoorbike> frame;
+    if (!frame.decode(newValue)) {
+        emit debug(QStringLiteral("Indoor Bike Data shorter than its flags ") + QString::number(frame.flags(), 16));
+    }
+    using field = ftms::indoorbike;
+
+    if (frame.has(field::instantSpeed)) {
+        if (!settings->speed_power_based) {
+            Speed = frame.value(field::instantSpeed) / 100.0;
         } else {
             Speed = metric::calculateSpeedFromPower(m_watt.value());
         }
-        index += 2;
         emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
     }
 
-    if (Flags.avgSpeed) {
-        double avgSpeed;
-        avgSpeed =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)))) /
-            100.0;
-        index += 2;
-        emit debug(QStringLiteral("Current Average Speed: ") + QString::number(avgSpeed));
+    if (frame.has(field::averageSpeed)) {
+        emit debug(QStringLiteral("Current Average Speed: ") +
+                   QString::number(frame.value(field::averageSpeed) / 100.0));
     }
 
-    if (Flags.instantCadence) {
-        if (settings.value(QStringLiteral("cadence_sensor_name"), QStringLiteral("Disabled"))
-                .toString()
-                .startsWith(QStringLiteral("Disabled"))) {
-            Cadence = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                (uint16_t)((uint8_t)newValue.at(index)))) /
-                      2.0;
+    if (frame.has(field::instantCadence)) {
+        if (settings->cadence_sensor_disabled) {
+            Cadence = frame.value(field::instantCadence) / 2.0;
         }
-        index += 2;
         emit debug(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
     }
 
-    if (Flags.avgCadence) {
-        double avgCadence;
-        avgCadence =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)))) /
-            2.0;
-        index += 2;
-        emit debug(QStringLiteral("Current Average Cadence: ") + QString::number(avgCadence));
+    if (frame.has(field::averageCadence)) {
+        emit debug(QStringLiteral("Current Average Cadence: ") +
+                   QString::number(frame.value(field::averageCadence) / 2.0));
     }
 
-    if (Flags.totDistance) {
-        Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-                              (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                             (uint32_t)((uint8_t)newValue.at(index)))) /
-                   1000.0;
-        index += 3;
+    if (frame.has(field::totalDistance)) {
+        Distance = frame.value(field::totalDistance) / 1000.0;
     } else {
         Distance += ((Speed.value() / 3600000.0) *
                      ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
@@ -219,47 +165,28 @@ void ftmsbike::characteristicChanged(const QLowEnergyCharacteristic &characteris
 
     emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
-    if (Flags.resistanceLvl) {
-        Resistance =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
+    if (frame.has(field::resistanceLevel)) {
+        Resistance = frame.value(field::resistanceLevel);
         emit resistanceRead(Resistance.value());
-        index += 2;
         emit debug(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
     }
 
-    if (Flags.instantPower) {
-        if (settings.value(QStringLiteral("power_sensor_name"), QStringLiteral("Disabled"))
-                .toString()
-                .startsWith(QStringLiteral("Disabled")))
-            m_watt = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                               (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
+    if (frame.has(field::instantPower)) {
+        if (settings->power_sensor_disabled)
+            m_watt = frame.value(field::instantPower);
         emit debug(QStringLiteral("Current Watt: ") + QString::number(m_watt.value()));
     }
 
-    if (Flags.avgPower) {
-        double avgPower;
-        avgPower =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        emit debug(QStringLiteral("Current Average Watt: ") + QString::number(avgPower));
+    if (frame.has(field::averagePower)) {
+        emit debug(QStringLiteral("Current Average Watt: ") + QString::number(frame.value(field::averagePower)));
     }
 
-    if (Flags.expEnergy && newValue.length() > index + 1) {
-        KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-
-        // energy per hour
-        index += 2;
-
-        // energy per minute
-        index += 1;
+    if (frame.has(field::totalEnergy)) {
+        KCal = frame.value(field::totalEnergy);
     } else {
         if (watts())
             KCal +=
-                ((((0.048 * ((double)watts()) + 1.19) * settings.value(QStringLiteral("weight"), 75.0).toFloat() *
-                   3.5) /
-                  200.0) /
+                ((((0.048 * ((double)watts()) + 1.19) * settings->weight * 3.5) / 200.0) /
                  (60000.0 / ((double)lastRefreshCharacteristicChanged.msecsTo(
                                 QDateTime::currentDateTime())))); //(( (0.048* Output in watts +1.19) * body weight in
                                                                   // kg * 3.5) / 200 ) / 60
@@ -267,33 +194,20 @@ void ftmsbike::characteristicChanged(const QLowEnergyCharacteristic &characteris
 
     emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
 
+    bool heartFromMachinery = false;
 #ifdef Q_OS_ANDROID
-    if (settings.value("ant_heart", false).toBool())
+    if (settings->ant_heart)
         Heart = (uint8_t)KeepAwakeHelper::heart();
     else
 #endif
     {
-        if (Flags.heartRate && !disable_hr_frommachinery && newValue.length() > index) {
-            Heart = ((double)((newValue.at(index))));
-            // index += 1; // NOTE: clang-analyzer-deadcode.DeadStores
+        if (frame.has(field::heartRate) && !disable_hr_frommachinery) {
+            Heart = frame.value(field::heartRate);
+            heartFromMachinery = true;
             emit debug(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
-        } else {
-            Flags.heartRate = false;
         }
     }
 
-    if (Flags.metabolic) {
-        // todo
-    }
-
-    if (Flags.elapsedTime) {
-        // todo
-    }
-
-    if (Flags.remainingTime) {
-        // todo
-    }
-
     if (Cadence.value() > 0) {
         CrankRevs++;
         LastCrankEventTime += (uint16_t)(1024.0 / (((double)(Cadence.value())) / 60.0));
@@ -301,8 +215,7 @@ void ftmsbike::characteristicChanged(const QLowEnergyCharacteristic &characteris
 
     lastRefreshCharacteristicChanged = QDateTime::currentDateTime();
 
-    if (heartRateBeltName.startsWith(QStringLiteral("Disabled")) &&
-        (!Flags.heartRate || Heart.value() == 0 || disable_hr_frommachinery)) {
+    if (settings->heart_rate_belt_disabled && (!heartFromMachinery || Heart.value() == 0)) {
 #ifdef Q_OS_IOS
 #ifndef IO_UNDER_QT
         lockscreen h;
@@ -317,9 +230,7 @@ void ftmsbike::characteristicChanged(const QLowEnergyCharacteristic &characteris
 
 #ifdef Q_OS_IOS
 #ifndef IO_UNDER_QT
-    bool cadence = settings.value("bike_cadence_sensor", false).toBool();
-    bool ios_peloton_workaround = settings.value("ios_peloton_workaround", true).toBool();
-    if (ios_peloton_workaround && cadence && h && firstStateChanged) {
+    if (settings->ios_peloton_workaround && settings->bike_cadence_sensor && h && firstStateChanged) {
         h->virtualbike_setCadence(currentCrankRevolutions(), lastCrankEventTime());
         h->virtualbike_setHeartRate((uint8_t)metrics_override_heartrate());
     }
@@ -409,6 +320,8 @@ void ftmsbike::stateChanged(QLowEnergyService::ServiceState state) {
                     qDebug() << QStringLiteral("FTMS service and Control Point found");
                     gattWriteCharControlPointId = c;
                     gattFTMSService = s;
+                    connect(s, &QLowEnergyService::characteristicChanged, writeQueue(),
+                            &blewritequeue::responseReceived);
                 }
             }
         }
@@ -438,7 +351,7 @@ void ftmsbike::stateChanged(QLowEnergyService::ServiceState state) {
             if (virtual_device_enabled) {
             emit debug(QStringLiteral("creating virtual bike interface..."));
             virtualBike =
-                new virtualbike(this, noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                virtualbike::create(this, noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
             // connect(virtualBike,&virtualbike::debug ,this,&ftmsbike::debug);
             connect(virtualBike, &virtualbike::changeInclination, this, &ftmsbike::changeInclination);
             connect(virtualBike, &virtualbike::ftmsCharacteristicChanged, this, &ftmsbike::ftmsCharacteristicChanged);
@@ -470,7 +383,7 @@ void ftmsbike::descriptorRead(const QLowEnergyDescriptor &descriptor, const QByt
 
 void ftmsbike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void ftmsbike::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
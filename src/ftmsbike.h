@@ -77,7 +77,7 @@ class ftmsbike : public bike {
 
   private:
     void writeCharacteristic(uint8_t *data, uint8_t data_len, const QString &info, bool disable_log = false,
-                             bool wait_for_response = false);
+                             bool wait_for_response = false, int coalesce = blewritequeue::NO_COALESCE);
     void startDiscover();
     uint16_t watts();
     void forceResistance(int8_t requestResistance);
@@ -87,7 +87,7 @@ class ftmsbike : public bike {
 
     QList<QLowEnergyService *> gattCommunicationChannelService;
     QLowEnergyCharacteristic gattWriteCharControlPointId;
-    QLowEnergyService *gattFTMSService;
+    QLowEnergyService *gattFTMSService = nullptr;
 
     uint8_t sec1Update = 0;
     QByteArray lastPacket;
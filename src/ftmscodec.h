@@ -0,0 +1,258 @@
+#ifndef FTMSCODEC_H
+#define FTMSCODEC_H
+
+#include <QByteArray>
+#include <array>
+#include <cstdint>
+
+// Data characteristics of the Fitness Machine Service: Indoor Bike (0x2AD2), Treadmill (0x2ACD), Rower (0x2AD1)
+// and Cross Trainer (0x2ACE). A frame starts with its flags, then every flag bit announces a group of little endian
+// fields, in the order of the specification; the first group (bit 0, More Data) is there when its bit is clear.
+// The layout of each characteristic is a constexpr table of fields, so the frame sizes are known at compile time:
+// frame<machine> decodes into fixed storage, without allocating and without reading past the end of the frame,
+// and encodes the fields that were set, for the virtual devices.
+namespace ftms {
+
+struct field {
+    uint8_t bit;  // flag bit of the group
+    uint8_t size; // bytes
+    bool isSigned;
+};
+
+constexpr bool present(const field &f, uint32_t flags) { return f.bit ? (flags >> f.bit) & 1 : !(flags & 1); }
+
+struct indoorbike {
+    static constexpr uint16_t uuid = 0x2AD2;
+    static constexpr int flagsSize = 2;
+    enum id {
+        instantSpeed, // 0.01 km/h
+        averageSpeed,
+        instantCadence, // 0.5 rpm
+        averageCadence,
+        totalDistance, // m
+        resistanceLevel,
+        instantPower, // W
+        averagePower,
+        totalEnergy, // kcal
+        energyPerHour,
+        energyPerMinute,
+        heartRate, // bpm
+        metabolicEquivalent,
+        elapsedTime, // s
+        remainingTime,
+        count
+    };
+    static constexpr field fields[count] = {
+        {0, 2, false},  {1, 2, false}, {2, 2, false}, {3, 2, false}, {4, 3, false},
+        {5, 2, true},   {6, 2, true},  {7, 2, true},  {8, 2, false}, {8, 2, false},
+        {8, 1, false},  {9, 1, false}, {10, 1, false}, {11, 2, false}, {12, 2, false},
+    };
+};
+
+struct treadmill {
+    static constexpr uint16_t uuid = 0x2ACD;
+    static constexpr int flagsSize = 2;
+    enum id {
+        instantSpeed, // 0.01 km/h
+        averageSpeed,
+        totalDistance, // m
+        inclination,   // 0.1 %
+        rampAngle,     // 0.1 degree
+        positiveElevationGain,
+        negativeElevationGain,
+        instantPace, // 0.1 km/min
+        averagePace,
+        totalEnergy, // kcal
+        energyPerHour,
+        energyPerMinute,
+        heartRate, // bpm
+        metabolicEquivalent,
+        elapsedTime, // s
+        remainingTime,
+        forceOnBelt,
+        powerOutput,
+        count
+    };
+    static constexpr field fields[count] = {
+        {0, 2, false},  {1, 2, false}, {2, 3, false}, {3, 2, true},   {3, 2, true},   {4, 2, false},
+        {4, 2, false},  {5, 1, false}, {6, 1, false}, {7, 2, false},  {7, 2, false},  {7, 1, false},
+        {8, 1, false},  {9, 1, false}, {10, 2, false}, {11, 2, false}, {12, 2, true}, {12, 2, true},
+    };
+};
+
+struct rower {
+    static constexpr uint16_t uuid = 0x2AD1;
+    static constexpr int flagsSize = 2;
+    enum id {
+        strokeRate, // 0.5 strokes/min
+        strokeCount,
+        averageStrokeRate,
+        totalDistance, // m
+        instantPace,   // s/500m
+        averagePace,
+        instantPower, // W
+        averagePower,
+        resistanceLevel,
+        totalEnergy, // kcal
+        energyPerHour,
+        energyPerMinute,
+        heartRate, // bpm
+        metabolicEquivalent,
+        elapsedTime, // s
+        remainingTime,
+        count
+    };
+    static constexpr field fields[count] = {
+        {0, 1, false},  {0, 2, false}, {1, 1, false}, {2, 3, false}, {3, 2, false},  {4, 2, false},
+        {5, 2, true},   {6, 2, true},  {7, 2, true},  {8, 2, false}, {8, 2, false},  {8, 1, false},
+        {9, 1, false},  {10, 1, false}, {11, 2, false}, {12, 2, false},
+    };
+};
+
+struct crosstrainer {
+    static constexpr uint16_t uuid = 0x2ACE;
+    static constexpr int flagsSize = 3; // bit 15 is the movement direction, without a field
+    enum id {
+        instantSpeed, // 0.01 km/h
+        averageSpeed,
+        totalDistance, // m
+        stepsPerMinute,
+        averageStepRate,
+        strideCount,
+        positiveElevationGain,
+        negativeElevationGain,
+        inclination, // 0.1 %
+        rampAngle,   // 0.1 degree
+        resistanceLevel,
+        instantPower, // W
+        averagePower,
+        totalEnergy, // kcal
+        energyPerHour,
+        energyPerMinute,
+        heartRate, // bpm
+        metabolicEquivalent,
+        elapsedTime, // s
+        remainingTime,
+        count
+    };
+    static constexpr field fields[count] = {
+        {0, 2, false},  {1, 2, false},  {2, 3, false},  {3, 2, false},  {3, 2, false},
+        {4, 2, false},  {5, 2, false},  {5, 2, false},  {6, 2, true},   {6, 2, true},
+        {7, 2, true},   {8, 2, true},   {9, 2, true},   {10, 2, false}, {10, 2, false},
+        {10, 1, false}, {11, 1, false}, {12, 1, false}, {13, 2, false}, {14, 2, false},
+    };
+};
+
+// bytes of a frame with these flags
+template <typename machine> constexpr int frameSize(uint32_t flags) {
+    int size = machine::flagsSize;
+    for (const field &f : machine::fields) {
+        if (present(f, flags)) {
+            size += f.size;
+        }
+    }
+    return size;
+}
+
+// bytes of a frame with every field
+template <typename machine> constexpr int maxFrameSize() { return frameSize<machine>(~1u); }
+
+static_assert(frameSize<indoorbike>(0x0264) == 11, "speed, cadence, resistance, power, heart rate");
+static_assert(frameSize<treadmill>(0x0108) == 9, "speed, inclination and ramp, heart rate");
+static_assert(frameSize<rower>(0x02A0) == 10, "strokes, power, resistance, heart rate");
+static_assert(maxFrameSize<indoorbike>() == 30 && maxFrameSize<treadmill>() == 34 && maxFrameSize<rower>() == 30 &&
+                  maxFrameSize<crosstrainer>() == 41,
+              "layouts of the specification");
+
+template <typename machine> class frame {
+    static_assert(machine::count <= 32, "one presence bit per field");
+
+  public:
+    using id = typename machine::id;
+
+    bool decode(const QByteArray &data) {
+        return decode(reinterpret_cast<const uint8_t *>(data.constData()), data.size());
+    }
+
+    // false when the frame is shorter than its flags announce: the fields before the end are still decoded
+    bool decode(const uint8_t *data, int length) {
+        m_present = 0;
+        m_values.fill(0);
+        m_flags = 0;
+        if (length < machine::flagsSize) {
+            return false;
+        }
+        for (int i = 0; i < machine::flagsSize; i++) {
+            m_flags |= (uint32_t)data[i] << (8 * i);
+        }
+        int offset = machine::flagsSize;
+        for (int i = 0; i < machine::count; i++) {
+            const field &f = machine::fields[i];
+            if (!present(f, m_flags)) {
+                continue;
+            }
+            if (offset + f.size > length) {
+                return false;
+            }
+            m_values[i] = read(data + offset, f);
+            m_present |= 1u << i;
+            offset += f.size;
+        }
+        return true;
+    }
+
+    // the fields of a group that aren't set are encoded as 0
+    QByteArray encode() const {
+        char buffer[maxFrameSize<machine>()];
+        int offset = 0;
+        for (int i = 0; i < machine::flagsSize; i++) {
+            buffer[offset++] = (char)((m_flags >> (8 * i)) & 0xFF);
+        }
+        for (int i = 0; i < machine::count; i++) {
+            const field &f = machine::fields[i];
+            if (!present(f, m_flags)) {
+                continue;
+            }
+            for (int b = 0; b < f.size; b++) {
+                buffer[offset++] = (char)(((uint32_t)m_values[i] >> (8 * b)) & 0xFF);
+            }
+        }
+        return QByteArray(buffer, offset);
+    }
+
+    void set(id i, int32_t value) {
+        m_values[i] = value;
+        m_present |= 1u << i;
+        const uint8_t bit = machine::fields[i].bit;
+        if (bit) {
+            m_flags |= 1u << bit;
+        } else {
+            m_flags &= ~1u;
+        }
+    }
+
+    bool has(id i) const { return m_present & (1u << i); }
+    // raw value, in the unit of the specification; 0 if the frame doesn't have it
+    int32_t value(id i) const { return m_values[i]; }
+    uint32_t flags() const { return m_flags; }
+
+  private:
+    static int32_t read(const uint8_t *p, const field &f) {
+        uint32_t v = 0;
+        for (int b = 0; b < f.size; b++) {
+            v |= (uint32_t)p[b] << (8 * b);
+        }
+        if (f.isSigned && (v >> (8 * f.size - 1)) & 1) {
+            v |= ~0u << (8 * f.size);
+        }
+        return (int32_t)v;
+    }
+
+    uint32_t m_flags = 1; // More Data: nothing of the first group
+    uint32_t m_present = 0;
+    std::array<int32_t, machine::count> m_values{};
+};
+
+} // namespace ftms
+
+#endif // FTMSCODEC_H
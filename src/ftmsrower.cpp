@@ -1,6 +1,8 @@
 #include "ftmsrower.h"
 #include "ftmsbike.h"
+#include "ftmscodec.h"
 #include "ios/lockscreen.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -45,8 +47,7 @@ void ftmsrower::writeCharacteristic(uint8_t *data, uint8_t data_len, const QStri
     gattFTMSService->writeCharacteristic(gattWriteCharControlPointId, QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -133,73 +134,43 @@ void ftmsrower::characteristicChanged(const QLowEnergyCharacteristic &characteri
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    qDebug() << QStringLiteral(" << ") << characteristic.uuid() << " " << newValue.toHex(' ');
+    packettrace::rx(this, newValue, characteristic.uuid());
 
-    if (characteristic.uuid() != QBluetoothUuid((quint16)0x2AD1)) {
+    if (characteristic.uuid() != QBluetoothUuid(ftms::rower::uuid)) {
         return;
     }
 
     lastPacket = newValue;
 
-    union flags {
-        struct {
-
-            uint16_t moreData : 1;
-            uint16_t avgStroke : 1;
-            uint16_t totDistance : 1;
-            uint16_t instantPace : 1;
-            uint16_t avgPace : 1;
-            uint16_t instantPower : 1;
-            uint16_t avgPower : 1;
-            uint16_t resistanceLvl : 1;
-            uint16_t expEnergy : 1;
-            uint16_t heartRate : 1;
-            uint16_t metabolic : 1;
-            uint16_t elapsedTime : 1;
-            uint16_t remainingTime : 1;
-            uint16_t spare : 3;
-        };
-
-        uint16_t word_flags;
-    };
-
-    flags Flags;
-    int index = 0;
-    Flags.word_flags = (newValue.at(1) << 8) | newValue.at(0);
-    index += 2;
-
-    if (!Flags.moreData) {
-
-        Cadence = ((uint8_t)newValue.at(index)) / 2;
-        StrokesCount =
-            (((uint16_t)((uint8_t)newValue.at(index + 2)) << 8) | (uint16_t)((uint8_t)newValue.at(index + 1)));
-
-        index += 3;
+    ftms::frame<ftms::rower> frame;
+    if (!frame.decode(newValue)) {
+        emit debug(QStringLiteral("Rower Data shorter than its flags ") + QString::number(frame.flags(), 16));
+    }
+    using field = ftms::rower;
+
+    if (frame.has(field::strokeRate)) {
 
+        Cadence = frame.value(field::strokeRate) / 2;
         /*
          * the concept 2 sends the pace in 2 frames, so this condition will create a bugus speed
-        if (!Flags.instantPace) {
+        if (!frame.has(field::instantPace)) {
             // eredited by echelon rower, probably we need to change this
             Speed = (0.37497622 * ((double)Cadence.value())) / 2.0;
             emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
         }*/
+    }
+    if (frame.has(field::strokeCount)) {
+        StrokesCount = frame.value(field::strokeCount);
         emit debug(QStringLiteral("Strokes Count: ") + QString::number(StrokesCount.value()));
     }
 
-    if (Flags.avgStroke) {
-
-        double avgStroke;
-        avgStroke = ((double)(uint16_t)((uint8_t)newValue.at(index))) / 2.0;
-        index += 1;
-        emit debug(QStringLiteral("Current Average Stroke: ") + QString::number(avgStroke));
+    if (frame.has(field::averageStrokeRate)) {
+        emit debug(QStringLiteral("Current Average Stroke: ") +
+                   QString::number(frame.value(field::averageStrokeRate) / 2.0));
     }
 
-    if (Flags.totDistance) {
-        Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-                              (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                             (uint32_t)((uint8_t)newValue.at(index)))) /
-                   1000.0;
-        index += 3;
+    if (frame.has(field::totalDistance)) {
+        Distance = frame.value(field::totalDistance) / 1000.0;
     } else {
         Distance += ((Speed.value() / 3600000.0) *
                      ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
@@ -207,12 +178,9 @@ void ftmsrower::characteristicChanged(const QLowEnergyCharacteristic &characteri
 
     emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
-    if (Flags.instantPace) {
+    if (frame.has(field::instantPace)) {
 
-        double instantPace;
-        instantPace =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
+        double instantPace = frame.value(field::instantPace);
         emit debug(QStringLiteral("Current Pace: ") + QString::number(instantPace));
 
         Speed = (60.0 / instantPace) *
@@ -220,49 +188,27 @@ void ftmsrower::characteristicChanged(const QLowEnergyCharacteristic &characteri
         emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
     }
 
-    if (Flags.avgPace) {
-
-        double avgPace;
-        avgPace =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        emit debug(QStringLiteral("Current Average Pace: ") + QString::number(avgPace));
+    if (frame.has(field::averagePace)) {
+        emit debug(QStringLiteral("Current Average Pace: ") + QString::number(frame.value(field::averagePace)));
     }
 
-    if (Flags.instantPower) {
-        m_watt =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
+    if (frame.has(field::instantPower)) {
+        m_watt = frame.value(field::instantPower);
         emit debug(QStringLiteral("Current Watt: ") + QString::number(m_watt.value()));
     }
 
-    if (Flags.avgPower) {
-
-        double avgPower;
-        avgPower =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        emit debug(QStringLiteral("Current Average Watt: ") + QString::number(avgPower));
+    if (frame.has(field::averagePower)) {
+        emit debug(QStringLiteral("Current Average Watt: ") + QString::number(frame.value(field::averagePower)));
     }
 
-    if (Flags.resistanceLvl) {
-        Resistance =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
+    if (frame.has(field::resistanceLevel)) {
+        Resistance = frame.value(field::resistanceLevel);
         emit resistanceRead(Resistance.value());
-        index += 2;
         emit debug(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
     }
 
-    if (Flags.expEnergy) {
-
-        KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-
-        // energy per hour
-        index += 2;
-
-        // energy per minute
-        index += 1;
+    if (frame.has(field::totalEnergy)) {
+        KCal = frame.value(field::totalEnergy);
     } else {
         if (watts())
             KCal +=
@@ -282,31 +228,14 @@ void ftmsrower::characteristicChanged(const QLowEnergyCharacteristic &characteri
     else
 #endif
     {
-        if (Flags.heartRate) {
-            if (index < newValue.length()) {
-                Heart = ((double)((newValue.at(index))));
-                // index += 1; //NOTE: clang-analyzer-deadcode.DeadStores
-                emit debug(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
-            } else
-                emit debug(QStringLiteral("Error on parsing heart"));
+        if (frame.has(field::heartRate)) {
+            Heart = frame.value(field::heartRate);
+            emit debug(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
+        } else if (frame.flags() & (1 << 9)) {
+            emit debug(QStringLiteral("Error on parsing heart"));
         }
     }
 
-    if (Flags.metabolic) {
-
-        // todo
-    }
-
-    if (Flags.elapsedTime) {
-
-        // todo
-    }
-
-    if (Flags.remainingTime) {
-
-        // todo
-    }
-
     if (Cadence.value() > 0) {
 
         CrankRevs++;
@@ -461,7 +390,7 @@ void ftmsrower::stateChanged(QLowEnergyService::ServiceState state) {
             if (virtual_device_enabled) {
             emit debug(QStringLiteral("creating virtual bike interface..."));
 
-            virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
+            virtualBike = virtualbike::create(this, noWriteResistance, noHeartService);
             // connect(virtualBike,&virtualbike::debug ,this,&ftmsrower::debug);
         }
     }
@@ -483,7 +412,7 @@ void ftmsrower::descriptorRead(const QLowEnergyDescriptor &descriptor, const QBy
 void ftmsrower::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
 
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void ftmsrower::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -1,65 +1,146 @@
 #include "gpx.h"
 #include "math.h"
 #include "qdebugfixup.h"
-#include <QDomDocument>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 
 gpx::gpx(QObject *parent) : QObject(parent) {}
 
+// the route computed from a gpx file is cached, so opening the same file again doesn't parse it
+static const char cacheMagic[] = "QZGPX2";
+
+static QString cacheFileName(const QFileInfo &info) {
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/gpx/");
+    return dir + QString::fromLatin1(
+                     QCryptographicHash::hash(info.absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex()) +
+           QStringLiteral(".route");
+}
+
+// bytes of a point in the cache, QDataStream writes the floats as doubles
+static const qint64 cachePointSize = sizeof(quint32) + 5 * sizeof(double);
+
+static bool readCache(const QFileInfo &info, QList<gpx_altitude_point_for_treadmill> &list) {
+    QFile cache(cacheFileName(info));
+    if (!cache.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&cache);
+    QByteArray magic;
+    qint64 size;
+    QDateTime modified;
+    quint32 count;
+    in >> magic >> size >> modified >> count;
+    // the cache is valid only for the same version of the file
+    if (in.status() != QDataStream::Ok || magic != cacheMagic || size != info.size() ||
+        modified != info.lastModified()) {
+        return false;
+    }
+    // count comes from the file: a damaged cache can't reserve more points than the bytes left can hold
+    list.reserve(static_cast<int>(qMin<qint64>(count, (cache.size() - cache.pos()) / cachePointSize)));
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        gpx_altitude_point_for_treadmill g;
+        in >> g.seconds >> g.inclination >> g.speed >> g.latitude >> g.longitude >> g.distance;
+        list.append(g);
+    }
+    if (in.status() != QDataStream::Ok) {
+        list.clear();
+        return false;
+    }
+    return true;
+}
+
+static void writeCache(const QFileInfo &info, const QList<gpx_altitude_point_for_treadmill> &list) {
+    QString fileName = cacheFileName(info);
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QFile cache(fileName);
+    if (!cache.open(QIODevice::WriteOnly)) {
+        qDebug() << QStringLiteral("gpx cache not writable") << fileName;
+        return;
+    }
+    QDataStream out(&cache);
+    out << QByteArray(cacheMagic) << info.size() << info.lastModified() << static_cast<quint32>(list.count());
+    for (const gpx_altitude_point_for_treadmill &g : list) {
+        out << g.seconds << g.inclination << g.speed << g.latitude << g.longitude << g.distance;
+    }
+}
+
 QList<gpx_altitude_point_for_treadmill> gpx::open(const QString &gpx) {
+    const QFileInfo info(gpx);
+    QList<gpx_altitude_point_for_treadmill> inclinationList;
+    if (readCache(info, inclinationList)) {
+        qDebug() << QStringLiteral("gpx loaded from cache") << gpx << inclinationList.count();
+        return inclinationList;
+    }
+
     QFile input(gpx);
     input.open(QIODevice::ReadOnly);
-    QDomDocument doc;
-    doc.setContent(&input);
-    QDomNodeList points = doc.elementsByTagName(QStringLiteral("trkpt"));
-    for (int i = 0; i < points.size(); i++) {
-        QDomNode point = points.item(i);
-        QDomNamedNodeMap att = point.attributes();
-        QString lat = att.namedItem(QStringLiteral("lat")).nodeValue();
-        QString lon = att.namedItem(QStringLiteral("lon")).nodeValue();
-        QDomElement ele = point.firstChildElement(QStringLiteral("ele"));
-        QDomElement time = point.firstChildElement(QStringLiteral("time"));
-        gpx_point g;
-        // 2020-10-10T10:54:45
-        g.time = QDateTime::fromString(time.text(), Qt::ISODate);
-        g.p.setAltitude(ele.text().toFloat());
-        g.p.setLatitude(lat.toFloat());
-        g.p.setLongitude(lon.toFloat());
-        this->points.append(g);
-    }
 
+    // single pass on the file: a point is only compared with the last one added to the list, so the track isn't
+    // kept in memory
     const uint8_t secondsInclination = 60;
-    QList<gpx_altitude_point_for_treadmill> inclinationList;
+    bool first = true;
+    gpx_point pP;
 
-    if (this->points.isEmpty()) {
-        return inclinationList;
-    }
+    QXmlStreamReader stream(&input);
+    while (!stream.atEnd()) {
+        if (stream.readNext() != QXmlStreamReader::StartElement || stream.name() != QLatin1String("trkpt")) {
+            continue;
+        }
 
-    gpx_point pP = this->points.constFirst();
+        gpx_point g;
+        g.p.setLatitude(stream.attributes().value(QStringLiteral("lat")).toDouble());
+        g.p.setLongitude(stream.attributes().value(QStringLiteral("lon")).toDouble());
+        g.p.setAltitude(0);
+        while (stream.readNextStartElement()) {
+            if (stream.name() == QLatin1String("ele")) {
+                g.p.setAltitude(stream.readElementText().toDouble());
+            } else if (stream.name() == QLatin1String("time")) {
+                // 2020-10-10T10:54:45
+                g.time = QDateTime::fromString(stream.readElementText(), Qt::ISODate);
+            } else {
+                stream.skipCurrentElement();
+            }
+        }
+
+        if (first) {
+            pP = g;
+            first = false;
+            continue;
+        }
 
-    for (int32_t i = 1; i < this->points.count(); i++) {
-        qint64 dT = qAbs(pP.time.secsTo(this->points.at(i).time));
+        qint64 dT = qAbs(pP.time.secsTo(g.time));
         if (dT < secondsInclination) {
             continue;
         }
 
-        double distance = this->points.at(i).p.distanceTo(pP.p);
-        double elevation = this->points.at(i).p.altitude() - pP.p.altitude();
+        double distance = g.p.distanceTo(pP.p);
+        double elevation = g.p.altitude() - pP.p.altitude();
 
-        pP = this->points[i];
+        pP = g;
 
-        gpx_altitude_point_for_treadmill g;
-        g.seconds = dT;
-        g.speed = (distance / 1000.0) * (3600 / dT);
-        g.inclination = (elevation / distance) * 100;
-        g.latitude = pP.p.latitude();
-        g.longitude = pP.p.longitude();
-        inclinationList.append(g);
+        gpx_altitude_point_for_treadmill a;
+        a.seconds = dT;
+        a.speed = (distance / 1000.0) * (3600 / dT);
+        a.inclination = (elevation / distance) * 100;
+        a.latitude = pP.p.latitude();
+        a.longitude = pP.p.longitude();
+        a.distance = distance;
+        inclinationList.append(a);
+    }
+    if (stream.hasError()) {
+        qDebug() << QStringLiteral("gpx parse error") << gpx << stream.errorString();
+    } else {
+        writeCache(info, inclinationList);
     }
     return inclinationList;
 }
 
-void gpx::save(const QString &filename, QList<SessionLine> session, bluetoothdevice::BLUETOOTH_TYPE type) {
+void gpx::save(const QString &filename, const sessionstore &session, bluetoothdevice::BLUETOOTH_TYPE type) {
     if (session.isEmpty()) {
         return;
     }
@@ -108,7 +189,8 @@ void gpx::save(const QString &filename, QList<SessionLine> session, bluetoothdev
     }
 
     stream.writeStartElement(QStringLiteral("trkseg"));
-    for (const SessionLine &s : qAsConst(session)) {
+    for (int i = 0; i < session.count(); i++) {
+        const SessionLine s = session.at(i);
         if (s.speed > 0) {
             stream.writeStartElement(QStringLiteral("trkpt"));
             stream.writeAttribute(QStringLiteral("lat"), QStringLiteral("0"));
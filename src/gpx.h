@@ -3,6 +3,7 @@
 
 #include "bluetoothdevice.h"
 #include "sessionline.h"
+#include "sessionstore.h"
 #include <QFile>
 #include <QGeoCoordinate>
 #include <QObject>
@@ -15,6 +16,7 @@ class gpx_altitude_point_for_treadmill {
     float speed;
     double latitude;
     double longitude;
+    double distance; // meters from the previous point
 };
 
 class gpx_point {
@@ -28,10 +30,7 @@ class gpx : public QObject {
   public:
     explicit gpx(QObject *parent = nullptr);
     QList<gpx_altitude_point_for_treadmill> open(const QString &gpx);
-    static void save(const QString &filename, QList<SessionLine> session, bluetoothdevice::BLUETOOTH_TYPE type);
-
-  private:
-    QList<gpx_point> points;
+    static void save(const QString &filename, const sessionstore &session, bluetoothdevice::BLUETOOTH_TYPE type);
 
   signals:
 };
@@ -1,4 +1,5 @@
 #include "heartratebelt.h"
+#include "packettrace.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
 #include <QEventLoop>
@@ -28,7 +29,7 @@ void heartratebelt::characteristicChanged(const QLowEnergyCharacteristic &charac
     Q_UNUSED(characteristic);
     emit packetReceived();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     if (newValue.length() > 1) {
         Heart = (uint8_t)newValue[1];
@@ -77,7 +78,7 @@ void heartratebelt::descriptorWritten(const QLowEnergyDescriptor &descriptor, co
 
 void heartratebelt::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void heartratebelt::serviceScanDone(void) {
@@ -8,7 +8,8 @@
 
 using namespace std::chrono_literals;
 
-homefitnessbuddy::homefitnessbuddy(bluetooth *bl, QObject *parent) : QObject(parent) {
+homefitnessbuddy::homefitnessbuddy(bluetooth *bl, QObject *parent)
+    : QObject(parent), cache(QStringLiteral("homefitnessbuddy")) {
 
     QSettings settings;
     bluetoothManager = bl;
@@ -32,6 +33,7 @@ void homefitnessbuddy::startEngine() {
 
     // request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     request.setHeader(QNetworkRequest::UserAgentHeader, QStringLiteral("qdomyos-zwift"));
+    cache.prepare(request);
 
     mgr->get(request);
 }
@@ -42,7 +44,14 @@ void homefitnessbuddy::error(QNetworkReply::NetworkError code) {
 
 void homefitnessbuddy::login_onfinish(QNetworkReply *reply) {
     disconnect(mgr, &QNetworkAccessManager::finished, this, &homefitnessbuddy::login_onfinish);
-    QByteArray payload = reply->readAll(); // JSON
+    QNetworkRequest request;
+    if (cache.resend(reply, request)) {
+        connect(mgr, &QNetworkAccessManager::finished, this, &homefitnessbuddy::login_onfinish);
+        mgr->get(request);
+        return;
+    }
+    // the list of the classes seen last time is still used when the site can't be reached
+    QByteArray payload = cache.body(reply); // JSON
 
     qDebug() << QStringLiteral("login_onfinish") << payload;
 
@@ -120,6 +129,7 @@ void homefitnessbuddy::searchWorkout(QDate date, const QString &coach) {
 
             // request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
             request.setHeader(QNetworkRequest::UserAgentHeader, QStringLiteral("qdomyos-zwift"));
+            cache.prepare(request);
 
             mgr->get(request);
             return;
@@ -129,7 +139,13 @@ void homefitnessbuddy::searchWorkout(QDate date, const QString &coach) {
 
 void homefitnessbuddy::search_workout_onfinish(QNetworkReply *reply) {
     disconnect(mgr, &QNetworkAccessManager::finished, this, &homefitnessbuddy::search_workout_onfinish);
-    QByteArray payload = reply->readAll(); // JSON
+    QNetworkRequest request;
+    if (cache.resend(reply, request)) {
+        connect(mgr, &QNetworkAccessManager::finished, this, &homefitnessbuddy::search_workout_onfinish);
+        mgr->get(request);
+        return;
+    }
+    QByteArray payload = cache.body(reply); // JSON
 
     qDebug() << QStringLiteral("search_workout_onfinish") << payload;
 
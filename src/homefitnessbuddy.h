@@ -2,6 +2,7 @@
 #define HOMEFITNESSBUDDY_H
 
 #include "bluetooth.h"
+#include "httpcache.h"
 #include "trainprogram.h"
 #include <QAbstractOAuth2>
 #include <QDesktopServices>
@@ -30,6 +31,7 @@ class homefitnessbuddy : public QObject {
     const int peloton_workout_second_resolution = 10;
 
     QNetworkAccessManager *mgr = nullptr;
+    httpcache cache;
     bluetooth *bluetoothManager = nullptr;    
 
     QJsonArray lessons;
@@ -1,9 +1,11 @@
 #include "homeform.h"
+#include "appdir.h"
 #include "gpx.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
 #include "material.h"
 #include "qfit.h"
+#include "settingssnapshot.h"
 #include "templateinfosenderbuilder.h"
 
 #include <QAbstractOAuth2>
@@ -24,6 +26,7 @@
 #include <QStandardPaths>
 #include <QTime>
 #include <QUrlQuery>
+#include <algorithm>
 #include <chrono>
 
 using namespace std::chrono_literals;
@@ -67,34 +70,51 @@ DataObject::DataObject(const QString &name, const QString &icon, const QString &
 }
 
 void DataObject::setName(const QString &v) {
+    if (m_name == v)
+        return;
     m_name = v;
     emit nameChanged(m_name);
 }
+// the setters only notify real changes: most of the tiles get the same text at every update
 void DataObject::setValue(const QString &v) {
+    if (m_value == v)
+        return;
     m_value = v;
     emit valueChanged(m_value);
 }
 void DataObject::setSecondLine(const QString &value) {
+    if (m_secondLine == value)
+        return;
     m_secondLine = value;
     emit secondLineChanged(m_secondLine);
 }
 void DataObject::setValueFontSize(int value) {
+    if (m_valueFontSize == value)
+        return;
     m_valueFontSize = value;
     emit valueFontSizeChanged(m_valueFontSize);
 }
 void DataObject::setValueFontColor(const QString &value) {
+    if (m_valueFontColor == value)
+        return;
     m_valueFontColor = value;
     emit valueFontColorChanged(m_valueFontColor);
 }
 void DataObject::setLabelFontSize(int value) {
+    if (m_labelFontSize == value)
+        return;
     m_labelFontSize = value;
     emit labelFontSizeChanged(m_labelFontSize);
 }
 void DataObject::setGridId(int id) {
+    if (m_gridId == id)
+        return;
     m_gridId = id;
     emit gridIdChanged(m_gridId);
 }
 void DataObject::setVisible(bool visible) {
+    if (m_visible == visible)
+        return;
     m_visible = visible;
     emit visibleChanged(m_visible);
 }
@@ -250,6 +270,13 @@ homeform::homeform(QQmlApplicationEngine *engine, bluetooth *bl) {
     connect(bluetoothManager->getInnerTemplateManager(), &TemplateInfoSenderBuilder::activityDescriptionChanged, this,
             &homeform::setActivityDescription);
     engine->rootContext()->setContextProperty(QStringLiteral("rootItem"), (QObject *)this);
+    tilesModel = new tilemodel(this);
+    engine->rootContext()->setContextProperty(QStringLiteral("appModel"), tilesModel);
+
+    exportQueue = new exportqueue(this);
+    connect(exportQueue, &exportqueue::progress, this, &homeform::exportProgress);
+    connect(exportQueue, &exportqueue::finished, this, &homeform::exportFinished);
+    connect(exportQueue, &exportqueue::uploadRequested, this, &homeform::strava_upload_file);
 
     this->trainProgram = new trainprogram(QList<trainrow>(), bl);
 
@@ -261,6 +288,15 @@ homeform::homeform(QQmlApplicationEngine *engine, bluetooth *bl) {
     connect(backupTimer, &QTimer::timeout, this, &homeform::backup);
     backupTimer->start(1min);
 
+    settingsReloadTimer = new QTimer(this);
+    settingsReloadTimer->setSingleShot(true);
+    settingsReloadTimer->setInterval(1s);
+    connect(settingsReloadTimer, &QTimer::timeout, this, [this]() {
+        settingssnapshot::reload();
+        tilesModel->reloadSettings();
+        sortTiles();
+    });
+
     QObject *rootObject = engine->rootObjects().constFirst();
     QObject *home = rootObject->findChild<QObject *>(QStringLiteral("home"));
     QObject *stack = rootObject;
@@ -312,6 +348,11 @@ void homeform::chartSaved(QString fileName) {
         return;
     chartImagesFilenames.append(fileName);
     if (chartImagesFilenames.length() >= 6) {
+        // the FIT file attached to the mail may still be written
+        if (exportQueue->pendingJobs() > 0) {
+            mailAfterExport = true;
+            return;
+        }
         sendMail();
         chartImagesFilenames.clear();
     }
@@ -408,37 +449,29 @@ void homeform::pelotonWorkoutChanged(const QString &name, const QString &instruc
     emit infoChanged(m_info);
 }
 
-QString homeform::getWritableAppDir() {
-    QString path = QLatin1String("");
-#if defined(Q_OS_ANDROID)
-    path = getAndroidDataAppDir() + "/";
-#elif defined(Q_OS_MACOS) || defined(Q_OS_OSX)
-    path = QStandardPaths::writableLocation(QStandardPaths::DownloadLocation) + "/";
-#elif defined(Q_OS_IOS)
-    path = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/";
-#endif
-    return path;
-}
+QString homeform::getWritableAppDir() { return appdir::writable(); }
 
 void homeform::backup() {
 
-    static uint8_t index = 0;
     qDebug() << QStringLiteral("saving fit file backup...");
 
-    QString path = getWritableAppDir();
     bluetoothdevice *dev = bluetoothManager->device();
     if (dev) {
 
-        QString filename = path + QString::number(index) + backupFitFileName;
-        QFile::remove(filename);
-        qfit::save(filename, Session, dev->deviceType(),
-                   qobject_cast<m3ibike *>(dev) ? QFIT_PROCESS_DISTANCENOISE : QFIT_PROCESS_NONE,
-                   stravaPelotonWorkoutType);
-
-        index++;
-        if (index > 1) {
-            index = 0;
+        // a new session (or device) starts a new backup file, otherwise only the new lines are appended
+        if (fitBackup && (fitBackup->samples() > Session.count() || fitBackup->deviceType() != dev->deviceType())) {
+            delete fitBackup;
+            fitBackup = nullptr;
+        }
+        if (!fitBackup) {
+            const QString path = getWritableAppDir();
+            fitBackup = new qfitwriter(path + QStringLiteral("0") + backupFitFileName,
+                                       path + QStringLiteral("1") + backupFitFileName, dev->deviceType());
         }
+        for (int i = fitBackup->samples(); i < Session.count(); i++) {
+            fitBackup->append(Session.at(i), stravaPelotonWorkoutType);
+        }
+        fitBackup->writeTrailer(stravaPelotonWorkoutType);
     }
 }
 
@@ -470,6 +503,7 @@ homeform::~homeform() {
 
     gpx_save_clicked();
     fit_save_clicked();
+    delete fitBackup;
 }
 
 void homeform::aboutToQuit() {
@@ -550,714 +584,185 @@ void homeform::ftmsAccessoryConnected(smartspin2k *d) {
     connect(this, &homeform::autoResistanceChanged, d, &smartspin2k::autoResistanceChanged);
 }
 
-void homeform::sortTiles() {
+// tiles of the home grid for every device type: tiles in the same position are placed in this order
+const QList<homeform::tiledefinition> &homeform::tileDefinitions(bluetoothdevice::BLUETOOTH_TYPE type) {
+    static const QHash<int, QList<tiledefinition>> definitions = {
+        {bluetoothdevice::TREADMILL,
+         {{"speed", true, "speed", 0, &homeform::speed},
+          {"inclination", true, "inclination", 0, &homeform::inclination},
+          {"elevation", true, "elevation", 0, &homeform::elevation},
+          {"elapsed", true, "elapsed", 0, &homeform::elapsed},
+          {"moving_time", false, "moving_time", 19, &homeform::moving_time},
+          {"peloton_offset", false, "peloton_offset", 20, &homeform::peloton_offset},
+          {"calories", true, "calories", 0, &homeform::calories},
+          {"odometer", true, "odometer", 0, &homeform::odometer},
+          {"pace", true, "pace", 0, &homeform::pace},
+          {"watt", true, "watt", 0, &homeform::watt},
+          {"weight_loss", false, "weight_loss", 24, &homeform::weightLoss},
+          {"avgwatt", true, "avgwatt", 0, &homeform::avgWatt},
+          {"ftp", true, "ftp", 0, &homeform::ftp},
+          {"jouls", true, "jouls", 0, &homeform::jouls},
+          {"heart", true, "heart", 0, &homeform::heart},
+          {"fan", true, "fan", 0, &homeform::fan},
+          {"datetime", true, "datetime", 0, &homeform::datetime},
+          {"lapelapsed", false, "lapelapsed", 18, &homeform::lapElapsed},
+          {"watt_kg", false, "watt_kg", 24, &homeform::wattKg},
+          {"remainingtimetrainprogramrow", false, "remainingtimetrainprogramrow", 27,
+           &homeform::remaningTimeTrainingProgramCurrentRow},
+          {"nextrowstrainprogram", false, "nextrowtrainprogram", 31, &homeform::nextRows},
+          {"mets", false, "mets", 28, &homeform::mets},
+          {"targetmets", false, "targetmets", 29, &homeform::targetMets},
+          {"cadence", true, "cadence", 30, &homeform::cadence}}},
+        {bluetoothdevice::BIKE,
+         {{"speed", true, "speed", 0, &homeform::speed},
+          {"cadence", true, "cadence", 0, &homeform::cadence},
+          {"elevation", true, "elevation", 0, &homeform::elevation},
+          {"elapsed", true, "elapsed", 0, &homeform::elapsed},
+          {"moving_time", false, "moving_time", 19, &homeform::moving_time},
+          {"peloton_offset", false, "peloton_offset", 20, &homeform::peloton_offset},
+          {"calories", true, "calories", 0, &homeform::calories},
+          {"odometer", true, "odometer", 0, &homeform::odometer},
+          {"resistance", true, "resistance", 0, &homeform::resistance},
+          {"peloton_resistance", true, "peloton_resistance", 0, &homeform::peloton_resistance},
+          {"watt", true, "watt", 0, &homeform::watt},
+          {"weight_loss", false, "weight_loss", 24, &homeform::weightLoss},
+          {"avgwatt", true, "avgwatt", 0, &homeform::avgWatt},
+          {"ftp", true, "ftp", 0, &homeform::ftp},
+          {"jouls", true, "jouls", 0, &homeform::jouls},
+          {"heart", true, "heart", 0, &homeform::heart},
+          {"fan", true, "fan", 0, &homeform::fan},
+          {"datetime", true, "datetime", 0, &homeform::datetime},
+          {"target_resistance", true, "target_resistance", 0, &homeform::target_resistance},
+          {"target_peloton_resistance", false, "target_peloton_resistance", 21, &homeform::target_peloton_resistance},
+          {"target_cadence", false, "target_cadence", 19, &homeform::target_cadence},
+          {"target_power", false, "target_power", 20, &homeform::target_power},
+          {"target_zone", false, "target_zone", 24, &homeform::target_zone},
+          {"lapelapsed", false, "lapelapsed", 18, &homeform::lapElapsed},
+          {"watt_kg", false, "watt_kg", 24, &homeform::wattKg},
+          {"gears", false, "gears", 25, &homeform::gears},
+          {"remainingtimetrainprogramrow", false, "remainingtimetrainprogramrow", 27,
+           &homeform::remaningTimeTrainingProgramCurrentRow},
+          {"nextrowstrainprogram", false, "nextrowtrainprogram", 31, &homeform::nextRows},
+          {"mets", false, "mets", 28, &homeform::mets},
+          {"targetmets", false, "targetmets", 29, &homeform::targetMets},
+          {"inclination", true, "inclination", 29, &homeform::inclination, "proform_studio"},
+          {"steering_angle", false, "steering_angle", 30, &homeform::steeringAngle}}},
+        {bluetoothdevice::ROWING,
+         {{"speed", true, "speed", 0, &homeform::speed},
+          {"cadence", true, "cadence", 0, &homeform::cadence},
+          {"elevation", true, "elevation", 0, &homeform::elevation},
+          {"elapsed", true, "elapsed", 0, &homeform::elapsed},
+          {"moving_time", false, "moving_time", 19, &homeform::moving_time},
+          {"peloton_offset", false, "peloton_offset", 20, &homeform::peloton_offset},
+          {"calories", true, "calories", 0, &homeform::calories},
+          {"odometer", true, "odometer", 0, &homeform::odometer},
+          {"resistance", true, "resistance", 0, &homeform::resistance},
+          {"peloton_resistance", true, "peloton_resistance", 0, &homeform::peloton_resistance},
+          {"watt", true, "watt", 0, &homeform::watt},
+          {"weight_loss", false, "weight_loss", 24, &homeform::weightLoss},
+          {"avgwatt", true, "avgwatt", 0, &homeform::avgWatt},
+          {"ftp", true, "ftp", 0, &homeform::ftp},
+          {"jouls", true, "jouls", 0, &homeform::jouls},
+          {"heart", true, "heart", 0, &homeform::heart},
+          {"fan", true, "fan", 0, &homeform::fan},
+          {"datetime", true, "datetime", 0, &homeform::datetime},
+          {"target_resistance", true, "target_resistance", 0, &homeform::target_resistance},
+          {"target_peloton_resistance", false, "target_peloton_resistance", 21, &homeform::target_peloton_resistance},
+          {"target_cadence", false, "target_cadence", 19, &homeform::target_cadence},
+          {"target_power", false, "target_power", 20, &homeform::target_power},
+          {"lapelapsed", false, "lapelapsed", 18, &homeform::lapElapsed},
+          {"strokes_length", false, "strokes_length", 21, &homeform::strokesLength},
+          {"strokes_count", false, "strokes_count", 22, &homeform::strokesCount},
+          {"pace", true, "pace", 0, &homeform::pace},
+          {"watt_kg", false, "watt_kg", 24, &homeform::wattKg},
+          {"remainingtimetrainprogramrow", false, "remainingtimetrainprogramrow", 27,
+           &homeform::remaningTimeTrainingProgramCurrentRow},
+          {"nextrowstrainprogram", false, "nextrowtrainprogram", 31, &homeform::nextRows},
+          {"mets", false, "mets", 28, &homeform::mets},
+          {"targetmets", false, "targetmets", 29, &homeform::targetMets}}},
+        {bluetoothdevice::ELLIPTICAL,
+         {{"speed", true, "speed", 0, &homeform::speed},
+          {"cadence", true, "cadence", 0, &homeform::cadence},
+          {"inclination", true, "inclination", 0, &homeform::inclination},
+          {"elevation", true, "elevation", 0, &homeform::elevation},
+          {"elapsed", true, "elapsed", 0, &homeform::elapsed},
+          {"moving_time", false, "moving_time", 19, &homeform::moving_time},
+          {"peloton_offset", false, "peloton_offset", 20, &homeform::peloton_offset},
+          {"calories", true, "calories", 0, &homeform::calories},
+          {"odometer", true, "odometer", 0, &homeform::odometer},
+          {"resistance", true, "resistance", 0, &homeform::resistance},
+          {"peloton_resistance", true, "peloton_resistance", 0, &homeform::peloton_resistance},
+          {"watt", true, "watt", 0, &homeform::watt},
+          {"weight_loss", false, "weight_loss", 24, &homeform::weightLoss},
+          {"avgwatt", true, "avgwatt", 0, &homeform::avgWatt},
+          {"ftp", true, "ftp", 0, &homeform::ftp},
+          {"jouls", true, "jouls", 0, &homeform::jouls},
+          {"heart", true, "heart", 0, &homeform::heart},
+          {"fan", true, "fan", 0, &homeform::fan},
+          {"datetime", true, "datetime", 0, &homeform::datetime},
+          {"target_resistance", true, "target_resistance", 0, &homeform::target_resistance},
+          {"lapelapsed", false, "lapelapsed", 18, &homeform::lapElapsed},
+          {"watt_kg", false, "watt_kg", 24, &homeform::wattKg},
+          {"remainingtimetrainprogramrow", false, "remainingtimetrainprogramrow", 27,
+           &homeform::remaningTimeTrainingProgramCurrentRow},
+          {"nextrowstrainprogram", false, "nextrowtrainprogram", 31, &homeform::nextRows},
+          {"mets", false, "mets", 28, &homeform::mets},
+          {"targetmets", false, "targetmets", 29, &homeform::targetMets}}},
+    };
+    static const QList<tiledefinition> none;
+    auto d = definitions.constFind(type);
+    return d != definitions.constEnd() ? d.value() : none;
+}
 
-    QSettings settings;
-    bool proform_studio = settings.value(QStringLiteral("proform_studio"), false).toBool();
+void homeform::sortTiles() {
 
     if (!bluetoothManager || !bluetoothManager->device())
         return;
 
-    dataList.clear();
-
-    if (bluetoothManager->device()->deviceType() == bluetoothdevice::TREADMILL) {
-        for (int i = 0; i < 100; i++) {
-            if (settings.value(QStringLiteral("tile_speed_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_speed_order"), 0).toInt() == i) {
-
-                speed->setGridId(i);
-                dataList.append(speed);
-            }
-
-            if (settings.value(QStringLiteral("tile_inclination_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_inclination_order"), 0).toInt() == i) {
-                inclination->setGridId(i);
-                dataList.append(inclination);
-            }
-
-            if (settings.value(QStringLiteral("tile_elevation_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_elevation_order"), 0).toInt() == i) {
-                elevation->setGridId(i);
-                dataList.append(elevation);
-            }
-
-            if (settings.value(QStringLiteral("tile_elapsed_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_elapsed_order"), 0).toInt() == i) {
-                elapsed->setGridId(i);
-                dataList.append(elapsed);
-            }
-
-            if (settings.value(QStringLiteral("tile_moving_time_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_moving_time_order"), 19).toInt() == i) {
-                moving_time->setGridId(i);
-                dataList.append(moving_time);
-            }
-
-            if (settings.value(QStringLiteral("tile_peloton_offset_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_peloton_offset_order"), 20).toInt() == i) {
-                peloton_offset->setGridId(i);
-                dataList.append(peloton_offset);
-            }
-
-            if (settings.value(QStringLiteral("tile_calories_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_calories_order"), 0).toInt() == i) {
-                calories->setGridId(i);
-                dataList.append(calories);
-            }
-
-            if (settings.value(QStringLiteral("tile_odometer_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_odometer_order"), 0).toInt() == i) {
-                odometer->setGridId(i);
-                dataList.append(odometer);
-            }
-
-            if (settings.value(QStringLiteral("tile_pace_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_pace_order"), 0).toInt() == i) {
-                pace->setGridId(i);
-                dataList.append(pace);
-            }
-
-            if (settings.value(QStringLiteral("tile_watt_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_watt_order"), 0).toInt() == i) {
-                watt->setGridId(i);
-                dataList.append(watt);
-            }
-
-            if (settings.value(QStringLiteral("tile_weight_loss_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_weight_loss_order"), 24).toInt() == i) {
-                weightLoss->setGridId(i);
-                dataList.append(weightLoss);
-            }
-
-            if (settings.value(QStringLiteral("tile_avgwatt_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_avgwatt_order"), 0).toInt() == i) {
-                avgWatt->setGridId(i);
-                dataList.append(avgWatt);
-            }
-
-            if (settings.value(QStringLiteral("tile_ftp_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_ftp_order"), 0).toInt() == i) {
-                ftp->setGridId(i);
-                dataList.append(ftp);
-            }
-
-            if (settings.value(QStringLiteral("tile_jouls_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_jouls_order"), 0).toInt() == i) {
-                jouls->setGridId(i);
-                dataList.append(jouls);
-            }
-
-            if (settings.value(QStringLiteral("tile_heart_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_heart_order"), 0).toInt() == i) {
-                heart->setGridId(i);
-                dataList.append(heart);
-            }
-
-            if (settings.value(QStringLiteral("tile_fan_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_fan_order"), 0).toInt() == i) {
-                fan->setGridId(i);
-                dataList.append(fan);
-            }
-
-            if (settings.value(QStringLiteral("tile_datetime_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_datetime_order"), 0).toInt() == i) {
-                datetime->setGridId(i);
-                dataList.append(datetime);
-            }
-
-            if (settings.value(QStringLiteral("tile_lapelapsed_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_lapelapsed_order"), 18).toInt() == i) {
-                lapElapsed->setGridId(i);
-                dataList.append(lapElapsed);
-            }
-
-            if (settings.value(QStringLiteral("tile_watt_kg_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_watt_kg_order"), 24).toInt() == i) {
-                wattKg->setGridId(i);
-                dataList.append(wattKg);
-            }
-
-            if (settings.value(QStringLiteral("tile_remainingtimetrainprogramrow_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_remainingtimetrainprogramrow_order"), 27).toInt() == i) {
-
-                remaningTimeTrainingProgramCurrentRow->setGridId(i);
-                dataList.append(remaningTimeTrainingProgramCurrentRow);
-            }
-
-            if (settings.value(QStringLiteral("tile_nextrowstrainprogram_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_nextrowtrainprogram_order"), 31).toInt() == i) {
-
-                nextRows->setGridId(i);
-                dataList.append(nextRows);
-            }
-
-            if (settings.value(QStringLiteral("tile_mets_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_mets_order"), 28).toInt() == i) {
-
-                mets->setGridId(i);
-                dataList.append(mets);
-            }
-            if (settings.value(QStringLiteral("tile_targetmets_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_targetmets_order"), 29).toInt() == i) {
+    // the layout only depends on the tile settings: it's computed again only when they change
+    bluetoothdevice::BLUETOOTH_TYPE type = bluetoothManager->device()->deviceType();
+    auto snapshot = settingssnapshot::current();
+    if (tilesLayoutSettings == snapshot && tilesLayoutType == type) {
+        return;
+    }
+    tilesLayoutSettings = snapshot;
+    tilesLayoutType = type;
 
-                targetMets->setGridId(i);
-                dataList.append(targetMets);
-            }
-            if (settings.value(QStringLiteral("tile_cadence_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_cadence_order"), 30).toInt() == i) {
-                cadence->setGridId(i);
-                dataList.append(cadence);
-            }
+    QSettings settings;
+    const QList<tiledefinition> &definitions = tileDefinitions(type);
+    QVector<QPair<int, int>> layout; // position, definition
+    layout.reserve(definitions.count());
+    for (int d = 0; d < definitions.count(); d++) {
+        const tiledefinition &t = definitions.at(d);
+        if (t.only && !settings.value(QLatin1String(t.only), false).toBool()) {
+            continue;
         }
-    } else if (bluetoothManager->device()->deviceType() == bluetoothdevice::BIKE) {
-        for (int i = 0; i < 100; i++) {
-            if (settings.value(QStringLiteral("tile_speed_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_speed_order"), 0).toInt() == i) {
-
-                speed->setGridId(i);
-                dataList.append(speed);
-            }
-
-            if (settings.value(QStringLiteral("tile_cadence_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_cadence_order"), 0).toInt() == i) {
-                cadence->setGridId(i);
-                dataList.append(cadence);
-            }
-
-            if (settings.value(QStringLiteral("tile_elevation_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_elevation_order"), 0).toInt() == i) {
-                elevation->setGridId(i);
-                dataList.append(elevation);
-            }
-
-            if (settings.value(QStringLiteral("tile_elapsed_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_elapsed_order"), 0).toInt() == i) {
-                elapsed->setGridId(i);
-                dataList.append(elapsed);
-            }
-
-            if (settings.value(QStringLiteral("tile_moving_time_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_moving_time_order"), 19).toInt() == i) {
-                moving_time->setGridId(i);
-                dataList.append(moving_time);
-            }
-
-            if (settings.value(QStringLiteral("tile_peloton_offset_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_peloton_offset_order"), 20).toInt() == i) {
-                peloton_offset->setGridId(i);
-                dataList.append(peloton_offset);
-            }
-
-            if (settings.value(QStringLiteral("tile_calories_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_calories_order"), 0).toInt() == i) {
-                calories->setGridId(i);
-                dataList.append(calories);
-            }
-
-            if (settings.value(QStringLiteral("tile_odometer_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_odometer_order"), 0).toInt() == i) {
-                odometer->setGridId(i);
-                dataList.append(odometer);
-            }
-
-            if (settings.value(QStringLiteral("tile_resistance_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_resistance_order"), 0).toInt() == i) {
-                resistance->setGridId(i);
-                dataList.append(resistance);
-            }
-
-            if (settings.value(QStringLiteral("tile_peloton_resistance_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_peloton_resistance_order"), 0).toInt() == i) {
-                peloton_resistance->setGridId(i);
-                dataList.append(peloton_resistance);
-            }
-
-            if (settings.value(QStringLiteral("tile_watt_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_watt_order"), 0).toInt() == i) {
-                watt->setGridId(i);
-                dataList.append(watt);
-            }
-
-            if (settings.value(QStringLiteral("tile_weight_loss_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_weight_loss_order"), 24).toInt() == i) {
-                weightLoss->setGridId(i);
-                dataList.append(weightLoss);
-            }
-
-            if (settings.value(QStringLiteral("tile_avgwatt_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_avgwatt_order"), 0).toInt() == i) {
-                avgWatt->setGridId(i);
-                dataList.append(avgWatt);
-            }
-
-            if (settings.value(QStringLiteral("tile_ftp_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_ftp_order"), 0).toInt() == i) {
-                ftp->setGridId(i);
-                dataList.append(ftp);
-            }
-
-            if (settings.value(QStringLiteral("tile_jouls_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_jouls_order"), 0).toInt() == i) {
-                jouls->setGridId(i);
-                dataList.append(jouls);
-            }
-
-            if (settings.value(QStringLiteral("tile_heart_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_heart_order"), 0).toInt() == i) {
-                heart->setGridId(i);
-                dataList.append(heart);
-            }
-
-            if (settings.value(QStringLiteral("tile_fan_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_fan_order"), 0).toInt() == i) {
-                fan->setGridId(i);
-                dataList.append(fan);
-            }
-
-            if (settings.value(QStringLiteral("tile_datetime_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_datetime_order"), 0).toInt() == i) {
-                datetime->setGridId(i);
-                dataList.append(datetime);
-            }
-
-            if (settings.value(QStringLiteral("tile_target_resistance_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_target_resistance_order"), 0).toInt() == i) {
-                target_resistance->setGridId(i);
-                dataList.append(target_resistance);
-            }
-
-            if (settings.value(QStringLiteral("tile_target_peloton_resistance_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_target_peloton_resistance_order"), 21).toInt() == i) {
-                target_peloton_resistance->setGridId(i);
-                dataList.append(target_peloton_resistance);
-            }
-
-            if (settings.value(QStringLiteral("tile_target_cadence_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_target_cadence_order"), 19).toInt() == i) {
-                target_cadence->setGridId(i);
-                dataList.append(target_cadence);
-            }
-
-            if (settings.value(QStringLiteral("tile_target_power_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_target_power_order"), 20).toInt() == i) {
-                target_power->setGridId(i);
-                dataList.append(target_power);
-            }
-
-            if (settings.value(QStringLiteral("tile_target_zone_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_target_zone_order"), 24).toInt() == i) {
-                target_zone->setGridId(i);
-                dataList.append(target_zone);
-            }
-
-            if (settings.value(QStringLiteral("tile_lapelapsed_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_lapelapsed_order"), 18).toInt() == i) {
-                lapElapsed->setGridId(i);
-                dataList.append(lapElapsed);
-            }
-
-            if (settings.value(QStringLiteral("tile_watt_kg_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_watt_kg_order"), 24).toInt() == i) {
-                wattKg->setGridId(i);
-                dataList.append(wattKg);
-            }
-            if (settings.value(QStringLiteral("tile_gears_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_gears_order"), 25).toInt() == i) {
-                gears->setGridId(i);
-                dataList.append(gears);
-            }
-
-            if (settings.value(QStringLiteral("tile_remainingtimetrainprogramrow_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_remainingtimetrainprogramrow_order"), 27).toInt() == i) {
-
-                remaningTimeTrainingProgramCurrentRow->setGridId(i);
-                dataList.append(remaningTimeTrainingProgramCurrentRow);
-            }
-
-            if (settings.value(QStringLiteral("tile_nextrowstrainprogram_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_nextrowtrainprogram_order"), 31).toInt() == i) {
-
-                nextRows->setGridId(i);
-                dataList.append(nextRows);
-            }
-
-            if (settings.value(QStringLiteral("tile_mets_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_mets_order"), 28).toInt() == i) {
-                mets->setGridId(i);
-                dataList.append(mets);
-            }
-            if (settings.value(QStringLiteral("tile_targetmets_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_targetmets_order"), 29).toInt() == i) {
-                targetMets->setGridId(i);
-                dataList.append(targetMets);
-            }
-            // the proform studio is the only bike managed with an inclination properties.
-            // In order to don't break the tiles layout to all the bikes users, i enable this
-            // only if this bike is selected
-            if (proform_studio) {
-                if (settings.value(QStringLiteral("tile_inclination_enabled"), true).toBool() &&
-                    settings.value(QStringLiteral("tile_inclination_order"), 29).toInt() == i) {
-                    inclination->setGridId(i);
-                    dataList.append(inclination);
-                }
-            }
-            if (settings.value(QStringLiteral("tile_steering_angle_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_steering_angle_order"), 30).toInt() == i) {
-
-                steeringAngle->setGridId(i);
-                dataList.append(steeringAngle);
-            }
+        if (!settings.value(QStringLiteral("tile_") + QLatin1String(t.enabled) + QStringLiteral("_enabled"),
+                            t.enabledDefault)
+                 .toBool()) {
+            continue;
         }
-    } else if (bluetoothManager->device()->deviceType() == bluetoothdevice::ROWING) {
-        for (int i = 0; i < 100; i++) {
-            if (settings.value(QStringLiteral("tile_speed_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_speed_order"), 0).toInt() == i) {
-                speed->setGridId(i);
-                dataList.append(speed);
-            }
-
-            if (settings.value(QStringLiteral("tile_cadence_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_cadence_order"), 0).toInt() == i) {
-                cadence->setGridId(i);
-                dataList.append(cadence);
-            }
-
-            if (settings.value(QStringLiteral("tile_elevation_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_elevation_order"), 0).toInt() == i) {
-                elevation->setGridId(i);
-                dataList.append(elevation);
-            }
-
-            if (settings.value(QStringLiteral("tile_elapsed_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_elapsed_order"), 0).toInt() == i) {
-                elapsed->setGridId(i);
-                dataList.append(elapsed);
-            }
-
-            if (settings.value(QStringLiteral("tile_moving_time_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_moving_time_order"), 19).toInt() == i) {
-                moving_time->setGridId(i);
-                dataList.append(moving_time);
-            }
-
-            if (settings.value(QStringLiteral("tile_peloton_offset_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_peloton_offset_order"), 20).toInt() == i) {
-                peloton_offset->setGridId(i);
-                dataList.append(peloton_offset);
-            }
-
-            if (settings.value(QStringLiteral("tile_calories_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_calories_order"), 0).toInt() == i) {
-                calories->setGridId(i);
-                dataList.append(calories);
-            }
-
-            if (settings.value(QStringLiteral("tile_odometer_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_odometer_order"), 0).toInt() == i) {
-                odometer->setGridId(i);
-                dataList.append(odometer);
-            }
-
-            if (settings.value(QStringLiteral("tile_resistance_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_resistance_order"), 0).toInt() == i) {
-                resistance->setGridId(i);
-                dataList.append(resistance);
-            }
-
-            if (settings.value(QStringLiteral("tile_peloton_resistance_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_peloton_resistance_order"), 0).toInt() == i) {
-                peloton_resistance->setGridId(i);
-                dataList.append(peloton_resistance);
-            }
-
-            if (settings.value(QStringLiteral("tile_watt_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_watt_order"), 0).toInt() == i) {
-                watt->setGridId(i);
-                dataList.append(watt);
-            }
-
-            if (settings.value(QStringLiteral("tile_weight_loss_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_weight_loss_order"), 24).toInt() == i) {
-                weightLoss->setGridId(i);
-                dataList.append(weightLoss);
-            }
-
-            if (settings.value(QStringLiteral("tile_avgwatt_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_avgwatt_order"), 0).toInt() == i) {
-                avgWatt->setGridId(i);
-                dataList.append(avgWatt);
-            }
-
-            if (settings.value(QStringLiteral("tile_ftp_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_ftp_order"), 0).toInt() == i) {
-                ftp->setGridId(i);
-                dataList.append(ftp);
-            }
-
-            if (settings.value(QStringLiteral("tile_jouls_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_jouls_order"), 0).toInt() == i) {
-                jouls->setGridId(i);
-                dataList.append(jouls);
-            }
-
-            if (settings.value(QStringLiteral("tile_heart_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_heart_order"), 0).toInt() == i) {
-                heart->setGridId(i);
-                dataList.append(heart);
-            }
-
-            if (settings.value(QStringLiteral("tile_fan_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_fan_order"), 0).toInt() == i) {
-                fan->setGridId(i);
-                dataList.append(fan);
-            }
-
-            if (settings.value(QStringLiteral("tile_datetime_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_datetime_order"), 0).toInt() == i) {
-                datetime->setGridId(i);
-                dataList.append(datetime);
-            }
-
-            if (settings.value(QStringLiteral("tile_target_resistance_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_target_resistance_order"), 0).toInt() == i) {
-                target_resistance->setGridId(i);
-                dataList.append(target_resistance);
-            }
-
-            if (settings.value(QStringLiteral("tile_target_peloton_resistance_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_target_peloton_resistance_order"), 21).toInt() == i) {
-                target_peloton_resistance->setGridId(i);
-                dataList.append(target_peloton_resistance);
-            }
-
-            if (settings.value(QStringLiteral("tile_target_cadence_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_target_cadence_order"), 19).toInt() == i) {
-                target_cadence->setGridId(i);
-                dataList.append(target_cadence);
-            }
-
-            if (settings.value(QStringLiteral("tile_target_power_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_target_power_order"), 20).toInt() == i) {
-                target_power->setGridId(i);
-                dataList.append(target_power);
-            }
-
-            if (settings.value(QStringLiteral("tile_lapelapsed_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_lapelapsed_order"), 18).toInt() == i) {
-                lapElapsed->setGridId(i);
-                dataList.append(lapElapsed);
-            }
-
-            if (settings.value(QStringLiteral("tile_strokes_length_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_strokes_length_order"), 21).toInt() == i) {
-                strokesLength->setGridId(i);
-                dataList.append(strokesLength);
-            }
-
-            if (settings.value(QStringLiteral("tile_strokes_count_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_strokes_count_order"), 22).toInt() == i) {
-                strokesCount->setGridId(i);
-                dataList.append(strokesCount);
-            }
-
-            if (settings.value(QStringLiteral("tile_pace_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_pace_order"), 0).toInt() == i) {
-                pace->setGridId(i);
-                pace->setName("Pace (m/500m)");
-                dataList.append(pace);
-            }
-
-            if (settings.value(QStringLiteral("tile_watt_kg_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_watt_kg_order"), 24).toInt() == i) {
-                wattKg->setGridId(i);
-                dataList.append(wattKg);
-            }
-
-            if (settings.value(QStringLiteral("tile_remainingtimetrainprogramrow_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_remainingtimetrainprogramrow_order"), 27).toInt() == i) {
-                remaningTimeTrainingProgramCurrentRow->setGridId(i);
-                dataList.append(remaningTimeTrainingProgramCurrentRow);
-            }
-
-            if (settings.value(QStringLiteral("tile_nextrowstrainprogram_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_nextrowtrainprogram_order"), 31).toInt() == i) {
-
-                nextRows->setGridId(i);
-                dataList.append(nextRows);
-            }
-
-            if (settings.value(QStringLiteral("tile_mets_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_mets_order"), 28).toInt() == i) {
-                mets->setGridId(i);
-                dataList.append(mets);
-            }
-            if (settings.value(QStringLiteral("tile_targetmets_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_targetmets_order"), 29).toInt() == i) {
-                targetMets->setGridId(i);
-                dataList.append(targetMets);
-            }
+        int order =
+            settings.value(QStringLiteral("tile_") + QLatin1String(t.order) + QStringLiteral("_order"), t.orderDefault)
+                .toInt();
+        if (order >= 0 && order < 100) {
+            layout.append(qMakePair(order, d));
         }
-    } else if (bluetoothManager->device()->deviceType() == bluetoothdevice::ELLIPTICAL) {
-        for (int i = 0; i < 100; i++) {
-            if (settings.value(QStringLiteral("tile_speed_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_speed_order"), 0).toInt() == i) {
-                speed->setGridId(i);
-                dataList.append(speed);
-            }
-
-            if (settings.value(QStringLiteral("tile_cadence_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_cadence_order"), 0).toInt() == i) {
-                cadence->setGridId(i);
-                dataList.append(cadence);
-            }
-
-            if (settings.value(QStringLiteral("tile_inclination_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_inclination_order"), 0).toInt() == i) {
-                inclination->setGridId(i);
-                dataList.append(inclination);
-            }
-
-            if (settings.value(QStringLiteral("tile_elevation_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_elevation_order"), 0).toInt() == i) {
-                elevation->setGridId(i);
-                dataList.append(elevation);
-            }
-
-            if (settings.value(QStringLiteral("tile_elapsed_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_elapsed_order"), 0).toInt() == i) {
-                elapsed->setGridId(i);
-                dataList.append(elapsed);
-            }
-
-            if (settings.value(QStringLiteral("tile_moving_time_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_moving_time_order"), 19).toInt() == i) {
-                moving_time->setGridId(i);
-                dataList.append(moving_time);
-            }
-
-            if (settings.value(QStringLiteral("tile_peloton_offset_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_peloton_offset_order"), 20).toInt() == i) {
-                peloton_offset->setGridId(i);
-                dataList.append(peloton_offset);
-            }
-
-            if (settings.value(QStringLiteral("tile_calories_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_calories_order"), 0).toInt() == i) {
-                calories->setGridId(i);
-                dataList.append(calories);
-            }
-
-            if (settings.value(QStringLiteral("tile_odometer_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_odometer_order"), 0).toInt() == i) {
-                odometer->setGridId(i);
-                dataList.append(odometer);
-            }
-
-            if (settings.value(QStringLiteral("tile_resistance_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_resistance_order"), 0).toInt() == i) {
-                resistance->setGridId(i);
-                dataList.append(resistance);
-            }
-
-            if (settings.value(QStringLiteral("tile_peloton_resistance_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_peloton_resistance_order"), 0).toInt() == i) {
-                peloton_resistance->setGridId(i);
-                dataList.append(peloton_resistance);
-            }
-
-            if (settings.value(QStringLiteral("tile_watt_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_watt_order"), 0).toInt() == i) {
-                watt->setGridId(i);
-                dataList.append(watt);
-            }
-
-            if (settings.value(QStringLiteral("tile_weight_loss_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_weight_loss_order"), 24).toInt() == i) {
-                weightLoss->setGridId(i);
-                dataList.append(weightLoss);
-            }
-
-            if (settings.value(QStringLiteral("tile_avgwatt_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_avgwatt_order"), 0).toInt() == i) {
-                avgWatt->setGridId(i);
-                dataList.append(avgWatt);
-            }
-
-            if (settings.value(QStringLiteral("tile_ftp_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_ftp_order"), 0).toInt() == i) {
-                ftp->setGridId(i);
-                dataList.append(ftp);
-            }
-
-            if (settings.value(QStringLiteral("tile_jouls_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_jouls_order"), 0).toInt() == i) {
-                jouls->setGridId(i);
-                dataList.append(jouls);
-            }
-
-            if (settings.value(QStringLiteral("tile_heart_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_heart_order"), 0).toInt() == i) {
-                heart->setGridId(i);
-                dataList.append(heart);
-            }
-
-            if (settings.value(QStringLiteral("tile_fan_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_fan_order"), 0).toInt() == i) {
-                fan->setGridId(i);
-                dataList.append(fan);
-            }
-
-            if (settings.value(QStringLiteral("tile_datetime_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_datetime_order"), 0).toInt() == i) {
-                datetime->setGridId(i);
-                dataList.append(datetime);
-            }
-
-            if (settings.value(QStringLiteral("tile_target_resistance_enabled"), true).toBool() &&
-                settings.value(QStringLiteral("tile_target_resistance_order"), 0).toInt() == i) {
-                target_resistance->setGridId(i);
-                dataList.append(target_resistance);
-            }
-
-            if (settings.value(QStringLiteral("tile_lapelapsed_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_lapelapsed_order"), 18).toInt() == i) {
-                lapElapsed->setGridId(i);
-                dataList.append(lapElapsed);
-            }
-
-            if (settings.value(QStringLiteral("tile_watt_kg_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_watt_kg_order"), 24).toInt() == i) {
-                wattKg->setGridId(i);
-                dataList.append(wattKg);
-            }
-
-            if (settings.value(QStringLiteral("tile_remainingtimetrainprogramrow_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_remainingtimetrainprogramrow_order"), 27).toInt() == i) {
-                remaningTimeTrainingProgramCurrentRow->setGridId(i);
-                dataList.append(remaningTimeTrainingProgramCurrentRow);
-            }
-
-            if (settings.value(QStringLiteral("tile_nextrowstrainprogram_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_nextrowtrainprogram_order"), 31).toInt() == i) {
-
-                nextRows->setGridId(i);
-                dataList.append(nextRows);
-            }
+    }
+    std::stable_sort(layout.begin(), layout.end(),
+                     [](const QPair<int, int> &a, const QPair<int, int> &b) { return a.first < b.first; });
 
-            if (settings.value(QStringLiteral("tile_mets_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_mets_order"), 28).toInt() == i) {
-                mets->setGridId(i);
-                dataList.append(mets);
-            }
-            if (settings.value(QStringLiteral("tile_targetmets_enabled"), false).toBool() &&
-                settings.value(QStringLiteral("tile_targetmets_order"), 29).toInt() == i) {
-                targetMets->setGridId(i);
-                dataList.append(targetMets);
-            }
-        }
+    dataList.clear();
+    for (const auto &l : qAsConst(layout)) {
+        DataObject *tile = this->*(definitions.at(l.second).object);
+        tile->setGridId(l.first);
+        dataList.append(tile);
+    }
+    if (type == bluetoothdevice::ROWING && dataList.contains(pace)) {
+        pace->setName("Pace (m/500m)");
     }
 
-    engine->rootContext()->setContextProperty(QStringLiteral("appModel"), QVariant::fromValue(dataList));
+    tilesModel->setTiles(dataList);
 }
 
 DataObject *homeform::tileFromName(QString name) {
@@ -1302,6 +807,7 @@ void homeform::moveTile(QString name, int newIndex, int oldIndex) {
             }
         }
 
+        tilesLayoutSettings.reset();
         // sortTiles();
         // dataList.move(oldIndex, newIndex);
         // very dirty, but i needed a way to synchronize QML with C++
@@ -1604,7 +1110,15 @@ void homeform::Start_inner(bool send_event_to_device) {
                 bluetoothManager->device()->clearStats();
             }
             Session.clear();
+            wattChart.clear();
+            heartChart.clear();
+            cadenceChart.clear();
+            resistanceChart.clear();
+            pelotonResistanceChart.clear();
+            delete fitBackup;
+            fitBackup = nullptr;
             chartImagesFilenames.clear();
+            mailAfterExport = false;
 
             stravaPelotonActivityName = QLatin1String("");
             stravaPelotonInstructorName = QLatin1String("");
@@ -1676,6 +1190,7 @@ void homeform::Stop() {
 
     if (trainProgram) {
         trainProgram->rows.clear();
+        trainProgram->invalidate();
     }
 }
 
@@ -1748,6 +1263,14 @@ QString homeform::signal() {
     return QStringLiteral("icons/icons/signal-1.png");
 }
 
+// h:mm:ss of a duration of the device snapshot
+static QString durationString(double seconds) {
+    const int s = (int)seconds;
+    return QString::number(s / 3600) + QStringLiteral(":%1:%2")
+                                           .arg((s / 60) % 60, 2, 10, QLatin1Char('0'))
+                                           .arg(s % 60, 2, 10, QLatin1Char('0'));
+}
+
 void homeform::update() {
 
     QSettings settings;
@@ -1765,6 +1288,8 @@ void homeform::update() {
 
     if (bluetoothManager->device()) {
 
+        // the values of the last update of the device, read at once
+        const devicesnapshot snapshot = bluetoothManager->device()->snapshot();
         double inclination = 0;
         double resistance = 0;
         double watts = 0;
@@ -1785,26 +1310,21 @@ void homeform::update() {
         }
 
         emit signalChanged(signal());
-        speed->setValue(QString::number(bluetoothManager->device()->currentSpeed().value() * unit_conversion, 'f', 1));
-        speed->setSecondLine(
-            QStringLiteral("AVG: ") +
-            QString::number((bluetoothManager->device())->currentSpeed().average() * unit_conversion, 'f', 1) +
-            QStringLiteral(" MAX: ") +
-            QString::number((bluetoothManager->device())->currentSpeed().max() * unit_conversion, 'f', 1));
-        heart->setValue(QString::number(bluetoothManager->device()->currentHeart().value(), 'f', 0));
-
-        calories->setValue(QString::number(bluetoothManager->device()->calories().value(), 'f', 0));
-        calories->setSecondLine(QString::number(bluetoothManager->device()->calories().rate1s() * 60.0, 'f', 1) +
-                                " /min");
+        speed->setValue(QString::number(snapshot.speed * unit_conversion, 'f', 1));
+        speed->setSecondLine(QStringLiteral("AVG: ") + QString::number(snapshot.speedAvg * unit_conversion, 'f', 1) +
+                             QStringLiteral(" MAX: ") + QString::number(snapshot.speedMax * unit_conversion, 'f', 1));
+        heart->setValue(QString::number(snapshot.heart, 'f', 0));
+
+        calories->setValue(QString::number(snapshot.calories, 'f', 0));
+        calories->setSecondLine(QString::number(snapshot.caloriesRate * 60.0, 'f', 1) + " /min");
         if (!settings.value(QStringLiteral("fitmetria_fanfit_enable"), false).toBool())
-            fan->setValue(QString::number(bluetoothManager->device()->fanSpeed()));
+            fan->setValue(QString::number(snapshot.fanSpeed));
         else
-            fan->setValue(QString::number(qRound(((double)bluetoothManager->device()->fanSpeed()) / 10.0) * 10.0));
-        jouls->setValue(QString::number(bluetoothManager->device()->jouls().value() / 1000.0, 'f', 1));
-        jouls->setSecondLine(QString::number(bluetoothManager->device()->jouls().rate1s() / 1000.0 * 60.0, 'f', 1) +
-                             " /min");
-        elapsed->setValue(bluetoothManager->device()->elapsedTime().toString(QStringLiteral("h:mm:ss")));
-        moving_time->setValue(bluetoothManager->device()->movingTime().toString(QStringLiteral("h:mm:ss")));
+            fan->setValue(QString::number(qRound(((double)snapshot.fanSpeed) / 10.0) * 10.0));
+        jouls->setValue(QString::number(snapshot.jouls / 1000.0, 'f', 1));
+        jouls->setSecondLine(QString::number(snapshot.joulsRate / 1000.0 * 60.0, 'f', 1) + " /min");
+        elapsed->setValue(durationString(snapshot.elapsed));
+        moving_time->setValue(durationString(snapshot.moving));
         if (trainProgram) {
             peloton_offset->setValue(QString::number(trainProgram->offsetElapsedTime()) + QStringLiteral(" sec."));
             remaningTimeTrainingProgramCurrentRow->setValue(
@@ -1869,33 +1389,28 @@ void homeform::update() {
                 nextRows->setValue(QStringLiteral("N/A"));
             }
         }
-        mets->setValue(QString::number(bluetoothManager->device()->currentMETS().value(), 'f', 1));
-        mets->setSecondLine(
-            QStringLiteral("AVG: ") + QString::number(bluetoothManager->device()->currentMETS().average(), 'f', 1) +
-            QStringLiteral("MAX: ") + QString::number(bluetoothManager->device()->currentMETS().max(), 'f', 1));
-        lapElapsed->setValue(bluetoothManager->device()->lapElapsedTime().toString(QStringLiteral("h:mm:ss")));
-        avgWatt->setValue(QString::number(bluetoothManager->device()->wattsMetric().average(), 'f', 0));
-        wattKg->setValue(QString::number(bluetoothManager->device()->wattKg().value(), 'f', 1));
-        wattKg->setSecondLine(
-            QStringLiteral("AVG: ") + QString::number(bluetoothManager->device()->wattKg().average(), 'f', 1) +
-            QStringLiteral("MAX: ") + QString::number(bluetoothManager->device()->wattKg().max(), 'f', 1));
+        mets->setValue(QString::number(snapshot.mets, 'f', 1));
+        mets->setSecondLine(QStringLiteral("AVG: ") + QString::number(snapshot.metsAvg, 'f', 1) +
+                            QStringLiteral("MAX: ") + QString::number(snapshot.metsMax, 'f', 1));
+        lapElapsed->setValue(durationString(snapshot.lapElapsed));
+        avgWatt->setValue(QString::number(snapshot.wattAvg, 'f', 0));
+        wattKg->setValue(QString::number(snapshot.wattKg, 'f', 1));
+        wattKg->setSecondLine(QStringLiteral("AVG: ") + QString::number(snapshot.wattKgAvg, 'f', 1) +
+                              QStringLiteral("MAX: ") + QString::number(snapshot.wattKgMax, 'f', 1));
         datetime->setValue(QTime::currentTime().toString(QStringLiteral("hh:mm:ss")));
         if (power5s)
-            watts = bluetoothManager->device()->wattsMetric().average5s();
+            watts = snapshot.watt5s;
         else
-            watts = bluetoothManager->device()->wattsMetric().value();
+            watts = snapshot.watt;
         watt->setValue(QString::number(watts, 'f', 0));
         weightLoss->setValue(QString::number(miles ? bluetoothManager->device()->weightLoss() * 35.274
                                                    : bluetoothManager->device()->weightLoss(),
                                              'f', 2));
 
-        cadence = bluetoothManager->device()->currentCadence().value();
+        cadence = snapshot.cadence;
         this->cadence->setValue(QString::number(cadence));
-        this->cadence->setSecondLine(
-            QStringLiteral("AVG: ") +
-            QString::number(((bike *)bluetoothManager->device())->currentCadence().average(), 'f', 0) +
-            QStringLiteral(" MAX: ") +
-            QString::number(((bike *)bluetoothManager->device())->currentCadence().max(), 'f', 0));
+        this->cadence->setSecondLine(QStringLiteral("AVG: ") + QString::number(snapshot.cadenceAvg, 'f', 0) +
+                                     QStringLiteral(" MAX: ") + QString::number(snapshot.cadenceMax, 'f', 0));
 
 #ifdef Q_OS_IOS
 #ifndef IO_UNDER_QT
@@ -1922,8 +1437,8 @@ void homeform::update() {
 
         if (bluetoothManager->device()->deviceType() == bluetoothdevice::TREADMILL) {
 
-            odometer->setValue(QString::number(bluetoothManager->device()->odometer() * unit_conversion, 'f', 2));
-            if (bluetoothManager->device()->currentSpeed().value()) {
+            odometer->setValue(QString::number(snapshot.odometer * unit_conversion, 'f', 2));
+            if (snapshot.speed) {
                 pace = 10000 / (((treadmill *)bluetoothManager->device())->currentPace().second() +
                                 (((treadmill *)bluetoothManager->device())->currentPace().minute() * 60));
                 if (pace < 0) {
@@ -1933,7 +1448,7 @@ void homeform::update() {
 
                 pace = 0;
             }
-            inclination = ((treadmill *)bluetoothManager->device())->currentInclination().value();
+            inclination = snapshot.inclination;
             this->pace->setValue(
                 ((treadmill *)bluetoothManager->device())->currentPace().toString(QStringLiteral("m:ss")));
             this->pace->setSecondLine(
@@ -1943,32 +1458,27 @@ void homeform::update() {
                 ((treadmill *)bluetoothManager->device())->maxPace().toString(QStringLiteral("m:ss")));
             this->inclination->setValue(QString::number(inclination, 'f', 1));
             this->inclination->setSecondLine(
-                QStringLiteral("AVG: ") +
-                QString::number(((treadmill *)bluetoothManager->device())->currentInclination().average(), 'f', 1) +
-                QStringLiteral(" MAX: ") +
-                QString::number(((treadmill *)bluetoothManager->device())->currentInclination().max(), 'f', 1));
-            elevation->setValue(
-                QString::number(((treadmill *)bluetoothManager->device())->elevationGain().value(), 'f', 1));
-            elevation->setSecondLine(
-                QString::number(((treadmill *)bluetoothManager->device())->elevationGain().rate1s() * 60.0, 'f', 1) +
-                " /min");
-
-            if (bluetoothManager->device()->currentSpeed().value() < 9) {
+                QStringLiteral("AVG: ") + QString::number(snapshot.inclinationAvg, 'f', 1) +
+                QStringLiteral(" MAX: ") + QString::number(snapshot.inclinationMax, 'f', 1));
+            elevation->setValue(QString::number(snapshot.elevationGain, 'f', 1));
+            elevation->setSecondLine(QString::number(snapshot.elevationRate * 60.0, 'f', 1) + " /min");
+
+            if (snapshot.speed < 9) {
                 speed->setValueFontColor(QStringLiteral("white"));
                 this->pace->setValueFontColor(QStringLiteral("white"));
-            } else if (bluetoothManager->device()->currentSpeed().value() < 10) {
+            } else if (snapshot.speed < 10) {
                 speed->setValueFontColor(QStringLiteral("limegreen"));
                 this->pace->setValueFontColor(QStringLiteral("limegreen"));
-            } else if (bluetoothManager->device()->currentSpeed().value() < 11) {
+            } else if (snapshot.speed < 11) {
                 speed->setValueFontColor(QStringLiteral("gold"));
                 this->pace->setValueFontColor(QStringLiteral("gold"));
-            } else if (bluetoothManager->device()->currentSpeed().value() < 12) {
+            } else if (snapshot.speed < 12) {
                 speed->setValueFontColor(QStringLiteral("orange"));
                 this->pace->setValueFontColor(QStringLiteral("orange"));
-            } else if (bluetoothManager->device()->currentSpeed().value() < 13) {
+            } else if (snapshot.speed < 13) {
                 speed->setValueFontColor(QStringLiteral("darkorange"));
                 this->pace->setValueFontColor(QStringLiteral("darkorange"));
-            } else if (bluetoothManager->device()->currentSpeed().value() < 14) {
+            } else if (snapshot.speed < 14) {
                 speed->setValueFontColor(QStringLiteral("orangered"));
                 this->pace->setValueFontColor(QStringLiteral("orangered"));
             } else {
@@ -1978,12 +1488,12 @@ void homeform::update() {
 
             // originally born for #470. When the treadmill reaches the 0 speed it enters in the pause mode
             // so this logic should care about sync the treadmill state to the UI state
-            if (((treadmill *)bluetoothManager->device())->autoPauseWhenSpeedIsZero() &&
-                bluetoothManager->device()->currentSpeed().value() == 0 && paused == false && stopped == false) {
+            if (((treadmill *)bluetoothManager->device())->autoPauseWhenSpeedIsZero() && snapshot.speed == 0 &&
+                paused == false && stopped == false) {
                 qDebug() << QStringLiteral("autoPauseWhenSpeedIsZero!");
                 Start_inner(false);
             } else if (((treadmill *)bluetoothManager->device())->autoStartWhenSpeedIsGreaterThenZero() &&
-                       bluetoothManager->device()->currentSpeed().value() > 0 && (paused == true || stopped == true)) {
+                       snapshot.speed > 0 && (paused == true || stopped == true)) {
                 qDebug() << QStringLiteral("autoStartWhenSpeedIsGreaterThenZero!");
                 Start_inner(false);
             }
@@ -1993,16 +1503,14 @@ void homeform::update() {
             bool proform_studio = settings.value(QStringLiteral("proform_studio"), false).toBool();
 
             if (proform_studio) {
-                inclination = ((bike *)bluetoothManager->device())->currentInclination().value();
+                inclination = snapshot.inclination;
                 this->inclination->setValue(QString::number(inclination, 'f', 1));
                 this->inclination->setSecondLine(
-                    QStringLiteral("AVG: ") +
-                    QString::number(((bike *)bluetoothManager->device())->currentInclination().average(), 'f', 1) +
-                    QStringLiteral(" MAX: ") +
-                    QString::number(((bike *)bluetoothManager->device())->currentInclination().max(), 'f', 1));
+                    QStringLiteral("AVG: ") + QString::number(snapshot.inclinationAvg, 'f', 1) +
+                    QStringLiteral(" MAX: ") + QString::number(snapshot.inclinationMax, 'f', 1));
             }
-            odometer->setValue(QString::number(bluetoothManager->device()->odometer() * unit_conversion, 'f', 2));
-            resistance = ((bike *)bluetoothManager->device())->currentResistance().value();
+            odometer->setValue(QString::number(snapshot.odometer * unit_conversion, 'f', 2));
+            resistance = snapshot.resistance;
             peloton_resistance = ((bike *)bluetoothManager->device())->pelotonResistance().value();
             this->peloton_resistance->setValue(QString::number(peloton_resistance, 'f', 0));
             this->target_resistance->setValue(
@@ -2016,11 +1524,8 @@ void homeform::update() {
             this->resistance->setValue(QString::number(resistance, 'f', 0));
             this->gears->setValue(QString::number(((bike *)bluetoothManager->device())->gears()));
 
-            this->resistance->setSecondLine(
-                QStringLiteral("AVG: ") +
-                QString::number(((bike *)bluetoothManager->device())->currentResistance().average(), 'f', 0) +
-                QStringLiteral(" MAX: ") +
-                QString::number(((bike *)bluetoothManager->device())->currentResistance().max(), 'f', 0));
+            this->resistance->setSecondLine(QStringLiteral("AVG: ") + QString::number(snapshot.resistanceAvg, 'f', 0) +
+                                            QStringLiteral(" MAX: ") + QString::number(snapshot.resistanceMax, 'f', 0));
             this->peloton_resistance->setSecondLine(
                 QStringLiteral("AVG: ") +
                 QString::number(((bike *)bluetoothManager->device())->pelotonResistance().average(), 'f', 0) +
@@ -2055,7 +1560,7 @@ void homeform::update() {
                 QString::number(((bike *)bluetoothManager->device())->currentSteeringAngle().value(), 'f', 1));
 
         } else if (bluetoothManager->device()->deviceType() == bluetoothdevice::ROWING) {
-            if (bluetoothManager->device()->currentSpeed().value()) {
+            if (snapshot.speed) {
                 pace = 10000 / (((rower *)bluetoothManager->device())->currentPace().second() +
                                 (((rower *)bluetoothManager->device())->currentPace().minute() * 60));
                 if (pace < 0) {
@@ -2071,13 +1576,12 @@ void homeform::update() {
                 ((rower *)bluetoothManager->device())->averagePace().toString(QStringLiteral("m:ss")) +
                 QStringLiteral(" MAX: ") +
                 ((rower *)bluetoothManager->device())->maxPace().toString(QStringLiteral("m:ss")));
-            odometer->setValue(
-                QString::number(bluetoothManager->device()->odometer() * 1000.0 * unit_conversion, 'f', 0));
-            resistance = ((rower *)bluetoothManager->device())->currentResistance().value();
+            odometer->setValue(QString::number(snapshot.odometer * 1000.0 * unit_conversion, 'f', 0));
+            resistance = snapshot.resistance;
             peloton_resistance = ((rower *)bluetoothManager->device())->pelotonResistance().value();
             totalStrokes = ((rower *)bluetoothManager->device())->currentStrokesCount().value();
-            avgStrokesRate = ((rower *)bluetoothManager->device())->currentCadence().average();
-            maxStrokesRate = ((rower *)bluetoothManager->device())->currentCadence().max();
+            avgStrokesRate = snapshot.cadenceAvg;
+            maxStrokesRate = snapshot.cadenceMax;
             avgStrokesLength = ((rower *)bluetoothManager->device())->currentStrokesLength().average();
             this->strokesCount->setValue(
                 QString::number(((rower *)bluetoothManager->device())->currentStrokesCount().value(), 'f', 0));
@@ -2095,11 +1599,8 @@ void homeform::update() {
                 QString::number(((rower *)bluetoothManager->device())->lastRequestedPower().value(), 'f', 0));
             this->resistance->setValue(QString::number(resistance, 'f', 0));
 
-            this->resistance->setSecondLine(
-                QStringLiteral("AVG: ") +
-                QString::number(((rower *)bluetoothManager->device())->currentResistance().average(), 'f', 0) +
-                QStringLiteral(" MAX: ") +
-                QString::number(((rower *)bluetoothManager->device())->currentResistance().max(), 'f', 0));
+            this->resistance->setSecondLine(QStringLiteral("AVG: ") + QString::number(snapshot.resistanceAvg, 'f', 0) +
+                                            QStringLiteral(" MAX: ") + QString::number(snapshot.resistanceMax, 'f', 0));
             this->peloton_resistance->setSecondLine(
                 QStringLiteral("AVG: ") +
                 QString::number(((rower *)bluetoothManager->device())->pelotonResistance().average(), 'f', 0) +
@@ -2116,22 +1617,22 @@ void homeform::update() {
                 QString::number(((rower *)bluetoothManager->device())->currentStrokesLength().average(), 'f', 1) +
                 QStringLiteral(" MAX: ") +
                 QString::number(((rower *)bluetoothManager->device())->currentStrokesLength().max(), 'f', 1));
-            if (bluetoothManager->device()->currentSpeed().value() < 4) {
+            if (snapshot.speed < 4) {
                 speed->setValueFontColor(QStringLiteral("white"));
                 this->pace->setValueFontColor(QStringLiteral("white"));
-            } else if (bluetoothManager->device()->currentSpeed().value() < 5) {
+            } else if (snapshot.speed < 5) {
                 speed->setValueFontColor(QStringLiteral("limegreen"));
                 this->pace->setValueFontColor(QStringLiteral("limegreen"));
-            } else if (bluetoothManager->device()->currentSpeed().value() < 5.5) {
+            } else if (snapshot.speed < 5.5) {
                 speed->setValueFontColor(QStringLiteral("gold"));
                 this->pace->setValueFontColor(QStringLiteral("gold"));
-            } else if (bluetoothManager->device()->currentSpeed().value() < 6) {
+            } else if (snapshot.speed < 6) {
                 speed->setValueFontColor(QStringLiteral("orange"));
                 this->pace->setValueFontColor(QStringLiteral("orange"));
-            } else if (bluetoothManager->device()->currentSpeed().value() < 6.5) {
+            } else if (snapshot.speed < 6.5) {
                 speed->setValueFontColor(QStringLiteral("darkorange"));
                 this->pace->setValueFontColor(QStringLiteral("darkorange"));
-            } else if (bluetoothManager->device()->currentSpeed().value() < 7) {
+            } else if (snapshot.speed < 7) {
                 speed->setValueFontColor(QStringLiteral("orangered"));
                 this->pace->setValueFontColor(QStringLiteral("orangered"));
             } else {
@@ -2140,24 +1641,20 @@ void homeform::update() {
             }
         } else if (bluetoothManager->device()->deviceType() == bluetoothdevice::ELLIPTICAL) {
 
-            odometer->setValue(QString::number(bluetoothManager->device()->odometer() * unit_conversion, 'f', 2));
-            resistance = ((elliptical *)bluetoothManager->device())->currentResistance().value();
+            odometer->setValue(QString::number(snapshot.odometer * unit_conversion, 'f', 2));
+            resistance = snapshot.resistance;
             // this->peloton_resistance->setValue(QString::number(((elliptical*)bluetoothManager->device())->pelotonResistance(),
             // 'f', 0));
             this->resistance->setValue(QString::number(resistance));
-            inclination = ((elliptical *)bluetoothManager->device())->currentInclination().value();
+            inclination = snapshot.inclination;
             this->inclination->setValue(QString::number(inclination, 'f', 1));
             this->inclination->setSecondLine(
-                QStringLiteral("AVG: ") +
-                QString::number(((elliptical *)bluetoothManager->device())->currentInclination().average(), 'f', 1) +
-                QStringLiteral(" MAX: ") +
-                QString::number(((elliptical *)bluetoothManager->device())->currentInclination().max(), 'f', 1));
-            elevation->setValue(
-                QString::number(((elliptical *)bluetoothManager->device())->elevationGain().value(), 'f', 1));
+                QStringLiteral("AVG: ") + QString::number(snapshot.inclinationAvg, 'f', 1) +
+                QStringLiteral(" MAX: ") + QString::number(snapshot.inclinationMax, 'f', 1));
+            elevation->setValue(QString::number(snapshot.elevationGain, 'f', 1));
         }
-        watt->setSecondLine(
-            QStringLiteral("AVG: ") + QString::number((bluetoothManager->device())->wattsMetric().average(), 'f', 0) +
-            QStringLiteral(" MAX: ") + QString::number((bluetoothManager->device())->wattsMetric().max(), 'f', 0));
+        watt->setSecondLine(QStringLiteral("AVG: ") + QString::number(snapshot.wattAvg, 'f', 0) +
+                            QStringLiteral(" MAX: ") + QString::number(snapshot.wattMax, 'f', 0));
 
         double ftpPerc = 0;
         double ftpZone = 1;
@@ -2321,7 +1818,7 @@ void homeform::update() {
 
         QString Z;
         double maxHeartRate = heartRateMax();
-        double percHeartRate = (bluetoothManager->device()->currentHeart().value() * 100) / maxHeartRate;
+        double percHeartRate = (snapshot.heart * 100) / maxHeartRate;
 
         if (percHeartRate < settings.value(QStringLiteral("heart_rate_zone1"), 70.0).toDouble()) {
             Z = QStringLiteral("Z1");
@@ -2349,10 +1846,8 @@ void homeform::update() {
             currentHRZone = 5;
             heart->setValueFontColor(QStringLiteral("red"));
         }
-        heart->setSecondLine(Z + QStringLiteral(" AVG: ") +
-                             QString::number((bluetoothManager->device())->currentHeart().average(), 'f', 0) +
-                             QStringLiteral(" MAX: ") +
-                             QString::number((bluetoothManager->device())->currentHeart().max(), 'f', 0));
+        heart->setSecondLine(Z + QStringLiteral(" AVG: ") + QString::number(snapshot.heartAvg, 'f', 0) +
+                             QStringLiteral(" MAX: ") + QString::number(snapshot.heartMax, 'f', 0));
 
         /*
                 if(trainProgram)
@@ -2373,9 +1868,8 @@ void homeform::update() {
 
 #ifdef Q_OS_ANDROID
         if (settings.value("ant_cadence", false).toBool() && KeepAwakeHelper::antObject(false)) {
-            KeepAwakeHelper::antObject(false)->callMethod<void>(
-                "setCadenceSpeedPower", "(FII)V", (float)bluetoothManager->device()->currentSpeed().value(), (int)watts,
-                (int)cadence);
+            KeepAwakeHelper::antObject(false)->callMethod<void>("setCadenceSpeedPower", "(FII)V",
+                                                                (float)snapshot.speed, (int)watts, (int)cadence);
         }
 #endif
 
@@ -2397,7 +1891,7 @@ void homeform::update() {
                         bool done = false;
 
                         if (bluetoothManager->device()->deviceType() == bluetoothdevice::TREADMILL &&
-                            ((treadmill *)bluetoothManager->device())->currentSpeed().value() > 0.0f) {
+                            snapshot.speed > 0.0f) {
                             double speed = settings.value(QStringLiteral("trainprogram_speed_min"), 8).toUInt();
                             double incline = settings.value(QStringLiteral("trainprogram_incline_min"), 0).toUInt();
                             if (!speed) {
@@ -2459,7 +1953,7 @@ void homeform::update() {
                             }
                         }
                     }
-                } else if (bluetoothManager->device()->currentSpeed().value() > 0) {
+                } else if (snapshot.speed > 0) {
                     if (bluetoothManager->device()->deviceType() == bluetoothdevice::TREADMILL) {
 
                         ((treadmill *)bluetoothManager->device())->changeSpeedAndInclination(0, 0);
@@ -2502,39 +1996,31 @@ void homeform::update() {
                     }
                 }
 
-                if (!stopped && !paused && bluetoothManager->device()->currentHeart().value() &&
-                    bluetoothManager->device()->currentSpeed().value() > 0.0f) {
+                if (!stopped && !paused && snapshot.heart && snapshot.speed > 0.0f) {
                     if (bluetoothManager->device()->deviceType() == bluetoothdevice::TREADMILL) {
 
                         const double step = 0.2;
-                        double currentSpeed = ((treadmill *)bluetoothManager->device())->currentSpeed().value();
+                        double currentSpeed = snapshot.speed;
                         if (zone < currentHRZone) {
                             ((treadmill *)bluetoothManager->device())
-                                ->changeSpeedAndInclination(
-                                    currentSpeed - step,
-                                    ((treadmill *)bluetoothManager->device())->currentInclination().value());
+                                ->changeSpeedAndInclination(currentSpeed - step, snapshot.inclination);
                             pid_heart_zone_small_inc_counter = 0;
                         } else if (zone > currentHRZone && maxSpeed >= currentSpeed + step) {
                             ((treadmill *)bluetoothManager->device())
-                                ->changeSpeedAndInclination(
-
-                                    currentSpeed + step,
-                                    ((treadmill *)bluetoothManager->device())->currentInclination().value());
+                                ->changeSpeedAndInclination(currentSpeed + step, snapshot.inclination);
                             pid_heart_zone_small_inc_counter = 0;
                         } else {
                             pid_heart_zone_small_inc_counter++;
                             if (pid_heart_zone_small_inc_counter > 6) {
                                 ((treadmill *)bluetoothManager->device())
-                                    ->changeSpeedAndInclination(
-                                        currentSpeed + step,
-                                        ((treadmill *)bluetoothManager->device())->currentInclination().value());
+                                    ->changeSpeedAndInclination(currentSpeed + step, snapshot.inclination);
                                 pid_heart_zone_small_inc_counter = 0;
                             }
                         }
                     } else if (bluetoothManager->device()->deviceType() == bluetoothdevice::BIKE) {
 
                         const int step = 1;
-                        int8_t currentResistance = ((bike *)bluetoothManager->device())->currentResistance().value();
+                        int8_t currentResistance = snapshot.resistance;
                         if (zone < currentHRZone) {
 
                             ((bike *)bluetoothManager->device())->changeResistance(currentResistance - step);
@@ -2545,7 +2031,7 @@ void homeform::update() {
                     } else if (bluetoothManager->device()->deviceType() == bluetoothdevice::ROWING) {
 
                         const int step = 1;
-                        int8_t currentResistance = ((rower *)bluetoothManager->device())->currentResistance().value();
+                        int8_t currentResistance = snapshot.resistance;
                         if (zone < currentHRZone) {
 
                             ((rower *)bluetoothManager->device())->changeResistance(currentResistance - step);
@@ -2571,13 +2057,11 @@ void homeform::update() {
             else if (!settings.value(QStringLiteral("fitmetria_fanfit_mode"), QStringLiteral("Heart"))
                           .toString()
                           .compare(QStringLiteral("Heart"))) {
-                qDebug() << QStringLiteral("fitmetria_fanfit heart mode")
-                         << bluetoothManager->device()->currentHeart().value();
+                qDebug() << QStringLiteral("fitmetria_fanfit heart mode") << snapshot.heart;
                 const uint8_t min = 80;
                 uint8_t v = 0;
-                if (bluetoothManager->device()->currentHeart().value() > min && maxHeartRate > min)
-                    v = ((bluetoothManager->device()->currentHeart().value() - min) * 100.0) /
-                        (double)(maxHeartRate - min);
+                if (snapshot.heart > min && maxHeartRate > min)
+                    v = ((snapshot.heart - min) * 100.0) / (double)(maxHeartRate - min);
                 bluetoothManager->device()->changeFanSpeed(v + fanOverride);
             }
             // Power Mode
@@ -2604,11 +2088,8 @@ void homeform::update() {
         }
 
         if (!stopped && !paused) {
-            SessionLine s(bluetoothManager->device()->currentSpeed().value(), inclination,
-                          bluetoothManager->device()->odometer(), watts, resistance, peloton_resistance,
-                          (uint8_t)bluetoothManager->device()->currentHeart().value(), pace, cadence,
-                          bluetoothManager->device()->calories().value(),
-                          bluetoothManager->device()->elevationGain().value(),
+            SessionLine s(snapshot.speed, inclination, snapshot.odometer, watts, resistance, peloton_resistance,
+                          (uint8_t)snapshot.heart, pace, cadence, snapshot.calories, snapshot.elevationGain,
                           bluetoothManager->device()->elapsedTime().second() +
                               (bluetoothManager->device()->elapsedTime().minute() * 60) +
                               (bluetoothManager->device()->elapsedTime().hour() * 3600),
@@ -2617,6 +2098,11 @@ void homeform::update() {
                           bluetoothManager->device()->currentCordinate());
 
             Session.append(s);
+            wattChart.append(s.watt);
+            heartChart.append(s.heart);
+            cadenceChart.append(s.cadence);
+            resistanceChart.append(s.resistance);
+            pelotonResistanceChart.append(s.peloton_resistance);
 
             if (lapTrigger) {
                 lapTrigger = false;
@@ -2672,9 +2158,11 @@ void homeform::gpx_save_clicked() {
     QString path = getWritableAppDir();
 
     if (bluetoothManager->device()) {
-        gpx::save(path + QDateTime::currentDateTime().toString().replace(QStringLiteral(":"), QStringLiteral("_")) +
-                      QStringLiteral(".gpx"),
-                  Session, bluetoothManager->device()->deviceType());
+        exportqueue::job j;
+        j.type = bluetoothManager->device()->deviceType();
+        j.gpxFile = path + QDateTime::currentDateTime().toString().replace(QStringLiteral(":"), QStringLiteral("_")) +
+                    QStringLiteral(".gpx");
+        exportQueue->exportSession(Session, j);
     }
 }
 
@@ -2686,21 +2174,48 @@ void homeform::fit_save_clicked() {
         QString filename = path +
                            QDateTime::currentDateTime().toString().replace(QStringLiteral(":"), QStringLiteral("_")) +
                            QStringLiteral(".fit");
-        qfit::save(filename, Session, dev->deviceType(),
-                   qobject_cast<m3ibike *>(dev) ? QFIT_PROCESS_DISTANCENOISE : QFIT_PROCESS_NONE,
-                   stravaPelotonWorkoutType);
-        lastFitFileSaved = filename;
+        exportqueue::job j;
+        j.type = dev->deviceType();
+        j.fitFile = filename;
+        j.processFlag = qobject_cast<m3ibike *>(dev) ? QFIT_PROCESS_DISTANCENOISE : QFIT_PROCESS_NONE;
+        j.sport = stravaPelotonWorkoutType;
 
         QSettings settings;
         if (!settings.value(QStringLiteral("strava_accesstoken"), QLatin1String("")).toString().isEmpty()) {
+            j.strava = true;
+            j.stravaUpload = stravaUpload();
+        }
+        // written in the background: lastFitFileSaved is set, and the mail with the charts sent, by exportFinished
+        exportQueue->exportSession(Session, j);
+    }
+}
+
+void homeform::exportFinished(const exportqueue::job &j) {
+    if (!j.fitFile.isEmpty()) {
+        lastFitFileSaved = j.fitFile;
+    }
+    if (mailAfterExport && exportQueue->pendingJobs() == 0) {
+        mailAfterExport = false;
+        sendMail();
+        chartImagesFilenames.clear();
+    }
+}
+
+void homeform::exportProgress(const QString &file, int percent) {
+    qDebug() << QStringLiteral("export") << file << percent << QStringLiteral("%");
 
-            QFile f(filename);
-            f.open(QFile::OpenModeFlag::ReadOnly);
-            QByteArray fitfile = f.readAll();
-            strava_upload_file(fitfile, filename);
-            f.close();
+    if (exportQueue->pendingJobs() > 0) {
+        if (infoBeforeExport.isNull()) {
+            infoBeforeExport = m_info;
         }
+        m_info = QStringLiteral("Saving... ") + QString::number(percent) + QStringLiteral("%");
+    } else if (!infoBeforeExport.isNull()) {
+        m_info = infoBeforeExport;
+        infoBeforeExport = QString();
+    } else {
+        return;
     }
+    emit infoChanged(m_info);
 }
 
 void homeform::gpx_open_clicked(const QUrl &fileName) {
@@ -2726,6 +2241,7 @@ void homeform::gpx_open_clicked(const QUrl &fileName) {
                 r.inclination = p.inclination;
                 r.latitude = p.latitude;
                 r.longitude = p.longitude;
+                r.distance = p.distance / 1000.0;
                 r.forcespeed = true;
                 list.append(r);
             }
@@ -2852,12 +2368,50 @@ void homeform::strava_refreshtoken() {
     settings.setValue(QStringLiteral("strava_lastrefresh"), QDateTime::currentDateTime());
 }
 
-bool homeform::strava_upload_file(const QByteArray &data, const QString &remotename) {
+exportqueue::upload homeform::stravaUpload() {
+
+    QSettings settings;
+    exportqueue::upload u;
+
+    // Map some known sports and default to ride for anything else
+    if (bluetoothManager->device()->deviceType() == bluetoothdevice::TREADMILL) {
+        u.activityType = QStringLiteral("run");
+    } else if (bluetoothManager->device()->deviceType() == bluetoothdevice::ROWING) {
+        u.activityType = QStringLiteral("rowing");
+    } else {
+        u.activityType = QStringLiteral("ride");
+    }
+
+    // use metadata config if the user selected it
+    QString activityName =
+        QStringLiteral(" ") + settings.value(QStringLiteral("strava_suffix"), QStringLiteral("#QZ")).toString();
+    if (!stravaPelotonActivityName.isEmpty()) {
+        activityName = stravaPelotonActivityName + QStringLiteral(" - ") + stravaPelotonInstructorName + activityName;
+        if (pelotonHandler && settings.value(QStringLiteral("peloton_description_link"), true).toBool())
+            activityDescription =
+                QStringLiteral("https://members.onepeloton.com/classes/cycling?modal=classDetailsModal&classId=") +
+                pelotonHandler->current_ride_id;
+    } else {
+        if (bluetoothManager->device()->deviceType() == bluetoothdevice::TREADMILL) {
+            activityName = QStringLiteral("Run") + activityName;
+        } else if (bluetoothManager->device()->deviceType() == bluetoothdevice::ROWING) {
+            activityName = QStringLiteral("Row") + activityName;
+        } else {
+            activityName = QStringLiteral("Ride") + activityName;
+        }
+    }
+    u.name = activityName;
+    u.description = activityDescription;
+    return u;
+}
+
+void homeform::strava_upload_file(const exportqueue::upload &u, const QByteArray &data) {
 
     strava_refreshtoken();
 
     QSettings settings;
     QString token = settings.value(QStringLiteral("strava_accesstoken")).toString();
+    QString remotename = u.file;
 
     // The V3 API doc said "https://api.strava.com" but it is not working yet
     QUrl url = QUrl(QStringLiteral("https://www.strava.com/api/v3/uploads"));
@@ -2883,42 +2437,17 @@ bool homeform::strava_upload_file(const QByteArray &data, const QString &remoten
     activityTypePart.setHeader(QNetworkRequest::ContentDispositionHeader,
                                QVariant("form-data; name=\"activity_type\""));
 
-    // Map some known sports and default to ride for anything else
-    if (bluetoothManager->device()->deviceType() == bluetoothdevice::TREADMILL) {
-        activityTypePart.setBody("run");
-    } else if (bluetoothManager->device()->deviceType() == bluetoothdevice::ROWING) {
-        activityTypePart.setBody("rowing");
-    } else {
-        activityTypePart.setBody("ride");
-    }
+    activityTypePart.setBody(u.activityType.toLatin1());
     multiPart->append(activityTypePart);
 
     QHttpPart activityNamePart;
     activityNamePart.setHeader(QNetworkRequest::ContentDispositionHeader,
                                QVariant(QStringLiteral("form-data; name=\"name\"")));
 
-    // use metadata config if the user selected it
-    QString activityName =
-        QStringLiteral(" ") + settings.value(QStringLiteral("strava_suffix"), QStringLiteral("#QZ")).toString();
-    if (!stravaPelotonActivityName.isEmpty()) {
-        activityName = stravaPelotonActivityName + QStringLiteral(" - ") + stravaPelotonInstructorName + activityName;
-        if (pelotonHandler && settings.value(QStringLiteral("peloton_description_link"), true).toBool())
-            activityDescription =
-                QStringLiteral("https://members.onepeloton.com/classes/cycling?modal=classDetailsModal&classId=") +
-                pelotonHandler->current_ride_id;
-    } else {
-        if (bluetoothManager->device()->deviceType() == bluetoothdevice::TREADMILL) {
-            activityName = QStringLiteral("Run") + activityName;
-        } else if (bluetoothManager->device()->deviceType() == bluetoothdevice::ROWING) {
-            activityName = QStringLiteral("Row") + activityName;
-        } else {
-            activityName = QStringLiteral("Ride") + activityName;
-        }
-    }
     activityNamePart.setHeader(QNetworkRequest::ContentTypeHeader,
                                QVariant(QStringLiteral("text/plain;charset=utf-8")));
-    activityNamePart.setBody(activityName.toUtf8());
-    if (activityName != QLatin1String("")) {
+    activityNamePart.setBody(u.name.toUtf8());
+    if (u.name != QLatin1String("")) {
         multiPart->append(activityNamePart);
     }
 
@@ -2927,8 +2456,8 @@ bool homeform::strava_upload_file(const QByteArray &data, const QString &remoten
                                       QVariant(QStringLiteral("form-data; name=\"description\"")));
     activityDescriptionPart.setHeader(QNetworkRequest::ContentTypeHeader,
                                       QVariant(QStringLiteral("text/plain;charset=utf-8")));
-    activityDescriptionPart.setBody(activityDescription.toUtf8());
-    if (activityDescription != QLatin1String("")) {
+    activityDescriptionPart.setBody(u.description.toUtf8());
+    if (u.description != QLatin1String("")) {
         multiPart->append(activityDescriptionPart);
     }
 
@@ -2938,7 +2467,8 @@ bool homeform::strava_upload_file(const QByteArray &data, const QString &remoten
     QHttpPart dataTypePart;
     dataTypePart.setHeader(QNetworkRequest::ContentDispositionHeader,
                            QVariant(QStringLiteral("form-data; name=\"data_type\"")));
-    dataTypePart.setBody("fit");
+    // .fit.gz when strava_upload_gzip is enabled
+    dataTypePart.setBody(remotename.endsWith(QStringLiteral(".gz")) ? "fit.gz" : "fit");
     multiPart->append(dataTypePart);
 
     QHttpPart externalIdPart;
@@ -2970,7 +2500,6 @@ bool homeform::strava_upload_file(const QByteArray &data, const QString &remoten
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 13, 0))
     connect(replyStrava, &QNetworkReply::errorOccurred, this, &homeform::errorOccurredUploadStrava);
 #endif
-    return true;
 }
 
 void homeform::errorOccurredUploadStrava(QNetworkReply::NetworkError code) {
@@ -2987,6 +2516,12 @@ void homeform::writeFileCompleted() {
     // NOTE: clazy-unused-non-trivial-variable
 
     qDebug() << "reply:" << response;
+
+    int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    bool ok = reply->error() == QNetworkReply::NoError && statusCode >= 200 && statusCode < 300;
+    // no network, expired token, rate limit and server errors: the file stays in the queue
+    bool retry = statusCode == 0 || statusCode == 401 || statusCode == 408 || statusCode == 429 || statusCode >= 500;
+    exportQueue->uploadFinished(ok, retry);
 }
 
 void homeform::onStravaGranted() {
@@ -3225,7 +2760,7 @@ void homeform::sendMail() {
     message.addRecipient(new EmailAddress(settings.value(QStringLiteral("user_email"), QLatin1String("")).toString(),
                                           settings.value(QStringLiteral("user_email"), QLatin1String("")).toString()));
     if (!Session.isEmpty()) {
-        QString title = Session.constFirst().time.toString();
+        QString title = Session.first().time.toString();
         if (!stravaPelotonActivityName.isEmpty()) {
             title +=
                 QStringLiteral(" ") + stravaPelotonActivityName + QStringLiteral(" - ") + stravaPelotonInstructorName;
@@ -3410,37 +2945,7 @@ void homeform::sendMail() {
 }
 
 #if defined(Q_OS_ANDROID)
-QString homeform::getAndroidDataAppDir() {
-    static QString path = "";
-
-    if (path.length()) {
-        return path;
-    }
-
-    QAndroidJniObject filesArr = QtAndroid::androidActivity().callObjectMethod(
-        "getExternalFilesDirs", "(Ljava/lang/String;)[Ljava/io/File;", nullptr);
-    jobjectArray dataArray = filesArr.object<jobjectArray>();
-    QString out;
-    if (dataArray) {
-        QAndroidJniEnvironment env;
-        jsize dataSize = env->GetArrayLength(dataArray);
-        if (dataSize) {
-            QAndroidJniObject mediaPath;
-            QAndroidJniObject file;
-            for (int i = 0; i < dataSize; i++) {
-                file = env->GetObjectArrayElement(dataArray, i);
-                jboolean val = QAndroidJniObject::callStaticMethod<jboolean>(
-                    "android/os/Environment", "isExternalStorageRemovable", "(Ljava/io/File;)Z", file.object());
-                mediaPath = file.callObjectMethod("getAbsolutePath", "()Ljava/lang/String;");
-                out = mediaPath.toString();
-                if (!val)
-                    break;
-            }
-        }
-    }
-    path = out;
-    return out;
-}
+QString homeform::getAndroidDataAppDir() { return appdir::androidData(); }
 #endif
 
 void homeform::saveSettings(const QUrl &filename) {
@@ -3473,6 +2978,17 @@ void homeform::loadSettings(const QUrl &filename) {
             settings.setValue(s, settings2Load.value(s));
         }
     }
+    settingssnapshot::reload();
+    tilesModel->reloadSettings();
+}
+
+void homeform::settingsChanged() {
+    // the values already written are used at once. Qt.labs.settings writes its pending values with a delay and
+    // when the settings page is destroyed, so the snapshot is rebuilt again once the page has been popped from the
+    // stack: one timer restarted by every change, instead of a reload per change
+    settingssnapshot::reload();
+    tilesModel->reloadSettings();
+    settingsReloadTimer->start();
 }
 
 double homeform::heartRateMax() {
@@ -2,14 +2,21 @@
 #define HOMEFORM_H
 
 #include "bluetooth.h"
+#include "chartlod.h"
+#include "exportqueue.h"
 
 #include "fit_profile.hpp"
 #include "peloton.h"
+#include "qfitwriter.h"
 #include "screencapture.h"
 #include "sessionline.h"
+#include "sessionstore.h"
+#include "settingssnapshot.h"
 #include "smtpclient/src/SmtpMime"
+#include "tilemodel.h"
 #include "trainprogram.h"
 #include <QChart>
+#include <QXYSeries>
 #include <QColor>
 #include <QGraphicsScene>
 #include <QNetworkReply>
@@ -117,11 +124,6 @@ class homeform : public QObject {
     Q_PROPERTY(QString workoutName READ workoutName)
     Q_PROPERTY(QString instructorName READ instructorName)
     Q_PROPERTY(int workout_sample_points READ workout_sample_points)
-    Q_PROPERTY(QList<double> workout_watt_points READ workout_watt_points)
-    Q_PROPERTY(QList<double> workout_heart_points READ workout_heart_points)
-    Q_PROPERTY(QList<double> workout_cadence_points READ workout_cadence_points)
-    Q_PROPERTY(QList<double> workout_peloton_resistance_points READ workout_peloton_resistance_points)
-    Q_PROPERTY(QList<double> workout_resistance_points READ workout_resistance_points)
     Q_PROPERTY(double wattMaxChart READ wattMaxChart)
     Q_PROPERTY(bool autoResistance READ autoResistance NOTIFY autoResistanceChanged WRITE setAutoResistance)
 
@@ -289,7 +291,7 @@ class homeform : public QObject {
     QString stopColor();
     QString workoutStartDate() {
         if (!Session.isEmpty()) {
-            return Session.constFirst().time.toString();
+            return Session.first().time.toString();
         } else {
             return QLatin1String("");
         }
@@ -351,52 +353,61 @@ class homeform : public QObject {
 
     Q_INVOKABLE void sortTiles();
     Q_INVOKABLE void moveTile(QString name, int newIndex, int oldIndex);
+    Q_INVOKABLE void settingsChanged();
     DataObject *tileFromName(QString name);
 
-    QList<double> workout_watt_points() {
-        QList<double> l;
-        l.reserve(Session.size() + 1);
-        for (const SessionLine &s : qAsConst(Session)) {
-            l.append(s.watt);
+    // fills a series of the end of workout charts with about one point per pixel of its width, x in msecs
+    Q_INVOKABLE void update_chart_series(QtCharts::QAbstractSeries *series, const QString &channel, int pixels) {
+        const chartlod *lod = nullptr;
+        if (channel == QStringLiteral("watt")) {
+            lod = &wattChart;
+        } else if (channel == QStringLiteral("heart")) {
+            lod = &heartChart;
+        } else if (channel == QStringLiteral("cadence")) {
+            lod = &cadenceChart;
+        } else if (channel == QStringLiteral("resistance")) {
+            lod = &resistanceChart;
+        } else if (channel == QStringLiteral("peloton_resistance")) {
+            lod = &pelotonResistanceChart;
         }
-        return l;
-    }
-    QList<double> workout_heart_points() {
-        QList<double> l;
-        l.reserve(Session.size() + 1);
-        for (const SessionLine &s : qAsConst(Session)) {
-            l.append(s.heart);
-        }
-        return l;
-    }
-    QList<double> workout_cadence_points() {
-        QList<double> l;
-        l.reserve(Session.size() + 1);
-        for (const SessionLine &s : qAsConst(Session)) {
-            l.append(s.cadence);
-        }
-        return l;
-    }
-    QList<double> workout_resistance_points() {
-        QList<double> l;
-        l.reserve(Session.size() + 1);
-        for (const SessionLine &s : qAsConst(Session)) {
-            l.append(s.resistance);
+        QtCharts::QXYSeries *xy = qobject_cast<QtCharts::QXYSeries *>(series);
+        // a chart not laid out yet has no width, it's filled again when it gets one
+        if (!lod || !xy || pixels <= 0) {
+            return;
         }
-        return l;
-    }
-    QList<double> workout_peloton_resistance_points() {
-        QList<double> l;
-        l.reserve(Session.size() + 1);
-        for (const SessionLine &s : qAsConst(Session)) {
-            l.append(s.peloton_resistance);
+        QVector<QPointF> points = lod->points(pixels);
+        for (QPointF &p : points) {
+            p.setX(p.x() * 1000.0);
         }
-        return l;
+        // a single change of the series instead of a signal per point
+        xy->replace(points);
     }
 
   private:
+    struct tiledefinition {
+        const char *enabled; // tile_<enabled>_enabled setting
+        bool enabledDefault;
+        const char *order; // tile_<order>_order setting
+        int orderDefault;
+        DataObject *homeform::*object;
+        const char *only = nullptr; // setting that has to be enabled too
+    };
+    static const QList<tiledefinition> &tileDefinitions(bluetoothdevice::BLUETOOTH_TYPE type);
+
     QList<QObject *> dataList;
-    QList<SessionLine> Session;
+    tilemodel *tilesModel;
+    std::shared_ptr<const settingssnapshot> tilesLayoutSettings;
+    bluetoothdevice::BLUETOOTH_TYPE tilesLayoutType = bluetoothdevice::UNKNOWN;
+    sessionstore Session;
+    // level of detail of the charted channels of Session
+    chartlod wattChart;
+    chartlod heartChart;
+    chartlod cadenceChart;
+    chartlod resistanceChart;
+    chartlod pelotonResistanceChart;
+    qfitwriter *fitBackup = nullptr;
+    exportqueue *exportQueue;
+    QString infoBeforeExport;
     bluetooth *bluetoothManager;
     QQmlApplicationEngine *engine;
     trainprogram *trainProgram = nullptr;
@@ -427,7 +438,8 @@ class homeform : public QObject {
     FIT_SPORT stravaPelotonWorkoutType = FIT_SPORT_INVALID;
     QString activityDescription;
 
-    QString lastFitFileSaved = QLatin1String("");
+    QString lastFitFileSaved = QLatin1String(""); // set once the export has written it
+    bool mailAfterExport = false;                   // the charts are saved, the mail waits for the FIT file
 
     QList<QString> chartImagesFilenames;
 
@@ -471,6 +483,7 @@ class homeform : public QObject {
 
     QTimer *timer;
     QTimer *backupTimer;
+    QTimer *settingsReloadTimer; // restarted by settingsChanged()
 
     QString strava_code;
     QOAuth2AuthorizationCodeFlow *strava_connect();
@@ -478,7 +491,8 @@ class homeform : public QObject {
     QNetworkReply *replyStrava;
     QAbstractOAuth::ModifyParametersFunction buildModifyParametersFunction(const QUrl &clientIdentifier,
                                                                            const QUrl &clientIdentifierSharedKey);
-    bool strava_upload_file(const QByteArray &data, const QString &remotename);
+    // Strava upload of the current workout
+    exportqueue::upload stravaUpload();
 
     int16_t fanOverride = 0;
 
@@ -519,6 +533,9 @@ class homeform : public QObject {
     void networkRequestFinished(QNetworkReply *reply);
     void callbackReceived(const QVariantMap &values);
     void writeFileCompleted();
+    void strava_upload_file(const exportqueue::upload &u, const QByteArray &data);
+    void exportProgress(const QString &file, int percent);
+    void exportFinished(const exportqueue::job &j);
     void errorOccurredUploadStrava(QNetworkReply::NetworkError code);
     void pelotonWorkoutStarted(const QString &name, const QString &instructor);
     void pelotonWorkoutChanged(const QString &name, const QString &instructor);
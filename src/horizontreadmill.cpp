@@ -1,7 +1,9 @@
 #include "horizontreadmill.h"
 
 #include "ftmsbike.h"
+#include "ftmscodec.h"
 #include "ios/lockscreen.h"
+#include "packettrace.h"
 #include "virtualtreadmill.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -35,42 +37,37 @@ horizontreadmill::horizontreadmill(bool noWriteResistance, bool noHeartService)
     this->noHeartService = noHeartService;
     initDone = false;
     connect(refresh, &QTimer::timeout, this, &horizontreadmill::update);
+    connect(this, &horizontreadmill::packetReceived, writeQueue(), &blewritequeue::responseReceived);
+    writeQueue()->setPacing(0ms, 3s);
     refresh->start(200ms);
 }
 
 void horizontreadmill::writeCharacteristic(QLowEnergyService *service, QLowEnergyCharacteristic characteristic,
                                            uint8_t *data, uint8_t data_len, QString info, bool disable_log,
-                                           bool wait_for_response) {
-    QEventLoop loop;
-    QTimer timeout;
-
+                                           bool wait_for_response, int coalesce) {
     if (!service) {
         qDebug() << "no gattCustomService available";
         return;
     }
 
-    if (wait_for_response) {
-        connect(this, &horizontreadmill::packetReceived, &loop, &QEventLoop::quit);
-        timeout.singleShot(3000, &loop, SLOT(quit()));
-    } else {
-        connect(service, SIGNAL(characteristicWritten(QLowEnergyCharacteristic, QByteArray)), &loop, SLOT(quit()));
-        timeout.singleShot(3000, &loop, SLOT(quit()));
-    }
-
-    service->writeCharacteristic(characteristic, QByteArray((const char *)data, data_len));
-
-    if (!disable_log)
-        qDebug() << " >> " << QByteArray((const char *)data, data_len).toHex(' ') << " // " << info;
-
-    loop.exec();
+    writeQueue()->write(service, characteristic, QByteArray((const char *)data, data_len), info, disable_log,
+                        wait_for_response, coalesce);
 }
 
-void horizontreadmill::waitForAPacket() {
-    QEventLoop loop;
-    QTimer timeout;
-    connect(this, &horizontreadmill::packetReceived, &loop, &QEventLoop::quit);
-    timeout.singleShot(3000, &loop, SLOT(quit()));
-    loop.exec();
+void horizontreadmill::waitForAPacket() { writeQueue()->waitForResponse(QStringLiteral("waitForAPacket")); }
+
+// request control and start, then the command: the whole sequence is replaced by a newer one still pending
+void horizontreadmill::writeFTMSControlPoint(uint8_t *data, uint8_t data_len, const QString &info, int coalesce) {
+    const QByteArray requestControl(1, (char)FTMS_REQUEST_CONTROL);
+    const QByteArray start(1, (char)FTMS_START_RESUME);
+    writeQueue()->enqueue(QList<blewritequeue::command>()
+                          << blewritequeue::writeCommand(gattFTMSService, gattWriteCharControlPointId, requestControl,
+                                                         QStringLiteral("requestControl"), false, true, coalesce)
+                          << blewritequeue::writeCommand(gattFTMSService, gattWriteCharControlPointId, start,
+                                                         QStringLiteral("start simulation"), false, true, coalesce)
+                          << blewritequeue::writeCommand(gattFTMSService, gattWriteCharControlPointId,
+                                                         QByteArray((const char *)data, data_len), info, false, true,
+                                                         coalesce));
 }
 
 void horizontreadmill::btinit() {
@@ -811,22 +808,14 @@ void horizontreadmill::forceSpeed(double requestSpeed) {
         write[13] = datas[3];
 
         writeCharacteristic(gattCustomService, gattWriteCharCustomService, write, sizeof(write),
-                            QStringLiteral("forceSpeed"), false, true);
+                            QStringLiteral("forceSpeed"), false, true, blewritequeue::COALESCE_SPEED);
     } else if (gattFTMSService) {
         // for the Tecnogym Myrun
-        uint8_t write[] = {FTMS_REQUEST_CONTROL};
-        writeCharacteristic(gattFTMSService, gattWriteCharControlPointId, write, sizeof(write), "requestControl", false,
-                            true);
-        write[0] = {FTMS_START_RESUME};
-        writeCharacteristic(gattFTMSService, gattWriteCharControlPointId, write, sizeof(write), "start simulation",
-                            false, true);
-
         uint8_t writeS[] = {FTMS_SET_TARGET_SPEED, 0x00, 0x00};
         writeS[1] = ((uint16_t)requestSpeed * 100) & 0xFF;
         writeS[2] = ((uint16_t)requestSpeed * 100) >> 8;
 
-        writeCharacteristic(gattFTMSService, gattWriteCharControlPointId, writeS, sizeof(writeS),
-                            QStringLiteral("forceSpeed"), false, true);
+        writeFTMSControlPoint(writeS, sizeof(writeS), QStringLiteral("forceSpeed"), blewritequeue::COALESCE_SPEED);
     }
 }
 
@@ -849,22 +838,15 @@ void horizontreadmill::forceIncline(double requestIncline) {
         write[12] = datas[2];
 
         writeCharacteristic(gattCustomService, gattWriteCharCustomService, write, sizeof(write),
-                            QStringLiteral("forceIncline"), false, true);
+                            QStringLiteral("forceIncline"), false, true, blewritequeue::COALESCE_INCLINATION);
     } else if (gattFTMSService) {
         // for the Tecnogym Myrun
-        uint8_t write[] = {FTMS_REQUEST_CONTROL};
-        writeCharacteristic(gattFTMSService, gattWriteCharControlPointId, write, sizeof(write), "requestControl", false,
-                            true);
-        write[0] = {FTMS_START_RESUME};
-        writeCharacteristic(gattFTMSService, gattWriteCharControlPointId, write, sizeof(write), "start simulation",
-                            false, true);
-
         uint8_t writeS[] = {FTMS_SET_TARGET_INCLINATION, 0x00, 0x00};
         writeS[1] = ((int16_t)requestIncline * 10) & 0xFF;
         writeS[2] = ((int16_t)requestIncline * 10) >> 8;
 
-        writeCharacteristic(gattFTMSService, gattWriteCharControlPointId, writeS, sizeof(writeS),
-                            QStringLiteral("forceIncline"), false, true);
+        writeFTMSControlPoint(writeS, sizeof(writeS), QStringLiteral("forceIncline"),
+                              blewritequeue::COALESCE_INCLINATION);
     }
 }
 
@@ -882,8 +864,7 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + characteristic.uuid().toString() + " " + QString::number(newValue.length()) +
-               " " + newValue.toHex(' '));
+    packettrace::rx(this, newValue, characteristic.uuid());
 
     if (characteristic.uuid() == QBluetoothUuid((quint16)0xFFF4)) {
         if (newValue.at(0) == 0x55) {
@@ -944,99 +925,40 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
         Distance += ((Speed.value() / 3600000.0) *
                      ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
         emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
-    } else if (characteristic.uuid() == QBluetoothUuid((quint16)0x2ACD)) {
+    } else if (characteristic.uuid() == QBluetoothUuid(ftms::treadmill::uuid)) {
         lastPacket = newValue;
 
         // default flags for this treadmill is 84 04
+        ftms::frame<ftms::treadmill> frame;
+        if (!frame.decode(newValue)) {
+            emit debug(QStringLiteral("Treadmill Data shorter than its flags ") + QString::number(frame.flags(), 16));
+        }
+        using field = ftms::treadmill;
 
-        union flags {
-            struct {
-
-                uint16_t moreData : 1;
-                uint16_t avgSpeed : 1;
-                uint16_t totalDistance : 1;
-                uint16_t inclination : 1;
-                uint16_t elevation : 1;
-                uint16_t instantPace : 1;
-                uint16_t averagePace : 1;
-                uint16_t expEnergy : 1;
-                uint16_t heartRate : 1;
-                uint16_t metabolic : 1;
-                uint16_t elapsedTime : 1;
-                uint16_t remainingTime : 1;
-                uint16_t forceBelt : 1;
-                uint16_t spare : 3;
-            };
-
-            uint16_t word_flags;
-        };
-
-        flags Flags;
-        int index = 0;
-        Flags.word_flags = (newValue.at(1) << 8) | newValue.at(0);
-        index += 2;
-
-        if (!Flags.moreData) {
-            Speed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                              (uint16_t)((uint8_t)newValue.at(index)))) /
-                    100.0;
-            index += 2;
+        if (frame.has(field::instantSpeed)) {
+            Speed = frame.value(field::instantSpeed) / 100.0;
             emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
         }
 
-        if (Flags.avgSpeed) {
-            double avgSpeed;
-            avgSpeed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                 (uint16_t)((uint8_t)newValue.at(index)))) /
-                       100.0;
-            index += 2;
-            emit debug(QStringLiteral("Current Average Speed: ") + QString::number(avgSpeed));
+        if (frame.has(field::averageSpeed)) {
+            emit debug(QStringLiteral("Current Average Speed: ") +
+                       QString::number(frame.value(field::averageSpeed) / 100.0));
         }
 
-        if (Flags.totalDistance) {
-            // ignoring the distance, because it's a total life odometer
-            // Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-            // (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint32_t)((uint8_t)newValue.at(index)))) / 1000.0;
-            index += 3;
-        }
-        // else
-        {
-            Distance += ((Speed.value() / 3600000.0) *
-                         ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
-        }
+        // ignoring the total distance, because it's a total life odometer
+        Distance += ((Speed.value() / 3600000.0) *
+                     ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
 
         emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
-        if (Flags.inclination) {
-            Inclination = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                    (uint16_t)((uint8_t)newValue.at(index)))) /
-                          10.0;
-            index += 4; // the ramo value is useless
+        // the ramp angle is useless
+        if (frame.has(field::inclination)) {
+            Inclination = frame.value(field::inclination) / 10.0;
             emit debug(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
         }
 
-        if (Flags.elevation) {
-            index += 4; // TODO
-        }
-
-        if (Flags.instantPace) {
-            index += 1; // TODO
-        }
-
-        if (Flags.averagePace) {
-            index += 1; // TODO
-        }
-
-        if (Flags.expEnergy) {
-            KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                             (uint16_t)((uint8_t)newValue.at(index))));
-            index += 2;
-
-            // energy per hour
-            index += 2;
-
-            // energy per minute
-            index += 1;
+        if (frame.has(field::totalEnergy)) {
+            KCal = frame.value(field::totalEnergy);
         } else {
             if (watts(settings.value(QStringLiteral("weight"), 75.0).toFloat()))
                 KCal += ((((0.048 * ((double)watts(settings.value(QStringLiteral("weight"), 75.0).toFloat())) + 1.19) *
@@ -1056,33 +978,13 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
         else
 #endif
         {
-            if (Flags.heartRate) {
-                if (index < newValue.length()) {
-
-                    heart = ((double)((newValue.at(index))));
-                    emit debug(QStringLiteral("Current Heart: ") + QString::number(heart));
-                } else {
-                    emit debug(QStringLiteral("Error on parsing heart!"));
-                }
-                // index += 1; //NOTE: clang-analyzer-deadcode.DeadStores
+            if (frame.has(field::heartRate)) {
+                heart = frame.value(field::heartRate);
+                emit debug(QStringLiteral("Current Heart: ") + QString::number(heart));
+            } else if (frame.flags() & (1 << 8)) {
+                emit debug(QStringLiteral("Error on parsing heart!"));
             }
         }
-
-        if (Flags.metabolic) {
-            // todo
-        }
-
-        if (Flags.elapsedTime) {
-            // todo
-        }
-
-        if (Flags.remainingTime) {
-            // todo
-        }
-
-        if (Flags.forceBelt) {
-            // todo
-        }
     }
 
     if (heartRateBeltName.startsWith(QStringLiteral("Disabled"))) {
@@ -1208,13 +1110,13 @@ void horizontreadmill::stateChanged(QLowEnergyService::ServiceState state) {
         if (virtual_device_enabled) {
             if (!virtual_device_force_bike) {
                 debug("creating virtual treadmill interface...");
-                virtualTreadmill = new virtualtreadmill(this, noHeartService);
+                virtualTreadmill = virtualtreadmill::create(this, noHeartService);
                 connect(virtualTreadmill, &virtualtreadmill::debug, this, &horizontreadmill::debug);
                 connect(virtualTreadmill, &virtualtreadmill::changeInclination, this,
                         &horizontreadmill::changeInclinationRequested);
             } else {
                 debug("creating virtual bike interface...");
-                virtualBike = new virtualbike(this);
+                virtualBike = virtualbike::create(this);
                 connect(virtualBike, &virtualbike::changeInclination, this,
                         &horizontreadmill::changeInclinationRequested);
             }
@@ -1249,7 +1151,7 @@ void horizontreadmill::descriptorRead(const QLowEnergyDescriptor &descriptor, co
 void horizontreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                              const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void horizontreadmill::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -49,7 +49,9 @@ class horizontreadmill : public treadmill {
 
   private:
     void writeCharacteristic(QLowEnergyService *service, QLowEnergyCharacteristic characteristic, uint8_t *data,
-                             uint8_t data_len, QString info, bool disable_log = false, bool wait_for_response = false);
+                             uint8_t data_len, QString info, bool disable_log = false, bool wait_for_response = false,
+                             int coalesce = blewritequeue::NO_COALESCE);
+    void writeFTMSControlPoint(uint8_t *data, uint8_t data_len, const QString &info, int coalesce);
     void waitForAPacket();
     void startDiscover();
     void btinit();
@@ -0,0 +1,104 @@
+#include "httpcache.h"
+#include "qdebugfixup.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+static const char cacheMagic[] = "QZHTTP1";
+
+httpcache::httpcache(const QString &name) {
+    dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/") + name +
+          QStringLiteral("/");
+}
+
+QString httpcache::fileName(const QUrl &url) const {
+    return dir +
+           QString::fromLatin1(QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Sha1).toHex()) +
+           QStringLiteral(".http");
+}
+
+bool httpcache::read(const QUrl &url, entry &e) const {
+    QFile cache(fileName(url));
+    if (!cache.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&cache);
+    QByteArray magic;
+    QByteArray encoded;
+    in >> magic >> encoded >> e.etag >> e.lastModified >> e.body;
+    // two urls with the same hash would be served the wrong response
+    return in.status() == QDataStream::Ok && magic == cacheMagic && encoded == url.toEncoded();
+}
+
+void httpcache::write(const QUrl &url, const entry &e) const {
+    QDir().mkpath(dir);
+    // a response is replaced only when the new one is complete, a reader never sees half of it
+    QSaveFile cache(fileName(url));
+    if (!cache.open(QIODevice::WriteOnly)) {
+        qDebug() << QStringLiteral("http cache not writable") << cache.fileName();
+        return;
+    }
+    QDataStream out(&cache);
+    out << QByteArray(cacheMagic) << url.toEncoded() << e.etag << e.lastModified << e.body;
+    cache.commit();
+}
+
+void httpcache::prepare(QNetworkRequest &request) const {
+    entry e;
+    if (!read(request.url(), e)) {
+        return;
+    }
+    if (!e.etag.isEmpty()) {
+        request.setRawHeader(QByteArrayLiteral("If-None-Match"), e.etag);
+    }
+    if (!e.lastModified.isEmpty()) {
+        request.setRawHeader(QByteArrayLiteral("If-Modified-Since"), e.lastModified);
+    }
+}
+
+bool httpcache::resend(QNetworkReply *reply, QNetworkRequest &request) const {
+    entry e;
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 304 || read(reply->request().url(), e)) {
+        return false;
+    }
+    qDebug() << QStringLiteral("http cache response lost, sending again") << reply->request().url().path();
+    request = reply->request();
+    // a null value removes the header
+    request.setRawHeader(QByteArrayLiteral("If-None-Match"), QByteArray());
+    request.setRawHeader(QByteArrayLiteral("If-Modified-Since"), QByteArray());
+    return true;
+}
+
+QByteArray httpcache::body(QNetworkReply *reply, bool stale) {
+    const QUrl url = reply->request().url();
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    entry e;
+
+    if (status == 304) {
+        if (read(url, e)) {
+            qDebug() << QStringLiteral("http cache not modified") << url.path();
+            return e.body;
+        }
+        return QByteArray();
+    }
+
+    if (reply->error() != QNetworkReply::NoError) {
+        if (stale && read(url, e)) {
+            qDebug() << QStringLiteral("http cache stale response") << url.path() << reply->error();
+            return e.body;
+        }
+        return reply->readAll();
+    }
+
+    e.body = reply->readAll();
+    e.etag = reply->rawHeader(QByteArrayLiteral("ETag"));
+    e.lastModified = reply->rawHeader(QByteArrayLiteral("Last-Modified"));
+    // a response without validators is still kept for the offline case
+    if (status == 200 && !e.body.isEmpty() && reply->operation() == QNetworkAccessManager::GetOperation) {
+        write(url, e);
+    }
+    return e.body;
+}
@@ -0,0 +1,43 @@
+#ifndef HTTPCACHE_H
+#define HTTPCACHE_H
+
+#include <QByteArray>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QString>
+
+// Responses of the web services of the workout providers, kept on disk with their ETag and Last-Modified.
+// prepare() adds the validators of the stored response to a GET request, so an unchanged resource is answered by
+// a 304 Not Modified without its body; body() returns the stored body in that case, and also when the request
+// fails and the stale copy is allowed, so a class already seen can be found again without network. A 200 replaces
+// the stored response. The validators of the server are used whatever its Cache-Control says: every request still
+// reaches the server when it is online. Nothing removes the responses but the system clearing the cache location,
+// so only the urls asked again and again belong here, not the ones of a single workout.
+class httpcache {
+  public:
+    // the responses are stored in their own directory of the cache location
+    explicit httpcache(const QString &name);
+
+    void prepare(QNetworkRequest &request) const;
+    // reads the reply; stale: the stored body when the request failed
+    QByteArray body(QNetworkReply *reply, bool stale = true);
+    // a 304 whose stored response is gone since prepare(): request is the same request without the validators,
+    // to send again
+    bool resend(QNetworkReply *reply, QNetworkRequest &request) const;
+
+  private:
+    struct entry {
+        QByteArray etag;
+        QByteArray lastModified;
+        QByteArray body;
+    };
+
+    QString fileName(const QUrl &url) const;
+    bool read(const QUrl &url, entry &e) const;
+    void write(const QUrl &url, const entry &e) const;
+
+    QString dir;
+};
+
+#endif // HTTPCACHE_H
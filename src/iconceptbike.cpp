@@ -1,4 +1,5 @@
 #include "iconceptbike.h"
+#include "packettrace.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
 #include <QMetaEnum>
@@ -83,7 +84,7 @@ void iconceptbike::update() {
             bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
             if (virtual_device_enabled) {
                 emit debug(QStringLiteral("creating virtual treadmill interface..."));
-                virtualBike = new virtualbike(this, true);
+                virtualBike = virtualbike::create(this, true);
                 connect(virtualBike, &virtualbike::changeInclination, this, &iconceptbike::changeInclination);
             }
         }
@@ -164,7 +165,7 @@ void iconceptbike::readSocket() {
 
     while (socket->bytesAvailable()) {
         QByteArray line = socket->readAll();
-        qDebug() << QStringLiteral(" << ") + line.toHex(' ');
+        packettrace::rx(this, line);
 
         if (line.length() == 16) {
             elapsed = GetElapsedTimeFromPacket(line);
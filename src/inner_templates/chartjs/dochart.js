@@ -1004,15 +1004,37 @@ function dochart_init() {
     el.enqueue().then(onSettingsOK).catch(function(err) {
             console.error('Error is ' + err);
     })
-    el = new MainWSQueueElement({
-        msg: 'getsessionarray'
+    get_session_array(0, []);
+}
+
+// the history is downloaded in pages of columns, starting from the sequence since
+function get_session_array(since, arr) {
+    let el = new MainWSQueueElement({
+        msg: 'getsessionarray',
+        content: {
+            since: since,
+            max: 1000
+        }
     }, function(msg) {
         if (msg.msg === 'R_getsessionarray') {
             return msg.content;
         }
         return null;
     }, 15000, 3);
-    el.enqueue().then(process_arr).catch(function(err) {
+    el.enqueue().then(function(content) {
+        let n = content.next - content.first;
+        for (let i = 0; i < n; i++) {
+            let sample = {};
+            for (let key in content.columns) {
+                sample[key] = content.columns[key][i];
+            }
+            arr.push(sample);
+        }
+        if (n > 0 && content.next < content.last)
+            get_session_array(content.next, arr);
+        else
+            process_arr(arr);
+    }).catch(function(err) {
         console.error('Error is ' + err);
     });
 }
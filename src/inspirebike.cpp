@@ -1,6 +1,7 @@
 #include "inspirebike.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -49,7 +50,7 @@ wait_for_response)
 data_len));
 
     if(!disable_log)
-        debug(" >> " + QByteArray((const char*)data, data_len).toHex(' ') + " // " + info);
+        packettrace::tx(this, QByteArray((const char*)data, data_len), info);
 
     loop.exec();
 }*/
@@ -131,7 +132,7 @@ void inspirebike::characteristicChanged(const QLowEnergyCharacteristic &characte
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     lastPacket = newValue;
 
@@ -278,7 +279,7 @@ void inspirebike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
                 if (virtual_device_enabled) {
                 emit debug(QStringLiteral("creating virtual bike interface..."));
-                virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
+                virtualBike = virtualbike::create(this, noWriteResistance, noHeartService);
                 // connect(virtualBike,&virtualbike::debug ,this,&inspirebike::debug);
                 connect(virtualBike, &virtualbike::changeInclination, this, &inspirebike::changeInclination);
             }
@@ -306,7 +307,7 @@ void inspirebike::descriptorWritten(const QLowEnergyDescriptor &descriptor, cons
 
 void inspirebike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void inspirebike::serviceScanDone(void) {
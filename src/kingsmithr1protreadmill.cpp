@@ -1,6 +1,7 @@
 #include "kingsmithr1protreadmill.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualtreadmill.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -60,8 +61,8 @@ void kingsmithr1protreadmill::writeCharacteristic(uint8_t *data, uint8_t data_le
             gattWriteCharacteristic, QByteArray((const char *)data, data_len), QLowEnergyService::WriteWithoutResponse);
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info + " " + gattWriteCharacteristic.properties());
+        packettrace::tx(this, QByteArray((const char *)data, data_len),
+                        info + " " + gattWriteCharacteristic.properties());
     }
 
     loop.exec();
@@ -110,11 +111,11 @@ void kingsmithr1protreadmill::update() {
             if (virtual_device_enabled) {
                 if (!virtual_device_force_bike) {
                     debug("creating virtual treadmill interface...");
-                    virtualTreadMill = new virtualtreadmill(this, noHeartService);
+                    virtualTreadMill = virtualtreadmill::create(this, noHeartService);
                     connect(virtualTreadMill, &virtualtreadmill::debug, this, &kingsmithr1protreadmill::debug);
                 } else {
                     debug("creating virtual bike interface...");
-                    virtualBike = new virtualbike(this);
+                    virtualBike = virtualbike::create(this);
                     connect(virtualBike, &virtualbike::changeInclination, this,
                             &kingsmithr1protreadmill::changeInclinationRequested);
                 }
@@ -234,7 +235,7 @@ void kingsmithr1protreadmill::characteristicChanged(const QLowEnergyCharacterist
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    emit debug(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
+    packettrace::rx(this, value);
     emit packetReceived();
 
     lastPacket = value;
@@ -438,7 +439,7 @@ void kingsmithr1protreadmill::descriptorWritten(const QLowEnergyDescriptor &desc
 void kingsmithr1protreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                                     const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void kingsmithr1protreadmill::serviceScanDone(void) {
@@ -1,6 +1,7 @@
 #include "kingsmithr2treadmill.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualtreadmill.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -70,7 +71,7 @@ void kingsmithr2treadmill::writeCharacteristic(const QString &data, const QStrin
     }
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + encrypted.toHex(' ') + QStringLiteral(" // ") + info);
+        packettrace::tx(this, encrypted, info);
     }
 
     loop.exec();
@@ -117,11 +118,11 @@ void kingsmithr2treadmill::update() {
             if (virtual_device_enabled) {
                 if (!virtual_device_force_bike) {
                     debug("creating virtual treadmill interface...");
-                    virtualTreadMill = new virtualtreadmill(this, noHeartService);
+                    virtualTreadMill = virtualtreadmill::create(this, noHeartService);
                     connect(virtualTreadMill, &virtualtreadmill::debug, this, &kingsmithr2treadmill::debug);
                 } else {
                     debug("creating virtual bike interface...");
-                    virtualBike = new virtualbike(this);
+                    virtualBike = virtualbike::create(this);
                     connect(virtualBike, &virtualbike::changeInclination, this,
                             &kingsmithr2treadmill::changeInclinationRequested);
                 }
@@ -225,7 +226,7 @@ void kingsmithr2treadmill::characteristicChanged(const QLowEnergyCharacteristic
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    emit debug(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
+    packettrace::rx(this, value);
 
     buffer.append(value);
     if (value.back() != '\x0d') {
@@ -416,7 +417,7 @@ void kingsmithr2treadmill::descriptorWritten(const QLowEnergyDescriptor &descrip
 void kingsmithr2treadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                                  const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void kingsmithr2treadmill::serviceScanDone(void) {
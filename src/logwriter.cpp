@@ -0,0 +1,187 @@
+#include "logwriter.h"
+#include "appdir.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QMutex>
+#include <QSettings>
+#include <stdio.h>
+
+extern QString logfilename;
+
+static QMutex syncMutex; // only used once the thread is stopped
+
+logwriter *logwriter::instance() {
+    static logwriter *writer = nullptr;
+    static QMutex mutex;
+    QMutexLocker locker(&mutex);
+    if (!writer) {
+        writer = new logwriter(appdir::writable() + logfilename);
+        if (qApp) {
+            QObject::connect(qApp, &QCoreApplication::aboutToQuit, writer, &logwriter::stop, Qt::DirectConnection);
+        }
+        writer->start(QThread::LowPriority);
+    }
+    return writer;
+}
+
+bool logwriter::packetsEnabled() {
+    static const bool enabled = QSettings().value(QStringLiteral("log_binary_packets"), false).toBool();
+    return enabled;
+}
+
+void logwriter::logPacket(const QString &device, bool tx, const QByteArray &data) {
+    if (packetsEnabled()) {
+        instance()->packet(device, tx, data);
+    }
+}
+
+logwriter::logwriter(const QString &filename) : m_queue(QUEUE_SIZE), m_filename(filename), m_file(filename) {
+    QSettings settings;
+    m_maxSize = settings.value(QStringLiteral("log_max_size_mb"), 0).toLongLong() * 1024 * 1024;
+    m_binaryPackets = packetsEnabled();
+
+    m_file.open(QIODevice::WriteOnly | QIODevice::Append);
+    if (m_binaryPackets) {
+        QString name = m_filename;
+        if (name.endsWith(QStringLiteral(".log"))) {
+            name.chop(4);
+        }
+        m_packetFile.setFileName(name + QStringLiteral(".qzpkt"));
+        if (m_packetFile.open(QIODevice::WriteOnly | QIODevice::Append) && m_packetFile.size() == 0) {
+            m_packetFile.write("QZPKT1\n");
+        }
+    }
+}
+
+logwriter::~logwriter() { stop(); }
+
+void logwriter::message(const QString &text) {
+    entry e;
+    e.time = QDateTime::currentMSecsSinceEpoch();
+    e.kind = TEXT;
+    e.text = text.toUtf8();
+    if (m_stopped) {
+        QMutexLocker locker(&syncMutex);
+        QByteArray t, p;
+        format(e, t, p);
+        write(t, p);
+    } else if (!m_queue.push(std::move(e))) {
+        m_dropped++;
+    }
+}
+
+void logwriter::packet(const QString &device, bool tx, const QByteArray &data) {
+    if (!m_binaryPackets) {
+        return;
+    }
+    entry e;
+    e.time = QDateTime::currentMSecsSinceEpoch();
+    e.kind = tx ? PACKET_TX : PACKET_RX;
+    e.text = device.toUtf8().left(255);
+    e.data = data.left(0xFFFF);
+    if (m_stopped) {
+        QMutexLocker locker(&syncMutex);
+        QByteArray t, p;
+        format(e, t, p);
+        write(t, p);
+    } else if (!m_queue.push(std::move(e))) {
+        m_dropped++;
+    }
+}
+
+void logwriter::stop() {
+    if (m_stopped) {
+        return;
+    }
+    m_stop = true;
+    if (isRunning()) {
+        wait();
+    }
+    m_stopped = true;
+    // messages pushed between the last drain and m_stopped
+    QMutexLocker locker(&syncMutex);
+    flush();
+}
+
+void logwriter::run() {
+    while (!m_stop) {
+        msleep(BATCH_INTERVAL_MS);
+        flush();
+    }
+    flush();
+}
+
+void logwriter::flush() {
+    QByteArray text;
+    QByteArray packets;
+    entry e;
+    while (m_queue.pop(e)) {
+        format(e, text, packets);
+    }
+    uint32_t dropped = m_dropped.exchange(0);
+    if (dropped) {
+        text += QByteArray::number(dropped) + " log messages dropped\n";
+    }
+    write(text, packets);
+}
+
+void logwriter::format(const entry &e, QByteArray &text, QByteArray &packets) {
+    if (e.kind == TEXT) {
+        // same prefix as the lines written by the message handler before: date with seconds, then the msecs
+        qint64 second = e.time / 1000;
+        if (second != m_lastSecond) {
+            m_lastSecond = second;
+            m_lastSecondText = QDateTime::fromMSecsSinceEpoch(e.time).toString().toUtf8();
+        }
+        text += m_lastSecondText;
+        text += ' ';
+        text += QByteArray::number(e.time);
+        text += ' ';
+        text += e.text;
+        return;
+    }
+
+    char record[8 + 1 + 1];
+    qint64 t = e.time;
+    for (int i = 0; i < 8; i++) {
+        record[i] = (char)((t >> (8 * i)) & 0xFF);
+    }
+    record[8] = e.kind == PACKET_TX ? 1 : 0;
+    record[9] = (char)e.text.size();
+    packets.append(record, sizeof(record));
+    packets += e.text;
+    packets += (char)(e.data.size() & 0xFF);
+    packets += (char)(e.data.size() >> 8);
+    packets += e.data;
+}
+
+void logwriter::write(const QByteArray &text, const QByteArray &packets) {
+    if (!text.isEmpty()) {
+        if (m_maxSize > 0 && m_file.isOpen() && m_file.size() + text.size() > m_maxSize) {
+            rotate();
+        }
+        if (m_file.isOpen()) {
+            m_file.write(text);
+            m_file.flush();
+        }
+        fwrite(text.constData(), 1, text.size(), stderr);
+    }
+    if (!packets.isEmpty() && m_packetFile.isOpen()) {
+        m_packetFile.write(packets);
+        m_packetFile.flush();
+    }
+}
+
+void logwriter::rotate() {
+    QString name = m_filename;
+    if (name.endsWith(QStringLiteral(".log"))) {
+        name.chop(4);
+    }
+    QString old = name + QStringLiteral(".1.log");
+    m_file.close();
+    QFile::remove(old);
+    QFile::rename(m_filename, old);
+    m_file.setFileName(m_filename);
+    m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
@@ -0,0 +1,78 @@
+#ifndef LOGWRITER_H
+#define LOGWRITER_H
+
+#include "boundedqueue.h"
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QThread>
+
+#include <atomic>
+
+// Debug log sink running on its own thread.
+// The message handler only pushes the message in a lock-free queue; the thread wakes up every
+// BATCH_INTERVAL_MS, formats the timestamps and writes everything queued with a single write. When the
+// queue is full the messages are dropped and counted, and the count is written in the log.
+// The log file is rotated to <name>.1.log when it exceeds log_max_size_mb.
+// With log_binary_packets enabled, the BLE packets passed to packet() are also written to <name>.qzpkt:
+// "QZPKT1\n" followed by records of: int64 msecs since epoch, uint8 direction (0 rx, 1 tx), uint8 device name
+// length, device name, uint16 data length, data (little endian).
+class logwriter : public QThread {
+
+    Q_OBJECT
+  public:
+    static const int QUEUE_SIZE = 8192;
+    static const int BATCH_INTERVAL_MS = 50;
+
+    // the writer of the debug log, started at the first call
+    static logwriter *instance();
+
+    // log_binary_packets setting, read once
+    static bool packetsEnabled();
+    // for the devices: does nothing unless the binary packet log is enabled
+    static void logPacket(const QString &device, bool tx, const QByteArray &data);
+
+    // line already formatted, without the timestamp
+    void message(const QString &text);
+    void packet(const QString &device, bool tx, const QByteArray &data);
+
+    // writes what is still queued and stops the thread, the next messages are written synchronously
+    void stop();
+
+    bool binaryPackets() const { return m_binaryPackets; }
+
+  protected:
+    void run() override;
+
+  private:
+    enum KIND { TEXT = 0, PACKET_RX, PACKET_TX };
+    struct entry {
+        qint64 time = 0;
+        char kind = TEXT;
+        QByteArray text; // message, or device name for the packets
+        QByteArray data;
+    };
+
+    logwriter(const QString &filename);
+    ~logwriter();
+    void flush();
+    void format(const entry &e, QByteArray &text, QByteArray &packets);
+    void write(const QByteArray &text, const QByteArray &packets);
+    void rotate();
+
+    boundedqueue<entry> m_queue;
+    std::atomic<uint32_t> m_dropped{0};
+    std::atomic<bool> m_stop{false};
+    std::atomic<bool> m_stopped{false};
+
+    QString m_filename;
+    QFile m_file;
+    QFile m_packetFile;
+    qint64 m_maxSize;
+    bool m_binaryPackets;
+
+    qint64 m_lastSecond = -1;
+    QByteArray m_lastSecondText;
+};
+
+#endif // LOGWRITER_H
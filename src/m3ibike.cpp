@@ -1,7 +1,9 @@
 #include "m3ibike.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualbike.h"
+#include "workerthread.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
 #include <QFile>
@@ -300,7 +302,7 @@ m3ibike::~m3ibike() {
         delete elapsedTimer;
     }
     if (virtualBike) {
-        delete virtualBike;
+        workerthread::destroy(virtualBike);
     }
     m_instance = 0;
     disconnecting = true;
@@ -610,7 +612,7 @@ void m3ibike::processAdvertising(const QByteArray &data) {
     if (disconnecting) {
         return;
     }
-    emit debug(QStringLiteral(" << ") + data.toHex(' '));
+    packettrace::rx(this, data);
     if (parse_data(data, &k3)) {
         QSettings settings;
         detectDisc->start(M3i_DISCONNECT_THRESHOLD);
@@ -633,7 +635,7 @@ void m3ibike::processAdvertising(const QByteArray &data) {
 #endif
                     if (virtual_device_enabled) {
                     emit debug(QStringLiteral("creating virtual bike interface..."));
-                    virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
+                    virtualBike = virtualbike::create(this, noWriteResistance, noHeartService);
                     // connect(virtualBike, &virtualbike::debug, this, &m3ibike::debug);
                     connect(virtualBike, &virtualbike::changeInclination, this, &m3ibike::changeInclination);
                 }
@@ -754,6 +756,10 @@ void m3ibike::processAdvertising(const QByteArray &data) {
         emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
         emit debug(QStringLiteral("Current Watt: ") + QString::number(watts()));
         emit debug(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
+
+        // the keiser doesn't go through update_metrics
+        publishSnapshot();
+        emit metricsUpdated();
     }
 }
 
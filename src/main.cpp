@@ -12,7 +12,10 @@
 #include "bluetooth.h"
 #include "domyostreadmill.h"
 #include "homeform.h"
+#include "logwriter.h"
 #include "mainwindow.h"
+#include "packetreplay.h"
+#include "packettrace.h"
 #include "qfit.h"
 #include "virtualtreadmill.h"
 #include <QDir>
@@ -48,6 +51,10 @@ bool onlyVirtualTreadmill = false;
 bool testPeloton = false;
 bool testHomeFitnessBudy = false;
 bool testPowerZonePack = false;
+QString replayFile;
+QString replayDevice;
+double replaySpeed = 0; // as fast as possible
+QString replayCharacteristic;
 QString peloton_username = "";
 QString peloton_password = "";
 QString pzp_username = "";
@@ -166,9 +173,25 @@ QCoreApplication *createApplication(int &argc, char *argv[]) {
 
             bikeResistanceOffset = atoi(argv[++i]);
         }
+        if (!qstrcmp(argv[i], "-replay")) {
+
+            replayFile = argv[++i];
+        }
+        if (!qstrcmp(argv[i], "-replay-device")) {
+
+            replayDevice = argv[++i];
+        }
+        if (!qstrcmp(argv[i], "-replay-speed")) {
+
+            replaySpeed = atof(argv[++i]);
+        }
+        if (!qstrcmp(argv[i], "-replay-characteristic")) {
+
+            replayCharacteristic = argv[++i];
+        }
     }
 
-    if (nogui) {
+    if (nogui || !replayFile.isEmpty()) {
         return new QCoreApplication(argc, argv);
     } else if (forceQml) {
         return new QApplication(argc, argv);
@@ -211,53 +234,47 @@ QCoreApplication *createApplication(int &argc, char *argv[]) {
     }
 }
 
-void myMessageOutput(QtMsgType type, const QMessageLogContext &context, const QString &msg) {
-
-    QSettings settings;
-    static bool logdebug = settings.value(QStringLiteral("log_debug"), false).toBool();
+static bool logEnabled() {
+    static bool logdebug = QSettings().value(QStringLiteral("log_debug"), false).toBool();
 #if defined(Q_OS_LINUX) // Linux OS does not read settings file for now
     if((logs == false && !forceQml) || (logdebug == false && forceQml))
 #else
     if (logdebug == false)
 #endif
+        return false;
+    return logs == true || logdebug == true;
+}
+
+void myMessageOutput(QtMsgType type, const QMessageLogContext &context, const QString &msg) {
+
+    if (!logEnabled())
         return;
 
     // QByteArray localMsg = msg.toLocal8Bit(); // NOTE: clazy-unused-non-trivial-variable
     const char *file = context.file ? context.file : "";
     const char *function = context.function ? context.function : "";
-    QString txt = QDateTime::currentDateTime().toString() + QStringLiteral(" ") +
-                  QString::number(QDateTime::currentMSecsSinceEpoch()) + QStringLiteral(" ");
+    // the timestamp is added by the log writer thread
+    QString txt;
     switch (type) {
     case QtInfoMsg:
-        txt += QStringLiteral("Info: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
+        txt = QStringLiteral("Info: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
         break;
     case QtDebugMsg:
-        txt += QStringLiteral("Debug: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
+        txt = QStringLiteral("Debug: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
         break;
     case QtWarningMsg:
-        txt += QStringLiteral("Warning: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
+        txt = QStringLiteral("Warning: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
         break;
     case QtCriticalMsg:
-        txt += QStringLiteral("Critical: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
+        txt = QStringLiteral("Critical: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
         break;
     case QtFatalMsg:
-        txt += QStringLiteral("Fatal: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
+        txt = QStringLiteral("Fatal: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
         abort();
     }
 
-    if (logs == true || logdebug == true) {
-
-        QString path = homeform::getWritableAppDir();
-
-        // Linux log files are generated on binary location
-
-        QFile outFile(path + logfilename);
-        outFile.open(QIODevice::WriteOnly | QIODevice::Append);
-        QTextStream ts(&outFile);
-        ts << txt;
-
-        fprintf(stderr, "%s", txt.toLocal8Bit().constData());
-    }
+    // Linux log files are generated on binary location
+    logwriter::instance()->message(txt);
 
     (*QT_DEFAULT_MESSAGE_HANDLER)(type, context, msg);
 }
@@ -279,7 +296,7 @@ int main(int argc, char *argv[]) {
 
 #ifdef Q_OS_LINUX
 #ifndef Q_OS_ANDROID
-    if (getuid() && !testPeloton && !testHomeFitnessBudy && !testPowerZonePack) {
+    if (getuid() && !testPeloton && !testHomeFitnessBudy && !testPowerZonePack && replayFile.isEmpty()) {
 
         printf("Runme as root!\n");
         return -1;
@@ -331,6 +348,7 @@ int main(int argc, char *argv[]) {
 #endif
 
     qInstallMessageHandler(myMessageOutput);
+    packettrace::setLogEnabled(logEnabled());
     qDebug() << QStringLiteral("version ") << app->applicationVersion();
     foreach (QString s, settings.allKeys()) {
         if (!s.contains(QStringLiteral("password"))) {
@@ -354,14 +372,15 @@ int main(int argc, char *argv[]) {
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
     if (!forceQml) {
         if (onlyVirtualBike) {
-            virtualbike V(new bike(), noWriteResistance,
-                          noHeartService); // FIXED: clang-analyzer-cplusplus.NewDeleteLeaks - potential leak
+            virtualbike *V = virtualbike::create(
+                new bike(), noWriteResistance,
+                noHeartService); // FIXED: clang-analyzer-cplusplus.NewDeleteLeaks - potential leak
 
             Q_UNUSED(V)
             return app->exec();
         } else if (onlyVirtualTreadmill) {
-            virtualtreadmill V(new treadmill(),
-                               noHeartService); // FIXED: clang-analyzer-cplusplus.NewDeleteLeaks - potential leak
+            virtualtreadmill *V = virtualtreadmill::create(
+                new treadmill(), noHeartService); // FIXED: clang-analyzer-cplusplus.NewDeleteLeaks - potential leak
 
             Q_UNUSED(V)
             return app->exec();
@@ -411,13 +430,15 @@ int main(int argc, char *argv[]) {
                 }
             });
             return app->exec();
+        } else if (!replayFile.isEmpty()) {
+            return packetreplay::exec(replayFile, replayDevice, replaySpeed, replayCharacteristic);
         }
     }
 #endif
 
     /* test virtual echelon
      * settings.setValue("virtual_device_echelon", true);
-    virtualbike* V = new virtualbike(new bike(), noWriteResistance, noHeartService);
+    virtualbike* V = virtualbike::create(new bike(), noWriteResistance, noHeartService);
     Q_UNUSED(V)
     return app->exec();*/
     bluetooth bl(logs, deviceName, noWriteResistance, noHeartService, pollDeviceTime, noConsole, testResistance,
@@ -197,6 +197,7 @@ ApplicationWindow {
                     stackView.pop()
                     toolButtonLoadSettings.visible = false;
                     toolButtonSaveSettings.visible = false;
+                    rootItem.settingsChanged()
                     rootItem.sortTiles()
                 } else {
                     drawer.open()
@@ -364,6 +364,7 @@ void MainWindow::loadTrainProgram(const QString &fileName) {
                 r.duration = QTime(0, 0, 0, 0);
                 r.duration = r.duration.addSecs(p.seconds);
                 r.inclination = p.inclination;
+                r.distance = p.distance / 1000.0;
                 r.forcespeed = true;
                 list.append(r);
             }
@@ -496,6 +497,7 @@ void MainWindow::on_difficulty_valueChanged(int value) {
         trainProgram->rows[i].inclination = trainProgram->loadedRows.at(i).inclination +
                                             (trainProgram->loadedRows.at(i).inclination * (0.02 * (value - 50)));
     }
+    trainProgram->invalidate();
 
     int countRow = 0;
     for (const auto &row : qAsConst(trainProgram->rows)) {
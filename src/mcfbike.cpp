@@ -1,6 +1,7 @@
 #include "mcfbike.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -62,8 +63,7 @@ void mcfbike::writeCharacteristic(uint8_t *data, uint8_t data_len, const QString
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        qDebug() << QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                        QStringLiteral(" // ") + info;
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -178,7 +178,7 @@ void mcfbike::characteristicChanged(const QLowEnergyCharacteristic &characterist
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    qDebug() << " << " + newValue.toHex(' ');
+    packettrace::rx(this, newValue);
 
     lastPacket = newValue;
 
@@ -357,8 +357,8 @@ void mcfbike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
                 if (virtual_device_enabled) {
                 qDebug() << QStringLiteral("creating virtual bike interface...");
-                virtualBike =
-                    new virtualbike(this, noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                virtualBike = virtualbike::create(this, noWriteResistance, noHeartService, bikeResistanceOffset,
+                                                  bikeResistanceGain);
                 // connect(virtualBike,&virtualbike::debug ,this,&mcfbike::debug);
                 connect(virtualBike, &virtualbike::changeInclination, this, &mcfbike::changeInclination);
             }
@@ -383,7 +383,7 @@ void mcfbike::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QB
 
 void mcfbike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    qDebug() << QStringLiteral("characteristicWritten ") + newValue.toHex(' ');
+    packettrace::written(this, newValue);
 }
 
 void mcfbike::serviceScanDone(void) {
@@ -1,6 +1,6 @@
 #include "metric.h"
 #include "qdebugfixup.h"
-#include <QSettings>
+#include "settingssnapshot.h"
 
 #ifdef TEST
 static uint32_t random_value_uint32 = 0;
@@ -12,38 +12,36 @@ metric::metric() {}
 void metric::setType(_metric_type t) { m_type = t; }
 
 void metric::setValue(double v) {
-    QSettings settings;
+    const auto settings = settingssnapshot::current();
     if (m_type == METRIC_WATT) {
         if (v > 0) {
-            if (settings.value(QStringLiteral("watt_gain"), 1.0).toDouble() <= 2.00) {
-                if (settings.value(QStringLiteral("watt_gain"), 1.0).toDouble() != 1.0) {
+            if (settings->watt_gain <= 2.00) {
+                if (settings->watt_gain != 1.0) {
                     qDebug() << QStringLiteral("watt value was ") << v
-                             << QStringLiteral("but it will be transformed to")
-                             << v * settings.value(QStringLiteral("watt_gain"), 1.0).toDouble();
+                             << QStringLiteral("but it will be transformed to") << v * settings->watt_gain;
                 }
-                v *= settings.value(QStringLiteral("watt_gain"), 1.0).toDouble();
+                v *= settings->watt_gain;
             }
-            if (settings.value(QStringLiteral("watt_offset"), 0.0).toDouble() < 0) {
-                if (settings.value(QStringLiteral("watt_offset"), 0.0).toDouble() != 0.0) {
+            if (settings->watt_offset < 0) {
+                if (settings->watt_offset != 0.0) {
                     qDebug() << QStringLiteral("watt value was ") << v
-                             << QStringLiteral("but it will be transformed to")
-                             << v + settings.value(QStringLiteral("watt_offset"), 0.0).toDouble();
+                             << QStringLiteral("but it will be transformed to") << v + settings->watt_offset;
                 }
-                v += settings.value(QStringLiteral("watt_offset"), 0.0).toDouble();
+                v += settings->watt_offset;
             }
         }
     } else if (m_type == METRIC_SPEED) {
         if (v > 0) {
-            v *= settings.value(QStringLiteral("speed_gain"), 1.0).toDouble();
-            v += settings.value(QStringLiteral("speed_offset"), 0.0).toDouble();
+            v *= settings->speed_gain;
+            v += settings->speed_offset;
         }
     }
 
-    QDateTime now = QDateTime::currentDateTime();
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
     if (v != m_value) {
-        if (m_last5.count() > 1) {
+        if (m_last.count() > 1) {
             double diff = v - m_value;
-            double diffFromLastValue = qAbs(now.msecsTo(m_lastChanged));
+            double diffFromLastValue = qAbs(now - m_lastChanged);
             if (diffFromLastValue > 0)
                 m_rateAtSec = diff * (1000.0 / diffFromLastValue);
             else
@@ -63,10 +61,7 @@ void metric::setValue(double v) {
         m_lapCountValue++;
         m_totValue += value();
         m_lapTotValue += value();
-        m_last5.append(value());
-
-        if (m_last5.count() > 5)
-            m_last5.removeAt(0);
+        m_last.append(value());
 
         if (value() < m_min) {
             m_min = value();
@@ -94,7 +89,7 @@ void metric::clear(bool accumulator) {
     m_totValue = 0;
     m_countValue = 0;
     m_min = 999999999;
-    m_last5.clear();
+    m_last.clear();
     clearLap(accumulator);
 #ifdef TEST
     random_value_uint8 = 0;
@@ -132,25 +127,7 @@ double metric::lapAverage() {
     }
 }
 
-double metric::average5s() {
-    if (m_last5.count() == 0)
-        return 0;
-    else {
-        double sum = 0;
-        uint8_t c = 0;
-        QMutableListIterator<double> i(m_last5);
-        while (i.hasNext()) {
-            double b = i.next();
-            sum += b;
-            c++;
-        }
-
-        if (c > 0)
-            return (sum / c);
-        else
-            return 0;
-    }
-}
+double metric::average5s() { return m_last.average(5); }
 
 void metric::operator=(double v) { setValue(v); }
 
@@ -179,8 +156,7 @@ void metric::clearLap(bool accumulator) {
 void metric::setLap(bool accumulator) { clearLap(accumulator); }
 
 double metric::calculateSpeedFromPower(double power) {
-    QSettings settings;
-    double twt = 9.8 * (settings.value(QStringLiteral("weight"), 75.0).toFloat() + 0.0); // bike weight is null
+    double twt = 9.8 * (settingssnapshot::current()->weight + 0.0); // bike weight is null
     double aero = 0.22691607640851885;
     double hw = 0; // wind speed
     double tr = twt * 0.005;
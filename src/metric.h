@@ -2,6 +2,7 @@
 #define METRIC_H
 
 #include "qdebugfixup.h"
+#include "rollingmetric.h"
 #include <QDateTime>
 #include <math.h>
 
@@ -50,7 +51,7 @@ class metric {
     double m_min = 999999999;
     double m_max = 0;
     double m_offset = 0;
-    QList<double> m_last5;
+    rollingmetric m_last;
 
     double m_lapOffset = 0;
     double m_lapTotValue = 0;
@@ -58,7 +59,7 @@ class metric {
     double m_lapMin = 999999999;
     double m_lapMax = 0;
 
-    QDateTime m_lastChanged = QDateTime::currentDateTime();
+    qint64 m_lastChanged = QDateTime::currentMSecsSinceEpoch();
     double m_rateAtSec = 0;
 
     _metric_type m_type = METRIC_OTHER;
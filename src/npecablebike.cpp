@@ -1,5 +1,6 @@
 #include "npecablebike.h"
 #include "ios/lockscreen.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -49,7 +50,7 @@ wait_for_response)
 data_len));
 
     if(!disable_log)
-        debug(" >> " + QByteArray((const char*)data, data_len).toHex(' ') + " // " + info);
+        packettrace::tx(this, QByteArray((const char*)data, data_len), info);
 
     loop.exec();
 }*/
@@ -117,7 +118,7 @@ void npecablebike::characteristicChanged(const QLowEnergyCharacteristic &charact
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
     qDebug() << QStringLiteral(" << char ") << characteristic.uuid();
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     if (characteristic.uuid() == QBluetoothUuid((quint16)0x2A5B)) {
         lastPacket = newValue;
@@ -358,7 +359,7 @@ void npecablebike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
             if (virtual_device_enabled) {
             emit debug(QStringLiteral("creating virtual bike interface..."));
-            virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
+            virtualBike = virtualbike::create(this, noWriteResistance, noHeartService);
             // connect(virtualBike,&virtualbike::debug ,this,&npecablebike::debug);
             connect(virtualBike, &virtualbike::changeInclination, this, &npecablebike::changeInclination);
         }
@@ -380,7 +381,7 @@ void npecablebike::descriptorRead(const QLowEnergyDescriptor &descriptor, const
 
 void npecablebike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void npecablebike::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
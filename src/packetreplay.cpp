@@ -0,0 +1,489 @@
+#include "packetreplay.h"
+#include "bluetooth.h"
+#include "qdebugfixup.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QRegularExpression>
+#include <QThread>
+#include <QTimer>
+#include <QUuid>
+#include <functional>
+
+// btsnoop timestamps are microseconds from year 0
+static const qint64 BTSNOOP_EPOCH_DELTA = 0x00dcddb30f2f8000LL;
+
+static quint16 le16(const QByteArray &a, int i) { return (quint8)a.at(i) | ((quint16)(quint8)a.at(i + 1) << 8); }
+
+static QBluetoothUuid uuid128(const QByteArray &a, int i) {
+    // little endian in ATT, big endian in quint128
+    quint128 u;
+    for (int k = 0; k < 16; k++) {
+        u.data[k] = (quint8)a.at(i + 15 - k);
+    }
+    return QBluetoothUuid(u);
+}
+
+packetreplay::packetreplay(QObject *parent) : QObject(parent) {}
+
+bool packetreplay::load(const QString &fileName) {
+    m_packets.clear();
+    m_handles.clear();
+    m_readByType.clear();
+    m_fragments.clear();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << QStringLiteral("replay: can't open") << fileName << file.errorString();
+        return false;
+    }
+    const QByteArray magic = file.peek(8);
+    if (magic == QByteArray("btsnoop\0", 8)) {
+        loadBtsnoop(file);
+    } else if (magic.startsWith("QZPKT1\n")) {
+        loadQzpkt(file);
+    } else {
+        loadDebugLog(file);
+    }
+    qDebug() << QStringLiteral("replay:") << m_packets.count() << QStringLiteral("packets in") << fileName;
+    return !m_packets.isEmpty();
+}
+
+bool packetreplay::loadDebugLog(QFile &file) {
+    // <date> <msecs since epoch> Debug: <file> <function> <message>
+    static const QRegularExpression timeRe(QStringLiteral("\\s(\\d{13})\\s"));
+    static const QRegularExpression classRe(QStringLiteral("(\\w+)::\\w+\\("));
+    static const QRegularExpression byteRe(QStringLiteral("^[0-9a-fA-F]{2}$"));
+
+    qint64 time = 0;
+    QString device; // last class seen in a characteristicChanged() line
+    while (!file.atEnd()) {
+        const QString line = QString::fromUtf8(file.readLine()).trimmed();
+        int rx = line.indexOf(QStringLiteral(" << "));
+        int tx = line.indexOf(QStringLiteral(" >> "));
+        if (rx < 0 && tx < 0) {
+            const int changed = line.indexOf(QStringLiteral("::characteristicChanged("));
+            if (changed >= 0) {
+                const QRegularExpressionMatch m = classRe.match(line.left(changed + 24));
+                if (m.hasMatch()) {
+                    device = m.captured(1);
+                }
+            }
+            continue;
+        }
+        const bool isTx = rx < 0 || (tx >= 0 && tx < rx);
+        const int marker = isTx ? tx : rx;
+        const QString prefix = line.left(marker);
+
+        QRegularExpressionMatch m = timeRe.match(prefix);
+        if (m.hasMatch()) {
+            time = m.captured(1).toLongLong();
+        }
+
+        packet p;
+        p.time = time;
+        p.tx = isTx;
+        m = classRe.match(prefix);
+        // packettrace logs for the device that called it
+        if (m.hasMatch() && m.captured(1) != QStringLiteral("packettrace")) {
+            device = m.captured(1);
+        }
+
+        QString message = line.mid(marker + 4);
+        message = message.left(message.indexOf(QStringLiteral(" // "))); // tx info
+        message.remove(QLatin1Char('"'));
+        QStringList tokens = message.split(QLatin1Char(' '), QString::SkipEmptyParts);
+        // packettrace writes the class of the device first
+        if (!tokens.isEmpty() && tokens.first().startsWith(QLatin1Char('[')) &&
+            tokens.first().endsWith(QLatin1Char(']'))) {
+            device = tokens.takeFirst().mid(1);
+            device.chop(1);
+        }
+        p.device = device;
+        if (!tokens.isEmpty() && tokens.first().startsWith(QLatin1Char('{'))) {
+            p.characteristic = QBluetoothUuid(tokens.takeFirst());
+        }
+        // packettrace writes the length before the bytes
+        bool isNumber = false;
+        int length = tokens.isEmpty() ? -1 : tokens.first().toInt(&isNumber);
+        if (isNumber && length == tokens.count() - 1) {
+            tokens.removeFirst();
+        }
+        for (const QString &t : qAsConst(tokens)) {
+            if (!byteRe.match(t).hasMatch()) {
+                break;
+            }
+            p.data.append((char)t.toUInt(nullptr, 16));
+        }
+        if (!p.data.isEmpty()) {
+            m_packets.append(p);
+        }
+    }
+    return true;
+}
+
+bool packetreplay::loadQzpkt(QFile &file) {
+    // see logwriter
+    const QByteArray data = file.readAll();
+    int i = 7;
+    while (i + 10 <= data.size()) {
+        packet p;
+        for (int k = 0; k < 8; k++) {
+            p.time |= (qint64)(quint8)data.at(i + k) << (8 * k);
+        }
+        p.tx = data.at(i + 8) != 0;
+        const int nameLength = (quint8)data.at(i + 9);
+        i += 10;
+        if (i + nameLength + 2 > data.size()) {
+            break;
+        }
+        p.device = QString::fromUtf8(data.mid(i, nameLength));
+        i += nameLength;
+        const int length = le16(data, i);
+        i += 2;
+        if (i + length > data.size()) {
+            break;
+        }
+        p.data = data.mid(i, length);
+        i += length;
+        m_packets.append(p);
+    }
+    return true;
+}
+
+bool packetreplay::loadBtsnoop(QFile &file) {
+    QDataStream in(&file);
+    in.setByteOrder(QDataStream::BigEndian);
+    in.skipRawData(8);
+    quint32 version, datalink;
+    in >> version >> datalink;
+    // 1001 HCI without the packet type, 1002 HCI UART (H4)
+    if (datalink != 1001 && datalink != 1002) {
+        qDebug() << QStringLiteral("replay: unsupported btsnoop datalink") << datalink;
+        return false;
+    }
+
+    while (!in.atEnd()) {
+        quint32 originalLength, length, flags, drops;
+        qint64 timestamp;
+        in >> originalLength >> length >> flags >> drops >> timestamp;
+        QByteArray data((int)length, 0);
+        if (in.status() != QDataStream::Ok || in.readRawData(data.data(), (int)length) != (int)length) {
+            break;
+        }
+        const bool received = flags & 1;
+        const bool command = flags & 2;
+        const qint64 time = (timestamp - BTSNOOP_EPOCH_DELTA) / 1000;
+
+        int offset = 0;
+        if (datalink == 1002) {
+            if (data.isEmpty() || data.at(0) != 0x02) { // ACL data
+                continue;
+            }
+            offset = 1;
+        } else if (command) {
+            continue;
+        }
+        if (data.size() < offset + 4) {
+            continue;
+        }
+
+        const quint16 header = le16(data, offset);
+        const quint16 connection = header & 0x0FFF;
+        const int boundary = (header >> 12) & 0x03;
+        const QByteArray payload = data.mid(offset + 4, le16(data, offset + 2));
+        if (boundary == 0x01) { // continuing fragment
+            if (!m_fragments.contains(connection)) {
+                continue;
+            }
+            m_fragments[connection] += payload;
+        } else {
+            m_fragments[connection] = payload;
+        }
+
+        const QByteArray l2cap = m_fragments.value(connection);
+        if (l2cap.size() < 4 || l2cap.size() < 4 + le16(l2cap, 0)) {
+            continue;
+        }
+        m_fragments.remove(connection);
+        if (le16(l2cap, 2) == 0x0004) { // ATT channel
+            attPacket(connection, received, time, l2cap.mid(4, le16(l2cap, 0)));
+        }
+    }
+    return true;
+}
+
+void packetreplay::attPacket(quint16 connection, bool received, qint64 time, const QByteArray &att) {
+    if (att.isEmpty()) {
+        return;
+    }
+    const quint8 opcode = att.at(0);
+    switch (opcode) {
+    case 0x08: // read by type request: start handle, end handle, type
+        if (att.size() == 7) {
+            m_readByType.insert(connection, QBluetoothUuid(le16(att, 5)));
+        } else if (att.size() == 21) {
+            m_readByType.insert(connection, uuid128(att, 5));
+        }
+        break;
+    case 0x09: { // read by type response, the characteristic declarations during the discovery
+        if (att.size() < 2 || m_readByType.value(connection) != QBluetoothUuid(QBluetoothUuid::Characteristic)) {
+            break;
+        }
+        // handle, properties, value handle, uuid
+        const int length = (quint8)att.at(1);
+        if (length != 7 && length != 21) {
+            break;
+        }
+        for (int i = 2; i + length <= att.size(); i += length) {
+            const quint16 valueHandle = le16(att, i + 3);
+            const QBluetoothUuid uuid = length == 7 ? QBluetoothUuid(le16(att, i + 5)) : uuid128(att, i + 5);
+            m_handles.insert((quint32)connection << 16 | valueHandle, uuid);
+        }
+        break;
+    }
+    case 0x12: // write request
+    case 0x52: // write command
+    case 0x1B: // notification
+    case 0x1D: // indication
+    {
+        if (att.size() < 3) {
+            break;
+        }
+        packet p;
+        p.time = time;
+        // what the host sends: the writes of the app, or the notifications of a virtual device
+        p.tx = !received;
+        p.characteristic = m_handles.value((quint32)connection << 16 | le16(att, 1));
+        p.data = att.mid(3);
+        m_packets.append(p);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+QString packetreplay::deviceClass() const {
+    QMap<QString, int> count;
+    for (const packet &p : m_packets) {
+        if (!p.device.isEmpty()) {
+            count[p.device]++;
+        }
+    }
+    QString best;
+    for (auto i = count.constBegin(); i != count.constEnd(); ++i) {
+        if (best.isEmpty() || i.value() > count.value(best)) {
+            best = i.key();
+        }
+    }
+    return best;
+}
+
+// every device is created with noWriteResistance and noHeartService
+#define REPLAY_DEVICE(c, ...)                                                                                          \
+    { QStringLiteral(#c), []() -> bluetoothdevice * { return new c(__VA_ARGS__); } }
+
+static const QMap<QString, std::function<bluetoothdevice *()>> &factories() {
+    static const QMap<QString, std::function<bluetoothdevice *()>> f = {
+        REPLAY_DEVICE(activiotreadmill, 200, true, true),
+        REPLAY_DEVICE(bowflextreadmill, 200, true, true),
+        REPLAY_DEVICE(chronobike, true, true),
+        REPLAY_DEVICE(cscbike, true, true, true),
+        REPLAY_DEVICE(domyosbike, true, true, false),
+        REPLAY_DEVICE(domyoselliptical, true, true, false),
+        REPLAY_DEVICE(domyostreadmill, 200, true, true),
+        REPLAY_DEVICE(echelonconnectsport, true, true, 4, 1.0),
+        REPLAY_DEVICE(echelonrower, true, true, 4, 1.0),
+        REPLAY_DEVICE(echelonstride, 200, true, true),
+        REPLAY_DEVICE(eliterizer, true, true),
+        REPLAY_DEVICE(elitesterzosmart, true, true),
+        REPLAY_DEVICE(eslinkertreadmill, 200, true, true),
+        REPLAY_DEVICE(fakebike, true, true, true),
+        REPLAY_DEVICE(fitplusbike, true, true, 4, 1.0),
+        REPLAY_DEVICE(fitshowtreadmill, 200, true, true),
+        REPLAY_DEVICE(flywheelbike, true, true),
+        REPLAY_DEVICE(ftmsbike, true, true, 4, 1.0),
+        REPLAY_DEVICE(ftmsrower, true, true),
+        REPLAY_DEVICE(heartratebelt),
+        REPLAY_DEVICE(horizongr7bike, true, true, 4, 1.0),
+        REPLAY_DEVICE(horizontreadmill, true, true),
+        REPLAY_DEVICE(iconceptbike),
+        REPLAY_DEVICE(inspirebike, true, true),
+        REPLAY_DEVICE(kingsmithr1protreadmill, 200, true, true),
+        REPLAY_DEVICE(kingsmithr2treadmill, 200, true, true),
+        REPLAY_DEVICE(m3ibike, true, true),
+        REPLAY_DEVICE(mcfbike, true, true, 4, 1.0),
+        REPLAY_DEVICE(npecablebike, true, true),
+        REPLAY_DEVICE(pafersbike, true, true, 4, 1.0),
+        REPLAY_DEVICE(proformbike, true, true, 4, 1.0),
+        REPLAY_DEVICE(proformtreadmill, true, true),
+        REPLAY_DEVICE(renphobike, true, true),
+        REPLAY_DEVICE(schwinnic4bike, true, true),
+        REPLAY_DEVICE(shuaa5treadmill, true, true),
+        REPLAY_DEVICE(skandikawiribike, true, true, 4, 1.0),
+        REPLAY_DEVICE(smartrowrower, true, true, 4, 1.0),
+        REPLAY_DEVICE(snodebike, true, true),
+        REPLAY_DEVICE(soleelliptical, true, true, false),
+        REPLAY_DEVICE(solef80treadmill, true, true),
+        REPLAY_DEVICE(spirittreadmill),
+        REPLAY_DEVICE(sportsplusbike, true, true),
+        REPLAY_DEVICE(sportstechbike, true, true),
+        REPLAY_DEVICE(stagesbike, true, true, true),
+        REPLAY_DEVICE(strydrunpowersensor, true, true, true),
+        REPLAY_DEVICE(tacxneo2, true, true),
+        REPLAY_DEVICE(technogymmyruntreadmill, true, true),
+        REPLAY_DEVICE(toorxtreadmill),
+        REPLAY_DEVICE(trxappgateusbbike, true, true),
+        REPLAY_DEVICE(trxappgateusbtreadmill),
+        REPLAY_DEVICE(yesoulbike, true, true),
+    };
+    return f;
+}
+
+#undef REPLAY_DEVICE
+
+QStringList packetreplay::deviceClasses() { return factories().keys(); }
+
+bluetoothdevice *packetreplay::createDevice(const QString &className) {
+    auto f = factories().constFind(className.toLower());
+    if (f == factories().constEnd()) {
+        return nullptr;
+    }
+    bluetoothdevice *device = f.value()();
+    // the parsers check the error of the controller after every packet
+    device->m_control = QLowEnergyController::createCentral(QBluetoothDeviceInfo(), device);
+    // not connected: nothing to poll
+    for (QTimer *t : device->findChildren<QTimer *>()) {
+        t->stop();
+    }
+    return device;
+}
+
+QLowEnergyCharacteristic packetreplay::characteristic(const QBluetoothUuid &uuid) {
+    if (uuid.isNull()) {
+        return QLowEnergyCharacteristic();
+    }
+    auto s = m_services.constFind(uuid);
+    if (s == m_services.constEnd()) {
+        if (!m_peripheral) {
+            m_peripheral = QLowEnergyController::createPeripheral(this);
+        }
+        QLowEnergyCharacteristicData c;
+        c.setUuid(uuid);
+        c.setValue(QByteArray(1, 0));
+        c.setProperties(QLowEnergyCharacteristic::Notify | QLowEnergyCharacteristic::Read);
+        const QLowEnergyDescriptorData clientConfig(QBluetoothUuid::ClientCharacteristicConfiguration,
+                                                    QByteArray(2, 0));
+        c.addDescriptor(clientConfig);
+
+        QLowEnergyServiceData service;
+        service.setType(QLowEnergyServiceData::ServiceTypePrimary);
+        service.setUuid(QBluetoothUuid(QUuid::createUuid()));
+        service.addCharacteristic(c);
+        s = m_services.insert(uuid, m_peripheral->addService(service, this));
+        if (!s.value() || !s.value()->characteristic(uuid).isValid()) {
+            qDebug() << QStringLiteral("replay: can't build the characteristic") << uuid
+                     << QStringLiteral("the parsers will see an invalid one");
+        }
+    }
+    return s.value() ? s.value()->characteristic(uuid) : QLowEnergyCharacteristic();
+}
+
+static QString metricsLine(bluetoothdevice *device) {
+    return QString::number(device->currentSpeed().value(), 'f', 2) + QLatin1Char(';') +
+           QString::number(device->currentCadence().value(), 'f', 0) + QLatin1Char(';') +
+           QString::number(device->wattsMetric().value(), 'f', 0) + QLatin1Char(';') +
+           QString::number(device->currentHeart().value(), 'f', 0) + QLatin1Char(';') +
+           QString::number(device->currentResistance().value(), 'f', 0) + QLatin1Char(';') +
+           QString::number(device->currentInclination().value(), 'f', 1) + QLatin1Char(';') +
+           QString::number(device->odometer(), 'f', 3) + QLatin1Char(';') +
+           QString::number(device->calories().value(), 'f', 1);
+}
+
+packetreplay::result packetreplay::run(bluetoothdevice *device, double speed, const QBluetoothUuid &fallback,
+                                       QTextStream &out) {
+    result r;
+    out << "time;speed;cadence;watt;heart;resistance;inclination;odometer;calories\n";
+
+    qint64 first = -1;
+    QString last;
+    QElapsedTimer clock;
+    QElapsedTimer parse;
+    clock.start();
+    for (const packet &p : qAsConst(m_packets)) {
+        if (p.tx) {
+            continue;
+        }
+        if (first < 0) {
+            first = p.time;
+        }
+        if (speed > 0) {
+            // the timers and the queued signals of the device run meanwhile
+            const qint64 due = (qint64)((p.time - first) / speed);
+            while (clock.elapsed() < due) {
+                QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+                QThread::msleep((unsigned long)qBound((qint64)0, due - clock.elapsed(), (qint64)10));
+            }
+        }
+
+        const QLowEnergyCharacteristic c = characteristic(p.characteristic.isNull() ? fallback : p.characteristic);
+        parse.start();
+        const bool invoked =
+            QMetaObject::invokeMethod(device, "characteristicChanged", Qt::DirectConnection,
+                                      Q_ARG(QLowEnergyCharacteristic, c), Q_ARG(QByteArray, p.data));
+        r.parseNs += parse.nsecsElapsed();
+        if (!invoked) {
+            qDebug() << QStringLiteral("replay:") << device->metaObject()->className()
+                     << QStringLiteral("has no characteristicChanged slot");
+            return r;
+        }
+        r.packets++;
+
+        const QString line = metricsLine(device);
+        if (line != last) {
+            out << (p.time - first) << ';' << line << '\n';
+            last = line;
+            r.metricLines++;
+        }
+    }
+    out.flush();
+    r.ok = true;
+    return r;
+}
+
+int packetreplay::exec(const QString &fileName, const QString &deviceClass, double speed, const QString &fallback) {
+    QTextStream out(stdout);
+    packetreplay replay;
+    if (!replay.load(fileName)) {
+        out << "no packets in " << fileName << '\n';
+        return 1;
+    }
+
+    const QString className = deviceClass.isEmpty() ? replay.deviceClass() : deviceClass;
+    bluetoothdevice *device = createDevice(className);
+    if (!device) {
+        out << "unknown device class '" << className << "', use -replay-device with one of: "
+            << deviceClasses().join(QStringLiteral(", ")) << '\n';
+        return 2;
+    }
+
+    // 2ad2 or the full uuid
+    QBluetoothUuid characteristic;
+    if (!fallback.isEmpty()) {
+        characteristic = fallback.length() <= 4 ? QBluetoothUuid((quint16)fallback.toUShort(nullptr, 16))
+                                                : QBluetoothUuid(fallback);
+    }
+
+    const result r = replay.run(device, speed, characteristic, out);
+    out << "# " << className << ": " << r.packets << " packets, " << r.metricLines << " metric changes, "
+        << r.parseNs / 1000 << " us parsing";
+    if (r.parseNs > 0) {
+        out << ", " << qRound64(r.packets * 1e9 / r.parseNs) << " packets/s";
+    }
+    out << '\n';
+    // the device isn't deleted: its destructor may expect a connection that never existed
+    return r.ok ? 0 : 3;
+}
@@ -0,0 +1,81 @@
+#ifndef PACKETREPLAY_H
+#define PACKETREPLAY_H
+
+#include "bluetoothdevice.h"
+#include <QBluetoothUuid>
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QTextStream>
+
+// Headless replay of a packet capture through the parser of a device class, without a live machine.
+// The packets are read from a qz debug log (the " << " lines written by packettrace, with the class of their device
+// in brackets, and by the devices), a .qzpkt binary log (log_binary_packets) or a btsnoop_hci.log: there the ATT
+// notifications and indications are taken from the ACL data, and their characteristic from the discovery found in
+// the capture.
+// The device is created without connecting it and its timers are stopped, so nothing polls a missing
+// controller; run() calls its characteristicChanged() slot with every received packet, at the original timing
+// sped up by speed, or as fast as possible with speed 0. The characteristics are built by a local
+// peripheral controller, so the parsers that check the uuid see the one of the capture. Every change of the
+// metrics is written as a line of CSV, and the parse throughput at the end.
+// Devices that answer a packet by writing to their service can't be replayed.
+// From the command line: -replay <file> [-replay-device <class>] [-replay-speed <factor>]
+// [-replay-characteristic <uuid>]
+class packetreplay : public QObject {
+
+    Q_OBJECT
+  public:
+    struct packet {
+        qint64 time = 0; // msecs since epoch
+        bool tx = false;
+        QString device;                // class of the device, when the capture records it
+        QBluetoothUuid characteristic; // null when the capture doesn't record it
+        QByteArray data;
+    };
+
+    struct result {
+        int packets = 0;     // received packets fed to the parser
+        int metricLines = 0; // lines of metrics written
+        qint64 parseNs = 0;  // time spent in characteristicChanged()
+        bool ok = false;
+    };
+
+    explicit packetreplay(QObject *parent = nullptr);
+
+    bool load(const QString &fileName);
+    const QList<packet> &packets() const { return m_packets; }
+    // most frequent device class of the capture, empty if it doesn't record one
+    QString deviceClass() const;
+
+    static QStringList deviceClasses();
+    // not connected, nullptr if the class is unknown
+    static bluetoothdevice *createDevice(const QString &className);
+
+    // a characteristic of the local peripheral with this uuid, invalid for a null uuid
+    QLowEnergyCharacteristic characteristic(const QBluetoothUuid &uuid);
+    // the characteristic of the packets that don't have one is fallback
+    result run(bluetoothdevice *device, double speed, const QBluetoothUuid &fallback, QTextStream &out);
+
+    // command line entry point, returns the exit code
+    static int exec(const QString &fileName, const QString &deviceClass, double speed, const QString &fallback);
+
+  private:
+    bool loadDebugLog(QFile &file);
+    bool loadQzpkt(QFile &file);
+    bool loadBtsnoop(QFile &file);
+    void attPacket(quint16 connection, bool received, qint64 time, const QByteArray &att);
+
+    QList<packet> m_packets;
+    // btsnoop: uuid of the characteristic of each value handle, and the type of the last read by type request
+    QHash<quint32, QBluetoothUuid> m_handles;
+    QHash<quint16, QBluetoothUuid> m_readByType;
+    QHash<quint16, QByteArray> m_fragments;
+
+    QLowEnergyController *m_peripheral = nullptr;
+    QHash<QBluetoothUuid, QLowEnergyService *> m_services;
+};
+
+#endif // PACKETREPLAY_H
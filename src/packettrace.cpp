@@ -0,0 +1,74 @@
+#include "packettrace.h"
+#include "logwriter.h"
+#include "qdebugfixup.h"
+#include "settingssnapshot.h"
+
+#include <atomic>
+
+static std::atomic<bool> logEnabled{false};
+
+void packettrace::setLogEnabled(bool enabled) { logEnabled = enabled; }
+
+bool packettrace::enabled(const QObject *device) {
+    if (!logEnabled && !logwriter::packetsEnabled()) {
+        return false;
+    }
+
+    // the snapshot has the filter already split: no lock nor allocation per packet
+    const auto settings = settingssnapshot::current();
+    if (settings->packet_trace_classes.isEmpty() && settings->packet_trace_prefixes.isEmpty()) {
+        return true;
+    }
+    const QLatin1String name(device ? device->metaObject()->className() : "");
+    for (const QString &c : settings->packet_trace_classes) {
+        if (QString::compare(c, name, Qt::CaseInsensitive) == 0) {
+            return true;
+        }
+    }
+    for (const QString &c : settings->packet_trace_prefixes) {
+        if (name.startsWith(c, Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// "[class] ", so packetreplay knows which device the packet belongs to
+static QString tag(const QObject *device) {
+    if (!device) {
+        return QString();
+    }
+    return QLatin1Char('[') + QLatin1String(device->metaObject()->className()) + QStringLiteral("] ");
+}
+
+void packettrace::rx(const QObject *device, const QByteArray &data, const QBluetoothUuid &characteristic) {
+    if (!enabled(device)) {
+        return;
+    }
+    if (logEnabled) {
+        if (characteristic.isNull()) {
+            qDebug() << QStringLiteral(" << ") + tag(device) + QString::number(data.length()) + QStringLiteral(" ") +
+                            data.toHex(' ');
+        } else {
+            qDebug() << QStringLiteral(" << ") + tag(device) + characteristic.toString() + QStringLiteral(" ") +
+                            QString::number(data.length()) + QStringLiteral(" ") + data.toHex(' ');
+        }
+    }
+    logwriter::logPacket(QString::fromLatin1(device ? device->metaObject()->className() : ""), false, data);
+}
+
+void packettrace::tx(const QObject *device, const QByteArray &data, const QString &info) {
+    if (!enabled(device)) {
+        return;
+    }
+    if (logEnabled) {
+        qDebug() << QStringLiteral(" >> ") + tag(device) + data.toHex(' ') + QStringLiteral(" // ") + info;
+    }
+    logwriter::logPacket(QString::fromLatin1(device ? device->metaObject()->className() : ""), true, data);
+}
+
+void packettrace::written(const QObject *device, const QByteArray &data) {
+    if (logEnabled && enabled(device)) {
+        qDebug() << QStringLiteral("characteristicWritten ") + data.toHex(' ');
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef PACKETTRACE_H
+#define PACKETTRACE_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <QtBluetooth/qbluetoothuuid.h>
+
+// Trace of the BLE packets exchanged with the devices.
+// The devices pass the raw bytes, the direction and the characteristic: the hex dump is only built when the trace
+// is enabled for the class of the device, so a polled device doesn't format strings nobody reads. The trace is
+// enabled when the debug log is on and the class name matches the packet_trace_filter setting: a comma separated
+// list of class names (or prefixes ending with *), empty for every device. The packets are written in the debug
+// log, after the class of the device in brackets, and in the binary packet log of logwriter.
+class packettrace {
+
+  public:
+    // called once the debug log is set up
+    static void setLogEnabled(bool enabled);
+
+    static bool enabled(const QObject *device);
+
+    static void rx(const QObject *device, const QByteArray &data,
+                   const QBluetoothUuid &characteristic = QBluetoothUuid());
+    static void tx(const QObject *device, const QByteArray &data, const QString &info = QString());
+    // a write confirmed by the device: only in the debug log, the packet was already traced by tx()
+    static void written(const QObject *device, const QByteArray &data);
+};
+
+#endif // PACKETTRACE_H
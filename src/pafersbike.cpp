@@ -1,6 +1,7 @@
 #include "pafersbike.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -63,8 +64,7 @@ void pafersbike::writeCharacteristic(uint8_t *data, uint8_t data_len, const QStr
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        qDebug() << QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                        QStringLiteral(" // ") + info;
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -192,7 +192,7 @@ void pafersbike::characteristicChanged(const QLowEnergyCharacteristic &character
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    qDebug() << " << " + newValue.toHex(' ');
+    packettrace::rx(this, newValue);
 
     lastPacket = newValue;
 
@@ -346,8 +346,8 @@ void pafersbike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
                 if (virtual_device_enabled) {
                 qDebug() << QStringLiteral("creating virtual bike interface...");
-                virtualBike =
-                    new virtualbike(this, noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                virtualBike = virtualbike::create(this, noWriteResistance, noHeartService, bikeResistanceOffset,
+                                                  bikeResistanceGain);
                 // connect(virtualBike,&virtualbike::debug ,this,&pafersbike::debug);
                 connect(virtualBike, &virtualbike::changeInclination, this, &pafersbike::changeInclination);
             }
@@ -372,7 +372,7 @@ void pafersbike::descriptorWritten(const QLowEnergyDescriptor &descriptor, const
 
 void pafersbike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    qDebug() << QStringLiteral("characteristicWritten ") + newValue.toHex(' ');
+    packettrace::written(this, newValue);
 }
 
 void pafersbike::serviceScanDone(void) {
@@ -1,11 +1,15 @@
 #include "peloton.h"
+#include <QDataStream>
+#include <QDir>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <chrono>
 
 using namespace std::chrono_literals;
 
 const bool log_request = true;
 
-peloton::peloton(bluetooth *bl, QObject *parent) : QObject(parent) {
+peloton::peloton(bluetooth *bl, QObject *parent) : QObject(parent), cache(QStringLiteral("peloton")) {
 
     QSettings settings;
     bluetoothManager = bl;
@@ -41,6 +45,7 @@ void peloton::hfb_trainrows(QList<trainrow> *list) {
     }
     if (!trainrows.isEmpty()) {
 
+        saveTrainrows();
         emit workoutStarted(current_workout_name, current_instructor_name);
     }
 }
@@ -54,10 +59,134 @@ void peloton::pzp_trainrows(QList<trainrow> *list) {
     }
     if (!trainrows.isEmpty()) {
 
+        saveTrainrows();
         emit workoutStarted(current_workout_name, current_instructor_name);
     }
 }
 
+// a compacted copy of the targets of every ride, so a class taken again has them as soon as its ride is known
+static const char trainrowsMagic[] = "QZRIDE1";
+
+static QString trainrowsFileName(const QString &ride_id) {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/peloton/rides/") +
+           ride_id + QStringLiteral(".rows");
+}
+
+bool peloton::loadTrainrows(const QString &ride_id) {
+    if (ride_id.isEmpty()) {
+        return false;
+    }
+    QFile input(trainrowsFileName(ride_id));
+    if (!input.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QSettings settings;
+    QDataStream in(&input);
+    QByteArray magic;
+    QString difficulty;
+    double ftp;
+    qint32 api;
+    QString instructor_name;
+    quint32 count;
+    in >> magic >> difficulty >> ftp >> api >> instructor_name >> count;
+    // the targets depend on the difficulty and, for the power zone classes, on the ftp
+    if (in.status() != QDataStream::Ok || magic != trainrowsMagic ||
+        difficulty != settings.value(QStringLiteral("peloton_difficulty"), QStringLiteral("lower")).toString() ||
+        ftp != settings.value(QStringLiteral("ftp"), 200.0).toDouble()) {
+        return false;
+    }
+
+    // count isn't reserved: a damaged file would ask for any size
+    QList<trainrow> list;
+    for (quint32 i = 0; i < count; i++) {
+        trainrow r;
+        qint32 duration;
+        in >> duration >> r.speed >> r.fanspeed >> r.inclination >> r.resistance >> r.lower_resistance >>
+            r.upper_resistance >> r.requested_peloton_resistance >> r.lower_requested_peloton_resistance >>
+            r.upper_requested_peloton_resistance >> r.cadence >> r.lower_cadence >> r.upper_cadence >>
+            r.forcespeed >> r.loopTimeHR >> r.zoneHR >> r.maxSpeed >> r.power >> r.power_end >> r.mets;
+        r.duration = QTime::fromMSecsSinceStartOfDay(duration);
+        // the resistance of the bike is computed again: the ride can be taken on another bike
+        if (r.requested_peloton_resistance >= 0 && bluetoothManager && bluetoothManager->device()) {
+            bike *b = (bike *)bluetoothManager->device();
+            r.resistance = b->pelotonToBikeResistance(r.requested_peloton_resistance);
+            r.lower_resistance = b->pelotonToBikeResistance(r.lower_requested_peloton_resistance);
+            r.upper_resistance = b->pelotonToBikeResistance(r.upper_requested_peloton_resistance);
+        }
+        list.append(r);
+    }
+    if (in.status() != QDataStream::Ok || list.isEmpty()) {
+        return false;
+    }
+
+    trainrows = list;
+    current_api = (_PELOTON_API)api;
+    if (current_instructor_name.isEmpty()) {
+        current_instructor_name = instructor_name;
+    }
+    qDebug() << QStringLiteral("peloton ride loaded from cache") << ride_id << trainrows.count();
+    return true;
+}
+
+void peloton::saveTrainrows() {
+    if (current_ride_id.isEmpty() || trainrows.isEmpty()) {
+        return;
+    }
+
+    QSettings settings;
+    QString fileName = trainrowsFileName(current_ride_id);
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QSaveFile output(fileName);
+    if (!output.open(QIODevice::WriteOnly)) {
+        qDebug() << QStringLiteral("peloton ride cache not writable") << fileName;
+        return;
+    }
+    QDataStream out(&output);
+    out << QByteArray(trainrowsMagic)
+        << settings.value(QStringLiteral("peloton_difficulty"), QStringLiteral("lower")).toString()
+        << settings.value(QStringLiteral("ftp"), 200.0).toDouble() << (qint32)current_api << current_instructor_name
+        << (quint32)trainrows.count();
+    for (const trainrow &r : qAsConst(trainrows)) {
+        out << (qint32)r.duration.msecsSinceStartOfDay() << r.speed << r.fanspeed << r.inclination << r.resistance
+            << r.lower_resistance << r.upper_resistance << r.requested_peloton_resistance
+            << r.lower_requested_peloton_resistance << r.upper_requested_peloton_resistance << r.cadence
+            << r.lower_cadence << r.upper_cadence << r.forcespeed << r.loopTimeHR << r.zoneHR << r.maxSpeed << r.power
+            << r.power_end << r.mets;
+    }
+    output.commit();
+}
+
+void peloton::watch(QNetworkReply *reply, void (peloton::*onfinish)(QNetworkReply *)) {
+    const QString workout_id = current_workout_id;
+    connect(reply, &QNetworkReply::finished, this, [this, reply, onfinish, workout_id]() {
+        reply->deleteLater();
+        // the reply of a request made for the previous workout
+        if (workout_id != current_workout_id) {
+            qDebug() << QStringLiteral("peloton reply of an old workout") << reply->url();
+            return;
+        }
+        QNetworkRequest request;
+        if (cache.resend(reply, request)) {
+            watch(mgr->get(request), onfinish);
+            return;
+        }
+        (this->*onfinish)(reply);
+    });
+}
+
+void peloton::get(const QUrl &url, void (peloton::*onfinish)(QNetworkReply *), bool cached) {
+    QNetworkRequest request(url);
+
+    request.setHeader(QNetworkRequest::ContentTypeHeader, QStringLiteral("application/json"));
+    request.setHeader(QNetworkRequest::UserAgentHeader, QStringLiteral("qdomyos-zwift"));
+    if (cached) {
+        cache.prepare(request);
+    }
+
+    watch(mgr->get(request), onfinish);
+}
+
 void peloton::startEngine() {
     if (peloton_credentials_wrong) {
         return;
@@ -65,7 +194,6 @@ void peloton::startEngine() {
 
     QSettings settings;
     timer->stop();
-    connect(mgr, &QNetworkAccessManager::finished, this, &peloton::login_onfinish);
     QUrl url(QStringLiteral("https://api.onepeloton.com/auth/login"));
     QNetworkRequest request(url);
 
@@ -80,12 +208,10 @@ void peloton::startEngine() {
     QJsonDocument doc(obj);
     QByteArray data = doc.toJson();
 
-    mgr->post(request, data);
+    watch(mgr->post(request, data), &peloton::login_onfinish);
 }
 
 void peloton::login_onfinish(QNetworkReply *reply) {
-    disconnect(mgr, &QNetworkAccessManager::finished, this, &peloton::login_onfinish);
-
     QByteArray payload = reply->readAll(); // JSON
     QJsonParseError parseError;
     QJsonDocument document = QJsonDocument::fromJson(payload, &parseError);
@@ -114,9 +240,8 @@ void peloton::login_onfinish(QNetworkReply *reply) {
 }
 
 void peloton::workoutlist_onfinish(QNetworkReply *reply) {
-    disconnect(mgr, &QNetworkAccessManager::finished, this, &peloton::workoutlist_onfinish);
-
-    QByteArray payload = reply->readAll(); // JSON
+    // a stale list would start a workout already finished
+    QByteArray payload = cache.body(reply, false); // JSON
     QJsonParseError parseError;
     current_workout = QJsonDocument::fromJson(payload, &parseError);
     QJsonObject json = current_workout.object();
@@ -146,7 +271,16 @@ void peloton::workoutlist_onfinish(QNetworkReply *reply) {
         qDebug() << QStringLiteral("workoutlist_onfinish IN PROGRESS!");
 
         if ((bluetoothManager && bluetoothManager->device()) || testMode) {
+            // the summary, the workout and its performance graph only need the workout id: they are requested
+            // together, the instructor once the workout is known
+            trainrows.clear();
+            performance_trainrows.clear();
+            trainrows_cached = false;
+            current_instructor_name = QLatin1String("");
+            pending = workout_pending | instructor_pending | performance_pending;
             getSummary(id);
+            getWorkout(id);
+            getPerformance(id);
             timer->start(1min); // timeout request
             current_workout_status = status;
         } else {
@@ -169,8 +303,6 @@ void peloton::workoutlist_onfinish(QNetworkReply *reply) {
 }
 
 void peloton::summary_onfinish(QNetworkReply *reply) {
-    disconnect(mgr, &QNetworkAccessManager::finished, this, &peloton::summary_onfinish);
-
     QByteArray payload = reply->readAll(); // JSON
     QJsonParseError parseError;
     current_workout_summary = QJsonDocument::fromJson(payload, &parseError);
@@ -180,15 +312,11 @@ void peloton::summary_onfinish(QNetworkReply *reply) {
     } else {
         qDebug() << QStringLiteral("summary_onfinish");
     }
-
-    getWorkout(current_workout_id);
 }
 
 void peloton::instructor_onfinish(QNetworkReply *reply) {
-    disconnect(mgr, &QNetworkAccessManager::finished, this, &peloton::instructor_onfinish);
-
     QSettings settings;
-    QByteArray payload = reply->readAll(); // JSON
+    QByteArray payload = cache.body(reply); // JSON
     QJsonParseError parseError;
     instructor = QJsonDocument::fromJson(payload, &parseError);
     current_instructor_name = instructor.object()[QStringLiteral("name")].toString();
@@ -213,12 +341,10 @@ void peloton::instructor_onfinish(QNetworkReply *reply) {
     }
     emit workoutChanged(workout_name, current_instructor_name);
 
-    getPerformance(current_workout_id);
+    requestFinished(instructor_pending);
 }
 
 void peloton::workout_onfinish(QNetworkReply *reply) {
-    disconnect(mgr, &QNetworkAccessManager::finished, this, &peloton::workout_onfinish);
-
     QByteArray payload = reply->readAll(); // JSON
     QJsonParseError parseError;
     workout = QJsonDocument::fromJson(payload, &parseError);
@@ -239,22 +365,28 @@ void peloton::workout_onfinish(QNetworkReply *reply) {
     }
 
     getInstructor(current_instructor_id);
+
+    // a ride already taken has its targets without waiting for the other requests
+    if (loadTrainrows(current_ride_id)) {
+        trainrows_cached = true;
+        emit workoutStarted(current_workout_name, current_instructor_name);
+    }
+
+    requestFinished(workout_pending);
 }
 
 void peloton::performance_onfinish(QNetworkReply *reply) {
 
     QSettings settings;
     QString difficulty = settings.value(QStringLiteral("peloton_difficulty"), QStringLiteral("lower")).toString();
-    disconnect(mgr, &QNetworkAccessManager::finished, this, &peloton::performance_onfinish);
     QByteArray payload = reply->readAll(); // JSON
     QJsonParseError parseError;
     performance = QJsonDocument::fromJson(payload, &parseError);
-    current_api = peloton_api;
 
     QJsonObject json = performance.object();
     QJsonObject target_performance_metrics = json[QStringLiteral("target_performance_metrics")].toObject();
     QJsonArray segment_list = json[QStringLiteral("segment_list")].toArray();
-    trainrows.clear();
+    performance_trainrows.clear();
     if (!target_performance_metrics.isEmpty()) {
         QJsonArray target_graph_metrics = target_performance_metrics[QStringLiteral("target_graph_metrics")].toArray();
         QJsonObject resistances = target_graph_metrics[1].toObject();
@@ -268,7 +400,7 @@ void peloton::performance_onfinish(QNetworkReply *reply) {
         QJsonArray lower_cadences = graph_data_cadences[QStringLiteral("lower")].toArray();
         QJsonArray upper_cadences = graph_data_cadences[QStringLiteral("upper")].toArray();
 
-        trainrows.reserve(current_resistances.count() + 1);
+        performance_trainrows.reserve(current_resistances.count() + 1);
         for (int i = 0; i < current_resistances.count(); i++) {
             trainrow r;
             r.duration = QTime(0, 0, peloton_workout_second_resolution, 0);
@@ -289,17 +421,21 @@ void peloton::performance_onfinish(QNetworkReply *reply) {
 
             // in order to have compact rows in the training program to have an Reamining Time tile set correctly
             if (i == 0 ||
-                (r.requested_peloton_resistance != trainrows.last().requested_peloton_resistance ||
-                 r.lower_requested_peloton_resistance != trainrows.last().lower_requested_peloton_resistance ||
-                 r.upper_requested_peloton_resistance != trainrows.last().upper_requested_peloton_resistance ||
-                 r.cadence != trainrows.last().cadence || r.lower_cadence != trainrows.last().lower_cadence ||
-                 r.upper_cadence != trainrows.last().upper_cadence))
-                trainrows.append(r);
+                (r.requested_peloton_resistance != performance_trainrows.last().requested_peloton_resistance ||
+                 r.lower_requested_peloton_resistance !=
+                     performance_trainrows.last().lower_requested_peloton_resistance ||
+                 r.upper_requested_peloton_resistance !=
+                     performance_trainrows.last().upper_requested_peloton_resistance ||
+                 r.cadence != performance_trainrows.last().cadence ||
+                 r.lower_cadence != performance_trainrows.last().lower_cadence ||
+                 r.upper_cadence != performance_trainrows.last().upper_cadence))
+                performance_trainrows.append(r);
             else
-                trainrows.last().duration = trainrows.last().duration.addSecs(peloton_workout_second_resolution);
+                performance_trainrows.last().duration =
+                    performance_trainrows.last().duration.addSecs(peloton_workout_second_resolution);
         }
     } else if (!segment_list.isEmpty() && bluetoothManager->device()->deviceType() != bluetoothdevice::BIKE) {
-        trainrows.reserve(segment_list.count() + 1);
+        performance_trainrows.reserve(segment_list.count() + 1);
         foreach (QJsonValue o, segment_list) {
             int len = o["length"].toInt();
             int mets = o["intensity_in_mets"].toInt();
@@ -307,7 +443,7 @@ void peloton::performance_onfinish(QNetworkReply *reply) {
                 trainrow r;
                 r.duration = QTime(0, len / 60, len % 60, 0);
                 r.mets = mets;
-                trainrows.append(r);
+                performance_trainrows.append(r);
             }
         }
     }
@@ -315,14 +451,29 @@ void peloton::performance_onfinish(QNetworkReply *reply) {
     if (log_request) {
         qDebug() << QStringLiteral("performance_onfinish") << performance;
     } else {
-        qDebug() << QStringLiteral("performance_onfinish") << trainrows.length();
+        qDebug() << QStringLiteral("performance_onfinish") << performance_trainrows.length();
     }
 
-    if (!trainrows.isEmpty()) {
+    requestFinished(performance_pending);
+}
+
+void peloton::requestFinished(int request) {
+    pending &= ~request;
+    if (pending) {
+        return;
+    }
 
+    if (trainrows_cached) {
+        qDebug() << QStringLiteral("peloton targets already loaded from the cache");
+    } else if (!performance_trainrows.isEmpty()) {
+
+        current_api = peloton_api;
+        trainrows = performance_trainrows;
+        saveTrainrows();
         emit workoutStarted(current_workout_name, current_instructor_name);
     } else {
 
+        // the other providers need the ride, its air time and the instructor
         if (!PZP->searchWorkout(current_ride_id)) {
             current_api = homefitnessbuddy_api;
             HFB->searchWorkout(current_original_air_time.date(), current_instructor_name);
@@ -334,53 +485,28 @@ void peloton::performance_onfinish(QNetworkReply *reply) {
     timer->start(30s); // check for a status changed
 }
 
-void peloton::getInstructor(const QString &instructor_id) {
-    connect(mgr, &QNetworkAccessManager::finished, this, &peloton::instructor_onfinish);
 
+void peloton::getInstructor(const QString &instructor_id) {
     QUrl url(QStringLiteral("https://api.onepeloton.com/api/instructor/") + instructor_id);
-    QNetworkRequest request(url);
-
-    request.setHeader(QNetworkRequest::ContentTypeHeader, QStringLiteral("application/json"));
-    request.setHeader(QNetworkRequest::UserAgentHeader, QStringLiteral("qdomyos-zwift"));
-
-    mgr->get(request);
+    get(url, &peloton::instructor_onfinish);
 }
 
 void peloton::getPerformance(const QString &workout) {
-    connect(mgr, &QNetworkAccessManager::finished, this, &peloton::performance_onfinish);
-
     QUrl url(QStringLiteral("https://api.onepeloton.com/api/workout/") + workout +
              QStringLiteral("/performance_graph?every_n=") + QString::number(peloton_workout_second_resolution));
-    QNetworkRequest request(url);
-
-    request.setHeader(QNetworkRequest::ContentTypeHeader, QStringLiteral("application/json"));
-    request.setHeader(QNetworkRequest::UserAgentHeader, QStringLiteral("qdomyos-zwift"));
-
-    mgr->get(request);
+    // the workouts aren't cached: a new id every session, their responses would pile up. A ride already taken keeps
+    // its targets in the trainrows file
+    get(url, &peloton::performance_onfinish, false);
 }
 
 void peloton::getWorkout(const QString &workout) {
-    connect(mgr, &QNetworkAccessManager::finished, this, &peloton::workout_onfinish);
-
     QUrl url(QStringLiteral("https://api.onepeloton.com/api/workout/") + workout);
-    QNetworkRequest request(url);
-
-    request.setHeader(QNetworkRequest::ContentTypeHeader, QStringLiteral("application/json"));
-    request.setHeader(QNetworkRequest::UserAgentHeader, QStringLiteral("qdomyos-zwift"));
-
-    mgr->get(request);
+    get(url, &peloton::workout_onfinish, false);
 }
 
 void peloton::getSummary(const QString &workout) {
-    connect(mgr, &QNetworkAccessManager::finished, this, &peloton::summary_onfinish);
-
     QUrl url(QStringLiteral("https://api.onepeloton.com/api/workout/") + workout + QStringLiteral("/summary"));
-    QNetworkRequest request(url);
-
-    request.setHeader(QNetworkRequest::ContentTypeHeader, QStringLiteral("application/json"));
-    request.setHeader(QNetworkRequest::UserAgentHeader, QStringLiteral("qdomyos-zwift"));
-
-    mgr->get(request);
+    get(url, &peloton::summary_onfinish, false);
 }
 
 void peloton::getWorkoutList(int num) {
@@ -393,19 +519,12 @@ void peloton::getWorkoutList(int num) {
     // int pages = num / limit; //NOTE: clang-analyzer-deadcode.DeadStores
     // int rem = num % limit; //NOTE: clang-analyzer-deadcode.DeadStores
 
-    connect(mgr, &QNetworkAccessManager::finished, this, &peloton::workoutlist_onfinish);
-
     int current_page = 0;
 
     QUrl url(QStringLiteral("https://api.onepeloton.com/api/user/") + user_id +
              QStringLiteral("/workouts?sort_by=-created&page=") + QString::number(current_page) +
              QStringLiteral("&limit=") + QString::number(limit));
-    QNetworkRequest request(url);
-
-    request.setHeader(QNetworkRequest::ContentTypeHeader, QStringLiteral("application/json"));
-    request.setHeader(QNetworkRequest::UserAgentHeader, QStringLiteral("qdomyos-zwift"));
-
-    mgr->get(request);
+    get(url, &peloton::workoutlist_onfinish);
 }
 
 void peloton::setTestMode(bool test) { testMode = test; }
@@ -2,6 +2,7 @@
 #define PELOTON_H
 
 #include "bluetooth.h"
+#include "httpcache.h"
 #include "powerzonepack.h"
 #include "trainprogram.h"
 #include <QAbstractOAuth2>
@@ -51,6 +52,7 @@ class peloton : public QObject {
     const int peloton_workout_second_resolution = 10;
     bool peloton_credentials_wrong = false;
     QNetworkAccessManager *mgr = nullptr;
+    httpcache cache;
 
     QJsonDocument current_workout;
     QJsonDocument current_workout_summary;
@@ -60,6 +62,12 @@ class peloton : public QObject {
 
     QTimer *timer;
 
+    // the requests of a class still running: the targets are chosen once they have all finished
+    enum _PENDING { workout_pending = 1, instructor_pending = 2, performance_pending = 4 };
+    int pending = 0;
+    QList<trainrow> performance_trainrows;
+    bool trainrows_cached = false;
+
     bluetooth *bluetoothManager = nullptr;
     powerzonepack *PZP = nullptr;
     homefitnessbuddy *HFB = nullptr;
@@ -70,6 +78,13 @@ class peloton : public QObject {
     void getWorkout(const QString &workout);
     void getInstructor(const QString &instructor_id);
     void getPerformance(const QString &workout);
+    // cached: through the http cache, only for the urls asked again in the next sessions
+    void get(const QUrl &url, void (peloton::*onfinish)(QNetworkReply *), bool cached = true);
+    void watch(QNetworkReply *reply, void (peloton::*onfinish)(QNetworkReply *));
+    void requestFinished(int request);
+
+    bool loadTrainrows(const QString &ride_id);
+    void saveTrainrows();
 
     bool testMode = false;
 
@@ -1,6 +1,7 @@
 #include "proformtreadmill.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualtreadmill.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -40,8 +41,7 @@ void proformtreadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, cons
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -274,7 +274,7 @@ void proformtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
     bool nordictrack10 = settings.value("nordictrack_10_treadmill", false).toBool();
     double weight = settings.value(QStringLiteral("weight"), 75.0).toFloat();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     lastPacket = newValue;
 
@@ -593,13 +593,13 @@ void proformtreadmill::stateChanged(QLowEnergyService::ServiceState state) {
             if (virtual_device_enabled) {
                 if (!virtual_device_force_bike) {
                     debug("creating virtual treadmill interface...");
-                    virtualTreadmill = new virtualtreadmill(this, noHeartService);
+                    virtualTreadmill = virtualtreadmill::create(this, noHeartService);
                     connect(virtualTreadmill, &virtualtreadmill::debug, this, &proformtreadmill::debug);
                     connect(virtualTreadmill, &virtualtreadmill::changeInclination, this,
                             &proformtreadmill::changeInclinationRequested);
                 } else {
                     debug("creating virtual bike interface...");
-                    virtualBike = new virtualbike(this);
+                    virtualBike = virtualbike::create(this);
                     connect(virtualBike, &virtualbike::changeInclination, this,
                             &proformtreadmill::changeInclinationRequested);
                 }
@@ -626,7 +626,7 @@ void proformtreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor,
 void proformtreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                              const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void proformtreadmill::serviceScanDone(void) {
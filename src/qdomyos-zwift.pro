@@ -46,12 +46,16 @@ android: include(../android_openssl/openssl.pri)
 
 SOURCES += \
     activiotreadmill.cpp \
+   appdir.cpp \
    bike.cpp \
+   blewritequeue.cpp \
 	     bluetooth.cpp \
 		bluetoothdevice.cpp \
     bowflextreadmill.cpp \
+   chartlod.cpp \
    chronobike.cpp \
    cscbike.cpp \
+   deviceregistry.cpp \
 	 domyoselliptical.cpp \
 	     domyostreadmill.cpp \
 		echelonconnectsport.cpp \
@@ -61,6 +65,7 @@ SOURCES += \
    elitesterzosmart.cpp \
 	 elliptical.cpp \
 	eslinkertreadmill.cpp \
+   exportqueue.cpp \
     fakebike.cpp \
     fitmetria_fanfit.cpp \
    fitplusbike.cpp \
@@ -98,26 +103,34 @@ SOURCES += \
 	homeform.cpp \
     horizongr7bike.cpp \
    horizontreadmill.cpp \
+   httpcache.cpp \
    iconceptbike.cpp \
 	inspirebike.cpp \
 	keepawakehelper.cpp \
    kingsmithr1protreadmill.cpp \
    kingsmithr2treadmill.cpp \
+   logwriter.cpp \
 	     main.cpp \
    mcfbike.cpp \
 		metric.cpp \
     npecablebike.cpp \
+   packetreplay.cpp \
+   packettrace.cpp \
    pafersbike.cpp \
    peloton.cpp \
    powerzonepack.cpp \
 	proformbike.cpp \
 	proformtreadmill.cpp \
 	qfit.cpp \
+   qfitwriter.cpp \
    renphobike.cpp \
    rower.cpp \
+   rollingmetric.cpp \
 	schwinnic4bike.cpp \
    screencapture.cpp \
 	sessionline.cpp \
+   sessionstore.cpp \
+   settingssnapshot.cpp \
    shuaa5treadmill.cpp \
 	signalhandler.cpp \
     skandikawiribike.cpp \
@@ -148,6 +161,7 @@ SOURCES += \
     templateinfosender.cpp \
     templateinfosenderbuilder.cpp \
    stagesbike.cpp \
+   tilemodel.cpp \
 	     toorxtreadmill.cpp \
 		  treadmill.cpp \
    trxappgateusbbike.cpp \
@@ -157,6 +171,8 @@ SOURCES += \
 		trxappgateusbtreadmill.cpp \
 	 virtualbike.cpp \
 	     virtualtreadmill.cpp \
+   virtualnotifier.cpp \
+   workerthread.cpp \
              m3ibike.cpp \
                 domyosbike.cpp \
                scanrecordresult.cpp \
@@ -173,12 +189,18 @@ INCLUDEPATH += fit-sdk/
 
 HEADERS += \
     activiotreadmill.h \
+   appdir.h \
    bike.h \
+   blewritequeue.h \
+   boundedqueue.h \
 	bluetooth.h \
 	bluetoothdevice.h \
     bowflextreadmill.h \
+   chartlod.h \
    chronobike.h \
    cscbike.h \
+   devicesnapshot.h \
+   deviceregistry.h \
 	 domyoselliptical.h \
 	domyostreadmill.h \
 	echelonconnectsport.h \
@@ -188,6 +210,7 @@ HEADERS += \
    elitesterzosmart.h \
 	 elliptical.h \
    eslinkertreadmill.h \
+   exportqueue.h \
     fakebike.h \
     fitmetria_fanfit.h \
    fitplusbike.h \
@@ -197,6 +220,7 @@ HEADERS += \
    iconceptbike.h \
    kingsmithr1protreadmill.h \
    kingsmithr2treadmill.h \
+   logwriter.h \
    m3ibike.h \
         fitshowtreadmill.h \
 	fit-sdk/FitDecode.h \
@@ -418,9 +442,11 @@ HEADERS += \
 	fit-sdk/fit_zones_target_mesg_listener.hpp \
 	flywheelbike.h \
 	ftmsbike.h \
+	ftmscodec.h \
 	 heartratebelt.h \
 	homeform.h \
    horizontreadmill.h \
+   httpcache.h \
 	inspirebike.h \
 	ios/lockscreen.h \
 	keepawakehelper.h \
@@ -430,6 +456,8 @@ HEADERS += \
    mcfbike.h \
 	metric.h \
     npecablebike.h \
+   packetreplay.h \
+   packettrace.h \
    pafersbike.h \
    peloton.h \
    powerzonepack.h \
@@ -437,11 +465,16 @@ HEADERS += \
 	proformtreadmill.h \
     qdebugfixup.h \
 	qfit.h \
+   qfitwriter.h \
    renphobike.h \
    rower.h \
+   rollingmetric.h \
 	schwinnic4bike.h \
    screencapture.h \
+   seqlock.h \
 	sessionline.h \
+   sessionstore.h \
+   settingssnapshot.h \
    shuaa5treadmill.h \
 	signalhandler.h \
     skandikawiribike.h \
@@ -474,6 +507,7 @@ HEADERS += \
     templateinfosender.h \
     templateinfosenderbuilder.h \
    stagesbike.h \
+   tilemodel.h \
 	toorxtreadmill.h \
 	gpx.h \
 	treadmill.h \
@@ -484,6 +518,8 @@ HEADERS += \
 	 virtualbike.h \
    virtualrower.h \
 	virtualtreadmill.h \
+   virtualnotifier.h \
+   workerthread.h \
 	 domyosbike.h \
         yesoulbike.h \
         scanrecordresult.h \
@@ -11,56 +11,43 @@
 
 qfit::qfit(QObject *parent) : QObject(parent) {}
 
-void qfit::save(const QString &filename, QList<SessionLine> session, bluetoothdevice::BLUETOOTH_TYPE type,
-                uint32_t processFlag, FIT_SPORT overrideSport) {
-    std::list<fit::RecordMesg> records;
-    fit::Encode encode(fit::ProtocolVersion::V20);
-    if (session.isEmpty()) {
-        return;
-    }
-    std::fstream file;
-    uint32_t firstRealIndex = 0;
-    for (int i = 0; i < session.length(); i++) {
-        if ((session.at(i).speed > 0 && (type == bluetoothdevice::TREADMILL || type == bluetoothdevice::ELLIPTICAL)) ||
-            (session.at(i).cadence > 0 && (type == bluetoothdevice::BIKE || type == bluetoothdevice::ROWING))) {
-            firstRealIndex = i;
-            break;
-        }
-    }
-    double startingDistanceOffset = 0.0;
-    if (!session.isEmpty()) {
-        startingDistanceOffset = session.at(firstRealIndex).distance;
-    }
-
-    file.open(filename.toStdString(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
-
-    if (!file.is_open()) {
-
-        printf("Error opening file ExampleActivity.fit\n");
-        return;
-    }
-
-    QFile output(filename);
-    output.open(QIODevice::WriteOnly);
+bool qfit::isFirstRealLine(const SessionLine &sl, bluetoothdevice::BLUETOOTH_TYPE type) {
+    return (sl.speed > 0 && (type == bluetoothdevice::TREADMILL || type == bluetoothdevice::ELLIPTICAL)) ||
+           (sl.cadence > 0 && (type == bluetoothdevice::BIKE || type == bluetoothdevice::ROWING));
+}
 
+fit::FileIdMesg qfit::fileIdMesg(const SessionLine &first) {
     fit::FileIdMesg fileIdMesg; // Every FIT file requires a File ID message
     fileIdMesg.SetType(FIT_FILE_ACTIVITY);
     fileIdMesg.SetManufacturer(FIT_MANUFACTURER_DEVELOPMENT);
     fileIdMesg.SetProduct(1);
     fileIdMesg.SetSerialNumber(12345);
-    fileIdMesg.SetTimeCreated(session.at(firstRealIndex).time.toSecsSinceEpoch() - 631065600L);
+    fileIdMesg.SetTimeCreated(first.time.toSecsSinceEpoch() - 631065600L);
+    return fileIdMesg;
+}
+
+fit::DeveloperDataIdMesg qfit::developerDataIdMesg() {
+    fit::DeveloperDataIdMesg devIdMesg;
+    for (FIT_UINT8 i = 0; i < 16; i++) {
+
+        devIdMesg.SetApplicationId(i, i);
+    }
+    devIdMesg.SetDeveloperDataIndex(0);
+    return devIdMesg;
+}
 
+fit::SessionMesg qfit::sessionMesg(const SessionLine &first, const SessionLine &last, double startingDistanceOffset,
+                                   bluetoothdevice::BLUETOOTH_TYPE type, FIT_SPORT overrideSport) {
     fit::SessionMesg sessionMesg;
-    sessionMesg.SetTimestamp(session.at(firstRealIndex).time.toSecsSinceEpoch() - 631065600L);
-    sessionMesg.SetStartTime(session.at(firstRealIndex).time.toSecsSinceEpoch() - 631065600L);
-    sessionMesg.SetTotalElapsedTime(session.last().elapsedTime);
-    sessionMesg.SetTotalTimerTime(session.last().time.toSecsSinceEpoch() -
-                                  session.at(firstRealIndex).time.toSecsSinceEpoch());
-    sessionMesg.SetTotalDistance((session.last().distance - startingDistanceOffset) * 1000.0); // meters
-    sessionMesg.SetTotalCalories(session.last().calories);
-    sessionMesg.SetTotalMovingTime(session.last().elapsedTime);
+    sessionMesg.SetTimestamp(first.time.toSecsSinceEpoch() - 631065600L);
+    sessionMesg.SetStartTime(first.time.toSecsSinceEpoch() - 631065600L);
+    sessionMesg.SetTotalElapsedTime(last.elapsedTime);
+    sessionMesg.SetTotalTimerTime(last.time.toSecsSinceEpoch() - first.time.toSecsSinceEpoch());
+    sessionMesg.SetTotalDistance((last.distance - startingDistanceOffset) * 1000.0); // meters
+    sessionMesg.SetTotalCalories(last.calories);
+    sessionMesg.SetTotalMovingTime(last.elapsedTime);
     sessionMesg.SetMinAltitude(0);
-    sessionMesg.SetMaxAltitude(session.last().elevationGain);
+    sessionMesg.SetMaxAltitude(last.elevationGain);
     sessionMesg.SetEvent(FIT_EVENT_SESSION);
     sessionMesg.SetEventType(FIT_EVENT_TYPE_STOP);
     sessionMesg.SetFirstLapIndex(0);
@@ -83,43 +70,42 @@ void qfit::save(const QString &filename, QList<SessionLine> session, bluetoothde
 
         sessionMesg.SetSport(FIT_SPORT_ROWING);
         sessionMesg.SetSubSport(FIT_SUB_SPORT_INDOOR_ROWING);
-        if (session.last().totalStrokes)
-            sessionMesg.SetTotalStrokes(session.last().totalStrokes);
-        if (session.last().avgStrokesRate)
-            sessionMesg.SetAvgStrokeCount(session.last().avgStrokesRate);
-        if (session.last().maxStrokesRate)
-            sessionMesg.SetMaxCadence(session.last().maxStrokesRate);
-        if (session.last().avgStrokesLength)
-            sessionMesg.SetAvgStrokeDistance(session.last().avgStrokesLength);
+        if (last.totalStrokes)
+            sessionMesg.SetTotalStrokes(last.totalStrokes);
+        if (last.avgStrokesRate)
+            sessionMesg.SetAvgStrokeCount(last.avgStrokesRate);
+        if (last.maxStrokesRate)
+            sessionMesg.SetMaxCadence(last.maxStrokesRate);
+        if (last.avgStrokesLength)
+            sessionMesg.SetAvgStrokeDistance(last.avgStrokesLength);
     } else {
 
         sessionMesg.SetSport(FIT_SPORT_CYCLING);
         sessionMesg.SetSubSport(FIT_SUB_SPORT_INDOOR_CYCLING);
     }
+    return sessionMesg;
+}
 
-    fit::DeveloperDataIdMesg devIdMesg;
-    for (FIT_UINT8 i = 0; i < 16; i++) {
-
-        devIdMesg.SetApplicationId(i, i);
-    }
-    devIdMesg.SetDeveloperDataIndex(0);
-
+fit::ActivityMesg qfit::activityMesg(const SessionLine &first, const SessionLine &last) {
     fit::ActivityMesg activityMesg;
-    activityMesg.SetTimestamp(session.at(firstRealIndex).time.toSecsSinceEpoch() - 631065600L);
-    activityMesg.SetTotalTimerTime(session.last().elapsedTime);
+    activityMesg.SetTimestamp(first.time.toSecsSinceEpoch() - 631065600L);
+    activityMesg.SetTotalTimerTime(last.elapsedTime);
     activityMesg.SetNumSessions(1);
     activityMesg.SetType(FIT_ACTIVITY_MANUAL);
     activityMesg.SetEvent(FIT_EVENT_WORKOUT);
     activityMesg.SetEventType(FIT_EVENT_TYPE_START);
-    activityMesg.SetLocalTimestamp(fit::DateTime((time_t)session.last().time.toSecsSinceEpoch())
+    activityMesg.SetLocalTimestamp(fit::DateTime((time_t)last.time.toSecsSinceEpoch())
                                        .GetTimeStamp()); // seconds since 00:00 Dec d31 1989 in local time zone
     activityMesg.SetEvent(FIT_EVENT_ACTIVITY);
     activityMesg.SetEventType(FIT_EVENT_TYPE_STOP);
+    return activityMesg;
+}
 
+fit::LapMesg qfit::lapMesg(const SessionLine &first, bluetoothdevice::BLUETOOTH_TYPE type, FIT_SPORT overrideSport) {
     fit::LapMesg lapMesg;
     lapMesg.SetIntensity(FIT_INTENSITY_ACTIVE);
-    lapMesg.SetStartTime(session.at(firstRealIndex).time.toSecsSinceEpoch() - 631065600L);
-    lapMesg.SetTimestamp(session.at(firstRealIndex).time.toSecsSinceEpoch() - 631065600L);
+    lapMesg.SetStartTime(first.time.toSecsSinceEpoch() - 631065600L);
+    lapMesg.SetTimestamp(first.time.toSecsSinceEpoch() - 631065600L);
     lapMesg.SetEvent(FIT_EVENT_WORKOUT);
     lapMesg.SetEventType(FIT_EVENT_TYPE_STOP);
     lapMesg.SetLapTrigger(FIT_LAP_TRIGGER_TIME);
@@ -138,28 +124,96 @@ void qfit::save(const QString &filename, QList<SessionLine> session, bluetoothde
 
         lapMesg.SetSport(FIT_SPORT_CYCLING);
     }
+    return lapMesg;
+}
+
+void qfit::nextLap(fit::LapMesg &lapMesg, const SessionLine &sl) {
+    lapMesg.SetStartTime(sl.time.toSecsSinceEpoch() - 631065600L);
+    lapMesg.SetTimestamp(sl.time.toSecsSinceEpoch() - 631065600L);
+    lapMesg.SetEvent(FIT_EVENT_WORKOUT);
+    lapMesg.SetEventType(FIT_EVENT_LAP);
+}
+
+void qfit::endLap(fit::LapMesg &lapMesg, const SessionLine &sl) {
+    lapMesg.SetTotalElapsedTime(sl.elapsedTime - lapMesg.GetTotalElapsedTime());
+    lapMesg.SetTotalTimerTime(sl.elapsedTime - lapMesg.GetTotalTimerTime());
+}
+
+void qfit::lastLap(fit::LapMesg &lapMesg, const SessionLine &last) {
+    endLap(lapMesg, last);
+    lapMesg.SetEvent(FIT_EVENT_LAP);
+    lapMesg.SetEventType(FIT_EVENT_TYPE_STOP);
+}
+
+fit::RecordMesg qfit::recordMesg(const SessionLine &sl, double startingDistanceOffset, FIT_DATE_TIME timestamp) {
+    fit::RecordMesg newRecord;
+    newRecord.SetHeartRate(sl.heart);
+    newRecord.SetCadence(sl.cadence);
+    newRecord.SetDistance((sl.distance - startingDistanceOffset) * 1000.0); // meters
+    newRecord.SetSpeed(sl.speed / 3.6);                                     // meter per second
+    newRecord.SetPower(sl.watt);
+    newRecord.SetResistance(sl.resistance);
+    newRecord.SetCalories(sl.calories);
+    newRecord.SetAltitude(sl.elevationGain);
+    newRecord.SetTimestamp(timestamp);
+    return newRecord;
+}
+
+void qfit::save(const QString &filename, const sessionstore &session, bluetoothdevice::BLUETOOTH_TYPE type,
+                uint32_t processFlag, FIT_SPORT overrideSport) {
+    fit::Encode encode(fit::ProtocolVersion::V20);
+    if (session.isEmpty()) {
+        return;
+    }
+    std::fstream file;
+    uint32_t firstRealIndex = 0;
+    for (int i = 0; i < session.count(); i++) {
+        if (isFirstRealLine(session.at(i), type)) {
+            firstRealIndex = i;
+            break;
+        }
+    }
+    double startingDistanceOffset = 0.0;
+    if (!session.isEmpty()) {
+        startingDistanceOffset = session.at(firstRealIndex).distance;
+    }
+
+    file.open(filename.toStdString(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open()) {
+
+        printf("Error opening file ExampleActivity.fit\n");
+        return;
+    }
+
+    QFile output(filename);
+    output.open(QIODevice::WriteOnly);
+
+    fit::LapMesg lapMesg = qfit::lapMesg(session.at(firstRealIndex), type, overrideSport);
 
     encode.Open(file);
-    encode.Write(fileIdMesg);
-    encode.Write(devIdMesg);
-    encode.Write(sessionMesg);
-    encode.Write(activityMesg);
+    encode.Write(fileIdMesg(session.at(firstRealIndex)));
+    encode.Write(developerDataIdMesg());
+    encode.Write(sessionMesg(session.at(firstRealIndex), session.last(), startingDistanceOffset, type, overrideSport));
+    encode.Write(activityMesg(session.at(firstRealIndex), session.last()));
 
     fit::DateTime date((time_t)session.at(firstRealIndex).time.toSecsSinceEpoch());
     SessionLine sl;
+    QVector<double> distanceNoise;
     if (processFlag & QFIT_PROCESS_DISTANCENOISE) {
+        distanceNoise.fill(0.0, session.count());
         double distanceOld = -1.0;
         int startIdx = -1;
-        for (int i = firstRealIndex; i < session.length(); i++) {
+        for (int i = firstRealIndex; i < session.count(); i++) {
 
             sl = session.at(i);
-            if (sl.distance != distanceOld || i == session.length() - 1) {
-                if (i == session.length() - 1 && sl.distance == distanceOld) {
+            if (sl.distance != distanceOld || i == session.count() - 1) {
+                if (i == session.count() - 1 && sl.distance == distanceOld) {
                     i++;
                 }
                 if (startIdx >= 0) {
                     for (int j = startIdx; j < i; j++) {
-                        session[j].distance += 0.1 * (j - startIdx) / (i - startIdx);
+                        distanceNoise[j] += 0.1 * (j - startIdx) / (i - startIdx);
                     }
                 }
                 distanceOld = sl.distance;
@@ -167,44 +221,27 @@ void qfit::save(const QString &filename, QList<SessionLine> session, bluetoothde
             }
         }
     }
-    for (int i = firstRealIndex; i < session.length(); i++) {
+    for (int i = firstRealIndex; i < session.count(); i++) {
 
-        fit::RecordMesg newRecord;
         sl = session.at(i);
-        // fit::DateTime date((time_t)session.at(i).time.toSecsSinceEpoch());
-        newRecord.SetHeartRate(sl.heart);
-        newRecord.SetCadence(sl.cadence);
-        newRecord.SetDistance((sl.distance - startingDistanceOffset) * 1000.0); // meters
-        newRecord.SetSpeed(sl.speed / 3.6);                                     // meter per second
-        newRecord.SetPower(sl.watt);
-        newRecord.SetResistance(sl.resistance);
-        newRecord.SetCalories(sl.calories);
-        newRecord.SetAltitude(sl.elevationGain);
-
+        if (!distanceNoise.isEmpty()) {
+            sl.distance += distanceNoise.at(i);
+        }
         // using just the start point as reference in order to avoid pause time
         // strava ignore the elapsed field
         // this workaround could leads an accuracy issue.
-        newRecord.SetTimestamp(date.GetTimeStamp() + i);
-        encode.Write(newRecord);
+        encode.Write(recordMesg(sl, startingDistanceOffset, date.GetTimeStamp() + i));
 
         if (sl.lapTrigger) {
 
-            lapMesg.SetTotalElapsedTime(sl.elapsedTime - lapMesg.GetTotalElapsedTime());
-            lapMesg.SetTotalTimerTime(sl.elapsedTime - lapMesg.GetTotalTimerTime());
-
+            endLap(lapMesg, sl);
             encode.Write(lapMesg);
 
-            lapMesg.SetStartTime(sl.time.toSecsSinceEpoch() - 631065600L);
-            lapMesg.SetTimestamp(sl.time.toSecsSinceEpoch() - 631065600L);
-            lapMesg.SetEvent(FIT_EVENT_WORKOUT);
-            lapMesg.SetEventType(FIT_EVENT_LAP);
+            nextLap(lapMesg, sl);
         }
     }
 
-    lapMesg.SetTotalElapsedTime(session.last().elapsedTime - lapMesg.GetTotalElapsedTime());
-    lapMesg.SetTotalTimerTime(session.last().elapsedTime - lapMesg.GetTotalTimerTime());
-    lapMesg.SetEvent(FIT_EVENT_LAP);
-    lapMesg.SetEventType(FIT_EVENT_TYPE_STOP);
+    lastLap(lapMesg, session.last());
     encode.Write(lapMesg);
 
     if (!encode.Close()) {
@@ -2,8 +2,15 @@
 #define QFIT_H
 
 #include "bluetoothdevice.h"
+#include "fit_activity_mesg.hpp"
+#include "fit_developer_data_id_mesg.hpp"
+#include "fit_file_id_mesg.hpp"
+#include "fit_lap_mesg.hpp"
 #include "fit_profile.hpp"
+#include "fit_record_mesg.hpp"
+#include "fit_session_mesg.hpp"
 #include "sessionline.h"
+#include "sessionstore.h"
 #include <QFile>
 #include <QGeoCoordinate>
 #include <QObject>
@@ -16,9 +23,24 @@ class qfit : public QObject {
     Q_OBJECT
   public:
     explicit qfit(QObject *parent = nullptr);
-    static void save(const QString &filename, QList<SessionLine> session, bluetoothdevice::BLUETOOTH_TYPE type,
+    static void save(const QString &filename, const sessionstore &session, bluetoothdevice::BLUETOOTH_TYPE type,
                      uint32_t processFlag = QFIT_PROCESS_NONE, FIT_SPORT overrideSport = FIT_SPORT_INVALID);
 
+    // messages of an activity file, shared by save() and qfitwriter
+    static bool isFirstRealLine(const SessionLine &sl, bluetoothdevice::BLUETOOTH_TYPE type);
+    static fit::FileIdMesg fileIdMesg(const SessionLine &first);
+    static fit::DeveloperDataIdMesg developerDataIdMesg();
+    static fit::SessionMesg sessionMesg(const SessionLine &first, const SessionLine &last,
+                                        double startingDistanceOffset, bluetoothdevice::BLUETOOTH_TYPE type,
+                                        FIT_SPORT overrideSport);
+    static fit::ActivityMesg activityMesg(const SessionLine &first, const SessionLine &last);
+    static fit::LapMesg lapMesg(const SessionLine &first, bluetoothdevice::BLUETOOTH_TYPE type,
+                                FIT_SPORT overrideSport);
+    static void endLap(fit::LapMesg &lapMesg, const SessionLine &sl);
+    static void nextLap(fit::LapMesg &lapMesg, const SessionLine &sl);
+    static void lastLap(fit::LapMesg &lapMesg, const SessionLine &last);
+    static fit::RecordMesg recordMesg(const SessionLine &sl, double startingDistanceOffset, FIT_DATE_TIME timestamp);
+
   signals:
 };
 
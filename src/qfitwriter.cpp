@@ -0,0 +1,159 @@
+#include "qfitwriter.h"
+#include "qfit.h"
+#include "qdebugfixup.h"
+
+#include <cstring>
+#include <sstream>
+
+#include "fit_crc.hpp"
+#include "fit_date_time.hpp"
+
+// The FIT CRC has no initial value nor final xor, so it's linear: crc(A + B) = crc(A fed with len(B) zeros) ^
+// crc(B). Feeding zeros is itself linear, so it's applied as a 16x16 bit matrix raised to len(B) by squaring.
+static FIT_UINT16 crcApply(const FIT_UINT16 *op, FIT_UINT16 crc) {
+    FIT_UINT16 r = 0;
+    for (int i = 0; i < 16 && crc; i++, crc >>= 1) {
+        if (crc & 1) {
+            r ^= op[i];
+        }
+    }
+    return r;
+}
+
+static FIT_UINT16 crcCombine(FIT_UINT16 crcA, FIT_UINT16 crcB, qint64 lenB) {
+    FIT_UINT16 op[16];
+    FIT_UINT16 sq[16];
+    for (int i = 0; i < 16; i++) {
+        op[i] = fit::CRC::Get16((FIT_UINT16)(1 << i), 0);
+    }
+    while (lenB > 0) {
+        if (lenB & 1) {
+            crcA = crcApply(op, crcA);
+        }
+        lenB >>= 1;
+        for (int i = 0; i < 16; i++) {
+            sq[i] = crcApply(op, op[i]);
+        }
+        memcpy(op, sq, sizeof(op));
+    }
+    return crcA ^ crcB;
+}
+
+static FIT_UINT16 crcOf(const std::string &data) {
+    return fit::CRC::Calc16(data.data(), (FIT_UINT32)data.size());
+}
+
+qfitwriter::qfitwriter(const QString &filename0, const QString &filename1, bluetoothdevice::BLUETOOTH_TYPE type) {
+    this->type = type;
+    outputs[0].file.setFileName(filename0);
+    outputs[1].file.setFileName(filename1);
+    for (output &o : outputs) {
+        if (!o.file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+            qDebug() << QStringLiteral("qfitwriter: error opening") << o.file.fileName();
+        }
+    }
+}
+
+void qfitwriter::encode(const fit::Mesg &mesg, std::string &out, fit::MesgDefinition *definitions) {
+    std::ostringstream stream(std::ios::out | std::ios::binary);
+    fit::MesgDefinition mesgDefinition(mesg);
+    if (!definitions[mesg.GetLocalNum()].Supports(mesgDefinition)) {
+        mesgDefinition.Write(stream);
+        definitions[mesg.GetLocalNum()] = mesgDefinition;
+    }
+    mesg.Write(stream, &definitions[mesg.GetLocalNum()]);
+    out += stream.str();
+}
+
+bool qfitwriter::writeRecords(output &o) {
+    const std::string &data = o.pending;
+    if (!o.file.seek(FIT_FILE_HDR_SIZE + o.recordsSize) ||
+        o.file.write(data.data(), data.size()) != (qint64)data.size()) {
+        qDebug() << QStringLiteral("qfitwriter: write error") << o.file.errorString();
+        return false;
+    }
+    o.recordsCrc = crcCombine(o.recordsCrc, crcOf(data), data.size());
+    o.recordsSize += data.size();
+    o.pending.clear();
+    return true;
+}
+
+void qfitwriter::append(const SessionLine &sl, FIT_SPORT overrideSport) {
+    int i = m_samples++;
+    if (!outputs[0].file.isOpen() && !outputs[1].file.isOpen()) {
+        return;
+    }
+
+    std::string data;
+    if (!started) {
+        if (!qfit::isFirstRealLine(sl, type)) {
+            return;
+        }
+        started = true;
+        first = sl;
+        startingDistanceOffset = sl.distance;
+        startTimestamp = fit::DateTime((time_t)sl.time.toSecsSinceEpoch()).GetTimeStamp();
+        lapMesg = qfit::lapMesg(sl, type, overrideSport);
+        encode(qfit::fileIdMesg(sl), data, definitions);
+        encode(qfit::developerDataIdMesg(), data, definitions);
+    }
+    last = sl;
+
+    // same timestamps as qfit::save: the start time plus the index of the line in the session
+    encode(qfit::recordMesg(sl, startingDistanceOffset, startTimestamp + i), data, definitions);
+
+    if (sl.lapTrigger) {
+        qfit::endLap(lapMesg, sl);
+        encode(lapMesg, data, definitions);
+        qfit::nextLap(lapMesg, sl);
+    }
+    for (output &o : outputs) {
+        if (o.file.isOpen()) {
+            o.pending += data;
+        }
+    }
+}
+
+bool qfitwriter::writeTrailer(FIT_SPORT overrideSport) {
+    output &o = outputs[next];
+    next = (next + 1) % 2;
+    if (!started || !o.file.isOpen() || !writeRecords(o)) {
+        return false;
+    }
+
+    fit::MesgDefinition trailerDefinitions[FIT_MAX_LOCAL_MESGS];
+    for (int i = 0; i < FIT_MAX_LOCAL_MESGS; i++) {
+        trailerDefinitions[i] = definitions[i];
+    }
+    std::string trailer;
+    fit::LapMesg lap = lapMesg;
+    qfit::lastLap(lap, last);
+    encode(lap, trailer, trailerDefinitions);
+    encode(qfit::sessionMesg(first, last, startingDistanceOffset, type, overrideSport), trailer, trailerDefinitions);
+    encode(qfit::activityMesg(first, last), trailer, trailerDefinitions);
+
+    FIT_FILE_HDR header;
+    header.header_size = FIT_FILE_HDR_SIZE;
+    header.profile_version = FIT_PROFILE_VERSION;
+    header.protocol_version = FIT_PROTOCOL_VERSION;
+    memcpy((FIT_UINT8 *)&header.data_type, ".FIT", 4);
+    header.data_size = (FIT_UINT32)(o.recordsSize + trailer.size());
+    header.crc = fit::CRC::Calc16(&header, FIT_STRUCT_OFFSET(crc, FIT_FILE_HDR));
+
+    FIT_UINT16 crc = fit::CRC::Calc16(&header, FIT_FILE_HDR_SIZE);
+    crc = crcCombine(crc, o.recordsCrc, o.recordsSize);
+    crc = crcCombine(crc, crcOf(trailer), trailer.size());
+    trailer.push_back((char)(crc & 0xFF));
+    trailer.push_back((char)(crc >> 8));
+
+    qint64 end = FIT_FILE_HDR_SIZE + o.recordsSize + trailer.size();
+    if (!o.file.seek(FIT_FILE_HDR_SIZE + o.recordsSize) ||
+        o.file.write(trailer.data(), trailer.size()) != (qint64)trailer.size() || !o.file.resize(end) ||
+        !o.file.seek(0) || o.file.write((const char *)&header, FIT_FILE_HDR_SIZE) != FIT_FILE_HDR_SIZE) {
+        qDebug() << QStringLiteral("qfitwriter: error writing the trailer") << o.file.errorString();
+        return false;
+    }
+    o.file.flush();
+    qDebug() << QStringLiteral("qfitwriter: trailer written") << o.file.fileName() << end << QStringLiteral("bytes");
+    return true;
+}
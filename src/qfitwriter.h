@@ -0,0 +1,61 @@
+#ifndef QFITWRITER_H
+#define QFITWRITER_H
+
+#include "bluetoothdevice.h"
+#include "fit_lap_mesg.hpp"
+#include "fit_mesg_definition.hpp"
+#include "fit_profile.hpp"
+#include "sessionline.h"
+#include <QFile>
+#include <QString>
+
+#include <string>
+
+// Append-only FIT activity writer used for the periodic backup of the session.
+// Every new session line is encoded once as a RecordMesg and kept until it's written. The backup alternates
+// between two files kept open, like the backups before it: writeTrailer() appends the pending records to one of
+// them, then makes it valid by writing only the session/lap/activity messages, the header and the CRC after the
+// records. The next records of that file overwrite the trailer on its next turn, and the other file isn't touched
+// meanwhile, so a crash while writing leaves the previous backup valid.
+// The CRC of the records of each file is kept up to date while they are written, so the trailer never reads the
+// file back. The lines recorded before the device starts moving are skipped, like qfit::save does.
+class qfitwriter {
+
+  public:
+    qfitwriter(const QString &filename0, const QString &filename1, bluetoothdevice::BLUETOOTH_TYPE type);
+
+    void append(const SessionLine &sl, FIT_SPORT overrideSport = FIT_SPORT_INVALID);
+    bool writeTrailer(FIT_SPORT overrideSport = FIT_SPORT_INVALID);
+
+    // number of session lines passed to append(), skipped ones included
+    int samples() const { return m_samples; }
+    bluetoothdevice::BLUETOOTH_TYPE deviceType() const { return type; }
+
+  private:
+    struct output {
+        QFile file;
+        qint64 recordsSize = 0;
+        FIT_UINT16 recordsCrc = 0;
+        std::string pending; // records encoded since the last trailer of this file
+    };
+
+    void encode(const fit::Mesg &mesg, std::string &out, fit::MesgDefinition *definitions);
+    bool writeRecords(output &o);
+
+    output outputs[2];
+    int next = 0; // the file of the next trailer
+    bluetoothdevice::BLUETOOTH_TYPE type;
+    int m_samples = 0;
+    bool started = false;
+
+    SessionLine first;
+    SessionLine last;
+    double startingDistanceOffset = 0.0;
+    FIT_DATE_TIME startTimestamp = 0;
+    fit::LapMesg lapMesg;
+
+    // definitions in effect at the end of the records, the same in both files: the trailer starts from a copy
+    fit::MesgDefinition definitions[FIT_MAX_LOCAL_MESGS];
+};
+
+#endif // QFITWRITER_H
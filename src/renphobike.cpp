@@ -1,5 +1,6 @@
 #include "renphobike.h"
 #include "ios/lockscreen.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -44,7 +45,7 @@ void renphobike::writeCharacteristic(uint8_t *data, uint8_t data_len, QString in
     gattFTMSService->writeCharacteristic(gattWriteCharControlPointId, QByteArray((const char *)data, data_len));
 
     if (!disable_log)
-        debug(" >> " + QByteArray((const char *)data, data_len).toHex(' ') + " // " + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
 
     loop.exec();
 }
@@ -136,7 +137,7 @@ void renphobike::characteristicChanged(const QLowEnergyCharacteristic &character
     QSettings settings;
     QString heartRateBeltName = settings.value("heart_rate_belt_name", "Disabled").toString();
 
-    debug(" << " + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     if (characteristic.uuid() != QBluetoothUuid((quint16)0x2AD2))
         return;
@@ -433,7 +434,7 @@ void renphobike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
             if (virtual_device_enabled) {
             debug("creating virtual bike interface...");
-            virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
+            virtualBike = virtualbike::create(this, noWriteResistance, noHeartService);
             // connect(virtualBike,&virtualbike::debug ,this,&renphobike::debug);
             connect(virtualBike, &virtualbike::changeInclination, this, &renphobike::changeInclination);
         }
@@ -455,7 +456,7 @@ void renphobike::descriptorRead(const QLowEnergyDescriptor &descriptor, const QB
 
 void renphobike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    debug("characteristicWritten " + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void renphobike::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
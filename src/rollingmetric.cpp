@@ -0,0 +1,39 @@
+#include "rollingmetric.h"
+
+rollingmetric::rollingmetric() { clear(); }
+
+void rollingmetric::clear() {
+    for (uint8_t i = 0; i <= CAPACITY; i++) {
+        m_sums[i] = 0;
+    }
+    m_total = 0;
+    m_samples = 0;
+    m_head = 0;
+}
+
+void rollingmetric::append(double v) {
+    m_total += v;
+    m_samples++;
+    m_head++;
+    if (m_head > CAPACITY) {
+        m_head = 0;
+        for (uint8_t i = 0; i <= CAPACITY; i++) {
+            m_sums[i] -= m_total;
+        }
+        m_total = 0;
+    }
+    m_sums[m_head] = m_total;
+}
+
+uint8_t rollingmetric::count() const { return m_samples > CAPACITY ? CAPACITY : (uint8_t)m_samples; }
+
+double rollingmetric::average(uint8_t window) const {
+    if (window > count()) {
+        window = count();
+    }
+    if (window == 0) {
+        return 0;
+    }
+    uint8_t from = (m_head + (CAPACITY + 1) - window) % (CAPACITY + 1);
+    return (m_total - m_sums[from]) / window;
+}
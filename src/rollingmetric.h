@@ -0,0 +1,33 @@
+#ifndef ROLLINGMETRIC_H
+#define ROLLINGMETRIC_H
+
+#include <stdint.h>
+
+// Fixed-capacity ring buffer of the last samples of a metric, for metric::average5s().
+// It keeps a ring of running sums, so the average over any window up to CAPACITY samples is
+// (sum now - sum window samples ago) / window: O(1) and nothing is allocated per sample.
+class rollingmetric {
+
+  public:
+    static const uint8_t CAPACITY = 5;
+
+    rollingmetric();
+    void append(double v);
+    void clear();
+
+    // number of samples available, up to CAPACITY
+    uint8_t count() const;
+
+    // average of the last window samples (or of all the samples if there are less than window)
+    double average(uint8_t window) const;
+
+  private:
+    // m_sums[n % (CAPACITY + 1)] is the running sum after the n-th sample; the ring is rebased every
+    // time it wraps so the sums never grow large enough to lose precision
+    double m_sums[CAPACITY + 1];
+    double m_total = 0;
+    uint32_t m_samples = 0;
+    uint8_t m_head = 0;
+};
+
+#endif // ROLLINGMETRIC_H
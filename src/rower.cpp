@@ -1,7 +1,6 @@
 
 #include "rower.h"
 #include "qdebugfixup.h"
-#include <QSettings>
 
 rower::rower() {}
 
@@ -111,7 +110,6 @@ void rower::setLap() {
 
 // min/500m
 QTime rower::currentPace() {
-    QSettings settings;
     // bool miles = settings.value(QStringLiteral("miles_unit"), false).toBool();
     const double unit_conversion = 1.0;
     // rowers are alwasy in meters!
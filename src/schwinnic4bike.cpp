@@ -1,4 +1,5 @@
 #include "schwinnic4bike.h"
+#include "packettrace.h"
 
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
@@ -51,7 +52,7 @@ wait_for_response)
 data_len));
 
     if(!disable_log)
-        debug(" >> " + QByteArray((const char*)data, data_len).toHex(' ') + " // " + info);
+        packettrace::tx(this, QByteArray((const char*)data, data_len), info);
 
     loop.exec();
 }*/
@@ -127,7 +128,7 @@ void schwinnic4bike::characteristicChanged(const QLowEnergyCharacteristic &chara
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     if (characteristic.uuid() != QBluetoothUuid((quint16)0x2AD2))
         return;
@@ -424,7 +425,7 @@ void schwinnic4bike::stateChanged(QLowEnergyService::ServiceState state) {
             if (virtual_device_enabled) {
             emit debug(QStringLiteral("creating virtual bike interface..."));
 
-            virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
+            virtualBike = virtualbike::create(this, noWriteResistance, noHeartService);
             // connect(virtualBike,&virtualbike::debug ,this,&schwinnic4bike::debug);
             connect(virtualBike, &virtualbike::changeInclination, this, &schwinnic4bike::changeInclination);
         }
@@ -447,7 +448,7 @@ void schwinnic4bike::descriptorRead(const QLowEnergyDescriptor &descriptor, cons
 void schwinnic4bike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
 
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void schwinnic4bike::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -0,0 +1,61 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+// Single writer / multiple readers publication of a trivially copyable value.
+// The writer makes the sequence odd while it copies the value and even again when it's done; a reader copies the
+// value and tries again if the sequence was odd or has changed meanwhile. Readers never block the writer and never
+// get a value written in half, from any thread.
+template <typename T> class seqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "seqlock needs a trivially copyable value");
+
+  public:
+    seqlock() {
+        for (auto &w : m_words) {
+            w.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void store(const T &value) {
+        uint32_t words[WORDS] = {};
+        memcpy(words, &value, sizeof(T));
+
+        uint32_t s = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(s + 2, std::memory_order_release);
+    }
+
+    T load() const {
+        uint32_t words[WORDS];
+        uint32_t before, after;
+        do {
+            before = m_sequence.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORDS; i++) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = m_sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        T value;
+        memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+  private:
+    // 32 bits words are lock free on every platform we build for
+    static const size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    std::atomic<uint32_t> m_sequence{0};
+    std::atomic<uint32_t> m_words[WORDS];
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,158 @@
+#include "sessionstore.h"
+#include "appdir.h"
+#include "qdebugfixup.h"
+
+#include <cmath>
+#include <limits>
+
+sessionstore::~sessionstore() { clear(); }
+
+void sessionstore::clear() {
+    for (int c = 0; c < m_chunks.count(); c++) {
+        if (m_mapped.at(c)) {
+            m_spillFile.unmap((uchar *)m_chunks.at(c));
+        } else {
+            delete m_chunks.at(c);
+        }
+    }
+    m_chunks.clear();
+    m_mapped.clear();
+    m_count = 0;
+    m_resident = 0;
+
+    if (m_spillFile.isOpen()) {
+        m_spillFile.resize(0);
+    }
+    m_spillSize = 0;
+}
+
+void sessionstore::append(const SessionLine &sl) {
+    int j = m_count % CHUNK_SAMPLES;
+    if (j == 0) {
+        chunk *c = new chunk;
+        c->startTime = sl.time.toMSecsSinceEpoch();
+        m_chunks.append(c);
+        m_mapped.append(false);
+        m_resident++;
+        // the oldest full chunks go to disk, the one being filled always stays in memory
+        for (int i = 0; i < m_chunks.count() - 1 && m_resident - 1 > MAX_RESIDENT_CHUNKS; i++) {
+            if (!m_mapped.at(i) && !spill(i)) {
+                break;
+            }
+        }
+    }
+
+    chunk *c = m_chunks.last();
+    qint64 time = sl.time.toMSecsSinceEpoch() - c->startTime;
+    // a line can't be older than the first one of its chunk, and a pause longer than 49 days is clamped
+    c->time[j] = (uint32_t)qBound((qint64)0, time, (qint64)std::numeric_limits<uint32_t>::max());
+    c->distance[j] = sl.distance;
+    if (sl.coordinate.isValid()) {
+        c->latitude[j] = sl.coordinate.latitude();
+        c->longitude[j] = sl.coordinate.longitude();
+        c->altitude[j] = sl.coordinate.altitude();
+    } else {
+        c->latitude[j] = NAN;
+        c->longitude[j] = NAN;
+        c->altitude[j] = NAN;
+    }
+    c->elapsedTime[j] = sl.elapsedTime;
+    c->totalStrokes[j] = sl.totalStrokes;
+    c->speed[j] = sl.speed;
+    c->pace[j] = sl.pace;
+    c->calories[j] = sl.calories;
+    c->elevationGain[j] = sl.elevationGain;
+    c->avgStrokesRate[j] = sl.avgStrokesRate;
+    c->maxStrokesRate[j] = sl.maxStrokesRate;
+    c->avgStrokesLength[j] = sl.avgStrokesLength;
+    c->watt[j] = sl.watt;
+    c->inclination[j] = sl.inclination;
+    c->resistance[j] = sl.resistance;
+    c->peloton_resistance[j] = sl.peloton_resistance;
+    c->heart[j] = sl.heart;
+    c->cadence[j] = sl.cadence;
+    c->lapTrigger[j] = sl.lapTrigger;
+    m_count++;
+}
+
+void sessionstore::copyFrom(const sessionstore &other) {
+    clear();
+    m_chunks.reserve(other.m_chunks.count());
+    for (const chunk *c : other.m_chunks) {
+        m_chunks.append(new chunk(*c));
+        m_mapped.append(false);
+        m_resident++;
+    }
+    m_count = other.m_count;
+    // same bound as append(), the last chunk stays in memory
+    for (int i = 0; i < m_chunks.count() - 1 && m_resident - 1 > MAX_RESIDENT_CHUNKS; i++) {
+        if (!spill(i)) {
+            break;
+        }
+    }
+}
+
+SessionLine sessionstore::at(int i) const {
+    const chunk *c = m_chunks.at(i / CHUNK_SAMPLES);
+    int j = i % CHUNK_SAMPLES;
+
+    SessionLine sl;
+    sl.time = QDateTime::fromMSecsSinceEpoch(c->startTime + c->time[j]);
+    sl.distance = c->distance[j];
+    if (!std::isnan(c->latitude[j])) {
+        sl.coordinate = QGeoCoordinate(c->latitude[j], c->longitude[j], c->altitude[j]);
+    }
+    sl.elapsedTime = c->elapsedTime[j];
+    sl.totalStrokes = c->totalStrokes[j];
+    sl.speed = c->speed[j];
+    sl.pace = c->pace[j];
+    sl.calories = c->calories[j];
+    sl.elevationGain = c->elevationGain[j];
+    sl.avgStrokesRate = c->avgStrokesRate[j];
+    sl.maxStrokesRate = c->maxStrokesRate[j];
+    sl.avgStrokesLength = c->avgStrokesLength[j];
+    sl.watt = c->watt[j];
+    sl.inclination = c->inclination[j];
+    sl.resistance = c->resistance[j];
+    sl.peloton_resistance = c->peloton_resistance[j];
+    sl.heart = c->heart[j];
+    sl.cadence = c->cadence[j];
+    sl.lapTrigger = c->lapTrigger[j];
+    return sl;
+}
+
+bool sessionstore::spill(int c) {
+    if (m_mapped.at(c)) {
+        return true;
+    }
+
+    if (!m_spillFile.isOpen()) {
+        // the temporary directory of a mobile system can be small or cleaned while the app runs
+        m_spillFile.setFileTemplate(appdir::writable() + QStringLiteral("qz-session-XXXXXX"));
+        if (!m_spillFile.open()) {
+            qDebug() << QStringLiteral("sessionstore: can't open the spill file, keeping the session in memory");
+            return false;
+        }
+    }
+
+    // the chunk stays in memory if anything goes wrong
+    if (!m_spillFile.seek(m_spillSize) ||
+        m_spillFile.write((const char *)m_chunks.at(c), sizeof(chunk)) != (qint64)sizeof(chunk) ||
+        !m_spillFile.flush()) {
+        qDebug() << QStringLiteral("sessionstore: spill error") << m_spillFile.errorString();
+        return false;
+    }
+    uchar *mapped = m_spillFile.map(m_spillSize, sizeof(chunk));
+    if (!mapped) {
+        qDebug() << QStringLiteral("sessionstore: map error") << m_spillFile.errorString();
+        return false;
+    }
+
+    m_spillSize += sizeof(chunk);
+    delete m_chunks.at(c);
+    m_chunks[c] = (chunk *)mapped;
+    m_mapped[c] = true;
+    m_resident--;
+    qDebug() << QStringLiteral("sessionstore: chunk") << c << QStringLiteral("spilled to") << m_spillFile.fileName();
+    return true;
+}
@@ -0,0 +1,101 @@
+#ifndef SESSIONSTORE_H
+#define SESSIONSTORE_H
+
+#include "sessionline.h"
+#include <QList>
+#include <QTemporaryFile>
+#include <QVector>
+
+// Columnar storage of the lines of a workout session.
+// The lines are stored in chunks of CHUNK_SAMPLES lines, with one contiguous typed array per channel, so a line
+// takes about 80 bytes instead of a SessionLine with its QDateTime and QGeoCoordinate. Timestamps are stored as
+// milliseconds from the start of their chunk. Charts and exporters can read a channel chunk by chunk through
+// channel() without copying it. When more than MAX_RESIDENT_CHUNKS full chunks are in memory, the oldest one is
+// written to a temporary file of the app directory and memory mapped, so multi-day sessions don't grow the memory
+// without bound.
+class sessionstore {
+
+  public:
+    static const int CHUNK_SAMPLES = 3600; // one hour at one line per second
+    static const int MAX_RESIDENT_CHUNKS = 2;
+
+    // plain data only: a full chunk is written to the spill file and mapped back as it is
+    struct chunk {
+        qint64 startTime; // msecs since epoch of the first line
+        double distance[CHUNK_SAMPLES];
+        double latitude[CHUNK_SAMPLES]; // NaN when the line has no coordinate
+        double longitude[CHUNK_SAMPLES];
+        uint32_t time[CHUNK_SAMPLES]; // msecs from startTime
+        uint32_t elapsedTime[CHUNK_SAMPLES];
+        uint32_t totalStrokes[CHUNK_SAMPLES];
+        float speed[CHUNK_SAMPLES];
+        float pace[CHUNK_SAMPLES];
+        float calories[CHUNK_SAMPLES];
+        float elevationGain[CHUNK_SAMPLES];
+        float avgStrokesRate[CHUNK_SAMPLES];
+        float maxStrokesRate[CHUNK_SAMPLES];
+        float avgStrokesLength[CHUNK_SAMPLES];
+        float altitude[CHUNK_SAMPLES];
+        uint16_t watt[CHUNK_SAMPLES];
+        int8_t inclination[CHUNK_SAMPLES];
+        int8_t resistance[CHUNK_SAMPLES];
+        int8_t peloton_resistance[CHUNK_SAMPLES];
+        uint8_t heart[CHUNK_SAMPLES];
+        uint8_t cadence[CHUNK_SAMPLES];
+        uint8_t lapTrigger[CHUNK_SAMPLES];
+    };
+
+    // read only view of the values of a channel in a chunk
+    template <typename T> class span {
+      public:
+        span(const T *data, int size) : m_data(data), m_size(size) {}
+        const T *begin() const { return m_data; }
+        const T *end() const { return m_data + m_size; }
+        const T &operator[](int i) const { return m_data[i]; }
+        int size() const { return m_size; }
+
+      private:
+        const T *m_data;
+        int m_size;
+    };
+
+    sessionstore() = default;
+    ~sessionstore();
+
+    void append(const SessionLine &sl);
+    void clear();
+    // replaces the lines with a copy of the other session's, e.g. for an exporter running in another thread
+    void copyFrom(const sessionstore &other);
+
+    int count() const { return m_count; }
+    int size() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+
+    // the lines are rebuilt from the channels
+    SessionLine at(int i) const;
+    SessionLine first() const { return at(0); }
+    SessionLine last() const { return at(m_count - 1); }
+
+    int chunks() const { return m_chunks.count(); }
+    int chunkCount(int c) const { return c < m_chunks.count() - 1 ? CHUNK_SAMPLES : m_count - c * CHUNK_SAMPLES; }
+
+    // for example channel(c, &sessionstore::chunk::watt)
+    template <typename T> span<T> channel(int c, T (chunk::*field)[CHUNK_SAMPLES]) const {
+        return span<T>(m_chunks.at(c)->*field, chunkCount(c));
+    }
+
+  private:
+    Q_DISABLE_COPY(sessionstore)
+
+    bool spill(int c);
+
+    QVector<chunk *> m_chunks;
+    QVector<bool> m_mapped;
+    int m_count = 0;
+    int m_resident = 0;
+
+    QTemporaryFile m_spillFile;
+    qint64 m_spillSize = 0;
+};
+
+#endif // SESSIONSTORE_H
@@ -264,8 +264,16 @@ import Qt.labs.settings 1.0
             property bool virtual_device_ifit: false
             property bool virtual_device_rower: false
             property bool virtual_device_force_bike: false
+            property bool virtual_device_notify_on_change: false
+            property real virtual_device_notify_max_rate: 4
             property bool volume_change_gears: false
             property bool applewatch_fakedevice: false
+            property bool log_binary_packets: false
+            property int log_max_size_mb: 0
+            property string packet_trace_filter: ""
+            property int tile_refresh_ms: 200
+            property bool virtual_device_thread: false
+            property bool strava_upload_gzip: false
         }
 
         ColumnLayout {
@@ -319,6 +327,31 @@ import Qt.labs.settings 1.0
                         }
                     }
 
+                    RowLayout {
+                        spacing: 10
+                        Label {
+                            id: labelTileRefresh
+                            text: qsTr("Tiles Refresh (ms):")
+                            Layout.fillWidth: true
+                        }
+                        TextField {
+                            id: tileRefreshTextField
+                            text: settings.tile_refresh_ms
+                            horizontalAlignment: Text.AlignRight
+                            Layout.fillHeight: false
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            inputMethodHints: Qt.ImhDigitsOnly
+                            onAccepted: settings.tile_refresh_ms = text
+                            onActiveFocusChanged: if(this.focus) this.cursorPosition = this.text.length
+                        }
+                        Button {
+                            id: okTileRefreshButton
+                            text: "OK"
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            onClicked: settings.tile_refresh_ms = tileRefreshTextField.text
+                        }
+                    }
+
                     RowLayout {
                         spacing: 10
                         Label {
@@ -3951,6 +3984,21 @@ import Qt.labs.settings 1.0
                         }
                     }
 
+                    SwitchDelegate {
+                        id: stravaUploadGzipDelegate
+                        text: qsTr("Compress the uploads (gzip)")
+                        spacing: 0
+                        bottomPadding: 0
+                        topPadding: 0
+                        rightPadding: 0
+                        leftPadding: 0
+                        clip: false
+                        checked: settings.strava_upload_gzip
+                        Layout.alignment: Qt.AlignLeft | Qt.AlignTop
+                        Layout.fillWidth: true
+                        onClicked: settings.strava_upload_gzip = checked
+                    }
+
                     SwitchDelegate {
                         id: volumeChangeGearsDelegate
                         text: qsTr("Volumes buttons change gears")
@@ -4604,6 +4652,61 @@ import Qt.labs.settings 1.0
                         onClicked: settings.virtual_device_rower = checked
                     }
 
+                    SwitchDelegate {
+                        id: virtualDeviceNotifyOnChangeDelegate
+                        text: qsTr("Virtual Device Notify On Change")
+                        spacing: 0
+                        bottomPadding: 0
+                        topPadding: 0
+                        rightPadding: 0
+                        leftPadding: 0
+                        clip: false
+                        checked: settings.virtual_device_notify_on_change
+                        Layout.alignment: Qt.AlignLeft | Qt.AlignTop
+                        Layout.fillWidth: true
+                        onClicked: settings.virtual_device_notify_on_change = checked
+                    }
+
+                    RowLayout {
+                        spacing: 10
+                        Label {
+                            id: labelVirtualDeviceNotifyMaxRate
+                            text: qsTr("Virtual Device Max Notifications/s:")
+                            Layout.fillWidth: true
+                        }
+                        TextField {
+                            id: virtualDeviceNotifyMaxRateTextField
+                            text: settings.virtual_device_notify_max_rate
+                            horizontalAlignment: Text.AlignRight
+                            Layout.fillHeight: false
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            inputMethodHints: Qt.ImhFormattedNumbersOnly
+                            onAccepted: settings.virtual_device_notify_max_rate = text
+                            onActiveFocusChanged: if(this.focus) this.cursorPosition = this.text.length
+                        }
+                        Button {
+                            id: okVirtualDeviceNotifyMaxRateButton
+                            text: "OK"
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            onClicked: settings.virtual_device_notify_max_rate = virtualDeviceNotifyMaxRateTextField.text
+                        }
+                    }
+
+                    SwitchDelegate {
+                        id: virtualDeviceThreadDelegate
+                        text: qsTr("Virtual Device in a Separate Thread")
+                        spacing: 0
+                        bottomPadding: 0
+                        topPadding: 0
+                        rightPadding: 0
+                        leftPadding: 0
+                        clip: false
+                        checked: settings.virtual_device_thread
+                        Layout.alignment: Qt.AlignLeft | Qt.AlignTop
+                        Layout.fillWidth: true
+                        onClicked: settings.virtual_device_thread = checked
+                    }
+
                     SwitchDelegate {
                         id: virtualBikeForceResistanceDelegate
                         text: qsTr("Zwift Force Resistance")
@@ -4753,6 +4856,70 @@ import Qt.labs.settings 1.0
                         Layout.fillWidth: true
                         onClicked: settings.log_debug = checked
                     }
+
+                    SwitchDelegate {
+                        id: logBinaryPacketsDelegate
+                        text: qsTr("Binary Packet Log")
+                        spacing: 0
+                        bottomPadding: 0
+                        topPadding: 0
+                        rightPadding: 0
+                        leftPadding: 0
+                        clip: false
+                        checked: settings.log_binary_packets
+                        Layout.alignment: Qt.AlignLeft | Qt.AlignTop
+                        Layout.fillWidth: true
+                        onClicked: settings.log_binary_packets = checked
+                    }
+
+                    RowLayout {
+                        spacing: 10
+                        Label {
+                            id: labelLogMaxSize
+                            text: qsTr("Debug Log Max Size (MB, 0 unlimited):")
+                            Layout.fillWidth: true
+                        }
+                        TextField {
+                            id: logMaxSizeTextField
+                            text: settings.log_max_size_mb
+                            horizontalAlignment: Text.AlignRight
+                            Layout.fillHeight: false
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            inputMethodHints: Qt.ImhDigitsOnly
+                            onAccepted: settings.log_max_size_mb = text
+                            onActiveFocusChanged: if(this.focus) this.cursorPosition = this.text.length
+                        }
+                        Button {
+                            id: okLogMaxSizeButton
+                            text: "OK"
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            onClicked: settings.log_max_size_mb = logMaxSizeTextField.text
+                        }
+                    }
+
+                    RowLayout {
+                        spacing: 10
+                        Label {
+                            id: labelPacketTraceFilter
+                            text: qsTr("Packet Trace Devices (empty for all):")
+                            Layout.fillWidth: true
+                        }
+                        TextField {
+                            id: packetTraceFilterTextField
+                            text: settings.packet_trace_filter
+                            horizontalAlignment: Text.AlignRight
+                            Layout.fillHeight: false
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            onAccepted: settings.packet_trace_filter = text
+                            onActiveFocusChanged: if(this.focus) this.cursorPosition = this.text.length
+                        }
+                        Button {
+                            id: okPacketTraceFilterButton
+                            text: "OK"
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            onClicked: settings.packet_trace_filter = packetTraceFilterTextField.text
+                        }
+                    }
                 }
             }
         }
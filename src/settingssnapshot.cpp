@@ -0,0 +1,82 @@
+#include "settingssnapshot.h"
+#include "qdebugfixup.h"
+
+#include <QSettings>
+
+static std::shared_ptr<const settingssnapshot> m_current;
+
+std::shared_ptr<const settingssnapshot> settingssnapshot::current() {
+    std::shared_ptr<const settingssnapshot> s = std::atomic_load(&m_current);
+    if (!s) {
+        reload();
+        s = std::atomic_load(&m_current);
+    }
+    return s;
+}
+
+void settingssnapshot::reload() {
+    auto s = std::make_shared<settingssnapshot>();
+    s->load();
+    std::atomic_store(&m_current, std::shared_ptr<const settingssnapshot>(s));
+    qDebug() << QStringLiteral("settings snapshot reloaded");
+}
+
+void settingssnapshot::load() {
+    QSettings settings;
+
+    watt_gain = settings.value(QStringLiteral("watt_gain"), 1.0).toDouble();
+    watt_offset = settings.value(QStringLiteral("watt_offset"), 0.0).toDouble();
+    speed_gain = settings.value(QStringLiteral("speed_gain"), 1.0).toDouble();
+    speed_offset = settings.value(QStringLiteral("speed_offset"), 0.0).toDouble();
+
+    weight = settings.value(QStringLiteral("weight"), 75.0).toFloat();
+    miles_unit = settings.value(QStringLiteral("miles_unit"), false).toBool();
+
+    heart_rate_belt_name =
+        settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
+    power_sensor_name = settings.value(QStringLiteral("power_sensor_name"), QStringLiteral("Disabled")).toString();
+    cadence_sensor_name =
+        settings.value(QStringLiteral("cadence_sensor_name"), QStringLiteral("Disabled")).toString();
+    heart_rate_belt_disabled = heart_rate_belt_name.startsWith(QStringLiteral("Disabled"));
+    power_sensor_disabled = power_sensor_name.startsWith(QStringLiteral("Disabled"));
+    cadence_sensor_disabled = cadence_sensor_name.startsWith(QStringLiteral("Disabled"));
+    power_sensor_as_bike = settings.value(QStringLiteral("power_sensor_as_bike"), false).toBool();
+    power_sensor_as_treadmill = settings.value(QStringLiteral("power_sensor_as_treadmill"), false).toBool();
+    heart_ignore_builtin = settings.value(QStringLiteral("heart_ignore_builtin"), false).toBool();
+    ant_heart = settings.value(QStringLiteral("ant_heart"), false).toBool();
+
+    continuous_moving = settings.value(QStringLiteral("continuous_moving"), true).toBool();
+    instant_power_on_pause = settings.value(QStringLiteral("instant_power_on_pause"), false).toBool();
+    speed_power_based = settings.value(QStringLiteral("speed_power_based"), false).toBool();
+
+    bike_cadence_sensor = settings.value(QStringLiteral("bike_cadence_sensor"), false).toBool();
+    bike_power_sensor = settings.value(QStringLiteral("bike_power_sensor"), false).toBool();
+    bike_wheel_revs = settings.value(QStringLiteral("bike_wheel_revs"), false).toBool();
+    battery_service = settings.value(QStringLiteral("battery_service"), false).toBool();
+    virtual_device_onlyheart = settings.value(QStringLiteral("virtual_device_onlyheart"), false).toBool();
+    virtual_device_echelon = settings.value(QStringLiteral("virtual_device_echelon"), false).toBool();
+    virtual_device_ifit = settings.value(QStringLiteral("virtual_device_ifit"), false).toBool();
+    virtualbike_forceresistance = settings.value(QStringLiteral("virtualbike_forceresistance"), true).toBool();
+    zwift_erg = settings.value(QStringLiteral("zwift_erg"), false).toBool();
+    zwift_erg_filter = settings.value(QStringLiteral("zwift_erg_filter"), 0.0).toDouble();
+    zwift_erg_filter_down = settings.value(QStringLiteral("zwift_erg_filter_down"), 0.0).toDouble();
+    zwift_negative_inclination_x2 = settings.value(QStringLiteral("zwift_negative_inclination_x2"), false).toBool();
+    bluetooth_relaxed = settings.value(QStringLiteral("bluetooth_relaxed"), false).toBool();
+    bluetooth_30m_hangs = settings.value(QStringLiteral("bluetooth_30m_hangs"), false).toBool();
+    ios_peloton_workaround = settings.value(QStringLiteral("ios_peloton_workaround"), true).toBool();
+    virtual_device_thread = settings.value(QStringLiteral("virtual_device_thread"), false).toBool();
+    peloton_heartrate_metric =
+        settings.value(QStringLiteral("peloton_heartrate_metric"), QStringLiteral("Heart Rate")).toString();
+
+    tile_refresh_ms = settings.value(QStringLiteral("tile_refresh_ms"), 200).toInt();
+
+    packet_trace_filter = settings.value(QStringLiteral("packet_trace_filter"), QString()).toString();
+    for (QString c : packet_trace_filter.split(QLatin1Char(','), QString::SkipEmptyParts)) {
+        c = c.trimmed();
+        if (c.endsWith(QLatin1Char('*'))) {
+            packet_trace_prefixes.append(c.chopped(1));
+        } else if (!c.isEmpty()) {
+            packet_trace_classes.append(c);
+        }
+    }
+}
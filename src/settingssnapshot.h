@@ -0,0 +1,78 @@
+#ifndef SETTINGSSNAPSHOT_H
+#define SETTINGSSNAPSHOT_H
+
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+// Typed, immutable copy of the settings read on the BLE hot paths (metric::setValue,
+// characteristicChanged, update_metrics, virtual device providers...).
+// QSettings parses and looks up string keys on every access, so the packet handlers read these plain
+// fields instead. The snapshot is rebuilt with reload() whenever the settings are changed (settings page
+// closed, settings file loaded) and swapped atomically, so a reader always sees a consistent set of values.
+class settingssnapshot {
+
+  public:
+    static std::shared_ptr<const settingssnapshot> current();
+    static void reload();
+
+    // metric
+    double watt_gain = 1.0;
+    double watt_offset = 0.0;
+    double speed_gain = 1.0;
+    double speed_offset = 0.0;
+
+    // user
+    double weight = 75.0;
+    bool miles_unit = false;
+
+    // sensors
+    QString heart_rate_belt_name = QStringLiteral("Disabled");
+    QString power_sensor_name = QStringLiteral("Disabled");
+    QString cadence_sensor_name = QStringLiteral("Disabled");
+    bool heart_rate_belt_disabled = true;
+    bool power_sensor_disabled = true;
+    bool cadence_sensor_disabled = true;
+    bool power_sensor_as_bike = false;
+    bool power_sensor_as_treadmill = false;
+    bool heart_ignore_builtin = false;
+    bool ant_heart = false;
+
+    // bluetoothdevice
+    bool continuous_moving = true;
+    bool instant_power_on_pause = false;
+    bool speed_power_based = false;
+
+    // virtual devices
+    bool bike_cadence_sensor = false;
+    bool bike_power_sensor = false;
+    bool bike_wheel_revs = false;
+    bool battery_service = false;
+    bool virtual_device_onlyheart = false;
+    bool virtual_device_echelon = false;
+    bool virtual_device_ifit = false;
+    bool virtualbike_forceresistance = true;
+    bool zwift_erg = false;
+    double zwift_erg_filter = 0.0;
+    double zwift_erg_filter_down = 0.0;
+    bool zwift_negative_inclination_x2 = false;
+    bool bluetooth_relaxed = false;
+    bool bluetooth_30m_hangs = false;
+    bool ios_peloton_workaround = true;
+    bool virtual_device_thread = false; // see workerthread
+    QString peloton_heartrate_metric = QStringLiteral("Heart Rate");
+
+    // ui
+    int tile_refresh_ms = 200; // see tilemodel
+
+    // debug
+    QString packet_trace_filter; // see packettrace
+    // packet_trace_filter split once, so the trace of a packet doesn't parse it
+    QStringList packet_trace_classes;
+    QStringList packet_trace_prefixes; // the entries ending with *, without it
+
+  private:
+    void load();
+};
+
+#endif // SETTINGSSNAPSHOT_H
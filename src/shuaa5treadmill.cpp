@@ -1,6 +1,7 @@
 #include "shuaa5treadmill.h"
 #include "ftmsbike.h"
 #include "ios/lockscreen.h"
+#include "packettrace.h"
 #include "virtualtreadmill.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -46,7 +47,7 @@ void shuaa5treadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, QStri
     gattFTMSService->writeCharacteristic(gattWriteCharControlPointId, QByteArray((const char *)data, data_len));
 
     if (!disable_log)
-        qDebug() << " >> " << QByteArray((const char *)data, data_len).toHex(' ') << " // " << info;
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
 
     loop.exec();
 }
@@ -173,8 +174,7 @@ void shuaa5treadmill::characteristicChanged(const QLowEnergyCharacteristic &char
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + characteristic.uuid().toString() + " " + QString::number(newValue.length()) +
-               " " + newValue.toHex(' '));
+    packettrace::rx(this, newValue, characteristic.uuid());
 
     emit packetReceived();
 
@@ -444,7 +444,7 @@ void shuaa5treadmill::stateChanged(QLowEnergyService::ServiceState state) {
         if (virtual_device_enabled) {
             emit debug(QStringLiteral("creating virtual treadmill interface..."));
 
-            virtualTreadmill = new virtualtreadmill(this, noHeartService);
+            virtualTreadmill = virtualtreadmill::create(this, noHeartService);
             connect(virtualTreadmill, &virtualtreadmill::debug, this, &shuaa5treadmill::debug);
             connect(virtualTreadmill, &virtualtreadmill::changeInclination, this,
                     &shuaa5treadmill::changeInclinationRequested);
@@ -474,7 +474,7 @@ void shuaa5treadmill::descriptorRead(const QLowEnergyDescriptor &descriptor, con
 void shuaa5treadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                             const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void shuaa5treadmill::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -1,6 +1,8 @@
 #include "skandikawiribike.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualbike.h"
+#include "workerthread.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
 #include <QFile>
@@ -30,7 +32,7 @@ skandikawiribike::skandikawiribike(bool noWriteResistance, bool noHeartService,
 skandikawiribike::~skandikawiribike() {
     qDebug() << QStringLiteral("~skandikawiribike()") << virtualBike;
     if (virtualBike) {
-        delete virtualBike;
+        workerthread::destroy(virtualBike);
     }
 }
 
@@ -51,8 +53,7 @@ void skandikawiribike::writeCharacteristic(uint8_t *data, uint8_t data_len, cons
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -189,7 +190,7 @@ void skandikawiribike::characteristicChanged(const QLowEnergyCharacteristic &cha
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     lastPacket = newValue;
     if (newValue.length() == 5) {
@@ -343,8 +344,8 @@ void skandikawiribike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
                 if (virtual_device_enabled) {
                 emit debug(QStringLiteral("creating virtual bike interface..."));
-                virtualBike =
-                    new virtualbike(this, noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                virtualBike = virtualbike::create(this, noWriteResistance, noHeartService, bikeResistanceOffset,
+                                                  bikeResistanceGain);
                 // connect(virtualBike,&virtualbike::debug ,this,&skandikawiribike::debug);
                 connect(virtualBike, &virtualbike::changeInclination, this, &skandikawiribike::changeInclination);
             }
@@ -370,7 +371,7 @@ void skandikawiribike::descriptorWritten(const QLowEnergyDescriptor &descriptor,
 void skandikawiribike::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                              const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void skandikawiribike::serviceScanDone(void) {
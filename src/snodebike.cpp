@@ -1,4 +1,5 @@
 #include "snodebike.h"
+#include "packettrace.h"
 
 #include "ftmsbike.h"
 
@@ -52,7 +53,7 @@ wait_for_response)
 data_len));
 
     if(!disable_log)
-        debug(" >> " + QByteArray((const char*)data, data_len).toHex(' ') + " // " + info);
+        packettrace::tx(this, QByteArray((const char*)data, data_len), info);
 
     loop.exec();
 }*/
@@ -120,7 +121,7 @@ void snodebike::characteristicChanged(const QLowEnergyCharacteristic &characteri
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     if (characteristic.uuid() != QBluetoothUuid((quint16)0x2AD2)) {
         return;
@@ -400,7 +401,7 @@ void snodebike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
             if (virtual_device_enabled) {
             emit debug(QStringLiteral("creating virtual bike interface..."));
-            virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
+            virtualBike = virtualbike::create(this, noWriteResistance, noHeartService);
             // connect(virtualBike,&virtualbike::debug ,this,&snodebike::debug);
             connect(virtualBike, &virtualbike::changeInclination, this, &snodebike::changeInclination);
             connect(virtualBike, &virtualbike::ftmsCharacteristicChanged, this, &snodebike::ftmsCharacteristicChanged);
@@ -441,7 +442,7 @@ void snodebike::descriptorRead(const QLowEnergyDescriptor &descriptor, const QBy
 
 void snodebike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void snodebike::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
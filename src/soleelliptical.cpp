@@ -1,7 +1,9 @@
 #include "soleelliptical.h"
+#include "packettrace.h"
 
 #include "keepawakehelper.h"
 #include "virtualtreadmill.h"
+#include "workerthread.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
 #include <QFile>
@@ -33,7 +35,7 @@ soleelliptical::~soleelliptical() {
     qDebug() << QStringLiteral("~soleelliptical()") << virtualTreadmill;
     if (virtualTreadmill) {
 
-        delete virtualTreadmill;
+        workerthread::destroy(virtualTreadmill);
     }
 }
 
@@ -54,8 +56,7 @@ void soleelliptical::writeCharacteristic(uint8_t *data, uint8_t data_len, const
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -129,13 +130,13 @@ void soleelliptical::update() {
             if (virtual_device_enabled) {
                 if (!virtual_device_force_bike) {
                     debug("creating virtual treadmill interface...");
-                    virtualTreadmill = new virtualtreadmill(this, noHeartService);
+                    virtualTreadmill = virtualtreadmill::create(this, noHeartService);
                     connect(virtualTreadmill, &virtualtreadmill::debug, this, &soleelliptical::debug);
                     connect(virtualTreadmill, &virtualtreadmill::changeInclination, this,
                             &soleelliptical::changeInclinationRequested);
                 } else {
                     debug("creating virtual bike interface...");
-                    virtualBike = new virtualbike(this);
+                    virtualBike = virtualbike::create(this);
                     connect(virtualBike, &virtualbike::changeInclination, this,
                             &soleelliptical::changeInclinationRequested);
                 }
@@ -235,7 +236,7 @@ void soleelliptical::characteristicChanged(const QLowEnergyCharacteristic &chara
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     lastPacket = newValue;
 
@@ -405,7 +406,7 @@ void soleelliptical::descriptorWritten(const QLowEnergyDescriptor &descriptor, c
 void soleelliptical::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
 
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void soleelliptical::serviceScanDone(void) {
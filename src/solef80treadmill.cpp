@@ -1,4 +1,5 @@
 #include "solef80treadmill.h"
+#include "packettrace.h"
 
 #include "ios/lockscreen.h"
 #include "virtualtreadmill.h"
@@ -70,7 +71,7 @@ void solef80treadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, QStr
     gattCustomService->writeCharacteristic(gattWriteCharCustomService, QByteArray((const char *)data, data_len));
 
     if (!disable_log)
-        qDebug() << " >> " << QByteArray((const char *)data, data_len).toHex(' ') << " // " << info;
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
 
     loop.exec();
 }
@@ -324,8 +325,7 @@ void solef80treadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + characteristic.uuid().toString() + " " + QString::number(newValue.length()) +
-               " " + newValue.toHex(' '));
+    packettrace::rx(this, newValue, characteristic.uuid());
 
     if (characteristic.uuid() == _gattNotifyCharId) {
         emit packetReceived();
@@ -637,7 +637,7 @@ void solef80treadmill::stateChanged(QLowEnergyService::ServiceState state) {
         if (virtual_device_enabled) {
             emit debug(QStringLiteral("creating virtual treadmill interface..."));
 
-            virtualTreadmill = new virtualtreadmill(this, noHeartService);
+            virtualTreadmill = virtualtreadmill::create(this, noHeartService);
             connect(virtualTreadmill, &virtualtreadmill::debug, this, &solef80treadmill::debug);
         }
     }
@@ -659,7 +659,7 @@ void solef80treadmill::descriptorRead(const QLowEnergyDescriptor &descriptor, co
 void solef80treadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                              const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void solef80treadmill::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
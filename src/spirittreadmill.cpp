@@ -1,5 +1,6 @@
 #include "spirittreadmill.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualtreadmill.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -38,8 +39,7 @@ void spirittreadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, const
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -163,7 +163,7 @@ void spirittreadmill::characteristicChanged(const QLowEnergyCharacteristic &char
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
     emit packetReceived();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     lastPacket = newValue;
     if (newValue.length() != 18) {
@@ -306,7 +306,7 @@ void spirittreadmill::stateChanged(QLowEnergyService::ServiceState state) {
             bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
             if (virtual_device_enabled) {
                 emit debug(QStringLiteral("creating virtual treadmill interface..."));
-                virtualTreadMill = new virtualtreadmill(this, false);
+                virtualTreadMill = virtualtreadmill::create(this, false);
                 connect(virtualTreadMill, &virtualtreadmill::debug, this, &spirittreadmill::debug);
             }
         }
@@ -331,7 +331,7 @@ void spirittreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor,
 void spirittreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                             const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void spirittreadmill::serviceScanDone(void) {
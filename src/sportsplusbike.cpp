@@ -1,5 +1,6 @@
 #include "sportsplusbike.h"
 #include "keepawakehelper.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -40,7 +41,7 @@ void sportsplusbike::writeCharacteristic(uint8_t *data, uint8_t data_len, const
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') + " // " + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -117,7 +118,7 @@ void sportsplusbike::characteristicChanged(const QLowEnergyCharacteristic &chara
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
     emit packetReceived();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     lastPacket = newValue;
     if (newValue.length() != 12) {
@@ -258,7 +259,7 @@ void sportsplusbike::stateChanged(QLowEnergyService::ServiceState state) {
             bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
             if (virtual_device_enabled) {
                 emit debug(QStringLiteral("creating virtual bike interface..."));
-                virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
+                virtualBike = virtualbike::create(this, noWriteResistance, noHeartService);
                 // connect(virtualBike,&virtualbike::debug ,this,&sportsplusbike::debug);
                 connect(virtualBike, &virtualbike::changeInclination, this, &sportsplusbike::changeInclination);
             }
@@ -283,7 +284,7 @@ void sportsplusbike::descriptorWritten(const QLowEnergyDescriptor &descriptor, c
 
 void sportsplusbike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void sportsplusbike::serviceScanDone(void) {
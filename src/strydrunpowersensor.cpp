@@ -1,5 +1,6 @@
 #include "strydrunpowersensor.h"
 #include "ios/lockscreen.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -50,7 +51,7 @@ gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic, QB
                                                                                          data_len));
 
 if(!disable_log)
-    debug(" >> " + QByteArray((const char*)data, data_len).toHex(' ') + " // " + info);
+    packettrace::tx(this, QByteArray((const char*)data, data_len), info);
 
 loop.exec();
 }*/
@@ -92,7 +93,7 @@ void strydrunpowersensor::characteristicChanged(const QLowEnergyCharacteristic &
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     if (characteristic.uuid() == QBluetoothUuid::CyclingPowerMeasurement) {
         lastPacket = newValue;
@@ -297,7 +298,7 @@ void strydrunpowersensor::stateChanged(QLowEnergyService::ServiceState state) {
         bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
         if (virtual_device_enabled) {
             emit debug(QStringLiteral("creating virtual treadmill interface..."));
-            virtualTreadmill = new virtualtreadmill(this, noHeartService);
+            virtualTreadmill = virtualtreadmill::create(this, noHeartService);
             // connect(virtualBike,&virtualbike::debug ,this,&strydrunpowersensor::debug);
             connect(virtualTreadmill, &virtualtreadmill::changeInclination, this,
                     &strydrunpowersensor::inclinationChanged);
@@ -321,7 +322,7 @@ void strydrunpowersensor::descriptorRead(const QLowEnergyDescriptor &descriptor,
 void strydrunpowersensor::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                                 const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void strydrunpowersensor::characteristicRead(const QLowEnergyCharacteristic &characteristic,
@@ -1,5 +1,6 @@
 #include "tacxneo2.h"
 #include "ios/lockscreen.h"
+#include "packettrace.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -41,8 +42,7 @@ void tacxneo2::writeCharacteristic(uint8_t *data, uint8_t data_len, const QStrin
     gattCustomService->writeCharacteristic(gattWriteCharCustomId, QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
     }
 
     loop.exec();
@@ -153,7 +153,7 @@ void tacxneo2::characteristicChanged(const QLowEnergyCharacteristic &characteris
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
     qDebug() << QStringLiteral(" << char ") << characteristic.uuid();
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    packettrace::rx(this, newValue);
 
     if (characteristic.uuid() == QBluetoothUuid((quint16)0x2A5B)) {
         lastPacket = newValue;
@@ -399,7 +399,7 @@ void tacxneo2::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
             if (virtual_device_enabled) {
             emit debug(QStringLiteral("creating virtual bike interface..."));
-            virtualBike = new virtualbike(this, noWriteResistance, noHeartService, 4, 1);
+            virtualBike = virtualbike::create(this, noWriteResistance, noHeartService, 4, 1);
             // connect(virtualBike, &virtualbike::powerPacketReceived, this, &tacxneo2::powerPacketReceived);
             // connect(virtualBike,&virtualbike::debug ,this,&tacxneo2::debug);
         }
@@ -421,7 +421,7 @@ void tacxneo2::descriptorRead(const QLowEnergyDescriptor &descriptor, const QByt
 
 void tacxneo2::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void tacxneo2::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -1,4 +1,5 @@
 #include "technogymmyruntreadmill.h"
+#include "packettrace.h"
 
 #include "ftmsbike.h"
 #include "ios/lockscreen.h"
@@ -47,7 +48,7 @@ void technogymmyruntreadmill::writeCharacteristic(QLowEnergyService *service, QL
     service->writeCharacteristic(characteristic, QByteArray((const char *)data, data_len));
 
     if (!disable_log)
-        qDebug() << " >> " << QByteArray((const char *)data, data_len).toHex(' ') << " // " << info;
+        packettrace::tx(this, QByteArray((const char *)data, data_len), info);
 
     loop.exec();
 }
@@ -188,8 +189,7 @@ void technogymmyruntreadmill::characteristicChanged(const QLowEnergyCharacterist
     if (characteristic.uuid() == QBluetoothUuid((quint16)0x2AD9))
         emit packetReceived();
 
-    emit debug(QStringLiteral(" << ") + characteristic.uuid().toString() + " " + QString::number(newValue.length()) +
-               " " + newValue.toHex(' '));
+    packettrace::rx(this, newValue, characteristic.uuid());
 
     if (characteristic.uuid() == QBluetoothUuid((quint16)0x2ACD)) {
         lastPacket = newValue;
@@ -409,13 +409,13 @@ void technogymmyruntreadmill::stateChanged(QLowEnergyService::ServiceState state
         if (virtual_device_enabled) {
             if (!virtual_device_force_bike) {
                 debug("creating virtual treadmill interface...");
-                virtualTreadmill = new virtualtreadmill(this, noHeartService);
+                virtualTreadmill = virtualtreadmill::create(this, noHeartService);
                 connect(virtualTreadmill, &virtualtreadmill::debug, this, &technogymmyruntreadmill::debug);
                 connect(virtualTreadmill, &virtualtreadmill::changeInclination, this,
                         &technogymmyruntreadmill::changeInclinationRequested);
             } else {
                 debug("creating virtual bike interface...");
-                virtualBike = new virtualbike(this);
+                virtualBike = virtualbike::create(this);
                 connect(virtualBike, &virtualbike::changeInclination, this,
                         &technogymmyruntreadmill::changeInclinationRequested);
             }
@@ -445,7 +445,7 @@ void technogymmyruntreadmill::descriptorRead(const QLowEnergyDescriptor &descrip
 void technogymmyruntreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                                     const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    packettrace::written(this, newValue);
 }
 
 void technogymmyruntreadmill::characteristicRead(const QLowEnergyCharacteristic &characteristic,
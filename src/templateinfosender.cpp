@@ -16,13 +16,40 @@ TemplateInfoSender::~TemplateInfoSender() { stop(); }
 
 bool TemplateInfoSender::init(const QString &script) {
     jscript = script;
+    compiled = QJSValue();
+    compiledEngine = nullptr;
     stop();
     return init();
 }
 
+// QJSEngine::evaluate parses the script every time. A template that declares a function qzUpdate() is evaluated
+// once, in the global scope so its top level variables and functions keep their state between the updates, and
+// then only qzUpdate is called. The engine is shared by the templates, so the function is taken and removed from
+// the global object right away. Without it the script keeps being evaluated as a whole.
+QJSValue TemplateInfoSender::compile(QJSEngine *eng) {
+    QJSValue glob = eng->globalObject();
+    compiledEngine = eng;
+    glob.deleteProperty(QStringLiteral("qzUpdate"));
+    QJSValue jsv = eng->evaluate(jscript);
+    compiled = glob.property(QStringLiteral("qzUpdate"));
+    glob.deleteProperty(QStringLiteral("qzUpdate"));
+    if (!compiled.isCallable()) {
+        compiled = QJSValue();
+        return jsv;
+    }
+    return compiled.callWithInstance(glob);
+}
+
 bool TemplateInfoSender::update(QJSEngine *eng) {
     if (!jscript.isEmpty()) {
-        QJSValue jsv = eng->evaluate(jscript);
+        QJSValue jsv;
+        if (compiledEngine != eng) {
+            jsv = compile(eng);
+        } else if (compiled.isCallable()) {
+            jsv = compiled.callWithInstance(eng->globalObject());
+        } else {
+            jsv = eng->evaluate(jscript);
+        }
         if (!jsv.isError()) {
             QString evalres = jsv.toString();
             qDebug() << QStringLiteral("eval res ") << evalres;
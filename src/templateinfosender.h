@@ -30,7 +30,12 @@ class TemplateInfoSender : public QObject {
     void reinit();
 
   private:
+    // evaluates jscript in eng and returns the value of its first update
+    QJSValue compile(QJSEngine *eng);
     QTimer retryTimer;
+    // the qzUpdate() function declared by jscript, if any
+    QJSValue compiled;
+    QJSEngine *compiledEngine = nullptr;
 };
 
 #endif // TEMPLATEINFOSENDER_H
@@ -8,6 +8,7 @@
 #include <QNetworkInterface>
 #include <QStandardPaths>
 #include <QTime>
+#include <limits>
 #ifdef Q_HTTPSERVER
 #include "webserverinfosender.h"
 #endif
@@ -155,7 +156,8 @@ void TemplateInfoSenderBuilder::load(const QString &idInfo, const QStringList &f
         } else if (settings.value(QStringLiteral("template_") + templateId + QStringLiteral("_enabled"), false)
                        .toBool()) {
             newTemplate(templateId, TEMPLATE_TYPE_WEBSERVER,
-                        QStringLiteral("JSON.stringify({msg: \"workout\", content: this.workout})"));
+                        QStringLiteral("function qzUpdate() { return JSON.stringify({msg: \"workout\", "
+                                       "content: workout}); }"));
         } else {
             qDebug() << QStringLiteral("Template") << templateId << QStringLiteral(" is disabled: not created");
         }
@@ -193,10 +195,73 @@ TemplateInfoSender *TemplateInfoSenderBuilder::newTemplate(const QString &id, co
 void TemplateInfoSenderBuilder::reinit() { load(masterId, foldersToLook); }
 
 void TemplateInfoSenderBuilder::clearSessionArray() {
-    int len = sessionArray.count();
-    for (int i = 0; i < len; i++) {
-        sessionArray.removeAt(0);
+    sessionColumns.clear();
+    sessionCount = 0;
+    sessionArrayHead = 0;
+}
+
+void TemplateInfoSenderBuilder::sessionColumn::resize(int size) {
+    if (type == QJsonValue::String) {
+        strings.resize(size);
+    } else {
+        numbers.reserve(size);
+        while (numbers.size() < size) {
+            numbers.append(std::numeric_limits<double>::quiet_NaN());
+        }
+    }
+}
+
+void TemplateInfoSenderBuilder::sessionColumn::set(int i, const QVariant &value) {
+    if (type == QJsonValue::String) {
+        strings[i] = value.isValid() ? value.toString() : QString();
+    } else {
+        numbers[i] = value.isValid() ? value.toDouble() : std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+QJsonValue TemplateInfoSenderBuilder::sessionColumn::value(int i) const {
+    if (type == QJsonValue::String) {
+        return strings.at(i).isNull() ? QJsonValue() : QJsonValue(strings.at(i));
+    } else if (qIsNaN(numbers.at(i))) {
+        return QJsonValue();
+    } else if (type == QJsonValue::Bool) {
+        return numbers.at(i) != 0.0;
+    }
+    return numbers.at(i);
+}
+
+void TemplateInfoSenderBuilder::appendSessionArray(const QHash<QString, QVariant> &sample) {
+    int slot = sessionArrayHead;
+    if (sessionCount < TEMPLATE_SESSION_HISTORY_MAX) {
+        slot = sessionCount++;
+    } else {
+        sessionArrayHead = (sessionArrayHead + 1) % sessionCount;
+    }
+    for (auto it = sample.constBegin(); it != sample.constEnd(); ++it) {
+        if (!sessionColumns.contains(it.key())) {
+            // the samples before this one don't have the field
+            sessionColumn &column = sessionColumns[it.key()];
+            const QJsonValue::Type type = QJsonValue::fromVariant(it.value()).type();
+            column.type = type == QJsonValue::String || type == QJsonValue::Bool ? type : QJsonValue::Double;
+        }
     }
+    for (auto it = sessionColumns.begin(); it != sessionColumns.end(); ++it) {
+        if (it->size() < sessionCount) {
+            it->resize(sessionCount);
+        }
+        it->set(slot, sample.value(it.key()));
+    }
+    sessionSequence++;
+}
+
+// i-th oldest sample of the history
+QJsonObject TemplateInfoSenderBuilder::sessionSample(int i) const {
+    QJsonObject sample;
+    const int slot = (sessionArrayHead + i) % sessionCount;
+    for (auto it = sessionColumns.constBegin(); it != sessionColumns.constEnd(); ++it) {
+        sample[it.key()] = it->value(slot);
+    }
+    return sample;
 }
 
 void TemplateInfoSenderBuilder::start(bluetoothdevice *dev) {
@@ -468,12 +533,45 @@ void TemplateInfoSenderBuilder::onAppendActivityDescription(const QJsonValue &ms
     tempSender->send(out.toJson());
 }
 
-void TemplateInfoSenderBuilder::onGetSessionArray(TemplateInfoSender *tempSender) {
+// Without content the whole history is sent as an array of samples.
+// With content {since: N, max: M} at most M samples starting from the sequence N are sent, as columns:
+// {first: sequence of the first sample sent, next: sequence to ask next, last: sequence of the next sample
+// recorded, columns: {field: [values]}}. A client asks again with since = next until next == last.
+void TemplateInfoSenderBuilder::onGetSessionArray(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
     QJsonObject main;
-    main[QStringLiteral("content")] = sessionArray;
+    int count = sessionCount;
+    if (!msgContent.isObject()) {
+        QJsonArray arr;
+        for (int i = 0; i < count; i++) {
+            arr.append(sessionSample(i));
+        }
+        main[QStringLiteral("content")] = arr;
+    } else {
+        QJsonObject req = msgContent.toObject();
+        qint64 first = sessionSequence - count;
+        qint64 since = qMax(first, (qint64)req[QStringLiteral("since")].toDouble(0));
+        int from = (int)qMin(since - first, (qint64)count);
+        int n = qMin(count - from, req[QStringLiteral("max")].toInt(count));
+        QJsonObject columns;
+        if (n > 0) {
+            for (auto it = sessionColumns.constBegin(); it != sessionColumns.constEnd(); ++it) {
+                QJsonArray column;
+                for (int i = from; i < from + n; i++) {
+                    column.append(it->value((sessionArrayHead + i) % sessionCount));
+                }
+                columns[it.key()] = column;
+            }
+        }
+        QJsonObject content;
+        content[QStringLiteral("first")] = first + from;
+        content[QStringLiteral("next")] = first + from + n;
+        content[QStringLiteral("last")] = sessionSequence;
+        content[QStringLiteral("columns")] = columns;
+        main[QStringLiteral("content")] = content;
+    }
     main[QStringLiteral("msg")] = QStringLiteral("R_getsessionarray");
     QJsonDocument out(main);
-    tempSender->send(out.toJson());
+    tempSender->send(out.toJson(QJsonDocument::Compact));
 }
 
 void TemplateInfoSenderBuilder::onSaveTrainingProgram(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
@@ -626,7 +724,7 @@ void TemplateInfoSenderBuilder::onDataReceived(const QByteArray &data) {
                     onSaveChart(jsonObject[QStringLiteral("content")], sender);
                     return;
                 } else if (msg == QStringLiteral("getsessionarray")) {
-                    onGetSessionArray(sender);
+                    onGetSessionArray(jsonObject[QStringLiteral("content")], sender);
                     return;
                 }
             }
@@ -635,12 +733,24 @@ void TemplateInfoSenderBuilder::onDataReceived(const QByteArray &data) {
     qDebug() << QStringLiteral("Unrecognized message") << data;
 }
 
+// Only the values that changed since the last update are converted and set in the workout object: the scripts
+// see the same object, and context keeps the C++ copy of every value.
+void TemplateInfoSenderBuilder::setWorkoutValue(QJSValue &obj, const QString &name, const QVariant &value) {
+    auto it = context.find(name);
+    if (it != context.end() && it.value() == value) {
+        return;
+    }
+    context.insert(name, value);
+    obj.setProperty(name, engine->toScriptValue(value));
+}
+
 void TemplateInfoSenderBuilder::buildContext(bool forceReinit) {
     QJSValue glob = engine->globalObject();
     QJSValue obj;
     if (!glob.hasOwnProperty(QStringLiteral("workout")) || forceReinit) {
         obj = engine->newObject();
         glob.setProperty(QStringLiteral("workout"), obj);
+        context.clear();
     } else
         obj = glob.property(QStringLiteral("workout"));
 
@@ -674,14 +784,15 @@ void TemplateInfoSenderBuilder::buildContext(bool forceReinit) {
                 sett.setProperty(key, settLJ);
             }
         }
-        obj.setProperty(QStringLiteral("BIKE_TYPE"), (int)bluetoothdevice::BIKE);
-        obj.setProperty(QStringLiteral("ELLIPTICAL_TYPE"), (int)bluetoothdevice::ELLIPTICAL);
-        obj.setProperty(QStringLiteral("ROWING_TYPE"), (int)bluetoothdevice::ROWING);
-        obj.setProperty(QStringLiteral("TREADMILL_TYPE"), (int)bluetoothdevice::TREADMILL);
-        obj.setProperty(QStringLiteral("UNKNOWN_TYPE"), (int)bluetoothdevice::UNKNOWN);
+        setWorkoutValue(obj, QStringLiteral("BIKE_TYPE"), (int)bluetoothdevice::BIKE);
+        setWorkoutValue(obj, QStringLiteral("ELLIPTICAL_TYPE"), (int)bluetoothdevice::ELLIPTICAL);
+        setWorkoutValue(obj, QStringLiteral("ROWING_TYPE"), (int)bluetoothdevice::ROWING);
+        setWorkoutValue(obj, QStringLiteral("TREADMILL_TYPE"), (int)bluetoothdevice::TREADMILL);
+        setWorkoutValue(obj, QStringLiteral("UNKNOWN_TYPE"), (int)bluetoothdevice::UNKNOWN);
     }
     if (!device) {
         obj.setProperty(QStringLiteral("deviceId"), QJSValue());
+        context.remove(QStringLiteral("deviceId"));
     } else {
         QTime el = device->elapsedTime();
         QString name;
@@ -690,85 +801,87 @@ void TemplateInfoSenderBuilder::buildContext(bool forceReinit) {
 
         metric dep;
 #ifdef Q_OS_IOS
-        obj.setProperty("deviceId", device->bluetoothDevice.deviceUuid().toString());
+        setWorkoutValue(obj, QStringLiteral("deviceId"), device->bluetoothDevice.deviceUuid().toString());
 #else
-        obj.setProperty(QStringLiteral("deviceId"), device->bluetoothDevice.address().toString());
+        setWorkoutValue(obj, QStringLiteral("deviceId"), device->bluetoothDevice.address().toString());
 #endif
-        obj.setProperty(QStringLiteral("deviceName"),
+        setWorkoutValue(obj, QStringLiteral("deviceName"),
                         (name = device->bluetoothDevice.name()).isEmpty() ? QString(QStringLiteral("N/A")) : name);
-        obj.setProperty(QStringLiteral("deviceRSSI"), device->bluetoothDevice.rssi());
-        obj.setProperty(QStringLiteral("deviceType"), (int)device->deviceType());
-        obj.setProperty(QStringLiteral("deviceConnected"), (bool)device->connected());
-        obj.setProperty(QStringLiteral("devicePaused"), (bool)device->isPaused());
-        obj.setProperty(QStringLiteral("elapsed_s"), el.second());
-        obj.setProperty(QStringLiteral("elapsed_m"), el.minute());
-        obj.setProperty(QStringLiteral("elapsed_h"), el.hour());
+        setWorkoutValue(obj, QStringLiteral("deviceRSSI"), device->bluetoothDevice.rssi());
+        setWorkoutValue(obj, QStringLiteral("deviceType"), (int)device->deviceType());
+        setWorkoutValue(obj, QStringLiteral("deviceConnected"), (bool)device->connected());
+        setWorkoutValue(obj, QStringLiteral("devicePaused"), (bool)device->isPaused());
+        setWorkoutValue(obj, QStringLiteral("elapsed_s"), el.second());
+        setWorkoutValue(obj, QStringLiteral("elapsed_m"), el.minute());
+        setWorkoutValue(obj, QStringLiteral("elapsed_h"), el.hour());
         el = device->currentPace();
-        obj.setProperty(QStringLiteral("pace_s"), el.second());
-        obj.setProperty(QStringLiteral("pace_m"), el.minute());
-        obj.setProperty(QStringLiteral("pace_h"), el.hour());
+        setWorkoutValue(obj, QStringLiteral("pace_s"), el.second());
+        setWorkoutValue(obj, QStringLiteral("pace_m"), el.minute());
+        setWorkoutValue(obj, QStringLiteral("pace_h"), el.hour());
         el = device->movingTime();
-        obj.setProperty(QStringLiteral("moving_s"), el.second());
-        obj.setProperty(QStringLiteral("moving_m"), el.minute());
-        obj.setProperty(QStringLiteral("moving_h"), el.hour());
-        obj.setProperty(QStringLiteral("speed"), (dep = device->currentSpeed()).value());
-        obj.setProperty(QStringLiteral("speed_avg"), dep.average());
-        obj.setProperty(QStringLiteral("calories"), device->calories().value());
-        obj.setProperty(QStringLiteral("distance"), device->odometer());
-        obj.setProperty(QStringLiteral("heart"), (dep = device->currentHeart()).value());
-        obj.setProperty(QStringLiteral("heart_avg"), dep.average());
-        obj.setProperty(QStringLiteral("heart_max"), dep.max());
-        obj.setProperty(QStringLiteral("jouls"), device->jouls().value());
-        obj.setProperty(QStringLiteral("elevation"), device->elevationGain().value());
-        obj.setProperty(QStringLiteral("difficult"), device->difficult());
-        obj.setProperty(QStringLiteral("watts"), (dep = device->wattsMetric()).value());
-        obj.setProperty(QStringLiteral("watts_avg"), dep.average());
-        obj.setProperty(QStringLiteral("watts_max"), dep.max());
-        obj.setProperty(QStringLiteral("kgwatts"), (dep = device->wattKg()).value());
-        obj.setProperty(QStringLiteral("kgwatts_avg"), dep.average());
-        obj.setProperty(QStringLiteral("kgwatts_max"), dep.max());
-        obj.setProperty(QStringLiteral("workoutName"), workoutName);
-        obj.setProperty(QStringLiteral("workoutStartDate"), workoutStartDate);
-        obj.setProperty(QStringLiteral("instructorName"), instructorName);
-        obj.setProperty(QStringLiteral("latitude"), device->currentCordinate().latitude());
-        obj.setProperty(QStringLiteral("longitude"), device->currentCordinate().longitude());
-        obj.setProperty(
-            QStringLiteral("nickName"),
+        setWorkoutValue(obj, QStringLiteral("moving_s"), el.second());
+        setWorkoutValue(obj, QStringLiteral("moving_m"), el.minute());
+        setWorkoutValue(obj, QStringLiteral("moving_h"), el.hour());
+        setWorkoutValue(obj, QStringLiteral("speed"), (dep = device->currentSpeed()).value());
+        setWorkoutValue(obj, QStringLiteral("speed_avg"), dep.average());
+        setWorkoutValue(obj, QStringLiteral("calories"), device->calories().value());
+        setWorkoutValue(obj, QStringLiteral("distance"), device->odometer());
+        setWorkoutValue(obj, QStringLiteral("heart"), (dep = device->currentHeart()).value());
+        setWorkoutValue(obj, QStringLiteral("heart_avg"), dep.average());
+        setWorkoutValue(obj, QStringLiteral("heart_max"), dep.max());
+        setWorkoutValue(obj, QStringLiteral("jouls"), device->jouls().value());
+        setWorkoutValue(obj, QStringLiteral("elevation"), device->elevationGain().value());
+        setWorkoutValue(obj, QStringLiteral("difficult"), device->difficult());
+        setWorkoutValue(obj, QStringLiteral("watts"), (dep = device->wattsMetric()).value());
+        setWorkoutValue(obj, QStringLiteral("watts_avg"), dep.average());
+        setWorkoutValue(obj, QStringLiteral("watts_max"), dep.max());
+        setWorkoutValue(obj, QStringLiteral("kgwatts"), (dep = device->wattKg()).value());
+        setWorkoutValue(obj, QStringLiteral("kgwatts_avg"), dep.average());
+        setWorkoutValue(obj, QStringLiteral("kgwatts_max"), dep.max());
+        setWorkoutValue(obj, QStringLiteral("workoutName"), workoutName);
+        setWorkoutValue(obj, QStringLiteral("workoutStartDate"), workoutStartDate);
+        setWorkoutValue(obj, QStringLiteral("instructorName"), instructorName);
+        setWorkoutValue(obj, QStringLiteral("latitude"), device->currentCordinate().latitude());
+        setWorkoutValue(obj, QStringLiteral("longitude"), device->currentCordinate().longitude());
+        setWorkoutValue(
+            obj, QStringLiteral("nickName"),
             (nickName = settings.value(QStringLiteral("user_nickname"), QStringLiteral("")).toString()).isEmpty()
                 ? QString(QStringLiteral("N/A"))
                 : nickName);
         if (tp == bluetoothdevice::BIKE) {
-            obj.setProperty(QStringLiteral("peloton_resistance"),
+            setWorkoutValue(obj, QStringLiteral("peloton_resistance"),
                             (dep = ((bike *)device)->pelotonResistance()).value());
-            obj.setProperty(QStringLiteral("peloton_resistance_avg"), dep.average());
-            obj.setProperty(QStringLiteral("cadence"), (dep = ((bike *)device)->currentCadence()).value());
-            obj.setProperty(QStringLiteral("cadence_avg"), dep.average());
-            obj.setProperty(QStringLiteral("resistance"), (dep = ((bike *)device)->currentResistance()).value());
-            obj.setProperty(QStringLiteral("resistance_avg"), dep.average());
-            obj.setProperty(QStringLiteral("cranks"), ((bike *)device)->currentCrankRevolutions());
-            obj.setProperty(QStringLiteral("cranktime"), ((bike *)device)->lastCrankEventTime());
-            obj.setProperty(QStringLiteral("req_power"), (dep = ((bike *)device)->lastRequestedPower()).value());
-            obj.setProperty(QStringLiteral("req_cadence"), (dep = ((bike *)device)->lastRequestedCadence()).value());
-            obj.setProperty(QStringLiteral("req_resistance"),
+            setWorkoutValue(obj, QStringLiteral("peloton_resistance_avg"), dep.average());
+            setWorkoutValue(obj, QStringLiteral("cadence"), (dep = ((bike *)device)->currentCadence()).value());
+            setWorkoutValue(obj, QStringLiteral("cadence_avg"), dep.average());
+            setWorkoutValue(obj, QStringLiteral("resistance"), (dep = ((bike *)device)->currentResistance()).value());
+            setWorkoutValue(obj, QStringLiteral("resistance_avg"), dep.average());
+            setWorkoutValue(obj, QStringLiteral("cranks"), ((bike *)device)->currentCrankRevolutions());
+            setWorkoutValue(obj, QStringLiteral("cranktime"), ((bike *)device)->lastCrankEventTime());
+            setWorkoutValue(obj, QStringLiteral("req_power"), (dep = ((bike *)device)->lastRequestedPower()).value());
+            setWorkoutValue(obj, QStringLiteral("req_cadence"),
+                            (dep = ((bike *)device)->lastRequestedCadence()).value());
+            setWorkoutValue(obj, QStringLiteral("req_resistance"),
                             (dep = ((bike *)device)->lastRequestedResistance()).value());
         } else if (tp == bluetoothdevice::ROWING) {
-            obj.setProperty(QStringLiteral("peloton_resistance"),
+            setWorkoutValue(obj, QStringLiteral("peloton_resistance"),
                             (dep = ((rower *)device)->pelotonResistance()).value());
-            obj.setProperty(QStringLiteral("peloton_resistance_avg"), dep.average());
-            obj.setProperty(QStringLiteral("cadence"), (dep = ((rower *)device)->currentCadence()).value());
-            obj.setProperty(QStringLiteral("cadence_avg"), dep.average());
-            obj.setProperty(QStringLiteral("resistance"), (dep = ((rower *)device)->currentResistance()).value());
-            obj.setProperty(QStringLiteral("resistance_avg"), dep.average());
-            obj.setProperty(QStringLiteral("cranks"), ((rower *)device)->currentCrankRevolutions());
-            obj.setProperty(QStringLiteral("cranktime"), ((rower *)device)->lastCrankEventTime());
-            obj.setProperty(QStringLiteral("strokescount"), ((rower *)device)->currentStrokesCount().value());
-            obj.setProperty(QStringLiteral("strokeslength"), ((rower *)device)->currentStrokesLength().value());
+            setWorkoutValue(obj, QStringLiteral("peloton_resistance_avg"), dep.average());
+            setWorkoutValue(obj, QStringLiteral("cadence"), (dep = ((rower *)device)->currentCadence()).value());
+            setWorkoutValue(obj, QStringLiteral("cadence_avg"), dep.average());
+            setWorkoutValue(obj, QStringLiteral("resistance"), (dep = ((rower *)device)->currentResistance()).value());
+            setWorkoutValue(obj, QStringLiteral("resistance_avg"), dep.average());
+            setWorkoutValue(obj, QStringLiteral("cranks"), ((rower *)device)->currentCrankRevolutions());
+            setWorkoutValue(obj, QStringLiteral("cranktime"), ((rower *)device)->lastCrankEventTime());
+            setWorkoutValue(obj, QStringLiteral("strokescount"), ((rower *)device)->currentStrokesCount().value());
+            setWorkoutValue(obj, QStringLiteral("strokeslength"), ((rower *)device)->currentStrokesLength().value());
         } else {
-            obj.setProperty(QStringLiteral("inclination"), (dep = ((treadmill *)device)->currentInclination()).value());
-            obj.setProperty(QStringLiteral("inclination_avg"), dep.average());
+            setWorkoutValue(obj, QStringLiteral("inclination"),
+                            (dep = ((treadmill *)device)->currentInclination()).value());
+            setWorkoutValue(obj, QStringLiteral("inclination_avg"), dep.average());
         }
         if (!device->isPaused()) {
-            sessionArray.append(QJsonObject::fromVariantMap(obj.toVariant().toMap()));
+            appendSessionArray(context);
         }
     }
 }
@@ -5,11 +5,15 @@
 #include <QHash>
 #include <QJSEngine>
 #include <QJsonArray>
+#include <QJsonValue>
 #include <QSettings>
+#include <QVector>
 
 #define TEMPLATE_TYPE_TCPCLIENT QStringLiteral("TcpClient")
 #define TEMPLATE_TYPE_WEBSERVER QStringLiteral("WebServer")
 #define TEMPLATE_PRIVATE_WEBSERVER_ID "QZWS"
+// one sample per second: 12 hours, about 17 MB with the 50 fields of a bike
+#define TEMPLATE_SESSION_HISTORY_MAX 43200
 
 class TemplateInfoSenderBuilder : public QObject {
     Q_OBJECT
@@ -28,14 +32,32 @@ class TemplateInfoSenderBuilder : public QObject {
   private:
     bool validFileTemplateType(const QString &tp) const;
     void buildContext(bool forceReinit = false);
+    void setWorkoutValue(QJSValue &obj, const QString &name, const QVariant &value);
     QString activityDescription;
     void createTemplatesFromFolder(const QString &idInfo, const QString &folder, QStringList &dirTemplates);
     void clearSessionArray();
+    void appendSessionArray(const QHash<QString, QVariant> &sample);
+    QJsonObject sessionSample(int i) const;
     bluetoothdevice *device = nullptr;
     QTimer updateTimer;
     QString masterId;
     QStringList foldersToLook;
-    QJsonArray sessionArray;
+    // one field of the workout samples, in a typed array instead of a QJsonObject per sample
+    struct sessionColumn {
+        QJsonValue::Type type = QJsonValue::Double;
+        QVector<double> numbers;  // Double and Bool fields, NaN when a sample doesn't have the field
+        QVector<QString> strings; // String fields, shared with the context, null when a sample doesn't have it
+        int size() const { return type == QJsonValue::String ? strings.size() : numbers.size(); }
+        void resize(int size);
+        void set(int i, const QVariant &value);
+        QJsonValue value(int i) const;
+    };
+    // ring of the last TEMPLATE_SESSION_HISTORY_MAX workout samples, oldest first from sessionArrayHead
+    QHash<QString, sessionColumn> sessionColumns;
+    int sessionCount = 0;
+    int sessionArrayHead = 0;
+    // sequence number of the next sample, never reset so the clients can ask for the samples since a sequence
+    qint64 sessionSequence = 0;
     QHash<QString, QVariant> context;
     QJSEngine *engine = nullptr;
     TemplateInfoSenderBuilder(QObject *parent);
@@ -57,7 +79,7 @@ class TemplateInfoSenderBuilder : public QObject {
     void onSaveTrainingProgram(const QJsonValue &msgContent, TemplateInfoSender *tempSender);
     void onLoadTrainingPrograms(const QJsonValue &msgContent, TemplateInfoSender *tempSender);
     void onAppendActivityDescription(const QJsonValue &msgContent, TemplateInfoSender *tempSender);
-    void onGetSessionArray(TemplateInfoSender *tempSender);
+    void onGetSessionArray(const QJsonValue &msgContent, TemplateInfoSender *tempSender);
     QString workoutName = QStringLiteral("");
     QString workoutStartDate = QStringLiteral("");
     QString instructorName = QStringLiteral("");
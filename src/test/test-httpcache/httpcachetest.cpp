@@ -0,0 +1,174 @@
+#include "httpcache.h"
+
+#include <QDir>
+#include <QNetworkAccessManager>
+#include <QStandardPaths>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QtTest>
+
+// A server answering GET /workouts with a 200 and the ETag "v1", or with a 304 when the request has
+// If-None-Match: "v1", then closing the connection.
+class mockserver : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit mockserver(QObject *parent = nullptr) : QObject(parent) {
+        connect(&server, &QTcpServer::newConnection, this, &mockserver::newConnection);
+    }
+
+    bool listen() { return server.listen(QHostAddress::LocalHost); }
+    void close() { server.close(); }
+    QUrl url() const { return QUrl(QStringLiteral("http://127.0.0.1:%1/workouts").arg(server.serverPort())); }
+
+    int requests = 0;
+    bool lastConditional = false; // the last request had If-None-Match
+
+  private slots:
+    void newConnection() {
+        while (QTcpSocket *socket = server.nextPendingConnection()) {
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+                QByteArray &request = pending[socket];
+                request += socket->readAll();
+                if (!request.contains("\r\n\r\n")) {
+                    return;
+                }
+                requests++;
+                lastConditional = request.toLower().contains("if-none-match: \"v1\"");
+                if (lastConditional) {
+                    socket->write("HTTP/1.1 304 Not Modified\r\nETag: \"v1\"\r\nConnection: close\r\n\r\n");
+                } else {
+                    socket->write("HTTP/1.1 200 OK\r\nETag: \"v1\"\r\nContent-Type: application/json\r\n"
+                                  "Content-Length: 13\r\nConnection: close\r\n\r\n{\"rides\": 42}");
+                }
+                pending.remove(socket);
+                socket->disconnectFromHost();
+            });
+        }
+    }
+
+  private:
+    QTcpServer server;
+    QHash<QTcpSocket *, QByteArray> pending;
+};
+
+class httpcachetest : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void init();
+    void notModified();
+    void staleOffline();
+    void lostEntry();
+
+  private:
+    QNetworkReply *get(QNetworkRequest request);
+
+    QNetworkAccessManager manager;
+    QString cacheDir;
+};
+
+void httpcachetest::initTestCase() {
+    QStandardPaths::setTestModeEnabled(true);
+    cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/test");
+}
+
+void httpcachetest::init() { QDir(cacheDir).removeRecursively(); }
+
+QNetworkReply *httpcachetest::get(QNetworkRequest request) {
+    QNetworkReply *reply = manager.get(request);
+    reply->setParent(this);
+    return reply;
+}
+
+void httpcachetest::notModified() {
+    mockserver server;
+    QVERIFY(server.listen());
+    httpcache cache(QStringLiteral("test"));
+
+    QNetworkRequest request(server.url());
+    cache.prepare(request);
+    QVERIFY(!request.hasRawHeader("If-None-Match"));
+    QNetworkReply *reply = get(request);
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 5000);
+    QCOMPARE(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 200);
+    QCOMPARE(cache.body(reply), QByteArray("{\"rides\": 42}"));
+
+    // the second request is conditional and its 304 is answered with the stored body
+    request = QNetworkRequest(server.url());
+    cache.prepare(request);
+    QCOMPARE(request.rawHeader("If-None-Match"), QByteArray("\"v1\""));
+    reply = get(request);
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 5000);
+    QCOMPARE(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 304);
+    QVERIFY(server.lastConditional);
+    QCOMPARE(cache.body(reply), QByteArray("{\"rides\": 42}"));
+    QCOMPARE(server.requests, 2);
+}
+
+void httpcachetest::staleOffline() {
+    mockserver server;
+    QVERIFY(server.listen());
+    httpcache cache(QStringLiteral("test"));
+
+    QNetworkRequest request(server.url());
+    cache.prepare(request);
+    QNetworkReply *reply = get(request);
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 5000);
+    QCOMPARE(cache.body(reply), QByteArray("{\"rides\": 42}"));
+
+    // nobody listens on the port anymore
+    server.close();
+    request = QNetworkRequest(server.url());
+    cache.prepare(request);
+    reply = get(request);
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 5000);
+    QVERIFY(reply->error() != QNetworkReply::NoError);
+    QVERIFY(cache.body(reply, false).isEmpty());
+    QCOMPARE(cache.body(reply), QByteArray("{\"rides\": 42}"));
+}
+
+void httpcachetest::lostEntry() {
+    mockserver server;
+    QVERIFY(server.listen());
+    httpcache cache(QStringLiteral("test"));
+
+    QNetworkRequest request(server.url());
+    cache.prepare(request);
+    QNetworkReply *reply = get(request);
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 5000);
+    QCOMPARE(cache.body(reply), QByteArray("{\"rides\": 42}"));
+
+    // the stored response goes away between prepare() and the 304
+    request = QNetworkRequest(server.url());
+    cache.prepare(request);
+    QVERIFY(request.hasRawHeader("If-None-Match"));
+    QVERIFY(QDir(cacheDir).removeRecursively());
+    reply = get(request);
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 5000);
+    QCOMPARE(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 304);
+    QVERIFY(cache.body(reply).isEmpty());
+
+    QNetworkRequest again;
+    QVERIFY(cache.resend(reply, again));
+    QVERIFY(!again.hasRawHeader("If-None-Match"));
+    QCOMPARE(again.url(), server.url());
+    reply = get(again);
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 5000);
+    QCOMPARE(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 200);
+    QVERIFY(!server.lastConditional);
+    QCOMPARE(cache.body(reply), QByteArray("{\"rides\": 42}"));
+    QCOMPARE(server.requests, 3);
+
+    // a 304 with its stored response isn't sent again
+    request = QNetworkRequest(server.url());
+    cache.prepare(request);
+    reply = get(request);
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 5000);
+    QVERIFY(!cache.resend(reply, again));
+}
+
+QTEST_GUILESS_MAIN(httpcachetest)
+#include "httpcachetest.moc"
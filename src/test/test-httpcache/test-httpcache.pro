@@ -0,0 +1,18 @@
+# httpcache against a local mock server: a 200 stored then answered by a 304, the stale copy when the server is
+# gone and the resend of a 304 whose stored response was removed. See httpcachetest.cpp.
+
+QT += network testlib
+QT -= gui
+
+CONFIG += testcase c++11 console
+CONFIG -= app_bundle
+
+TARGET = test-httpcache
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+        ../../httpcache.cpp \
+        httpcachetest.cpp
+
+HEADERS += \
+        ../../httpcache.h
@@ -0,0 +1,379 @@
+#include "bluetoothdevice.h"
+#include "packetreplay.h"
+#include "settingssnapshot.h"
+#include "treadmill.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMetaMethod>
+#include <QSettings>
+#include <QSignalSpy>
+#include <QtTest>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Parser throughput of the device classes: every row feeds its frames to characteristicChanged() (or to
+// processAdvertising() for the devices that only scan) of a device created by packetreplay, without a connection.
+// QBENCHMARK measures a pass over the frames, then the ns and the heap allocations per packet are printed and
+// checked against a limit:
+//   QZ_PARSER_MAX_NS, QZ_PARSER_MAX_ALLOCS  absolute limits per packet (default 50000 ns, 200 allocations)
+//   QZ_PARSER_BASELINE                      CSV of a previous run: written if missing, otherwise a row fails when
+//                                           it's slower than the baseline by more than QZ_PARSER_TOLERANCE percent
+//                                           (default 25)
+//   QZ_PARSER_CAPTURE, QZ_PARSER_DEVICE     also replay a recorded capture (any format of packetreplay)
+//   QZ_PARSER_VERBOSE                       keep the debug output of the parsers, dropped by default
+// treadmillMetricsUpdated checks that the update of a treadmill notifies the virtual devices with metricsUpdated.
+// treadmillSnapshot checks that the metrics of a parsed frame reach the snapshot read by the virtual devices.
+// replayFixture replays replay/<class>.qzpkt and compares the metrics with replay/<class>.csv; a * field isn't
+// compared (the odometer follows the wall clock between the packets).
+
+// defined by main.cpp in the application
+QString logfilename = QStringLiteral("test-parsers.log");
+
+static std::atomic<bool> countAllocations{false};
+static std::atomic<qint64> allocations{0};
+
+static inline void allocation() {
+    if (countAllocations.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+#ifdef __GLIBC__
+// the Qt containers allocate with malloc, so that's what is counted
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size) noexcept {
+    allocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) noexcept {
+    allocation();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) noexcept {
+    allocation();
+    return __libc_realloc(ptr, size);
+}
+}
+#else
+// only operator new can be replaced portably
+void *operator new(size_t size) {
+    allocation();
+    void *p = std::malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+#endif
+
+Q_DECLARE_METATYPE(packetreplay::packet)
+
+struct synthesized {
+    const char *device;
+    quint16 characteristic; // 0 when the parser doesn't check it
+    const char *frames;     // hex, the frames separated by '|'
+};
+
+// frames with the flags the machines send most often
+static const synthesized synthesizedFrames[] = {
+    // speed, cadence, distance, resistance, power, energy, heart
+    {"ftmsbike", 0x2AD2,
+     "74 03 28 0a b4 00 d2 04 00 14 00 c8 00 32 00 f4 01 08 8c|"
+     "74 03 3c 0a b8 00 e6 04 00 15 00 d2 00 33 00 f4 01 08 8d"},
+    {"schwinnic4bike", 0x2AD2,
+     "74 03 28 0a b4 00 d2 04 00 14 00 c8 00 32 00 f4 01 08 8c|"
+     "74 03 3c 0a b8 00 e6 04 00 15 00 d2 00 33 00 f4 01 08 8d"},
+    {"renphobike", 0x2AD2,
+     "74 03 28 0a b4 00 d2 04 00 14 00 c8 00 32 00 f4 01 08 8c|"
+     "74 03 3c 0a b8 00 e6 04 00 15 00 d2 00 33 00 f4 01 08 8d"},
+    // strokes, distance, pace, power, energy
+    {"ftmsrower", 0x2AD1,
+     "2c 01 3c 2a 00 e8 03 00 78 00 96 00 20 00 f4 01 08|"
+     "2c 01 3e 2b 00 f2 03 00 76 00 98 00 21 00 f4 01 08"},
+    // speed, distance, inclination, energy, heart, elapsed time
+    {"horizontreadmill", 0x2ACD,
+     "8c 05 e8 03 d0 07 00 0f 00 00 00 32 00 f4 01 08 8c 58 02|"
+     "8c 05 f2 03 da 07 00 14 00 00 00 33 00 f4 01 08 8d 59 02"},
+    {"domyostreadmill", 0,
+     "f0 bc 00 00 00 00 00 64 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00|"
+     "f0 bc 00 0a 00 00 00 6e 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00"},
+    // metrics and resistance frames
+    {"echelonconnectsport", 0,
+     "f0 d1 09 00 3c 00 00 00 64 00 5a 00 00|"
+     "f0 d2 01 0a cd|"
+     "f0 d1 09 00 3d 00 00 00 66 00 5b 00 00"},
+    // advertising data
+    {"m3ibike", 0,
+     "02 01 06 30 00 01 5a 00 8c 00 c8 00 32 00 0a 1e e8 83 05|"
+     "02 01 06 30 00 01 5c 00 8d 00 d2 00 33 00 0a 1f f0 83 05"},
+    {"heartratebelt", 0x2A37, "00 8c|00 8d"},
+    {"cscbike", 0x2A5B, "02 10 00 00 04|02 11 00 00 08"},
+    {"tacxneo2", 0x2A5B, "02 10 00 00 04|02 11 00 00 08"},
+    {"stagesbike", 0x2A63, "00 00 c8 00|00 00 d2 00"},
+};
+
+static QtMessageHandler testHandler = nullptr;
+
+static void dropDebug(QtMsgType type, const QMessageLogContext &context, const QString &msg) {
+    if (type != QtDebugMsg && testHandler) {
+        testHandler(type, context, msg);
+    }
+}
+
+class parserbenchmark : public QObject {
+
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void parse_data();
+    void parse();
+    void treadmillMetricsUpdated();
+    void treadmillSnapshot();
+    void replayFixture_data();
+    void replayFixture();
+    void cleanupTestCase();
+
+  private:
+    packetreplay replay; // owns the characteristics
+    double maxNs = 50000;
+    double maxAllocations = 200;
+    double tolerance = 0.25;
+    QString baselineFile;
+    QHash<QString, QPair<double, double>> baseline; // ns and allocations per packet by data tag
+    QStringList measured;
+};
+
+void parserbenchmark::initTestCase() {
+    // settings of the benchmark only
+    QCoreApplication::setOrganizationName(QStringLiteral("qDomyos-Zwift test"));
+    QCoreApplication::setApplicationName(QStringLiteral("test-parsers"));
+    QSettings settings;
+    settings.setValue(QStringLiteral("virtual_device_enabled"), false);
+    settingssnapshot::reload();
+
+    if (!qEnvironmentVariableIsSet("QZ_PARSER_VERBOSE")) {
+        testHandler = qInstallMessageHandler(dropDebug);
+    }
+    if (qEnvironmentVariableIsSet("QZ_PARSER_MAX_NS")) {
+        maxNs = qEnvironmentVariable("QZ_PARSER_MAX_NS").toDouble();
+    }
+    if (qEnvironmentVariableIsSet("QZ_PARSER_MAX_ALLOCS")) {
+        maxAllocations = qEnvironmentVariable("QZ_PARSER_MAX_ALLOCS").toDouble();
+    }
+    if (qEnvironmentVariableIsSet("QZ_PARSER_TOLERANCE")) {
+        tolerance = qEnvironmentVariable("QZ_PARSER_TOLERANCE").toDouble() / 100.0;
+    }
+
+    baselineFile = qEnvironmentVariable("QZ_PARSER_BASELINE");
+    QFile f(baselineFile);
+    if (!baselineFile.isEmpty() && f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        while (!f.atEnd()) {
+            const QStringList fields = QString::fromUtf8(f.readLine()).trimmed().split(QLatin1Char(';'));
+            if (fields.count() == 3) {
+                baseline.insert(fields.at(0), qMakePair(fields.at(1).toDouble(), fields.at(2).toDouble()));
+            }
+        }
+    }
+}
+
+void parserbenchmark::parse_data() {
+    QTest::addColumn<QString>("device");
+    QTest::addColumn<QList<packetreplay::packet>>("packets");
+
+    for (const synthesized &s : synthesizedFrames) {
+        QList<packetreplay::packet> packets;
+        const QList<QByteArray> frames = QByteArray(s.frames).split('|');
+        for (const QByteArray &frame : frames) {
+            packetreplay::packet p;
+            if (s.characteristic) {
+                p.characteristic = QBluetoothUuid(s.characteristic);
+            }
+            p.data = QByteArray::fromHex(frame);
+            packets.append(p);
+        }
+        QTest::newRow(s.device) << QString::fromLatin1(s.device) << packets;
+    }
+
+    const QString capture = qEnvironmentVariable("QZ_PARSER_CAPTURE");
+    packetreplay recorded;
+    if (!capture.isEmpty() && recorded.load(capture)) {
+        QString device = qEnvironmentVariable("QZ_PARSER_DEVICE");
+        if (device.isEmpty()) {
+            device = recorded.deviceClass();
+        }
+        QList<packetreplay::packet> packets;
+        for (const packetreplay::packet &p : recorded.packets()) {
+            if (!p.tx) {
+                packets.append(p);
+            }
+        }
+        QTest::newRow(qPrintable(QStringLiteral("capture ") + device)) << device << packets;
+    }
+}
+
+void parserbenchmark::parse() {
+    QFETCH(QString, device);
+    QFETCH(QList<packetreplay::packet>, packets);
+    QVERIFY(!packets.isEmpty());
+
+    // not deleted: the destructors expect a connection
+    bluetoothdevice *d = packetreplay::createDevice(device);
+    QVERIFY2(d, qPrintable(QStringLiteral("unknown device class ") + device));
+    const QMetaObject *meta = d->metaObject();
+    int index = meta->indexOfMethod("characteristicChanged(QLowEnergyCharacteristic,QByteArray)");
+    const bool advertising = index < 0;
+    if (advertising) {
+        index = meta->indexOfMethod("processAdvertising(QByteArray)");
+    }
+    const QMetaMethod method = meta->method(index);
+    QVERIFY2(method.isValid(), meta->className());
+
+    QList<QLowEnergyCharacteristic> characteristics;
+    for (const packetreplay::packet &p : qAsConst(packets)) {
+        characteristics.append(replay.characteristic(p.characteristic));
+    }
+    auto feed = [&]() {
+        for (int i = 0; i < packets.count(); i++) {
+            if (advertising) {
+                method.invoke(d, Qt::DirectConnection, Q_ARG(QByteArray, packets.at(i).data));
+            } else {
+                method.invoke(d, Qt::DirectConnection, Q_ARG(QLowEnergyCharacteristic, characteristics.at(i)),
+                              Q_ARG(QByteArray, packets.at(i).data));
+            }
+        }
+    };
+
+    // the first packets create what the device keeps (virtual device, caches...)
+    feed();
+    QBENCHMARK { feed(); }
+
+    const int rounds = qMax(1, 2000 / packets.count());
+    QElapsedTimer timer;
+    allocations = 0;
+    countAllocations = true;
+    timer.start();
+    for (int r = 0; r < rounds; r++) {
+        feed();
+    }
+    const qint64 ns = timer.nsecsElapsed();
+    countAllocations = false;
+
+    const double count = (double)rounds * packets.count();
+    const double nsPerPacket = ns / count;
+    const double allocationsPerPacket = allocations.load() / count;
+    const QString tag = QString::fromLatin1(QTest::currentDataTag());
+    qInfo("%s: %.0f ns/packet, %.1f allocations/packet", qPrintable(tag), nsPerPacket, allocationsPerPacket);
+    measured.append(tag + QLatin1Char(';') + QString::number(nsPerPacket, 'f', 0) + QLatin1Char(';') +
+                    QString::number(allocationsPerPacket, 'f', 1));
+
+    QVERIFY2(nsPerPacket <= maxNs, qPrintable(QStringLiteral("over %1 ns/packet").arg(maxNs)));
+    QVERIFY2(allocationsPerPacket <= maxAllocations,
+             qPrintable(QStringLiteral("over %1 allocations/packet").arg(maxAllocations)));
+    auto b = baseline.constFind(tag);
+    if (b != baseline.constEnd()) {
+        QVERIFY2(nsPerPacket <= b.value().first * (1.0 + tolerance),
+                 qPrintable(QStringLiteral("baseline %1 ns/packet").arg(b.value().first)));
+        // allocations don't depend on the load of the machine
+        QVERIFY2(allocationsPerPacket <= b.value().second + 0.5,
+                 qPrintable(QStringLiteral("baseline %1 allocations/packet").arg(b.value().second)));
+    }
+}
+
+void parserbenchmark::treadmillMetricsUpdated() {
+    treadmill *d = qobject_cast<treadmill *>(packetreplay::createDevice(QStringLiteral("horizontreadmill")));
+    QVERIFY(d);
+    QSignalSpy updated(d, &bluetoothdevice::metricsUpdated);
+
+    // what the update timer of a connected treadmill does after a packet
+    d->update_metrics(true, d->watts(settingssnapshot::current()->weight));
+    QCOMPARE(updated.count(), 1);
+}
+
+void parserbenchmark::treadmillSnapshot() {
+    treadmill *d = qobject_cast<treadmill *>(packetreplay::createDevice(QStringLiteral("horizontreadmill")));
+    QVERIFY(d);
+
+    // 10 km/h, 1.5 %, 50 kcal, 140 bpm
+    QVERIFY(QMetaObject::invokeMethod(
+        d, "characteristicChanged", Qt::DirectConnection,
+        Q_ARG(QLowEnergyCharacteristic, replay.characteristic(QBluetoothUuid((quint16)0x2ACD))),
+        Q_ARG(QByteArray, QByteArray::fromHex("8c 05 e8 03 d0 07 00 0f 00 00 00 32 00 f4 01 08 8c 58 02"))));
+    // what the update timer of a connected treadmill does after a packet
+    d->update_metrics(true, d->watts(settingssnapshot::current()->weight));
+
+    const devicesnapshot s = d->snapshot();
+    QVERIFY(s.speed > 0);
+    QCOMPARE(s.speed, d->currentSpeed().value());
+    QCOMPARE(s.speedMax, d->currentSpeed().max());
+    QCOMPARE(s.inclinationAvg, d->currentInclination().average());
+    QVERIFY(s.timestamp > 0);
+}
+
+void parserbenchmark::replayFixture_data() {
+    QTest::addColumn<QString>("device");
+
+    QTest::newRow("horizontreadmill") << QStringLiteral("horizontreadmill");
+}
+
+void parserbenchmark::replayFixture() {
+    QFETCH(QString, device);
+    const QString capture = QFINDTESTDATA(QStringLiteral("replay/") + device + QStringLiteral(".qzpkt"));
+    const QString metrics = QFINDTESTDATA(QStringLiteral("replay/") + device + QStringLiteral(".csv"));
+    QVERIFY(!capture.isEmpty() && !metrics.isEmpty());
+
+    packetreplay fixture;
+    QVERIFY(fixture.load(capture));
+    QCOMPARE(fixture.deviceClass(), device);
+    bluetoothdevice *d = packetreplay::createDevice(device);
+    QVERIFY(d);
+
+    // the qzpkt doesn't record the characteristic, the parser checks it
+    QString output;
+    QTextStream out(&output);
+    QVERIFY(fixture.run(d, 0, QBluetoothUuid((quint16)0x2ACD), out).ok);
+
+    QFile f(metrics);
+    QVERIFY(f.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QStringList expected = QString::fromUtf8(f.readAll()).trimmed().split(QLatin1Char('\n'));
+    const QStringList lines = output.trimmed().split(QLatin1Char('\n'));
+    QCOMPARE(lines.count(), expected.count());
+    for (int i = 0; i < lines.count(); i++) {
+        const QStringList fields = lines.at(i).split(QLatin1Char(';'));
+        const QStringList expectedFields = expected.at(i).split(QLatin1Char(';'));
+        QCOMPARE(fields.count(), expectedFields.count());
+        for (int k = 0; k < fields.count(); k++) {
+            if (expectedFields.at(k) != QStringLiteral("*")) {
+                QVERIFY2(fields.at(k) == expectedFields.at(k), qPrintable(lines.at(i) + QStringLiteral(" expected ") +
+                                                                          expected.at(i)));
+            }
+        }
+    }
+}
+
+void parserbenchmark::cleanupTestCase() {
+    if (testHandler) {
+        qInstallMessageHandler(testHandler);
+    }
+    if (baselineFile.isEmpty() || !baseline.isEmpty()) {
+        return;
+    }
+    QFile f(baselineFile);
+    if (f.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        f.write(measured.join(QLatin1Char('\n')).toUtf8() + '\n');
+        qInfo("baseline written to %s", qPrintable(baselineFile));
+    }
+}
+
+QTEST_GUILESS_MAIN(parserbenchmark)
+#include "parserbenchmark.moc"
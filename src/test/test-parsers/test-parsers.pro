@@ -0,0 +1,23 @@
+# Throughput of the device parsers: the application is built without its main() and the benchmark feeds
+# synthesized frames, or a recorded capture, to the device classes. See parserbenchmark.cpp.
+
+QZ_SRC = $$PWD/../..
+include($$QZ_SRC/qdomyos-zwift.pro)
+
+# the paths of the application are relative to src/
+SOURCES -= main.cpp
+for(var, $$list(SOURCES HEADERS FORMS OBJECTIVE_SOURCES OBJECTIVE_HEADERS INCLUDEPATH)) {
+    files = $$eval($$var)
+    $$var =
+    for(file, files): $$var += $$absolute_path($$file, $$QZ_SRC)
+}
+INCLUDEPATH += $$QZ_SRC
+RESOURCES =
+
+TARGET = test-parsers
+QT += testlib
+CONFIG += testcase
+CONFIG -= app_bundle
+
+SOURCES += \
+        parserbenchmark.cpp
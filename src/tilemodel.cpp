@@ -0,0 +1,144 @@
+#include "tilemodel.h"
+#include "homeform.h"
+#include "settingssnapshot.h"
+
+tilemodel::tilemodel(QObject *parent) : QAbstractListModel(parent) {
+    m_flush.setSingleShot(true);
+    reloadSettings();
+    connect(&m_flush, &QTimer::timeout, this, &tilemodel::flush);
+}
+
+void tilemodel::reloadSettings() { m_flush.setInterval(settingssnapshot::current()->tile_refresh_ms); }
+
+void tilemodel::setTiles(const QList<QObject *> &tiles) {
+    beginResetModel();
+    for (DataObject *tile : qAsConst(m_tiles)) {
+        disconnect(tile, nullptr, this, nullptr);
+    }
+    m_tiles.clear();
+    m_rows.clear();
+    for (QObject *o : tiles) {
+        DataObject *tile = static_cast<DataObject *>(o);
+        m_rows.insert(tile, m_tiles.count());
+        m_tiles.append(tile);
+
+        connect(tile, &DataObject::nameChanged, this, [this, tile]() { changed(tile, NameRole); });
+        connect(tile, &DataObject::iconChanged, this, [this, tile]() { changed(tile, IconRole); });
+        connect(tile, &DataObject::gridIdChanged, this, [this, tile]() { changed(tile, GridIdRole); });
+        connect(tile, &DataObject::valueChanged, this, [this, tile]() { changed(tile, ValueRole); });
+        connect(tile, &DataObject::secondLineChanged, this, [this, tile]() { changed(tile, SecondLineRole); });
+        connect(tile, &DataObject::valueFontSizeChanged, this, [this, tile]() { changed(tile, ValueFontSizeRole); });
+        connect(tile, &DataObject::valueFontColorChanged, this,
+                [this, tile]() { changed(tile, ValueFontColorRole); });
+        connect(tile, &DataObject::labelFontSizeChanged, this, [this, tile]() { changed(tile, LabelFontSizeRole); });
+        connect(tile, &DataObject::writableChanged, this, [this, tile]() { changed(tile, WritableRole); });
+        connect(tile, &DataObject::visibleChanged, this, [this, tile]() { changed(tile, VisibleItemRole); });
+    }
+    m_dirty.fill(false, m_tiles.count());
+    m_anyDirty = false;
+    m_dirtyRoles.clear();
+    m_flush.stop();
+    endResetModel();
+}
+
+int tilemodel::rowCount(const QModelIndex &parent) const { return parent.isValid() ? 0 : m_tiles.count(); }
+
+QVariant tilemodel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= m_tiles.count()) {
+        return QVariant();
+    }
+    DataObject *tile = m_tiles.at(index.row());
+    switch (role) {
+    case NameRole:
+        return tile->name();
+    case IconRole:
+        return tile->icon();
+    case GridIdRole:
+        return tile->gridId();
+    case ValueRole:
+        return tile->value();
+    case SecondLineRole:
+        return tile->secondLine();
+    case ValueFontSizeRole:
+        return tile->valueFontSize();
+    case ValueFontColorRole:
+        return tile->valueFontColor();
+    case LabelFontSizeRole:
+        return tile->labelFontSize();
+    case WritableRole:
+        return tile->writable();
+    case VisibleItemRole:
+        return tile->visibleItem();
+    case PlusNameRole:
+        return tile->plusName();
+    case MinusNameRole:
+        return tile->minusName();
+    case IdentificatorRole:
+        return tile->identificator();
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> tilemodel::roleNames() const {
+    // same names as the DataObject properties used by the delegate
+    static const QHash<int, QByteArray> roles = {{NameRole, "name"},
+                                                 {IconRole, "icon"},
+                                                 {GridIdRole, "gridId"},
+                                                 {ValueRole, "value"},
+                                                 {SecondLineRole, "secondLine"},
+                                                 {ValueFontSizeRole, "valueFontSize"},
+                                                 {ValueFontColorRole, "valueFontColor"},
+                                                 {LabelFontSizeRole, "labelFontSize"},
+                                                 {WritableRole, "writable"},
+                                                 {VisibleItemRole, "visibleItem"},
+                                                 {PlusNameRole, "plusName"},
+                                                 {MinusNameRole, "minusName"},
+                                                 {IdentificatorRole, "identificator"}};
+    return roles;
+}
+
+QObject *tilemodel::get(int row) const {
+    if (row < 0 || row >= m_tiles.count()) {
+        return nullptr;
+    }
+    return m_tiles.at(row);
+}
+
+void tilemodel::changed(DataObject *tile, int role) {
+    int row = m_rows.value(tile, -1);
+    if (row == -1) {
+        return;
+    }
+    m_dirty[row] = true;
+    m_anyDirty = true;
+    if (!m_dirtyRoles.contains(role)) {
+        m_dirtyRoles.append(role);
+    }
+    if (!m_flush.isActive()) {
+        m_flush.start();
+    }
+}
+
+void tilemodel::flush() {
+    if (!m_anyDirty) {
+        return;
+    }
+    QVector<int> roles;
+    roles.swap(m_dirtyRoles);
+    m_anyDirty = false;
+    // one range per run of changed rows: a range from the first to the last would refresh the tiles between them
+    for (int first = 0; first < m_dirty.count(); first++) {
+        if (!m_dirty.at(first)) {
+            continue;
+        }
+        int last = first;
+        while (last + 1 < m_dirty.count() && m_dirty.at(last + 1)) {
+            last++;
+        }
+        for (int row = first; row <= last; row++) {
+            m_dirty[row] = false;
+        }
+        emit dataChanged(index(first), index(last), roles);
+        first = last;
+    }
+}
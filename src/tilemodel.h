@@ -0,0 +1,61 @@
+#ifndef TILEMODEL_H
+#define TILEMODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QList>
+#include <QTimer>
+
+class DataObject;
+
+// Model of the tiles shown in the home grid.
+// The tiles are the DataObject of homeform, exposed through roles: a tile whose value didn't change doesn't
+// notify anything, and the changes collected during the refresh interval (tile_refresh_ms setting) are sent
+// to QML with a dataChanged for every run of consecutive changed tiles, instead of a property change for every
+// tile at every update.
+class tilemodel : public QAbstractListModel {
+
+    Q_OBJECT
+
+  public:
+    enum Roles {
+        NameRole = Qt::UserRole + 1,
+        IconRole,
+        GridIdRole,
+        ValueRole,
+        SecondLineRole,
+        ValueFontSizeRole,
+        ValueFontColorRole,
+        LabelFontSizeRole,
+        WritableRole,
+        VisibleItemRole,
+        PlusNameRole,
+        MinusNameRole,
+        IdentificatorRole
+    };
+
+    explicit tilemodel(QObject *parent = nullptr);
+    void setTiles(const QList<QObject *> &tiles);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    Q_INVOKABLE QObject *get(int row) const;
+
+    // takes the refresh interval of the current settings snapshot
+    void reloadSettings();
+
+  private:
+    void changed(DataObject *tile, int role);
+    void flush();
+
+    QList<DataObject *> m_tiles;
+    QHash<DataObject *, int> m_rows;
+    QTimer m_flush;
+    QVector<bool> m_dirty; // by row
+    bool m_anyDirty = false;
+    QVector<int> m_dirtyRoles;
+};
+
+#endif // TILEMODEL_H
@@ -1,4 +1,5 @@
 #include "toorxtreadmill.h"
+#include "packettrace.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
 #include <QMetaEnum>
@@ -83,7 +84,7 @@ void toorxtreadmill::update() {
             bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
             if (virtual_device_enabled) {
                 emit debug(QStringLiteral("creating virtual treadmill interface..."));
-                virtualTreadMill = new virtualtreadmill(this, true);
+                virtualTreadMill = virtualtreadmill::create(this, true);
                 connect(virtualTreadMill, &virtualtreadmill::debug, this, &toorxtreadmill::debug);
             }
         }
@@ -205,7 +206,7 @@ void toorxtreadmill::readSocket() {
 
     while (socket->bytesAvailable()) {
         QByteArray line = socket->readAll();
-        qDebug() << QStringLiteral(" << ") + line.toHex(' ');
+        packettrace::rx(this, line);
 
         if (line.length() == 17) {
             elapsed = GetElapsedTimeFromPacket(line);
@@ -2,6 +2,7 @@
 #include "zwiftworkout.h"
 #include <QFile>
 #include <QtXml/QtXml>
+#include <algorithm>
 #include <chrono>
 
 using namespace std::chrono_literals;
@@ -23,6 +24,70 @@ uint32_t trainprogram::calculateTimeForRow(int32_t row) {
             (rows.at(row).duration.hour() * 3600));
 }
 
+const QVector<uint32_t> &trainprogram::timeline() {
+    if (!timelineValid) {
+        timelineValid = true;
+        rowsEnd.clear();
+        rowsEnd.reserve(rows.count());
+        rowsDistanceEnd.clear();
+        uint32_t end = 0;
+        bool route = !rows.isEmpty();
+        for (int32_t row = 0; row < rows.count(); row++) {
+            end += calculateTimeForRow(row);
+            rowsEnd.append(end);
+            route = route && rows.at(row).distance >= 0;
+        }
+        if (route) {
+            rowsDistanceEnd.reserve(rows.count());
+            double distanceEnd = 0;
+            for (const trainrow &row : qAsConst(rows)) {
+                distanceEnd += row.distance;
+                rowsDistanceEnd.append(distanceEnd);
+            }
+        }
+    }
+    return rowsEnd;
+}
+
+int32_t trainprogram::rowAt(int32_t elapsed) {
+    // first row ending after elapsed, rows.length() when the program is over
+    const QVector<uint32_t> &t = timeline();
+    return std::upper_bound(t.constBegin(), t.constEnd(), static_cast<uint32_t>(elapsed)) - t.constBegin();
+}
+
+int32_t trainprogram::rowPower(int32_t row) {
+    const trainrow &r = rows.at(row);
+    uint32_t len = calculateTimeForRow(row);
+    if (r.power == -1 || r.power_end == -1 || len == 0) {
+        return r.power;
+    }
+    // seconds elapsed in the row, the ramp is evaluated at the current time instead of being stored second by second
+    int32_t rowStart = row ? timeline().at(row - 1) : 0;
+    int32_t elapsed = qBound(0, ticks - rowStart, static_cast<int32_t>(len) - 1);
+    return r.power + ((r.power_end - r.power) * elapsed) / static_cast<int32_t>(len);
+}
+
+double trainprogram::routeDistance() { return bluetoothManager->device()->odometer() - startOdometer; }
+
+int32_t trainprogram::rowAtDistance(double distance) {
+    // first row ending after distance, rows.length() at the end of the route
+    timeline();
+    return std::upper_bound(rowsDistanceEnd.constBegin(), rowsDistanceEnd.constEnd(), distance) -
+           rowsDistanceEnd.constBegin();
+}
+
+QGeoCoordinate trainprogram::routePosition(int32_t row, double distance) {
+    // a row holds the position at its end: the position moves from the end of the previous row
+    const trainrow &r = rows.at(row);
+    if (row == 0 || qIsNaN(rows.at(row - 1).latitude) || r.distance <= 0) {
+        return QGeoCoordinate(r.latitude, r.longitude);
+    }
+    const trainrow &previous = rows.at(row - 1);
+    double f = qBound(0.0, (distance - rowsDistanceEnd.at(row - 1)) / r.distance, 1.0);
+    return QGeoCoordinate(previous.latitude + ((r.latitude - previous.latitude) * f),
+                          previous.longitude + ((r.longitude - previous.longitude) * f));
+}
+
 void trainprogram::scheduler() {
 
     QSettings settings;
@@ -38,6 +103,7 @@ void trainprogram::scheduler() {
 
     // entry point
     if (ticks == 1 && currentStep == 0) {
+        startOdometer = bluetoothManager->device()->odometer();
         if (bluetoothManager->device()->deviceType() == bluetoothdevice::TREADMILL) {
             if (rows.at(0).forcespeed && rows.at(0).speed) {
                 qDebug() << QStringLiteral("trainprogram change speed") + QString::number(rows.at(0).speed);
@@ -58,8 +124,8 @@ void trainprogram::scheduler() {
             }
 
             if (rows.at(0).power != -1) {
-                qDebug() << QStringLiteral("trainprogram change power") + QString::number(rows.at(0).power);
-                emit changePower(rows.at(0).power);
+                qDebug() << QStringLiteral("trainprogram change power") + QString::number(rowPower(0));
+                emit changePower(rowPower(0));
             }
 
             if (rows.at(0).requested_peloton_resistance != -1) {
@@ -100,16 +166,10 @@ void trainprogram::scheduler() {
     qDebug() << QStringLiteral("trainprogram elapsed ") + QString::number(ticks) + QStringLiteral("current row len") +
                     QString::number(currentRowLen);
 
-    uint32_t calculatedLine;
-    uint32_t calculatedElapsedTime = 0;
-    for (calculatedLine = 0; calculatedLine < static_cast<uint32_t>(rows.length()); calculatedLine++) {
-
-        calculatedElapsedTime += calculateTimeForRow(calculatedLine);
-
-        if (calculatedElapsedTime > static_cast<uint32_t>(ticks)) {
-            break;
-        }
-    }
+    // a route follows the distance covered, so the slope matches where the rider is whatever the speed
+    const bool route = !timeline().isEmpty() && !rowsDistanceEnd.isEmpty();
+    const double distance = route ? routeDistance() : 0;
+    uint32_t calculatedLine = route ? rowAtDistance(distance) : rowAt(ticks);
 
     if (calculatedLine != currentStep) {
         if (calculateTimeForRow(calculatedLine)) {
@@ -138,9 +198,8 @@ void trainprogram::scheduler() {
                 }
 
                 if (rows.at(currentStep).power != -1) {
-                    qDebug() << QStringLiteral("trainprogram change power ") +
-                                    QString::number(rows.at(currentStep).power);
-                    emit changePower(rows.at(currentStep).power);
+                    qDebug() << QStringLiteral("trainprogram change power ") + QString::number(rowPower(currentStep));
+                    emit changePower(rowPower(currentStep));
                 }
 
                 if (rows.at(currentStep).requested_peloton_resistance != -1) {
@@ -167,7 +226,9 @@ void trainprogram::scheduler() {
                 emit changeFanSpeed(rows.at(currentStep).fanspeed);
             }
 
-            if (rows.at(currentStep).latitude != NAN || rows.at(currentStep).longitude != NAN) {
+            if (route) {
+                emit changeGeoPosition(routePosition(currentStep, distance));
+            } else if (rows.at(currentStep).latitude != NAN || rows.at(currentStep).longitude != NAN) {
                 qDebug() << QStringLiteral("trainprogram change GEO position") +
                                 QString::number(rows.at(currentStep).latitude) + " " +
                                 QString::number(rows.at(currentStep).longitude);
@@ -183,12 +244,15 @@ void trainprogram::scheduler() {
             emit stop();
         }
     } else {
+        if (route && currentStep < rows.length()) {
+            emit changeGeoPosition(routePosition(currentStep, distance));
+        }
         if (bluetoothManager->device()->deviceType() == bluetoothdevice::TREADMILL) {
 
         } else {
             if (rows.length() > currentStep && rows.at(currentStep).power != -1) {
-                qDebug() << QStringLiteral("trainprogram change power ") + QString::number(rows.at(currentStep).power);
-                emit changePower(rows.at(currentStep).power);
+                qDebug() << QStringLiteral("trainprogram change power ") + QString::number(rowPower(currentStep));
+                emit changePower(rowPower(currentStep));
             }
         }
     }
@@ -247,6 +311,9 @@ bool trainprogram::saveXML(const QString &filename, const QList<trainrow> &rows)
             if (row.longitude != NAN) {
                 stream.writeAttribute(QStringLiteral("longitude"), QString::number(row.longitude));
             }
+            if (row.distance >= 0) {
+                stream.writeAttribute(QStringLiteral("distance"), QString::number(row.distance));
+            }
             if (row.upper_resistance >= 0) {
                 stream.writeAttribute(QStringLiteral("upper_resistance"), QString::number(row.upper_resistance));
             }
@@ -274,6 +341,9 @@ bool trainprogram::saveXML(const QString &filename, const QList<trainrow> &rows)
             if (row.power >= 0) {
                 stream.writeAttribute(QStringLiteral("power"), QString::number(row.power));
             }
+            if (row.power_end >= 0) {
+                stream.writeAttribute(QStringLiteral("power_end"), QString::number(row.power_end));
+            }
             stream.writeAttribute(QStringLiteral("forcespeed"),
                                   row.forcespeed ? QStringLiteral("1") : QStringLiteral("0"));
             if (row.fanspeed >= 0) {
@@ -348,6 +418,9 @@ QList<trainrow> trainprogram::loadXML(const QString &filename) {
             if (atts.hasAttribute(QStringLiteral("longitude"))) {
                 row.longitude = atts.value(QStringLiteral("longitude")).toInt();
             }
+            if (atts.hasAttribute(QStringLiteral("distance"))) {
+                row.distance = atts.value(QStringLiteral("distance")).toDouble();
+            }
             if (atts.hasAttribute(QStringLiteral("upper_resistance"))) {
                 row.upper_resistance = atts.value(QStringLiteral("upper_resistance")).toInt();
             }
@@ -374,6 +447,9 @@ QList<trainrow> trainprogram::loadXML(const QString &filename) {
             if (atts.hasAttribute(QStringLiteral("power"))) {
                 row.power = atts.value(QStringLiteral("power")).toInt();
             }
+            if (atts.hasAttribute(QStringLiteral("power_end"))) {
+                row.power_end = atts.value(QStringLiteral("power_end")).toInt();
+            }
             if (atts.hasAttribute(QStringLiteral("maxspeed"))) {
                 row.maxSpeed = atts.value(QStringLiteral("maxspeed")).toInt();
             }
@@ -398,7 +474,9 @@ QTime trainprogram::totalElapsedTime() { return QTime(0, 0, ticks); }
 trainrow trainprogram::currentRow() {
     if (started && !rows.isEmpty()) {
 
-        return rows.at(currentStep);
+        trainrow row = rows.at(currentStep);
+        row.power = rowPower(currentStep);
+        return row;
     }
     return trainrow();
 }
@@ -419,52 +497,29 @@ double trainprogram::currentTargetMets() {
 
 QTime trainprogram::currentRowElapsedTime() {
 
-    uint32_t calculatedLine;
-    uint32_t calculatedElapsedTime = 0;
-
-    if (rows.length() == 0)
+    int32_t calculatedLine = rowAt(ticks);
+    if (calculatedLine >= rows.length())
         return QTime(0, 0, 0);
 
-    for (calculatedLine = 0; calculatedLine < static_cast<uint32_t>(rows.length()); calculatedLine++) {
-
-        uint32_t currentLine = calculateTimeForRow(calculatedLine);
-        calculatedElapsedTime += currentLine;
-
-        if (calculatedElapsedTime > static_cast<uint32_t>(ticks)) {
-            return QTime(0, 0, ticks - (calculatedElapsedTime - currentLine));
-        }
-    }
-    return QTime(0, 0, 0);
+    uint32_t rowStart = calculatedLine ? rowsEnd.at(calculatedLine - 1) : 0;
+    return QTime(0, 0, ticks - rowStart);
 }
 
 QTime trainprogram::currentRowRemainingTime() {
-    uint32_t calculatedLine;
-    uint32_t calculatedElapsedTime = 0;
 
-    if (rows.length() == 0)
+    int32_t calculatedLine = rowAt(ticks);
+    if (calculatedLine >= rows.length())
         return QTime(0, 0, 0);
 
-    for (calculatedLine = 0; calculatedLine < static_cast<uint32_t>(rows.length()); calculatedLine++) {
-
-        uint32_t currentLine = calculateTimeForRow(calculatedLine);
-        calculatedElapsedTime += currentLine;
-
-        if (calculatedElapsedTime > static_cast<uint32_t>(ticks)) {
-            int seconds = calculatedElapsedTime - ticks;
-            int hours = seconds / 3600;
-            return QTime(hours, (seconds / 60) - (hours * 60), seconds % 60);
-        }
-    }
-    return QTime(0, 0, 0);
+    int seconds = rowsEnd.at(calculatedLine) - ticks;
+    int hours = seconds / 3600;
+    return QTime(hours, (seconds / 60) - (hours * 60), seconds % 60);
 }
 
 QTime trainprogram::duration() {
 
-    QTime total(0, 0, 0, 0);
-    for (const trainrow &row : qAsConst(rows)) {
-        total = total.addSecs((row.duration.hour() * 3600) + (row.duration.minute() * 60) + row.duration.second());
-    }
-    return total;
+    const QVector<uint32_t> &t = timeline();
+    return QTime(0, 0, 0, 0).addSecs(t.isEmpty() ? 0 : t.last());
 }
 
 double trainprogram::totalDistance() {
@@ -5,6 +5,7 @@
 #include <QObject>
 #include <QTime>
 #include <QTimer>
+#include <QVector>
 
 class trainrow {
   public:
@@ -26,9 +27,11 @@ class trainrow {
     int8_t zoneHR = -1;
     int8_t maxSpeed = -1;
     int32_t power = -1;
+    int32_t power_end = -1; // power ramps linearly from power to power_end during the row
     int32_t mets = -1;
     double latitude = NAN;
     double longitude = NAN;
+    double distance = -1; // km, a route made of rows with a distance is followed by the odometer
 };
 
 class trainprogram : public QObject {
@@ -52,8 +55,10 @@ class trainprogram : public QObject {
     void decreaseElapsedTime(uint32_t i);
     int32_t offsetElapsedTime() { return offset; }
 
+    // call invalidate() after changing rows: their timeline is cached
     QList<trainrow> rows;
     QList<trainrow> loadedRows; // rows as loaded
+    void invalidate() { timelineValid = false; }
     bool enabled = true;
 
     void restart();
@@ -78,12 +83,24 @@ class trainprogram : public QObject {
 
   private:
     uint32_t calculateTimeForRow(int32_t row);
+    const QVector<uint32_t> &timeline();
+    int32_t rowAt(int32_t elapsed);
+    int32_t rowPower(int32_t row);
+    double routeDistance();
+    int32_t rowAtDistance(double distance);
+    QGeoCoordinate routePosition(int32_t row, double distance);
     bluetooth *bluetoothManager;
     bool started = false;
     int32_t ticks = 0;
     uint16_t currentStep = 0;
     int32_t offset = 0;
     QTimer timer;
+    // end of each row in seconds from the start of the program, compiled again after invalidate()
+    QVector<uint32_t> rowsEnd;
+    bool timelineValid = false;
+    // end of each row in km from the start of the route, when all the rows have a distance
+    QVector<double> rowsDistanceEnd;
+    double startOdometer = 0;
 };
 
 #endif // TRAINPROGRAM_H
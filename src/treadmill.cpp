@@ -1,6 +1,6 @@
 
 #include "treadmill.h"
-#include <QSettings>
+#include "settingssnapshot.h"
 
 treadmill::treadmill() {}
 
@@ -25,17 +25,13 @@ void treadmill::update_metrics(bool watt_calc, const double watts) {
 
     QDateTime current = QDateTime::currentDateTime();
     double deltaTime = (((double)_lastTimeUpdate.msecsTo(current)) / ((double)1000.0));
-    QSettings settings;
-    bool power_as_treadmill = settings.value(QStringLiteral("power_sensor_as_treadmill"), false).toBool();
+    const auto settings = settingssnapshot::current();
 
-    if (settings.value(QStringLiteral("power_sensor_name"), QStringLiteral("Disabled"))
-                .toString()
-                .startsWith(QStringLiteral("Disabled")) == false &&
-        !power_as_treadmill)
+    if (!settings->power_sensor_disabled && !settings->power_sensor_as_treadmill)
         watt_calc = false;
 
     if (!_firstUpdate && !paused) {
-        if (currentSpeed().value() > 0.0 || settings.value(QStringLiteral("continuous_moving"), true).toBool()) {
+        if (currentSpeed().value() > 0.0 || settings->continuous_moving) {
             elapsed += deltaTime;
         }
         if (currentSpeed().value() > 0.0) {
@@ -46,7 +42,7 @@ void treadmill::update_metrics(bool watt_calc, const double watts) {
             }
             m_jouls += (m_watt.value() * deltaTime);
             WeightLoss = metric::calculateWeightLoss(KCal.value());
-            WattKg = m_watt.value() / settings.value(QStringLiteral("weight"), 75.0).toFloat();
+            WattKg = m_watt.value() / settings->weight;
         } else if (m_watt.value() > 0) {
             m_watt = 0;
             WattKg = 0;
@@ -61,6 +57,9 @@ void treadmill::update_metrics(bool watt_calc, const double watts) {
 
     _lastTimeUpdate = current;
     _firstUpdate = false;
+
+    publishSnapshot();
+    emit metricsUpdated();
 }
 
 uint16_t treadmill::watts(double weight) {
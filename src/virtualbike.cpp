@@ -1,5 +1,8 @@
 #include "virtualbike.h"
 #include "ftmsbike.h"
+#include "ftmscodec.h"
+#include "settingssnapshot.h"
+#include "workerthread.h"
 
 #include <QDataStream>
 #include <QMetaEnum>
@@ -9,6 +12,18 @@
 
 using namespace std::chrono_literals;
 
+virtualbike *virtualbike::create(bluetoothdevice *t, bool noWriteResistance, bool noHeartService,
+                                 uint8_t bikeResistanceOffset, double bikeResistanceGain) {
+    if (!settingssnapshot::current()->virtual_device_thread) {
+        return new virtualbike(t, noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+    }
+    // ftmsCharacteristicChanged is queued to the bike
+    qRegisterMetaType<QLowEnergyCharacteristic>();
+    return workerthread::get(QStringLiteral("virtualdevices"))->create<virtualbike>([=]() {
+        return new virtualbike(t, noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+    });
+}
+
 virtualbike::virtualbike(bluetoothdevice *t, bool noWriteResistance, bool noHeartService, uint8_t bikeResistanceOffset,
                          double bikeResistanceGain) {
     Bike = t;
@@ -359,6 +374,11 @@ virtualbike::virtualbike(bluetoothdevice *t, bool noWriteResistance, bool noHear
         //! [Start Advertising]
         leController = QLowEnergyController::createPeripheral();
         Q_ASSERT(leController);
+        // connected() is called from the thread of the device, the controller lives in this one
+        QObject::connect(leController, &QLowEnergyController::stateChanged, this,
+                         [this](QLowEnergyController::ControllerState state) {
+                             m_connected = state == QLowEnergyController::ConnectedState;
+                         });
 
         if (service_changed)
             serviceChanged = leController->addService(serviceDataChanged);
@@ -418,8 +438,8 @@ virtualbike::virtualbike(bluetoothdevice *t, bool noWriteResistance, bool noHear
     }
 
     //! [Provide Heartbeat]
-    QObject::connect(&bikeTimer, &QTimer::timeout, this, &virtualbike::bikeProvider);
-    bikeTimer.start(1s);
+    notifier = new virtualnotifier(Bike, this);
+    QObject::connect(notifier, &virtualnotifier::notify, this, &virtualbike::bikeProvider);
     //! [Provide Heartbeat]
     QObject::connect(leController, &QLowEnergyController::disconnected, this, &virtualbike::reconnect);
     QObject::connect(
@@ -430,11 +450,10 @@ virtualbike::virtualbike(bluetoothdevice *t, bool noWriteResistance, bool noHear
 
 void virtualbike::slopeChanged(int16_t iresistance) {
 
-    QSettings settings;
-    bool force_resistance = settings.value(QStringLiteral("virtualbike_forceresistance"), true).toBool();
-    bool erg_mode = settings.value(QStringLiteral("zwift_erg"), false).toBool();
-    bool zwift_negative_inclination_x2 =
-        settings.value(QStringLiteral("zwift_negative_inclination_x2"), false).toBool();
+    const auto settings = settingssnapshot::current();
+    bool force_resistance = settings->virtualbike_forceresistance;
+    bool erg_mode = settings->zwift_erg;
+    bool zwift_negative_inclination_x2 = settings->zwift_negative_inclination_x2;
 
     qDebug() << QStringLiteral("new requested resistance zwift erg grade ") + QString::number(iresistance) +
                     QStringLiteral(" enabled ") + force_resistance;
@@ -449,20 +468,28 @@ void virtualbike::slopeChanged(int16_t iresistance) {
 
     if (force_resistance && !erg_mode) {
         // same on the training program
-        Bike->changeResistance((int8_t)(round(resistance * bikeResistanceGain)) + bikeResistanceOffset +
-                               1); // resistance start from 1
+        changeResistance((int8_t)(round(resistance * bikeResistanceGain)) + bikeResistanceOffset +
+                         1); // resistance start from 1
     }
 }
 
-void virtualbike::powerChanged(uint16_t power) { Bike->changePower(power); }
+void virtualbike::powerChanged(uint16_t power) {
+    bluetoothdevice *b = Bike;
+    QMetaObject::invokeMethod(Bike, [b, power]() { b->changePower(power); });
+}
+
+void virtualbike::changeResistance(int8_t resistance) {
+    bluetoothdevice *b = Bike;
+    QMetaObject::invokeMethod(Bike, [b, resistance]() { b->changeResistance(resistance); });
+}
 
 void virtualbike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     QByteArray reply;
-    QSettings settings;
-    bool force_resistance = settings.value(QStringLiteral("virtualbike_forceresistance"), true).toBool();
-    bool erg_mode = settings.value(QStringLiteral("zwift_erg"), false).toBool();
-    bool echelon = settings.value(QStringLiteral("virtual_device_echelon"), false).toBool();
-    bool ifit = settings.value(QStringLiteral("virtual_device_ifit"), false).toBool();
+    const auto settings = settingssnapshot::current();
+    bool force_resistance = settings->virtualbike_forceresistance;
+    bool erg_mode = settings->zwift_erg;
+    bool echelon = settings->virtual_device_echelon;
+    bool ifit = settings->virtual_device_ifit;
     //    double erg_filter_upper =
     //        settings.value(QStringLiteral("zwift_erg_filter"), 0.0).toDouble(); //
     //        NOTE:clang-analyzer-deadcode.DeadStores
@@ -486,7 +513,7 @@ void virtualbike::characteristicChanged(const QLowEnergyCharacteristic &characte
             uint8_t uresistance = newValue.at(1);
             uresistance = uresistance / 10;
             if (force_resistance && !erg_mode) {
-                Bike->changeResistance(uresistance);
+                changeResistance(uresistance);
             }
             qDebug() << QStringLiteral("new requested resistance ") + QString::number(uresistance) +
                             QStringLiteral(" enabled ") + force_resistance;
@@ -634,10 +661,11 @@ void virtualbike::characteristicChanged(const QLowEnergyCharacteristic &characte
             reply3 = QByteArray::fromHex("01120000000114000000021400f5061400000067");
             reply4 = QByteArray::fromHex("ff0fd702002c013300b4000000000000a1000067");
 
-            reply2[11] = Bike->currentResistance().value();
-            reply2[12] = ((uint16_t)Bike->wattsMetric().value()) & 0xFF;
-            reply2[13] = (((uint16_t)Bike->wattsMetric().value()) >> 8) & 0xFF;
-            reply2[18] = Bike->currentCadence().value();
+            const devicesnapshot values = Bike->snapshot();
+            reply2[11] = values.resistance;
+            reply2[12] = ((uint16_t)values.watt) & 0xFF;
+            reply2[13] = (((uint16_t)values.watt) >> 8) & 0xFF;
+            reply2[18] = values.cadence;
 
             writeCharacteristic(service, characteristic, reply1);
             writeCharacteristic(service, characteristic, reply2);
@@ -650,10 +678,11 @@ void virtualbike::characteristicChanged(const QLowEnergyCharacteristic &characte
             reply3 = QByteArray::fromHex("01120000ffffffffffffffff00000000020d000d");
             reply4 = QByteArray::fromHex("ff0f000000bac00100000000002e0000aa0d000d");
 
-            reply2[11] = Bike->currentResistance().value();
-            reply2[12] = ((uint16_t)Bike->wattsMetric().value()) & 0xFF;
-            reply2[13] = (((uint16_t)Bike->wattsMetric().value()) >> 8) & 0xFF;
-            reply2[18] = Bike->currentCadence().value();
+            const devicesnapshot values = Bike->snapshot();
+            reply2[11] = values.resistance;
+            reply2[12] = ((uint16_t)values.watt) & 0xFF;
+            reply2[13] = (((uint16_t)values.watt) >> 8) & 0xFF;
+            reply2[18] = values.cadence;
 
             writeCharacteristic(service, characteristic, reply1);
             writeCharacteristic(service, characteristic, reply2);
@@ -800,26 +829,28 @@ void virtualbike::reconnect() {
 
 void virtualbike::bikeProvider() {
 
-    QSettings settings;
-    bool cadence = settings.value(QStringLiteral("bike_cadence_sensor"), false).toBool();
-    bool battery = settings.value(QStringLiteral("battery_service"), false).toBool();
-    bool power = settings.value(QStringLiteral("bike_power_sensor"), false).toBool();
-    bool bike_wheel_revs = settings.value(QStringLiteral("bike_wheel_revs"), false).toBool();
-    bool heart_only = settings.value(QStringLiteral("virtual_device_onlyheart"), false).toBool();
-    bool echelon = settings.value(QStringLiteral("virtual_device_echelon"), false).toBool();
-    bool ifit = settings.value(QStringLiteral("virtual_device_ifit"), false).toBool();
-    bool erg_mode = settings.value(QStringLiteral("zwift_erg"), false).toBool();
+    const auto settings = settingssnapshot::current();
+    bool cadence = settings->bike_cadence_sensor;
+    bool battery = settings->battery_service;
+    bool power = settings->bike_power_sensor;
+    bool bike_wheel_revs = settings->bike_wheel_revs;
+    bool heart_only = settings->virtual_device_onlyheart;
+    bool echelon = settings->virtual_device_echelon;
+    bool ifit = settings->virtual_device_ifit;
+    bool erg_mode = settings->zwift_erg;
 
-    uint16_t normalizeSpeed = (uint16_t)qRound(Bike->currentSpeed().value() * 100);
+    // one consistent copy of the bike values for the whole frame
+    const devicesnapshot values = Bike->snapshot();
+    uint16_t normalizeSpeed = (uint16_t)qRound(values.speed * 100);
 
 #ifdef Q_OS_IOS
 #ifndef IO_UNDER_QT
     if (h) {
         // really connected to a device
-        if (h->virtualbike_updateFTMS(normalizeSpeed, (char)Bike->currentResistance().value(),
-                                      (uint16_t)Bike->currentCadence().value() * 2,
-                                      (uint16_t)Bike->wattsMetric().value())) {
-            h->virtualbike_setHeartRate(Bike->currentHeart().value());
+        if (h->virtualbike_updateFTMS(normalizeSpeed, (char)values.resistance,
+                                      (uint16_t)values.cadence * 2,
+                                      (uint16_t)values.watt)) {
+            h->virtualbike_setHeartRate(values.heart);
             if (!erg_mode)
                 slopeChanged(h->virtualbike_getCurrentSlope());
             else
@@ -837,8 +868,8 @@ void virtualbike::bikeProvider() {
 
         return;
     } else {
-        bool bluetooth_relaxed = settings.value(QStringLiteral("bluetooth_relaxed"), false).toBool();
-        bool bluetooth_30m_hangs = settings.value(QStringLiteral("bluetooth_30m_hangs"), false).toBool();
+        bool bluetooth_relaxed = settings->bluetooth_relaxed;
+        bool bluetooth_30m_hangs = settings->bluetooth_30m_hangs;
         if (bluetooth_relaxed) {
 
             leController->stopAdvertising();
@@ -862,23 +893,14 @@ void virtualbike::bikeProvider() {
         if (!heart_only) {
             if (!cadence && !power) {
 
-                value.append((char)0x64); // speed, inst. cadence, resistance lvl, instant power
-                value.append((char)0x02); // heart rate
-
-                value.append((char)(normalizeSpeed & 0xFF));      // speed
-                value.append((char)(normalizeSpeed >> 8) & 0xFF); // speed
-
-                value.append((char)((uint16_t)(Bike->currentCadence().value() * 2) & 0xFF));        // cadence
-                value.append((char)(((uint16_t)(Bike->currentCadence().value() * 2) >> 8) & 0xFF)); // cadence
-
-                value.append((char)Bike->currentResistance().value()); // resistance
-                value.append((char)(0));                               // resistance
-
-                value.append((char)(((uint16_t)Bike->wattsMetric().value()) & 0xFF));      // watts
-                value.append((char)(((uint16_t)Bike->wattsMetric().value()) >> 8) & 0xFF); // watts
-
-                value.append(char(Bike->currentHeart().value())); // Actual value.
-                value.append((char)0);                            // Bkool FTMS protocol HRM offset 1280 fix
+                ftms::frame<ftms::indoorbike> frame;
+                frame.set(ftms::indoorbike::instantSpeed, normalizeSpeed);
+                frame.set(ftms::indoorbike::instantCadence, (uint16_t)(values.cadence * 2));
+                frame.set(ftms::indoorbike::resistanceLevel, (int16_t)values.resistance);
+                frame.set(ftms::indoorbike::instantPower, (uint16_t)values.watt);
+                frame.set(ftms::indoorbike::heartRate, (uint8_t)values.heart);
+                value = frame.encode();
+                value.append((char)0); // Bkool FTMS protocol HRM offset 1280 fix
 
                 if (!serviceFIT) {
                     qDebug() << QStringLiteral("serviceFIT not available");
@@ -887,7 +909,7 @@ void virtualbike::bikeProvider() {
                 }
 
                 QLowEnergyCharacteristic characteristic =
-                    serviceFIT->characteristic((QBluetoothUuid::CharacteristicType)0x2AD2);
+                    serviceFIT->characteristic(QBluetoothUuid(ftms::indoorbike::uuid));
                 Q_ASSERT(characteristic.isValid());
                 if (leController->state() != QLowEnergyController::ConnectedState) {
                     qDebug() << QStringLiteral("virtual bike not connected");
@@ -899,12 +921,12 @@ void virtualbike::bikeProvider() {
 
                 value.append((char)0x20); // crank data present
                 value.append((char)0x00);
-                value.append((char)(((uint16_t)Bike->wattsMetric().value()) & 0xFF));          // watt
-                value.append((char)(((uint16_t)Bike->wattsMetric().value()) >> 8) & 0xFF);     // watt
-                value.append((char)(((uint16_t)Bike->currentCrankRevolutions()) & 0xFF));      // revs count
-                value.append((char)(((uint16_t)Bike->currentCrankRevolutions()) >> 8) & 0xFF); // revs count
-                value.append((char)(Bike->lastCrankEventTime() & 0xff));                       // eventtime
-                value.append((char)(Bike->lastCrankEventTime() >> 8) & 0xFF);                  // eventtime
+                value.append((char)(((uint16_t)values.watt) & 0xFF));                  // watt
+                value.append((char)(((uint16_t)values.watt) >> 8) & 0xFF);             // watt
+                value.append((char)(((uint16_t)values.crankRevolutions) & 0xFF));      // revs count
+                value.append((char)(((uint16_t)values.crankRevolutions) >> 8) & 0xFF); // revs count
+                value.append((char)(values.lastCrankEventTime & 0xff));                // eventtime
+                value.append((char)(values.lastCrankEventTime >> 8) & 0xFF);           // eventtime
 
                 if (!service) {
                     qDebug() << QStringLiteral("service not available");
@@ -929,12 +951,12 @@ void virtualbike::bikeProvider() {
 
                     value.append((char)0x03); // crank and wheel data present
 
-                    if (Bike->currentSpeed().value()) {
+                    if (values.speed) {
 
                         const double wheelCircumference = 2000.0; // millimeters
                         wheelRevs++;
                         lastWheelTime +=
-                            (uint16_t)(1024.0 / ((Bike->currentSpeed().value() / 3.6) / (wheelCircumference / 1000.0)));
+                            (uint16_t)(1024.0 / ((values.speed / 3.6) / (wheelCircumference / 1000.0)));
                     }
                     value.append((char)((wheelRevs & 0xFF)));        // wheel count
                     value.append((char)((wheelRevs >> 8) & 0xFF));   // wheel count
@@ -943,10 +965,10 @@ void virtualbike::bikeProvider() {
                     value.append((char)(lastWheelTime & 0xff));      // eventtime
                     value.append((char)(lastWheelTime >> 8) & 0xFF); // eventtime
                 }
-                value.append((char)(((uint16_t)Bike->currentCrankRevolutions()) & 0xFF));      // revs count
-                value.append((char)(((uint16_t)Bike->currentCrankRevolutions()) >> 8) & 0xFF); // revs count
-                value.append((char)(Bike->lastCrankEventTime() & 0xff));                       // eventtime
-                value.append((char)(Bike->lastCrankEventTime() >> 8) & 0xFF);                  // eventtime
+                value.append((char)(((uint16_t)values.crankRevolutions) & 0xFF));      // revs count
+                value.append((char)(((uint16_t)values.crankRevolutions) >> 8) & 0xFF); // revs count
+                value.append((char)(values.lastCrankEventTime & 0xff));                // eventtime
+                value.append((char)(values.lastCrankEventTime >> 8) & 0xFF);           // eventtime
 
                 if (!service) {
                     qDebug() << QStringLiteral("service not available");
@@ -975,15 +997,15 @@ void virtualbike::bikeProvider() {
             value.append(0xf0);
             value.append(0xd1);
             value.append(0x09);
-            value.append((char)0x00);                                            // elapsed
-            value.append((char)0x00);                                            // elapsed
-            value.append((uint8_t)(((uint32_t)(Bike->odometer() * 100)) >> 24)); // distance
-            value.append((uint8_t)(((uint32_t)(Bike->odometer() * 100)) >> 16)); // distance
-            value.append((uint8_t)(((uint32_t)(Bike->odometer() * 100)) >> 8));  // distance
-            value.append((uint8_t)(Bike->odometer() * 100));                     // distance
+            value.append((char)0x00);                                           // elapsed
+            value.append((char)0x00);                                           // elapsed
+            value.append((uint8_t)(((uint32_t)(values.odometer * 100)) >> 24)); // distance
+            value.append((uint8_t)(((uint32_t)(values.odometer * 100)) >> 16)); // distance
+            value.append((uint8_t)(((uint32_t)(values.odometer * 100)) >> 8));  // distance
+            value.append((uint8_t)(values.odometer * 100));                     // distance
             value.append((char)0x00);
-            value.append(Bike->currentCadence().value());
-            value.append((uint8_t)Bike->currentHeart().value());
+            value.append(values.cadence);
+            value.append((uint8_t)values.heart);
 
             uint8_t sum = 0;
             for (uint8_t i = 0; i < value.length(); i++) {
@@ -1044,8 +1066,8 @@ void virtualbike::bikeProvider() {
         }
 
         QByteArray valueHR;
-        valueHR.append(char(0));                                  // Flags that specify the format of the value.
-        valueHR.append(char(Bike->metrics_override_heartrate())); // Actual value.
+        valueHR.append(char(0));                    // Flags that specify the format of the value.
+        valueHR.append(char(values.heartOverride)); // Actual value.
         QLowEnergyCharacteristic characteristicHR = serviceHR->characteristic(QBluetoothUuid::HeartRateMeasurement);
 
         Q_ASSERT(characteristicHR.isValid());
@@ -1067,7 +1089,8 @@ void virtualbike::echelonWriteResistance() {
     resistance.append(0xf0);
     resistance.append(0xd2);
     resistance.append(0x01);
-    resistance.append(Bike->currentResistance().value());
+    const uint8_t currentResistance = Bike->snapshot().resistance;
+    resistance.append(currentResistance);
 
     uint8_t sum = 0;
     for (uint8_t i = 0; i < resistance.length(); i++) {
@@ -1075,7 +1098,7 @@ void virtualbike::echelonWriteResistance() {
         sum += resistance[i]; // the last byte is a sort of a checksum
     }
     resistance.append(sum);
-    if (oldresistance != ((uint8_t)Bike->currentResistance().value())) {
+    if (oldresistance != currentResistance) {
         QLowEnergyCharacteristic characteristic =
             service->characteristic(QBluetoothUuid(QStringLiteral("0bf669f4-45f2-11e7-9598-0800200c9a66")));
         Q_ASSERT(characteristic.isValid());
@@ -1087,15 +1110,7 @@ void virtualbike::echelonWriteResistance() {
 
         writeCharacteristic(service, characteristic, resistance);
     }
-    oldresistance = ((uint8_t)Bike->currentResistance().value());
-}
-
-bool virtualbike::connected() {
-    if (!leController) {
-
-        return false;
-    }
-    return leController->state() == QLowEnergyController::ConnectedState;
+    oldresistance = currentResistance;
 }
 
 void virtualbike::error(QLowEnergyController::Error newError) {
@@ -26,17 +26,27 @@
 #include "ios/lockscreen.h"
 #endif
 #include "bike.h"
+#include "virtualnotifier.h"
+#include <atomic>
 
 class virtualbike : public QObject {
 
     Q_OBJECT
   public:
+    // with virtual_device_thread enabled the virtual bike is built and runs in the "virtualdevices" worker thread:
+    // it reads the bike through its snapshot and the commands are queued to the thread of the bike.
+    // Delete it with workerthread::destroy().
+    static virtualbike *create(bluetoothdevice *t, bool noWriteResistance = false, bool noHeartService = false,
+                               uint8_t bikeResistanceOffset = 4, double bikeResistanceGain = 1.0);
+    // safe from any thread
+    bool connected() { return m_connected; }
+
+  private:
     virtualbike(bluetoothdevice *t, bool noWriteResistance = false, bool noHeartService = false,
                 uint8_t bikeResistanceOffset = 4, double bikeResistanceGain = 1.0);
-    bool connected();
 
-  private:
     QLowEnergyController *leController = nullptr;
+    std::atomic<bool> m_connected{false}; // follows the state of leController
     QLowEnergyService *serviceHR = nullptr;
     QLowEnergyService *serviceBattery = nullptr;
     QLowEnergyService *serviceFIT = nullptr;
@@ -49,7 +59,7 @@ class virtualbike : public QObject {
     QLowEnergyServiceData serviceData;
     QLowEnergyServiceData serviceDataChanged;
     QLowEnergyServiceData serviceEchelon;
-    QTimer bikeTimer;
+    virtualnotifier *notifier = nullptr;
     bluetoothdevice *Bike;
 
     uint16_t lastWheelTime = 0;
@@ -68,6 +78,7 @@ class virtualbike : public QObject {
 
     void slopeChanged(int16_t slope);
     void powerChanged(uint16_t power);
+    void changeResistance(int8_t resistance);
 
 #ifdef Q_OS_IOS
     lockscreen *h = 0;
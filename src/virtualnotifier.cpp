@@ -0,0 +1,63 @@
+#include "virtualnotifier.h"
+
+#include <QDateTime>
+#include <QSettings>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+virtualnotifier::virtualnotifier(bluetoothdevice *device, QObject *parent) : QObject(parent) {
+    this->device = device;
+
+    QSettings settings;
+    bool notify_on_change = settings.value(QStringLiteral("virtual_device_notify_on_change"), false).toBool();
+    double max_rate = settings.value(QStringLiteral("virtual_device_notify_max_rate"), 4.0).toDouble();
+    if (max_rate > 0) {
+        minInterval = (int)(1000.0 / max_rate);
+    }
+
+    connect(&keepAliveTimer, &QTimer::timeout, this, &virtualnotifier::fire);
+    keepAliveTimer.start(1s);
+
+    rateTimer.setSingleShot(true);
+    connect(&rateTimer, &QTimer::timeout, this, &virtualnotifier::fire);
+
+    if (notify_on_change && device) {
+        qDebug() << QStringLiteral("virtual device notifications on change, max every") << minInterval
+                 << QStringLiteral("ms");
+        connect(device, &bluetoothdevice::metricsUpdated, this, &virtualnotifier::metricsUpdated);
+    }
+}
+
+void virtualnotifier::metricsUpdated() {
+    const devicesnapshot values = device->snapshot();
+    if (values.speed == lastSpeed && values.cadence == lastCadence && values.watt == lastWatt) {
+        return;
+    }
+
+    if (rateTimer.isActive()) {
+        // a notification is already scheduled and it will carry the new values
+        return;
+    }
+
+    qint64 elapsed = QDateTime::currentMSecsSinceEpoch() - lastNotification;
+    if (elapsed >= minInterval) {
+        fire();
+    } else {
+        rateTimer.start(minInterval - (int)elapsed);
+    }
+}
+
+void virtualnotifier::fire() {
+    rateTimer.stop();
+    // the keep-alive restarts from the last notification sent
+    keepAliveTimer.start();
+    lastNotification = QDateTime::currentMSecsSinceEpoch();
+    if (device) {
+        const devicesnapshot values = device->snapshot();
+        lastSpeed = values.speed;
+        lastCadence = values.cadence;
+        lastWatt = values.watt;
+    }
+    emit notify();
+}
@@ -0,0 +1,39 @@
+#ifndef VIRTUALNOTIFIER_H
+#define VIRTUALNOTIFIER_H
+
+#include "bluetoothdevice.h"
+#include <QObject>
+#include <QTimer>
+
+// Schedules the notifications of a virtual device (virtualbike, virtualtreadmill, virtualrower).
+// notify() is emitted every second as a keep-alive and, when virtual_device_notify_on_change is enabled, as
+// soon as the source device has new speed, cadence or power values, no more often than
+// virtual_device_notify_max_rate times per second. This way the apps connected to the virtual device see the
+// new values when they are parsed instead of up to a second later.
+// The values are read from the device snapshot, so the notifier can live in another thread than the device.
+class virtualnotifier : public QObject {
+
+    Q_OBJECT
+  public:
+    virtualnotifier(bluetoothdevice *device, QObject *parent = nullptr);
+
+  signals:
+    void notify();
+
+  private slots:
+    void metricsUpdated();
+    void fire();
+
+  private:
+    bluetoothdevice *device;
+    QTimer keepAliveTimer;
+    QTimer rateTimer;
+    int minInterval = 250;
+    qint64 lastNotification = 0;
+
+    double lastSpeed = -1;
+    double lastCadence = -1;
+    double lastWatt = -1;
+};
+
+#endif // VIRTUALNOTIFIER_H
@@ -1,4 +1,5 @@
 #include "virtualrower.h"
+#include "ftmscodec.h"
 #include "ftmsrower.h"
 
 #include <QDataStream>
@@ -158,8 +159,8 @@ virtualrower::virtualrower(bluetoothdevice *t, bool noWriteResistance, bool noHe
     }
 
     //! [Provide Heartbeat]
-    QObject::connect(&rowerTimer, &QTimer::timeout, this, &virtualrower::rowerProvider);
-    rowerTimer.start(1s);
+    notifier = new virtualnotifier(Rower, this);
+    QObject::connect(notifier, &virtualnotifier::notify, this, &virtualrower::rowerProvider);
     //! [Provide Heartbeat]
     QObject::connect(leController, &QLowEnergyController::disconnected, this, &virtualrower::reconnect);
     QObject::connect(
@@ -325,22 +326,14 @@ void virtualrower::rowerProvider() {
 
     if (!heart_only) {
 
-        value.append((char)0xA0); // resistance level, power and speed
-        value.append((char)0x02); // heart rate
-
-        value.append((char)((uint8_t)Rower->currentCadence().value() & 0xFF)); // Stroke Rate
-
-        value.append((char)((uint16_t)(((rower *)Rower)->currentStrokesCount().value()) & 0xFF));        // Stroke Count
-        value.append((char)(((uint16_t)(((rower *)Rower)->currentStrokesCount().value()) >> 8) & 0xFF)); // Stroke Count
-
-        value.append((char)(((uint16_t)Rower->wattsMetric().value()) & 0xFF));      // watts
-        value.append((char)(((uint16_t)Rower->wattsMetric().value()) >> 8) & 0xFF); // watts
-
-        value.append((char)((uint16_t)(Rower->currentResistance().value()) & 0xFF));        // resistance
-        value.append((char)(((uint16_t)(Rower->currentResistance().value()) >> 8) & 0xFF)); // resistance
-
-        value.append(char(Rower->currentHeart().value())); // Actual value.
-        value.append((char)0);                             // Bkool FTMS protocol HRM offset 1280 fix
+        ftms::frame<ftms::rower> frame;
+        frame.set(ftms::rower::strokeRate, qMin(255, (int)(Rower->currentCadence().value() * 2)));
+        frame.set(ftms::rower::strokeCount, (uint16_t)(((rower *)Rower)->currentStrokesCount().value()));
+        frame.set(ftms::rower::instantPower, (uint16_t)Rower->wattsMetric().value());
+        frame.set(ftms::rower::resistanceLevel, (int16_t)Rower->currentResistance().value());
+        frame.set(ftms::rower::heartRate, (uint8_t)Rower->currentHeart().value());
+        value = frame.encode();
+        value.append((char)0); // Bkool FTMS protocol HRM offset 1280 fix
 
         if (!serviceFIT) {
             qDebug() << QStringLiteral("serviceFIT not available");
@@ -349,7 +342,7 @@ void virtualrower::rowerProvider() {
         }
 
         QLowEnergyCharacteristic characteristic =
-            serviceFIT->characteristic((QBluetoothUuid::CharacteristicType)0x2AD2);
+            serviceFIT->characteristic(QBluetoothUuid(ftms::rower::uuid));
         Q_ASSERT(characteristic.isValid());
         if (leController->state() != QLowEnergyController::ConnectedState) {
             qDebug() << QStringLiteral("virtual rower not connected");
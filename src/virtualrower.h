@@ -26,6 +26,7 @@
 #include "ios/lockscreen.h"
 #endif
 #include "bike.h"
+#include "virtualnotifier.h"
 
 class virtualrower : public QObject {
 
@@ -42,7 +43,7 @@ class virtualrower : public QObject {
     QLowEnergyAdvertisingData advertisingData;
     QLowEnergyServiceData serviceDataHR;
     QLowEnergyServiceData serviceDataFIT;
-    QTimer rowerTimer;
+    virtualnotifier *notifier = nullptr;
     bluetoothdevice *Rower;
 
     uint16_t lastWheelTime = 0;
@@ -1,12 +1,24 @@
 #include "virtualtreadmill.h"
 #include "elliptical.h"
 #include "ftmsbike.h"
+#include "ftmscodec.h"
+#include "settingssnapshot.h"
+#include "workerthread.h"
 #include <QSettings>
 #include <QtMath>
 #include <chrono>
 
 using namespace std::chrono_literals;
 
+virtualtreadmill *virtualtreadmill::create(bluetoothdevice *t, bool noHeartService) {
+    if (!settingssnapshot::current()->virtual_device_thread) {
+        return new virtualtreadmill(t, noHeartService);
+    }
+    return workerthread::get(QStringLiteral("virtualdevices"))->create<virtualtreadmill>([=]() {
+        return new virtualtreadmill(t, noHeartService);
+    });
+}
+
 virtualtreadmill::virtualtreadmill(bluetoothdevice *t, bool noHeartService) {
     QSettings settings;
     treadMill = t;
@@ -204,6 +216,11 @@ virtualtreadmill::virtualtreadmill(bluetoothdevice *t, bool noHeartService) {
         //! [Start Advertising]
         leController = QLowEnergyController::createPeripheral();
         Q_ASSERT(leController);
+        // connected() is called from the thread of the device, the controller lives in this one
+        QObject::connect(leController, &QLowEnergyController::stateChanged, this,
+                         [this](QLowEnergyController::ControllerState state) {
+                             m_connected = state == QLowEnergyController::ConnectedState;
+                         });
         if (ftmsServiceEnable())
             serviceFTMS = leController->addService(serviceDataFTMS);
         if (RSCEnable())
@@ -229,8 +246,8 @@ virtualtreadmill::virtualtreadmill(bluetoothdevice *t, bool noHeartService) {
         QObject::connect(leController, &QLowEnergyController::disconnected, this, &virtualtreadmill::reconnect);
     }
     //! [Provide Heartbeat]
-    QObject::connect(&treadmillTimer, &QTimer::timeout, this, &virtualtreadmill::treadmillProvider);
-    treadmillTimer.start(1s);
+    notifier = new virtualnotifier(treadMill, this);
+    QObject::connect(notifier, &virtualnotifier::notify, this, &virtualtreadmill::treadmillProvider);
 }
 
 void virtualtreadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
@@ -251,9 +268,7 @@ void virtualtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
 
             uint16_t uspeed = a + (((uint16_t)b) << 8);
             double requestSpeed = (double)uspeed / 100.0;
-            if (treadMill->deviceType() == bluetoothdevice::TREADMILL) {
-                ((treadmill *)treadMill)->changeSpeed(requestSpeed);
-            }
+            changeDeviceSpeed(requestSpeed);
             emit debug(QStringLiteral("new requested speed ") + QString::number(requestSpeed));
         } else if ((char)newValue.at(0) == 0x03) // Set Target Inclination
         {
@@ -265,11 +280,7 @@ void virtualtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
             if (requestIncline < 0)
                 requestIncline = 0;
 
-            if (treadMill->deviceType() == bluetoothdevice::TREADMILL)
-                ((treadmill *)treadMill)->changeInclination(requestIncline, requestIncline);
-            // Resistance as incline on Sole E95s Elliptical #419
-            else if (treadMill->deviceType() == bluetoothdevice::ELLIPTICAL)
-                ((elliptical *)treadMill)->changeInclination(requestIncline, requestIncline);
+            changeDeviceInclination(requestIncline);
             emit debug("new requested incline " + QString::number(requestIncline));
         } else if ((char)newValue.at(0) == 0x07) // Start request
         {
@@ -309,6 +320,25 @@ void virtualtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
     }
 }
 
+void virtualtreadmill::changeDeviceSpeed(double speed) {
+    if (treadMill->deviceType() != bluetoothdevice::TREADMILL) {
+        return;
+    }
+    treadmill *t = (treadmill *)treadMill;
+    QMetaObject::invokeMethod(treadMill, [t, speed]() { t->changeSpeed(speed); });
+}
+
+void virtualtreadmill::changeDeviceInclination(double inclination) {
+    if (treadMill->deviceType() == bluetoothdevice::TREADMILL) {
+        treadmill *t = (treadmill *)treadMill;
+        QMetaObject::invokeMethod(treadMill, [t, inclination]() { t->changeInclination(inclination, inclination); });
+    } else if (treadMill->deviceType() == bluetoothdevice::ELLIPTICAL) {
+        // Resistance as incline on Sole E95s Elliptical #419
+        elliptical *e = (elliptical *)treadMill;
+        QMetaObject::invokeMethod(treadMill, [e, inclination]() { e->changeInclination(inclination, inclination); });
+    }
+}
+
 void virtualtreadmill::slopeChanged(int16_t iresistance) {
 
     QSettings settings;
@@ -337,7 +367,8 @@ void virtualtreadmill::reconnect() {
         return;
     }
 
-    qDebug() << QStringLiteral("virtualtreadmill reconnect ") << treadMill->connected();
+    // the treadmill may live in another thread: its controller isn't queried from here
+    qDebug() << QStringLiteral("virtualtreadmill reconnect");
     if (ftmsServiceEnable())
         serviceFTMS = leController->addService(serviceDataFTMS);
     if (RSCEnable())
@@ -358,7 +389,9 @@ void virtualtreadmill::reconnect() {
 void virtualtreadmill::treadmillProvider() {
     const uint64_t slopeTimeoutSecs = 30;
     QSettings settings;
-    uint16_t normalizeSpeed = (uint16_t)qRound(treadMill->currentSpeed().value() * 100);
+    // one consistent copy of the treadmill values for the whole frame
+    const devicesnapshot values = treadMill->snapshot();
+    uint16_t normalizeSpeed = (uint16_t)qRound(values.speed * 100);
     
     if((uint64_t)QDateTime::currentSecsSinceEpoch() > lastSlopeChanged + slopeTimeoutSecs)
         m_autoInclinationEnabled = false;
@@ -368,9 +401,9 @@ void virtualtreadmill::treadmillProvider() {
     if (h) {
         // really connected to a device
         if (h->virtualtreadmill_updateFTMS(normalizeSpeed, 0,
-                                      (uint16_t)((treadmill *)treadMill)->currentCadence().value() * 2,
-                                      (uint16_t)((treadmill *)treadMill)->wattsMetric().value())) {
-            h->virtualtreadmill_setHeartRate(((treadmill *)treadMill)->currentHeart().value());
+                                      (uint16_t)values.cadence * 2,
+                                      (uint16_t)values.watt)) {
+            h->virtualtreadmill_setHeartRate(values.heart);
             lastSlopeChanged = h->virtualtreadmill_lastChangeCurrentSlope();
             if((uint64_t)QDateTime::currentSecsSinceEpoch() < lastSlopeChanged + slopeTimeoutSecs)
                 slopeChanged(h->virtualtreadmill_getCurrentSlope());
@@ -395,47 +428,27 @@ void virtualtreadmill::treadmillProvider() {
 
     if (ftmsServiceEnable()) {
         if (ftmsTreadmillEnable()) {
-            value.append(0x08);       // Inclination avaiable
-            value.append((char)0x01); // heart rate avaiable
-
-            char a = (normalizeSpeed >> 8) & 0XFF;
-            char b = normalizeSpeed & 0XFF;
-            QByteArray speedBytes;
-            speedBytes.append(b);
-            speedBytes.append(a);
-            uint16_t normalizeIncline = 0;
-            if (treadMill->deviceType() == bluetoothdevice::TREADMILL)
-                normalizeIncline = (uint32_t)qRound(((treadmill *)treadMill)->currentInclination().value() * 10);
-            a = (normalizeIncline >> 8) & 0XFF;
-            b = normalizeIncline & 0XFF;
-            QByteArray inclineBytes;
-            inclineBytes.append(b);
-            inclineBytes.append(a);
+            int16_t normalizeIncline = 0;
             double ramp = 0;
-            if (treadMill->deviceType() == bluetoothdevice::TREADMILL)
-                ramp = qRadiansToDegrees(qAtan(((treadmill *)treadMill)->currentInclination().value() / 100));
-            int16_t normalizeRamp = (int32_t)qRound(ramp * 10);
-            a = (normalizeRamp >> 8) & 0XFF;
-            b = normalizeRamp & 0XFF;
-            QByteArray rampBytes;
-            rampBytes.append(b);
-            rampBytes.append(a);
-
-            value.append(speedBytes); // Actual value.
-
-            value.append(inclineBytes); // incline
-
-            value.append(rampBytes); // ramp angle
+            if (treadMill->deviceType() == bluetoothdevice::TREADMILL) {
+                normalizeIncline = (int16_t)qRound(values.inclination * 10);
+                ramp = qRadiansToDegrees(qAtan(values.inclination / 100));
+            }
 
-            value.append(treadMill->currentHeart().value()); // current heart rate
+            ftms::frame<ftms::treadmill> frame;
+            frame.set(ftms::treadmill::instantSpeed, normalizeSpeed);
+            frame.set(ftms::treadmill::inclination, normalizeIncline);
+            frame.set(ftms::treadmill::rampAngle, (int16_t)qRound(ramp * 10));
+            frame.set(ftms::treadmill::heartRate, (uint8_t)values.heart);
+            value = frame.encode();
 
             if (!serviceFTMS) {
                 qDebug() << QStringLiteral("service not available");
                 return;
             }
 
-            QLowEnergyCharacteristic characteristic = serviceFTMS->characteristic(
-                (QBluetoothUuid::CharacteristicType)0x2ACD); // TreadmillDataCharacteristicUuid
+            QLowEnergyCharacteristic characteristic =
+                serviceFTMS->characteristic(QBluetoothUuid(ftms::treadmill::uuid));
             Q_ASSERT(characteristic.isValid());
             if (leController->state() != QLowEnergyController::ConnectedState) {
                 emit debug(QStringLiteral("virtualtreadmill connection error"));
@@ -449,28 +462,18 @@ void virtualtreadmill::treadmillProvider() {
         }
 
         // indoor bike data in order to exploit a zwift bug for treadmill incline values
-        QByteArray valueBike;
-        valueBike.append((char)0x64); // speed, inst. cadence, resistance lvl, instant power
-        valueBike.append((char)0x02); // heart rate
-
-        valueBike.append((char)(normalizeSpeed & 0xFF));      // speed
-        valueBike.append((char)(normalizeSpeed >> 8) & 0xFF); // speed
-
         uint16_t cadence = 0;
         if (treadMill->deviceType() == bluetoothdevice::ELLIPTICAL)
             cadence = ((elliptical *)treadMill)->currentCadence().value();
 
-        valueBike.append((char)((uint16_t)(cadence * 2) & 0xFF));        // cadence
-        valueBike.append((char)(((uint16_t)(cadence * 2) >> 8) & 0xFF)); // cadence
-
-        valueBike.append((char)(0)); // resistance
-        valueBike.append((char)(0)); // resistance
-
-        valueBike.append((char)(((uint16_t)treadMill->wattsMetric().value()) & 0xFF));      // watts
-        valueBike.append((char)(((uint16_t)treadMill->wattsMetric().value()) >> 8) & 0xFF); // watts
-
-        valueBike.append(char(treadMill->currentHeart().value())); // Actual value.
-        valueBike.append((char)0);                                 // Bkool FTMS protocol HRM offset 1280 fix
+        ftms::frame<ftms::indoorbike> frameBike;
+        frameBike.set(ftms::indoorbike::instantSpeed, normalizeSpeed);
+        frameBike.set(ftms::indoorbike::instantCadence, (uint16_t)(cadence * 2));
+        frameBike.set(ftms::indoorbike::resistanceLevel, 0);
+        frameBike.set(ftms::indoorbike::instantPower, (uint16_t)values.watt);
+        frameBike.set(ftms::indoorbike::heartRate, (uint8_t)values.heart);
+        QByteArray valueBike = frameBike.encode();
+        valueBike.append((char)0); // Bkool FTMS protocol HRM offset 1280 fix
 
         if (!serviceFTMS) {
             qDebug() << QStringLiteral("serviceFIT not available");
@@ -479,7 +482,7 @@ void virtualtreadmill::treadmillProvider() {
         }
 
         QLowEnergyCharacteristic characteristicBike =
-            serviceFTMS->characteristic((QBluetoothUuid::CharacteristicType)0x2AD2);
+            serviceFTMS->characteristic(QBluetoothUuid(ftms::indoorbike::uuid));
         Q_ASSERT(characteristicBike.isValid());
         if (leController->state() != QLowEnergyController::ConnectedState) {
             qDebug() << QStringLiteral("virtual bike not connected");
@@ -503,11 +506,11 @@ void virtualtreadmill::treadmillProvider() {
         }
 
         value.append(0x02); // total distance
-        uint16_t speed = (treadMill->currentSpeed().value() / 3.6) * 256;
-        uint32_t distance = treadMill->odometer() * 1000.0;
+        uint16_t speed = (values.speed / 3.6) * 256;
+        uint32_t distance = values.odometer * 1000.0;
         value.append((char)((speed & 0xFF)));
         value.append((char)((speed >> 8) & 0xFF));
-        value.append((char)(treadMill->currentCadence().value()));
+        value.append((char)(values.cadence));
         value.append((char)((distance & 0xFF)));
         value.append((char)((distance >> 8) & 0xFF));
         value.append((char)((distance >> 16) & 0xFF));
@@ -535,8 +538,8 @@ void virtualtreadmill::treadmillProvider() {
         }
 
         QByteArray valueHR;
-        valueHR.append(char(0));                                 // Flags that specify the format of the value.
-        valueHR.append(char(treadMill->currentHeart().value())); // Actual value.
+        valueHR.append(char(0));            // Flags that specify the format of the value.
+        valueHR.append(char(values.heart)); // Actual value.
         QLowEnergyCharacteristic characteristicHR = serviceHR->characteristic(QBluetoothUuid::HeartRateMeasurement);
         Q_ASSERT(characteristicHR.isValid());
         if (leController->state() != QLowEnergyController::ConnectedState) {
@@ -551,13 +554,6 @@ void virtualtreadmill::treadmillProvider() {
     }
 }
 
-bool virtualtreadmill::connected() {
-    if (!leController) {
-        return false;
-    }
-    return leController->state() == QLowEnergyController::ConnectedState;
-}
-
 // Setup           |  FTMS Service | FTMS Treadmill Data | FTMS Bike | RSC | Heart
 // -------------------------------------------------------------------------------
 // iOS FTMS        |      X        |          X          |     X     |     |   X
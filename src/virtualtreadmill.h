@@ -27,16 +27,24 @@
 #include <QtCore/qtimer.h>
 
 #include "treadmill.h"
+#include "virtualnotifier.h"
+#include <atomic>
 
 class virtualtreadmill : public QObject {
     Q_OBJECT
   public:
-    virtualtreadmill(bluetoothdevice *t, bool noHeartService);
-    bool connected();
+    // built in the "virtualdevices" worker thread when virtual_device_thread is enabled, like virtualbike.
+    // Delete it with workerthread::destroy().
+    static virtualtreadmill *create(bluetoothdevice *t, bool noHeartService);
+    // safe from any thread
+    bool connected() { return m_connected; }
     bool autoInclinationEnabled() { return m_autoInclinationEnabled; }
 
   private:
+    virtualtreadmill(bluetoothdevice *t, bool noHeartService);
+
     QLowEnergyController *leController = nullptr;
+    std::atomic<bool> m_connected{false}; // follows the state of leController
     QLowEnergyService *serviceFTMS = nullptr;
     QLowEnergyService *serviceRSC = nullptr;
     QLowEnergyService *serviceHR = nullptr;
@@ -44,7 +52,7 @@ class virtualtreadmill : public QObject {
     QLowEnergyServiceData serviceDataFTMS;
     QLowEnergyServiceData serviceDataRSC;
     QLowEnergyServiceData serviceDataHR;
-    QTimer treadmillTimer;
+    virtualnotifier *notifier = nullptr;
     bluetoothdevice *treadMill;
     
     uint64_t lastSlopeChanged = 0;
@@ -54,6 +62,9 @@ class virtualtreadmill : public QObject {
     bool m_autoInclinationEnabled = false;
 
     void slopeChanged(int16_t iresistance);
+    // queued to the thread of the device
+    void changeDeviceSpeed(double speed);
+    void changeDeviceInclination(double inclination);
 
     bool ftmsServiceEnable();
     bool ftmsTreadmillEnable();
@@ -0,0 +1,56 @@
+#include "workerthread.h"
+#include "qdebugfixup.h"
+
+#include <QCoreApplication>
+
+workerthread *workerthread::get(const QString &name) {
+    static QHash<QString, workerthread *> threads;
+    static QMutex mutex;
+    QMutexLocker locker(&mutex);
+    workerthread *t = threads.value(name);
+    if (!t) {
+        t = new workerthread(name);
+        if (qApp) {
+            QObject::connect(qApp, &QCoreApplication::aboutToQuit, t, &workerthread::stop, Qt::DirectConnection);
+        }
+        threads.insert(name, t);
+        t->start(QThread::HighPriority);
+        qDebug() << QStringLiteral("worker thread started") << name;
+    }
+    return t;
+}
+
+workerthread::workerthread(const QString &name) {
+    setObjectName(name);
+    m_context = new QObject();
+    m_context->moveToThread(this);
+}
+
+void workerthread::drain() {
+    if (QThread::currentThread() == this || !isRunning()) {
+        return;
+    }
+    QMetaObject::invokeMethod(
+        m_context, []() {}, Qt::BlockingQueuedConnection);
+}
+
+void workerthread::destroy(QObject *object) {
+    if (!object) {
+        return;
+    }
+    QThread *thread = object->thread();
+    if (thread == QThread::currentThread() || !thread->isRunning()) {
+        delete object;
+        return;
+    }
+    QMetaObject::invokeMethod(
+        object, [object]() { delete object; }, Qt::BlockingQueuedConnection);
+}
+
+void workerthread::stop() {
+    // queued after the pending work
+    QMetaObject::invokeMethod(
+        m_context, [this]() { quit(); }, Qt::QueuedConnection);
+    wait();
+    qDebug() << QStringLiteral("worker thread stopped") << objectName();
+}
@@ -0,0 +1,51 @@
+#ifndef WORKERTHREAD_H
+#define WORKERTHREAD_H
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QThread>
+
+// Named threads with their own event loop, for the objects that must answer the BLE peers without waiting for
+// the GUI thread (e.g. the FTMS control point replies of the virtual devices while a chart or a page is
+// rendered). A thread is started at its first use and stopped when the application quits, once the work already
+// queued is done.
+// The objects living there talk to the GUI thread only through queued signals and invocations, and read the
+// devices through bluetoothdevice::snapshot().
+class workerthread : public QThread {
+
+    Q_OBJECT
+  public:
+    // the thread with this name, started if needed
+    static workerthread *get(const QString &name);
+
+    // runs factory in the thread and returns what it built: timers, sockets and children created by the
+    // constructor belong to the thread from the start. Blocks the caller until it's done.
+    template <typename T, typename F> T *create(F factory) {
+        if (QThread::currentThread() == this) {
+            return factory();
+        }
+        T *object = nullptr;
+        QMetaObject::invokeMethod(
+            m_context, [&object, &factory]() { object = factory(); }, Qt::BlockingQueuedConnection);
+        return object;
+    }
+
+    // runs f in the thread, after the work already queued
+    template <typename F> void post(F f) { QMetaObject::invokeMethod(m_context, std::move(f), Qt::QueuedConnection); }
+
+    // blocks until the work queued so far is done
+    void drain();
+
+    // deletes the object in its own thread and waits for it, so no slot of it can run afterwards
+    static void destroy(QObject *object);
+
+  private:
+    workerthread(const QString &name);
+    void stop();
+
+    QObject *m_context; // lives in the thread, target of the invocations, kept until the application exits
+};
+
+#endif // WORKERTHREAD_H
@@ -77,17 +77,12 @@ QList<trainrow> zwiftworkout::load(const QByteArray &input) {
                     PowerHigh = atts.value(QStringLiteral("PowerHigh")).toDouble();
                 }
 
-                for (uint32_t i = 0; i < Duration; i++) {
-                    trainrow row;
-                    row.duration = QTime(0, 0, 1, 0);
-                    if (PowerHigh > PowerLow)
-                        row.power = (PowerLow + (((PowerHigh - PowerLow) / Duration) * i)) *
-                                    settings.value(QStringLiteral("ftp"), 200.0).toDouble();
-                    else
-                        row.power = (PowerLow - (((PowerLow - PowerHigh) / Duration) * i)) *
-                                    settings.value(QStringLiteral("ftp"), 200.0).toDouble();
-                    list.append(row);
-                }
+                // a single row, the power is interpolated by trainprogram while the ramp runs
+                trainrow row;
+                row.duration = QTime(Duration / 3600, (Duration / 60) % 60, Duration % 60, 0);
+                row.power = PowerLow * settings.value(QStringLiteral("ftp"), 200.0).toDouble();
+                row.power_end = PowerHigh * settings.value(QStringLiteral("ftp"), 200.0).toDouble();
+                list.append(row);
             } else if (stream.name().contains(QStringLiteral("SteadyState"))) {
                 uint32_t Duration = 1;
                 double Power = 1;